@@ -0,0 +1,227 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Graphics/Animation/AnimationController.h>
+#include <Lumos/Graphics/Animation/SamplingContext.h>
+#include <Lumos/Graphics/Animation/Skeleton.h>
+#include <Lumos/Core/JobSystem.h>
+#include <Lumos/Maths/MathsUtilities.h>
+
+#include <ozz/animation/offline/animation_builder.h>
+#include <ozz/animation/offline/raw_animation.h>
+#include <ozz/animation/offline/raw_skeleton.h>
+#include <ozz/animation/offline/skeleton_builder.h>
+#include <ozz/animation/runtime/animation.h>
+#include <ozz/animation/runtime/skeleton.h>
+
+#include <vector>
+
+using namespace Lumos;
+using namespace Lumos::Graphics;
+
+namespace
+{
+    const uint32_t FrameCount          = 60;
+    const uint32_t ModelsPerJob        = 4; // As Scene::AddAnimationTasks
+    const uint32_t JointsPerLimb       = 15;
+    const float AnimationDuration      = 2.0f;
+    const uint32_t AnimationKeysPerSec = 30;
+
+    // A chain of JointsPerLimb joints below parent, named prefix0, prefix1...
+    void AddLimb(ozz::animation::offline::RawSkeleton::Joint& parent, const char* prefix)
+    {
+        ozz::animation::offline::RawSkeleton::Joint* joint = &parent;
+        for(uint32_t i = 0; i < JointsPerLimb; i++)
+        {
+            joint->children.resize(joint->children.size() + 1);
+            joint                        = &joint->children.back();
+            joint->name                  = std::string(prefix) + std::to_string(i);
+            joint->transform.translation = ozz::math::Float3(0.0f, 0.1f, 0.0f);
+            joint->transform.rotation    = ozz::math::Quaternion::identity();
+            joint->transform.scale       = ozz::math::Float3::one();
+        }
+    }
+
+    // Root, a spine with two arms, and two legs: 4 * JointsPerLimb + 2 joints, about a game character
+    SharedPtr<Skeleton> MakeSkeleton()
+    {
+        ozz::animation::offline::RawSkeleton raw;
+        raw.roots.resize(1);
+        ozz::animation::offline::RawSkeleton::Joint& root = raw.roots[0];
+        root.name                                         = "root";
+        root.transform                                    = ozz::math::Transform::identity();
+        root.children.resize(1);
+        root.children[0].name      = "spine";
+        root.children[0].transform = ozz::math::Transform::identity();
+
+        AddLimb(root.children[0], "arm_l");
+        AddLimb(root.children[0], "arm_r");
+        AddLimb(root, "leg_l");
+        AddLimb(root, "leg_r");
+
+        ozz::animation::offline::SkeletonBuilder builder;
+        return CreateSharedPtr<Skeleton>(builder(raw).release());
+    }
+
+    // Every joint swings around its own axis at its own rate, keyed AnimationKeysPerSec times a second
+    SharedPtr<Animation> MakeAnimation(const SharedPtr<Skeleton>& skeleton, const std::string& name, float speed)
+    {
+        const ozz::animation::Skeleton& ozzSkeleton = skeleton->GetSkeleton();
+        const uint32_t keyCount                     = (uint32_t)(AnimationDuration * AnimationKeysPerSec) + 1;
+
+        ozz::animation::offline::RawAnimation raw;
+        raw.duration = AnimationDuration;
+        raw.tracks.resize(ozzSkeleton.num_joints());
+        for(uint32_t joint = 0; joint < (uint32_t)raw.tracks.size(); joint++)
+        {
+            ozz::animation::offline::RawAnimation::JointTrack& track = raw.tracks[joint];
+            const ozz::math::Float3 axis                             = Normalize(ozz::math::Float3(1.0f, (float)(joint % 3), (float)(joint % 5)));
+            for(uint32_t key = 0; key < keyCount; key++)
+            {
+                const float time  = key * AnimationDuration / (keyCount - 1);
+                const float angle = 0.5f * sinf(speed * time * Maths::M_PI + joint);
+                track.rotations.push_back({ time, ozz::math::Quaternion::FromAxisAngle(axis, angle) });
+                track.translations.push_back({ time, ozz::math::Float3(0.0f, 0.1f + 0.01f * sinf(time + joint), 0.0f) });
+            }
+            track.scales.push_back({ 0.0f, ozz::math::Float3::one() });
+        }
+
+        ozz::animation::offline::AnimationBuilder builder;
+        return CreateSharedPtr<Animation>(name, builder(raw).release(), skeleton);
+    }
+
+    struct Character
+    {
+        AnimationController Controller;
+        SamplingContext Context;
+    };
+
+    // count characters on one skeleton with two states, each a little way into its clip
+    struct Crowd
+    {
+        SharedPtr<Skeleton> CrowdSkeleton;
+        std::vector<Character*> Characters;
+
+        explicit Crowd(uint32_t count)
+        {
+            CrowdSkeleton             = MakeSkeleton();
+            SharedPtr<Animation> walk = MakeAnimation(CrowdSkeleton, "Walk", 1.0f);
+            SharedPtr<Animation> run  = MakeAnimation(CrowdSkeleton, "Run", 2.0f);
+            const uint32_t jointCount = (uint32_t)CrowdSkeleton->GetSkeleton().num_joints();
+
+            TDArray<Mat4> bindPoses;
+            bindPoses.Resize(jointCount, Mat4(1.0f));
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                Character* character = new Character();
+                character->Controller.SetSkeleton(CrowdSkeleton);
+                character->Controller.AddState("Walk", walk);
+                character->Controller.AddState("Run", run);
+                character->Controller.SetBindPoses(bindPoses);
+                character->Controller.SetCurrentState(0);
+                character->Controller.SetTime(AnimationDuration * i / count);
+                Characters.push_back(character);
+            }
+        }
+
+        ~Crowd()
+        {
+            for(Character* character : Characters)
+                delete character;
+        }
+    };
+
+    // One frame of animation for one character, up to the skinning matrices the renderer uploads
+    void UpdateCharacter(Character& character, float deltaTime)
+    {
+        character.Controller.Update(deltaTime, character.Context);
+        Benchmark::DoNotOptimise(character.Controller.GetJointMatrices());
+    }
+
+    // Average time per frame to animate the whole crowd, on the calling thread or dispatched over the JobSystem
+    double MeasureCrowd(Crowd& crowd, bool parallel)
+    {
+        const float deltaTime = 1.0f / 60.0f;
+        const uint32_t count  = (uint32_t)crowd.Characters.size();
+        for(Character* character : crowd.Characters)
+            UpdateCharacter(*character, deltaTime);
+
+        double total = 0.0;
+        for(uint32_t frame = 0; frame < FrameCount; frame++)
+        {
+            total += Benchmark::Measure(1, [&]()
+                                        {
+                                            if(parallel)
+                                            {
+                                                System::JobSystem::Context ctx;
+                                                System::JobSystem::Dispatch(ctx, count, ModelsPerJob, [&](JobDispatchArgs args)
+                                                                            { UpdateCharacter(*crowd.Characters[args.jobIndex], deltaTime); });
+                                                System::JobSystem::Wait(ctx);
+                                            }
+                                            else
+                                            {
+                                                for(Character* character : crowd.Characters)
+                                                    UpdateCharacter(*character, deltaTime);
+                                            } });
+        }
+        return total / FrameCount;
+    }
+}
+
+// Per frame cost of animating crowds of characters with 62 joints, sampled, converted to model space and turned
+// into skinning matrices, on the main thread and spread over the JobSystem workers
+LUMOS_BENCHMARK(AnimationCrowd)
+{
+    const uint32_t counts[] = { 100, 1000, 4000 };
+    for(uint32_t count : counts)
+    {
+        Crowd crowd(count);
+        const double serialTime   = MeasureCrowd(crowd, false);
+        const double parallelTime = MeasureCrowd(crowd, true);
+        printf("%5u characters: main thread %8.3f ms, %u job threads %8.3f ms\n", count, serialTime, System::JobSystem::GetThreadCount(), parallelTime);
+    }
+}
+
+// Cost of the blending features for 1000 characters: a single state, a crossfade between two states, an
+// additive layer, a masked upper body layer, and each LOD level with a single state
+LUMOS_BENCHMARK(AnimationBlending)
+{
+    const uint32_t count = 1000;
+
+    Crowd single(count);
+    const double singleTime = MeasureCrowd(single, false);
+
+    // A fade long enough to still be running at the end of the measurement
+    Crowd crossFade(count);
+    for(Character* character : crossFade.Characters)
+        character->Controller.CrossFade(1, 1000.0f);
+    const double crossFadeTime = MeasureCrowd(crossFade, false);
+
+    Crowd additive(count);
+    for(Character* character : additive.Characters)
+    {
+        const uint32_t layer = character->Controller.AddLayer("Additive", AnimationBlendMode::Additive, 0.5f);
+        character->Controller.SetCurrentState(1, layer);
+    }
+    const double additiveTime = MeasureCrowd(additive, false);
+
+    Crowd masked(count);
+    for(Character* character : masked.Characters)
+    {
+        const uint32_t layer = character->Controller.AddLayer("UpperBody", AnimationBlendMode::Override);
+        character->Controller.SetCurrentState(1, layer);
+        character->Controller.SetLayerMask(layer, "spine");
+    }
+    const double maskedTime = MeasureCrowd(masked, false);
+
+    printf("%u characters: single state %7.3f ms, crossfade %7.3f ms, additive layer %7.3f ms, masked upper body layer %7.3f ms\n",
+           count, singleTime, crossFadeTime, additiveTime, maskedTime);
+
+    for(uint32_t lod = 0; lod <= 3; lod++)
+    {
+        Crowd crowd(count);
+        for(Character* character : crowd.Characters)
+            character->Controller.SetLOD(lod);
+        printf("%u characters: LOD %u %7.3f ms\n", count, lod, MeasureCrowd(crowd, false));
+    }
+}
@@ -0,0 +1,114 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Core/OS/Memory.h>
+#include <vector>
+
+#ifdef LUMOS_PLATFORM_LINUX
+#include <unistd.h>
+#endif
+
+using namespace Lumos;
+
+namespace
+{
+    // Resident set size of the process, 0 where it can't be read
+    uint64_t ResidentBytes()
+    {
+#ifdef LUMOS_PLATFORM_LINUX
+        FILE* file = fopen("/proc/self/statm", "r");
+        if(!file)
+            return 0;
+
+        unsigned long long size = 0, resident = 0;
+        const int read = fscanf(file, "%llu %llu", &size, &resident);
+        fclose(file);
+        return read == 2 ? resident * (uint64_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+        return 0;
+#endif
+    }
+
+    double ToMegabytes(uint64_t bytes)
+    {
+        return bytes / (1024.0 * 1024.0);
+    }
+
+    // The arenas the engine creates at startup, with the sizes their owners guess at
+    const uint64_t StartupArenaSizes[] = {
+        Megabytes(1),   // Application frame arena
+        Kilobytes(64),  // Application arena
+        Megabytes(8),   // Application UI arena
+        Megabytes(1),   // UI frame arena
+        Megabytes(2),   // CoreSystem
+        Megabytes(4),   // AssetManager
+        Megabytes(4),   // LumosPhysicsEngine
+        Megabytes(4),   // OctreeBroadphase
+        Kilobytes(64),  // SceneManager
+        Kilobytes(64),  // SystemManager
+        Megabytes(1),   // Scratch arena
+        Megabytes(1),   // Scratch arena
+    };
+
+    // Size the spike arena is created with. Without chaining it would have to be SpikeSize up front
+    const uint64_t SpikeArenaSize = Megabytes(1);
+    const uint64_t SpikeSize      = Megabytes(256);
+    const uint64_t SpikeChunk     = Kilobytes(64);
+}
+
+// Resident memory of the engine's startup arenas with 16KB used in each, which is about what an idle
+// server touches
+LUMOS_BENCHMARK(ArenaStartupMemory)
+{
+    const uint64_t before = ResidentBytes();
+
+    std::vector<Arena*> arenas;
+    uint64_t requested = 0;
+    for(uint64_t size : StartupArenaSizes)
+    {
+        Arena* arena = ArenaAlloc(size);
+        ArenaPush(arena, Kilobytes(16));
+        arenas.push_back(arena);
+        requested += size;
+    }
+
+    const uint64_t after = ResidentBytes();
+
+    uint64_t committed = 0, reserved = 0;
+    for(Arena* arena : arenas)
+    {
+        const ArenaStats stats = ArenaGetStats(arena);
+        committed += stats.Committed;
+        reserved += stats.Reserved;
+    }
+
+    printf("%u arenas, %.2f MB requested: resident +%.2f MB, committed %.2f MB, reserved %.2f MB\n", (uint32_t)arenas.size(),
+           ToMegabytes(requested), ToMegabytes(after - before), ToMegabytes(committed), ToMegabytes(reserved));
+
+    for(Arena* arena : arenas)
+        ArenaRelease(arena);
+}
+
+// A one off spike of SpikeSize pushed in SpikeChunk pieces into a small arena, then cleared for a steady state of
+// 16KB. Reports push time, resident memory at the peak and after the clear, and the high water mark
+LUMOS_BENCHMARK(ArenaSpike)
+{
+    const uint64_t before = ResidentBytes();
+    Arena* arena          = ArenaAlloc(SpikeArenaSize);
+
+    const double pushTime = Benchmark::Measure(1, [&]()
+                                               {
+                                                   for(uint64_t pushed = 0; pushed < SpikeSize; pushed += SpikeChunk)
+                                                       ArenaPush(arena, SpikeChunk); });
+    const uint64_t peak = ResidentBytes();
+
+    ArenaClear(arena);
+    ArenaPush(arena, Kilobytes(16));
+    const uint64_t steady = ResidentBytes();
+
+    const ArenaStats stats = ArenaGetStats(arena);
+    printf("%.0f MB spike in %.0f KB pushes: %.3f ms, resident +%.2f MB at peak, +%.2f MB after clear, high water mark %.2f MB, %u blocks\n",
+           ToMegabytes(SpikeSize), SpikeChunk / 1024.0, pushTime, ToMegabytes(peak - before), ToMegabytes(steady - before),
+           ToMegabytes(stats.HighWaterMark), stats.BlockCount);
+
+    ArenaRelease(arena);
+}
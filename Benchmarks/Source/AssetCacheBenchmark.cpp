@@ -0,0 +1,126 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Core/Asset/AssetCache.h>
+#include <Lumos/Audio/OggLoader.h>
+#include <Lumos/Utilities/LoadImage.h>
+#include <filesystem>
+#include <vector>
+
+using namespace Lumos;
+
+namespace
+{
+    // The benchmark can be started from the repository root or from a build folder inside it
+    bool FindExampleAssets(std::filesystem::path& outPath)
+    {
+        const char* candidates[] = { "ExampleProject/Assets", "../ExampleProject/Assets", "../../ExampleProject/Assets", "../../../ExampleProject/Assets" };
+        for(const char* candidate : candidates)
+        {
+            if(std::filesystem::is_directory(candidate))
+            {
+                outPath = std::filesystem::absolute(candidate);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct ExampleAssets
+    {
+        std::vector<std::string> Images;
+        std::vector<std::string> Sounds;
+        uint64_t ImageBytes = 0;
+        uint64_t SoundBytes = 0;
+    };
+
+    ExampleAssets CollectAssets(const std::filesystem::path& root)
+    {
+        ExampleAssets assets;
+        for(const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(root))
+        {
+            if(!entry.is_regular_file())
+                continue;
+
+            const std::string extension = entry.path().extension().string();
+            if(extension == ".png" || extension == ".jpg" || extension == ".tga")
+            {
+                assets.Images.push_back(entry.path().string());
+                assets.ImageBytes += entry.file_size();
+            }
+            else if(extension == ".ogg")
+            {
+                assets.Sounds.push_back(entry.path().string());
+                assets.SoundBytes += entry.file_size();
+            }
+        }
+        return assets;
+    }
+
+    double LoadImages(const ExampleAssets& assets)
+    {
+        return Benchmark::Measure(1, [&]()
+                                  {
+                                      for(const std::string& path : assets.Images)
+                                      {
+                                          uint32_t width = 0, height = 0, bits = 0;
+                                          bool isHDR     = false;
+                                          uint8_t* pixels = LoadImageFromFile(path, &width, &height, &bits, &isHDR);
+                                          Benchmark::DoNotOptimise(pixels);
+                                          delete[] pixels;
+                                      } });
+    }
+
+    double LoadSounds(const ExampleAssets& assets)
+    {
+        return Benchmark::Measure(1, [&]()
+                                  {
+                                      for(const std::string& path : assets.Sounds)
+                                      {
+                                          AudioData data = LoadOgg(path);
+                                          Benchmark::DoNotOptimise(data.Size);
+                                      } });
+    }
+}
+
+// ExampleProject's images and Ogg sounds loaded with the cache disabled, with an empty cache that imports and
+// stores every asset, and again from the cooked blobs. Models need a GPU device to upload their meshes, so they
+// are not covered here
+LUMOS_BENCHMARK(AssetCacheLoad)
+{
+    std::filesystem::path assetRoot;
+    if(!FindExampleAssets(assetRoot))
+    {
+        printf("ExampleProject/Assets not found, run from the repository root\n");
+        return;
+    }
+
+    const ExampleAssets assets = CollectAssets(assetRoot);
+
+    const std::filesystem::path cacheFolder = std::filesystem::temp_directory_path() / "LumosBenchmarkAssetCache";
+    std::filesystem::remove_all(cacheFolder);
+    std::filesystem::create_directories(cacheFolder);
+    AssetCache::Get().SetCacheFolder(cacheFolder.string() + "/");
+
+    AssetCache::Get().SetEnabled(false);
+    const double coldImageTime = LoadImages(assets);
+    const double coldSoundTime = LoadSounds(assets);
+
+    AssetCache::Get().SetEnabled(true);
+    const double cookImageTime = LoadImages(assets);
+    const double cookSoundTime = LoadSounds(assets);
+
+    AssetCache::Get().ResetStats();
+    const double cookedImageTime = LoadImages(assets);
+    const double cookedSoundTime = LoadSounds(assets);
+    const uint32_t hits          = AssetCache::Get().GetHitCount();
+    const uint32_t misses        = AssetCache::Get().GetMissCount();
+
+    printf("%3u images (%.1f MB): cold %8.3f ms, cooking %8.3f ms, cooked %8.3f ms\n", (uint32_t)assets.Images.size(),
+           assets.ImageBytes / (1024.0 * 1024.0), coldImageTime, cookImageTime, cookedImageTime);
+    printf("%3u sounds (%.1f MB): cold %8.3f ms, cooking %8.3f ms, cooked %8.3f ms\n", (uint32_t)assets.Sounds.size(),
+           assets.SoundBytes / (1024.0 * 1024.0), coldSoundTime, cookSoundTime, cookedSoundTime);
+    printf("cooked pass: %u hits, %u misses\n", hits, misses);
+
+    AssetCache::Get().SetCacheFolder("");
+    std::filesystem::remove_all(cacheFolder);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace Lumos
+{
+    namespace Benchmark
+    {
+        typedef void (*BenchmarkFunc)();
+
+        // Adds a benchmark to the list run by main. Use LUMOS_BENCHMARK rather than constructing these directly
+        struct Registration
+        {
+            Registration(const char* name, BenchmarkFunc func);
+        };
+
+        // Best of repeats wall time in milliseconds. The fastest run is the least disturbed by the rest of the machine
+        template <typename Func>
+        double Measure(uint32_t repeats, Func&& func)
+        {
+            double best = 0.0;
+            for(uint32_t i = 0; i < repeats; i++)
+            {
+                auto start        = std::chrono::high_resolution_clock::now();
+                func();
+                auto end          = std::chrono::high_resolution_clock::now();
+                const double time = std::chrono::duration<double, std::milli>(end - start).count();
+                if(i == 0 || time < best)
+                    best = time;
+            }
+            return best;
+        }
+
+        // As Measure, with setup run untimed before each run, e.g. to restore the input the timed part consumes
+        template <typename Setup, typename Func>
+        double Measure(uint32_t repeats, Setup&& setup, Func&& func)
+        {
+            double best = 0.0;
+            for(uint32_t i = 0; i < repeats; i++)
+            {
+                setup();
+                auto start        = std::chrono::high_resolution_clock::now();
+                func();
+                auto end          = std::chrono::high_resolution_clock::now();
+                const double time = std::chrono::duration<double, std::milli>(end - start).count();
+                if(i == 0 || time < best)
+                    best = time;
+            }
+            return best;
+        }
+
+        // Keeps the optimiser from dropping work whose result is never read
+        template <typename T>
+        inline void DoNotOptimise(const T& value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile(""
+                         :
+                         : "r,m"(value)
+                         : "memory");
+#else
+            static volatile const T* sink;
+            sink = &value;
+#endif
+        }
+    }
+}
+
+#define LUMOS_BENCHMARK(name)                                                                \
+    static void name();                                                                      \
+    static Lumos::Benchmark::Registration name##Registration(#name, name); \
+    static void name()
@@ -0,0 +1,259 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Physics/LumosPhysicsEngine/Broadphase/BruteForceBroadphase.h>
+#include <Lumos/Physics/LumosPhysicsEngine/Broadphase/DynamicTreeBroadphase.h>
+#include <Lumos/Physics/LumosPhysicsEngine/Broadphase/OctreeBroadphase.h>
+#include <Lumos/Physics/LumosPhysicsEngine/Broadphase/SortAndSweepBroadphase.h>
+#include <Lumos/Physics/LumosPhysicsEngine/CollisionShapes/SphereCollisionShape.h>
+#include <Lumos/Maths/MathsUtilities.h>
+#include <random>
+#include <vector>
+
+using namespace Lumos;
+
+namespace
+{
+    // RigidBody3D can only be constructed by the physics engine or a derived type, like PathNode
+    class BenchBody : public RigidBody3D
+    {
+    public:
+        BenchBody(const RigidBody3DProperties& properties)
+            : RigidBody3D(properties)
+        {
+        }
+    };
+
+    const uint32_t StepCount = 10;
+
+    // Unit spheres spread through a cube with volumePerBody space for each, 8 gives about one neighbour per body.
+    // The first awakeFraction of the bodies move a little every step, the rest are at rest
+    struct BroadphaseScene
+    {
+        std::vector<BenchBody*> Bodies;
+        std::vector<RigidBody3D*> BodyPointers;
+        std::vector<Vec3> Velocities;
+        float HalfExtent;
+
+        explicit BroadphaseScene(uint32_t count, float volumePerBody = 8.0f, float awakeFraction = 1.0f)
+        {
+            std::mt19937 rng(count);
+            HalfExtent = 0.5f * powf((float)count * volumePerBody, 1.0f / 3.0f);
+            std::uniform_real_distribution<float> position(-HalfExtent, HalfExtent);
+            std::uniform_real_distribution<float> velocity(-2.0f, 2.0f);
+
+            SharedPtr<CollisionShape> shape = CreateSharedPtr<SphereCollisionShape>(0.5f);
+            const uint32_t awakeCount       = (uint32_t)(count * awakeFraction);
+            for(uint32_t i = 0; i < count; i++)
+            {
+                RigidBody3DProperties properties;
+                properties.Position = Vec3(position(rng), position(rng), position(rng));
+                properties.Shape    = shape;
+                properties.AtRest   = i >= awakeCount;
+                Bodies.push_back(new BenchBody(properties));
+                BodyPointers.push_back(Bodies.back());
+                Velocities.push_back(properties.AtRest ? Vec3(0.0f) : Vec3(velocity(rng), velocity(rng), velocity(rng)));
+            }
+        }
+
+        ~BroadphaseScene()
+        {
+            for(BenchBody* body : Bodies)
+                delete body;
+        }
+
+        void Move(float dt)
+        {
+            for(uint32_t i = 0; i < (uint32_t)Bodies.size(); i++)
+            {
+                if(Bodies[i]->GetIsAtRest())
+                    continue;
+
+                Vec3& velocity = Velocities[i];
+                Vec3 position  = Bodies[i]->GetPosition() + velocity * dt;
+                if(Maths::Abs(position.x) > HalfExtent)
+                    velocity.x = -velocity.x;
+                if(Maths::Abs(position.y) > HalfExtent)
+                    velocity.y = -velocity.y;
+                if(Maths::Abs(position.z) > HalfExtent)
+                    velocity.z = -velocity.z;
+                Bodies[i]->SetPosition(position);
+            }
+        }
+    };
+
+    // Average time of one FindPotentialCollisionPairs call over StepCount steps, after a first untimed step.
+    // Every broadphase gets the same scene, so the final pair counts should match
+    double MeasureBroadphase(Broadphase& broadphase, uint32_t count, float volumePerBody, float awakeFraction, uint32_t& pairCount)
+    {
+        BroadphaseScene scene(count, volumePerBody, awakeFraction);
+        TDArray<CollisionPair> pairs;
+        const uint32_t bodyCount = (uint32_t)scene.BodyPointers.size();
+        broadphase.FindPotentialCollisionPairs(scene.BodyPointers.data(), pairs, bodyCount);
+
+        double total = 0.0;
+        for(uint32_t step = 0; step < StepCount; step++)
+        {
+            scene.Move(1.0f / 60.0f);
+            for(BenchBody* body : scene.Bodies)
+                body->GetWorldSpaceAABB();
+
+            pairs.Clear();
+            total += Benchmark::Measure(1, [&]()
+                                        { broadphase.FindPotentialCollisionPairs(scene.BodyPointers.data(), pairs, bodyCount); });
+        }
+
+        pairCount = (uint32_t)pairs.Size();
+        return total / StepCount;
+    }
+}
+
+// Broadphase time per step for moving bodies. BruteForceBroadphase emits every pair without an overlap test,
+// so it is only run while its pair list fits in memory
+LUMOS_BENCHMARK(BroadphaseScaling)
+{
+    const uint32_t counts[] = { 1000, 5000, 10000, 50000 };
+    for(uint32_t count : counts)
+    {
+        uint32_t pairCount = 0;
+
+        SortAndSweepBroadphase sortAndSweep;
+        const double sortAndSweepTime = MeasureBroadphase(sortAndSweep, count, 8.0f, 1.0f, pairCount);
+        printf("%6u bodies: sort and sweep %9.3f ms (%u pairs)\n", count, sortAndSweepTime, pairCount);
+
+        OctreeBroadphase octree(5, 8);
+        const double octreeTime = MeasureBroadphase(octree, count, 8.0f, 1.0f, pairCount);
+        printf("%6u bodies: octree         %9.3f ms (%u pairs)\n", count, octreeTime, pairCount);
+
+        DynamicTreeBroadphase dynamicTree;
+        const double dynamicTreeTime = MeasureBroadphase(dynamicTree, count, 8.0f, 1.0f, pairCount);
+        printf("%6u bodies: dynamic tree   %9.3f ms (%u pairs)\n", count, dynamicTreeTime, pairCount);
+
+        if(count <= 5000)
+        {
+            BruteForceBroadphase bruteForce;
+            const double bruteForceTime = MeasureBroadphase(bruteForce, count, 8.0f, 1.0f, pairCount);
+            printf("%6u bodies: brute force    %9.3f ms (%u pairs)\n", count, bruteForceTime, pairCount);
+        }
+    }
+}
+
+// AABB and ray queries through DynamicTreeBroadphase against the linear scan LumosPhysicsEngine falls back to
+// for broadphases without query support
+LUMOS_BENCHMARK(BroadphaseQueries)
+{
+    const uint32_t counts[]   = { 1000, 10000, 50000 };
+    const uint32_t queryCount = 1000;
+    for(uint32_t count : counts)
+    {
+        BroadphaseScene scene(count);
+        DynamicTreeBroadphase dynamicTree;
+        TDArray<CollisionPair> pairs;
+        dynamicTree.FindPotentialCollisionPairs(scene.BodyPointers.data(), pairs, count);
+
+        std::mt19937 rng(count);
+        std::uniform_real_distribution<float> position(-scene.HalfExtent, scene.HalfExtent);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        std::vector<Maths::BoundingBox> boxes;
+        std::vector<Maths::Ray> rays;
+        for(uint32_t i = 0; i < queryCount; i++)
+        {
+            const Vec3 centre(position(rng), position(rng), position(rng));
+            boxes.push_back(Maths::BoundingBox(centre - Vec3(2.0f), centre + Vec3(2.0f)));
+            rays.push_back(Maths::Ray(centre, Vec3(direction(rng), direction(rng), direction(rng)).Normalised()));
+        }
+
+        TDArray<RigidBody3D*> found;
+        uint32_t treeFound  = 0;
+        uint32_t linearFound = 0;
+
+        const double treeBoxTime = Benchmark::Measure(3, [&]()
+                                                      {
+                                                          treeFound = 0;
+                                                          for(const Maths::BoundingBox& box : boxes)
+                                                          {
+                                                              found.Clear();
+                                                              dynamicTree.QueryAABB(box, found);
+                                                              treeFound += (uint32_t)found.Size();
+                                                          } });
+
+        const double linearBoxTime = Benchmark::Measure(3, [&]()
+                                                        {
+                                                            linearFound = 0;
+                                                            for(const Maths::BoundingBox& box : boxes)
+                                                            {
+                                                                for(RigidBody3D* body : scene.BodyPointers)
+                                                                {
+                                                                    const Maths::BoundingBox& aabb = body->GetWorldSpaceAABB();
+                                                                    if(aabb.m_Max.x < box.m_Min.x || aabb.m_Min.x > box.m_Max.x
+                                                                       || aabb.m_Max.y < box.m_Min.y || aabb.m_Min.y > box.m_Max.y
+                                                                       || aabb.m_Max.z < box.m_Min.z || aabb.m_Min.z > box.m_Max.z)
+                                                                        continue;
+                                                                    linearFound++;
+                                                                }
+                                                            } });
+
+        uint32_t treeHits   = 0;
+        uint32_t linearHits = 0;
+        const double treeRayTime = Benchmark::Measure(3, [&]()
+                                                      {
+                                                          treeHits = 0;
+                                                          for(const Maths::Ray& ray : rays)
+                                                          {
+                                                              RaycastHit hit;
+                                                              treeHits += dynamicTree.Raycast(ray, 20.0f, hit) ? 1 : 0;
+                                                          } });
+
+        const double linearRayTime = Benchmark::Measure(3, [&]()
+                                                        {
+                                                            linearHits = 0;
+                                                            for(const Maths::Ray& ray : rays)
+                                                            {
+                                                                const Vec3 invDirection(1.0f / ray.Direction.x, 1.0f / ray.Direction.y, 1.0f / ray.Direction.z);
+                                                                float maxDistance = 20.0f;
+                                                                bool hit          = false;
+                                                                for(RigidBody3D* body : scene.BodyPointers)
+                                                                {
+                                                                    const Maths::BoundingBox& aabb = body->GetWorldSpaceAABB();
+                                                                    const float distance           = DynamicTree::RayBoxDistance(ray.Origin, invDirection, aabb.m_Min, aabb.m_Max, maxDistance);
+                                                                    if(distance < 0.0f)
+                                                                        continue;
+                                                                    maxDistance = distance;
+                                                                    hit         = true;
+                                                                }
+                                                                linearHits += hit ? 1 : 0;
+                                                            } });
+
+        printf("%6u bodies, %u queries: AABB tree %8.3f ms, linear %8.3f ms (%u / %u found)\n", count, queryCount, treeBoxTime, linearBoxTime, treeFound, linearFound);
+        printf("%6u bodies, %u queries: ray  tree %8.3f ms, linear %8.3f ms (%u / %u hit)\n", count, queryCount, treeRayTime, linearRayTime, treeHits, linearHits);
+    }
+}
+
+// Densely packed bodies, about eight neighbours each, with only 5% of them awake. Pairs of two bodies at rest
+// can't produce contacts, so the broadphase cost should follow the awake bodies
+LUMOS_BENCHMARK(BroadphaseSleeping)
+{
+    const uint32_t counts[] = { 5000, 20000, 50000 };
+    for(uint32_t count : counts)
+    {
+        uint32_t pairCount = 0;
+
+        SortAndSweepBroadphase sortAndSweep;
+        const double sortAndSweepTime = MeasureBroadphase(sortAndSweep, count, 1.0f, 0.05f, pairCount);
+        printf("%6u bodies, 5%% awake: sort and sweep %9.3f ms (%u pairs)\n", count, sortAndSweepTime, pairCount);
+
+        OctreeBroadphase octree(5, 8);
+        const double octreeTime = MeasureBroadphase(octree, count, 1.0f, 0.05f, pairCount);
+        printf("%6u bodies, 5%% awake: octree         %9.3f ms (%u pairs)\n", count, octreeTime, pairCount);
+
+        DynamicTreeBroadphase dynamicTree;
+        const double dynamicTreeTime = MeasureBroadphase(dynamicTree, count, 1.0f, 0.05f, pairCount);
+        printf("%6u bodies, 5%% awake: dynamic tree   %9.3f ms (%u pairs)\n", count, dynamicTreeTime, pairCount);
+
+        if(count <= 5000)
+        {
+            BruteForceBroadphase bruteForce;
+            const double bruteForceTime = MeasureBroadphase(bruteForce, count, 1.0f, 0.05f, pairCount);
+            printf("%6u bodies, 5%% awake: brute force    %9.3f ms (%u pairs)\n", count, bruteForceTime, pairCount);
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Physics/LumosPhysicsEngine/LumosPhysicsEngine.h>
+#include <Lumos/Physics/LumosPhysicsEngine/Narrowphase/Manifold.h>
+#include <Lumos/Physics/LumosPhysicsEngine/CollisionShapes/CuboidCollisionShape.h>
+#include <Lumos/Maths/MathsUtilities.h>
+#include <vector>
+
+using namespace Lumos;
+
+namespace
+{
+    // RigidBody3D can only be constructed by the physics engine or a derived type, like PathNode
+    class BenchBody : public RigidBody3D
+    {
+    public:
+        BenchBody(const RigidBody3DProperties& properties)
+            : RigidBody3D(properties)
+        {
+        }
+    };
+
+    const uint32_t StackCount = 64;
+    const uint32_t StepCount  = 120;
+
+    // StackCount columns of unit boxes resting on a static ground, one manifold with four face contacts between
+    // each box and the one below. Positions stay fixed, so every step the solver has to cancel exactly one step of
+    // gravity, and whatever velocity it leaves behind is error that would make a real stack sink or jitter
+    struct StackScene
+    {
+        std::vector<BenchBody*> Bodies; // Per stack, the ground then the boxes bottom to top
+        std::vector<Manifold> Manifolds;
+        std::vector<Manifold> PreviousManifolds;
+        uint32_t Height;
+
+        explicit StackScene(uint32_t height)
+            : Height(height)
+        {
+            SharedPtr<CollisionShape> shape = CreateSharedPtr<CuboidCollisionShape>(Vec3(0.5f));
+            for(uint32_t stack = 0; stack < StackCount; stack++)
+            {
+                for(uint32_t i = 0; i <= height; i++)
+                {
+                    RigidBody3DProperties properties;
+                    properties.Position   = Vec3(stack * 2.0f, (float)i - 0.5f, 0.0f);
+                    properties.Shape      = shape;
+                    properties.Static     = i == 0;
+                    properties.Elasticity = 0.0f;
+                    Bodies.push_back(new BenchBody(properties));
+
+                    if(i == 0)
+                    {
+                        Bodies.back()->SetInverseMass(0.0f);
+                        Bodies.back()->SetInverseInertia(Mat3(0.0f));
+                    }
+                }
+            }
+
+            Manifolds.resize(StackCount * height);
+            PreviousManifolds.resize(StackCount * height);
+        }
+
+        ~StackScene()
+        {
+            for(BenchBody* body : Bodies)
+                delete body;
+        }
+
+        // The narrowphase's part: a fresh manifold per touching pair every step, warm started from last step's
+        void Collide(bool warmStart)
+        {
+            std::swap(Manifolds, PreviousManifolds);
+
+            const Vec3 normal(0.0f, 1.0f, 0.0f);
+            const Vec3 corners[4] = { Vec3(-0.5f, 0.5f, -0.5f), Vec3(0.5f, 0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f), Vec3(-0.5f, 0.5f, 0.5f) };
+            for(uint32_t stack = 0; stack < StackCount; stack++)
+            {
+                for(uint32_t i = 0; i < Height; i++)
+                {
+                    RigidBody3D* below = Bodies[stack * (Height + 1) + i];
+                    RigidBody3D* above = Bodies[stack * (Height + 1) + i + 1];
+                    Manifold& manifold = Manifolds[stack * Height + i];
+
+                    manifold.Initiate(below, above, 0.2f, 0.001f);
+                    for(const Vec3& corner : corners)
+                        manifold.AddContact(below->GetPosition() + corner, below->GetPosition() + corner, normal, 0.0f);
+
+                    if(warmStart)
+                        manifold.WarmStart(PreviousManifolds[stack * Height + i]);
+                }
+            }
+        }
+
+        // Largest speed left on any box once the step is solved
+        float ResidualSpeed() const
+        {
+            float speed = 0.0f;
+            for(BenchBody* body : Bodies)
+                speed = Maths::Max(speed, Maths::Length(body->GetLinearVelocity()));
+            return speed;
+        }
+    };
+
+    // Average solver time per step over StepCount steps, and the residual speed after the last one
+    double MeasureSolver(uint32_t height, uint32_t iterations, bool warmStart, float& residualSpeed)
+    {
+        StackScene scene(height);
+        const float dt = LumosPhysicsEngine::GetDeltaTime();
+        const Vec3 gravity(0.0f, -9.81f, 0.0f);
+
+        double total = 0.0;
+        for(uint32_t step = 0; step < StepCount; step++)
+        {
+            for(BenchBody* body : scene.Bodies)
+            {
+                if(!body->GetIsStatic())
+                    body->SetLinearVelocity(body->GetLinearVelocity() + gravity * dt);
+            }
+
+            scene.Collide(warmStart);
+            total += Benchmark::Measure(1, [&]()
+                                        {
+                                            for(Manifold& manifold : scene.Manifolds)
+                                                manifold.PreSolverStep();
+                                            for(Manifold& manifold : scene.Manifolds)
+                                                manifold.ApplyWarmStart();
+                                            for(uint32_t iteration = 0; iteration < iterations; iteration++)
+                                            {
+                                                for(Manifold& manifold : scene.Manifolds)
+                                                    manifold.ApplyImpulse();
+                                            } });
+        }
+
+        residualSpeed = scene.ResidualSpeed();
+        return total / StepCount;
+    }
+}
+
+// Contact solver time per step against stack height, for StackCount stacks. Starting every contact from zero
+// needs the engine's default 10 velocity iterations, and even then leaves the top of tall stacks moving. Warm
+// started contacts only correct last step's impulses, so fewer iterations reach a lower residual
+LUMOS_BENCHMARK(ContactSolverStacks)
+{
+    const uint32_t heights[] = { 5, 10, 20, 40 };
+    for(uint32_t height : heights)
+    {
+        float coldResidual = 0.0f, warmResidual = 0.0f, warmFewResidual = 0.0f;
+        const double coldTime    = MeasureSolver(height, 10, false, coldResidual);
+        const double warmTime    = MeasureSolver(height, 10, true, warmResidual);
+        const double warmFewTime = MeasureSolver(height, 4, true, warmFewResidual);
+
+        printf("%3u high: cold 10 iterations %7.3f ms (residual %.4f m/s), warm 10 iterations %7.3f ms (%.4f m/s), warm 4 iterations %7.3f ms (%.4f m/s)\n",
+               height, coldTime, coldResidual, warmTime, warmResidual, warmFewTime, warmFewResidual);
+    }
+}
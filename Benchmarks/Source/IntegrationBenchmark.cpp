@@ -0,0 +1,66 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Physics/LumosPhysicsEngine/LumosPhysicsEngine.h>
+#include <Lumos/Physics/LumosPhysicsEngine/RigidBody3D.h>
+#include <random>
+#include <vector>
+
+using namespace Lumos;
+
+namespace
+{
+    const uint32_t StepCount = 60;
+
+    // UpdateRigidBodys is the integration part of a physics step on its own
+    class IntegrationEngine : public LumosPhysicsEngine
+    {
+    public:
+        using LumosPhysicsEngine::UpdateRigidBodys;
+    };
+
+    // Best UpdateRigidBodys time for count bodies scattered with random velocities, awakeFraction of them awake
+    double MeasureIntegration(uint32_t count, IntegrationType type, float awakeFraction)
+    {
+        IntegrationEngine engine;
+        engine.SetIntegrationType(type);
+
+        std::mt19937 rng(count);
+        std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::vector<RigidBody3D*> bodies;
+        for(uint32_t i = 0; i < count; i++)
+        {
+            RigidBody3D* body = engine.CreateBody();
+            body->SetPosition(Vec3(value(rng), value(rng), value(rng)));
+            body->SetLinearVelocity(Vec3(value(rng), value(rng), value(rng)));
+            body->SetAngularVelocity(Vec3(value(rng), value(rng), value(rng)));
+            body->SetIsAtRest(unit(rng) >= awakeFraction);
+            bodies.push_back(body);
+        }
+
+        const double time = Benchmark::Measure(StepCount, [&]()
+                                               { engine.UpdateRigidBodys(); });
+
+        for(RigidBody3D* body : bodies)
+            engine.DestroyBody(body);
+
+        return time;
+    }
+}
+
+// Integration time per physics step, two position iterations, for 10k and 100k bodies with all of them or a tenth
+// of them awake, with the engine's default semi-implicit Euler and with RK4
+LUMOS_BENCHMARK(RigidBodyIntegrate)
+{
+    const uint32_t counts[] = { 10000, 100000 };
+    for(uint32_t count : counts)
+    {
+        const double semiImplicitTime      = MeasureIntegration(count, IntegrationType::SEMI_IMPLICIT_EULER, 1.0f);
+        const double semiImplicitTenthTime = MeasureIntegration(count, IntegrationType::SEMI_IMPLICIT_EULER, 0.1f);
+        const double rk4Time               = MeasureIntegration(count, IntegrationType::RUNGE_KUTTA_4, 1.0f);
+        const double rk4TenthTime          = MeasureIntegration(count, IntegrationType::RUNGE_KUTTA_4, 0.1f);
+        printf("%6u bodies: semi-implicit Euler %7.3f ms (10%% awake %7.3f ms), RK4 %7.3f ms (10%% awake %7.3f ms)\n", count,
+               semiImplicitTime, semiImplicitTenthTime, rk4Time, rk4TenthTime);
+    }
+}
@@ -0,0 +1,86 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Core/JobSystem.h>
+#include <atomic>
+#include <thread>
+
+using namespace Lumos;
+
+namespace
+{
+    const uint32_t DispatchCounts[] = { 1000, 100000, 1000000 };
+}
+
+// Jobs per second for single job Executes, which run out of task slots and queue space past a thousand or so jobs.
+// Submitted from the main thread and from inside a job
+LUMOS_BENCHMARK(JobDispatchThroughput)
+{
+    for(uint32_t count : DispatchCounts)
+    {
+        std::atomic<uint32_t> executed { 0 };
+        System::JobSystem::Context ctx;
+
+        const double mainTime = Benchmark::Measure(3, [&]()
+                                                   {
+                                                       for(uint32_t i = 0; i < count; i++)
+                                                           System::JobSystem::Execute(ctx, [&executed](JobDispatchArgs /*args*/)
+                                                                                      { executed.fetch_add(1, std::memory_order_relaxed); });
+                                                       System::JobSystem::Wait(ctx); });
+
+        const double nestedTime = Benchmark::Measure(3, [&]()
+                                                     {
+                                                         System::JobSystem::Context outer;
+                                                         System::JobSystem::Execute(outer, [&](JobDispatchArgs /*args*/)
+                                                                                    {
+                                                                                        for(uint32_t i = 0; i < count; i++)
+                                                                                            System::JobSystem::Execute(ctx, [&executed](JobDispatchArgs /*args*/)
+                                                                                                                       { executed.fetch_add(1, std::memory_order_relaxed); });
+                                                                                        System::JobSystem::Wait(ctx); });
+                                                         System::JobSystem::Wait(outer); });
+
+        Benchmark::DoNotOptimise(executed.load());
+        printf("%8u jobs: main thread %9.3f ms (%6.2f M jobs/s), from a job %9.3f ms (%6.2f M jobs/s)\n", count,
+               mainTime, count / mainTime / 1000.0, nestedTime, count / nestedTime / 1000.0);
+    }
+}
+
+// A dispatch past a full queue must not run its job ahead of work queued earlier. Every worker is held by a job
+// that waits for the dispatch loop to finish, the first queued job sets a flag and the rest spin on that flag.
+// Running an overflowing job on the submitter would spin forever
+LUMOS_BENCHMARK(JobDispatchOverflowOrder)
+{
+    const uint32_t workerCount = System::JobSystem::GetThreadCount();
+    const uint32_t count       = 10000;
+
+    std::atomic<bool> dispatched { false };
+    std::atomic<bool> produced { false };
+    std::atomic<uint32_t> blockedWorkers { 0 };
+    System::JobSystem::Context blockers;
+    System::JobSystem::Context ctx;
+
+    for(uint32_t i = 0; i < workerCount; i++)
+    {
+        System::JobSystem::Execute(blockers, [&](JobDispatchArgs /*args*/)
+                                   {
+                                       blockedWorkers.fetch_add(1);
+                                       while(!dispatched.load())
+                                           std::this_thread::yield(); });
+    }
+    while(blockedWorkers.load() < workerCount)
+        std::this_thread::yield();
+
+    const double time = Benchmark::Measure(1, [&]()
+                                           {
+                                               System::JobSystem::Execute(ctx, [&produced](JobDispatchArgs /*args*/)
+                                                                          { produced.store(true); });
+                                               for(uint32_t i = 1; i < count; i++)
+                                                   System::JobSystem::Execute(ctx, [&produced](JobDispatchArgs /*args*/)
+                                                                              {
+                                                                                  while(!produced.load())
+                                                                                      std::this_thread::yield(); });
+                                               dispatched.store(true);
+                                               System::JobSystem::Wait(ctx);
+                                               System::JobSystem::Wait(blockers); });
+
+    printf("%8u jobs queued behind %u blocked workers: finished in %.3f ms\n", count, workerCount, time);
+}
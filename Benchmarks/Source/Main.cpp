@@ -0,0 +1,57 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Core/Thread.h>
+#include <Lumos/Core/JobSystem.h>
+#include <cstring>
+
+namespace Lumos
+{
+    namespace Benchmark
+    {
+        struct Entry
+        {
+            const char* Name;
+            BenchmarkFunc Func;
+        };
+
+        // Registrations run during static initialisation, so the list must not depend on constructor order
+        static Entry s_Benchmarks[64];
+        static uint32_t s_BenchmarkCount = 0;
+
+        Registration::Registration(const char* name, BenchmarkFunc func)
+        {
+            if(s_BenchmarkCount < sizeof(s_Benchmarks) / sizeof(s_Benchmarks[0]))
+                s_Benchmarks[s_BenchmarkCount++] = { name, func };
+        }
+    }
+}
+
+// Runs every benchmark whose name contains one of the arguments, or all of them without arguments
+int main(int argc, char** argv)
+{
+    using namespace Lumos;
+
+    ThreadContext& mainThread = *GetThreadContext();
+    mainThread                = ThreadContextAlloc();
+    System::JobSystem::OnInit(1);
+
+    for(uint32_t i = 0; i < Benchmark::s_BenchmarkCount; i++)
+    {
+        const Benchmark::Entry& entry = Benchmark::s_Benchmarks[i];
+
+        bool selected = argc < 2;
+        for(int arg = 1; arg < argc && !selected; arg++)
+            selected = strstr(entry.Name, argv[arg]) != nullptr;
+
+        if(!selected)
+            continue;
+
+        printf("== %s\n", entry.Name);
+        entry.Func();
+        fflush(stdout);
+    }
+
+    System::JobSystem::Release();
+    ThreadContextRelease(GetThreadContext());
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Physics/LumosPhysicsEngine/RigidBody3D.h>
+#include <Lumos/Physics/LumosPhysicsEngine/Narrowphase/CollisionDetection.h>
+#include <Lumos/Physics/LumosPhysicsEngine/CollisionShapes/CuboidCollisionShape.h>
+#include <Lumos/Physics/LumosPhysicsEngine/CollisionShapes/CapsuleCollisionShape.h>
+#include <Lumos/Maths/MathsUtilities.h>
+#include <random>
+#include <vector>
+
+using namespace Lumos;
+
+namespace
+{
+    // RigidBody3D can only be constructed by the physics engine or a derived type, like PathNode
+    class BenchBody : public RigidBody3D
+    {
+    public:
+        BenchBody(const RigidBody3DProperties& properties)
+            : RigidBody3D(properties)
+        {
+        }
+    };
+
+    const uint32_t PairCount = 2000;
+    const uint32_t Repeats   = 5;
+
+    // PairCount pairs of randomly oriented shapes, the second a random direction away from the first with its
+    // centre between minDistance and maxDistance from the first's
+    struct PairScene
+    {
+        std::vector<BenchBody*> Bodies;
+        std::vector<Vec3> SearchAxes; // Per pair, kept between runs as the engine keeps them between steps
+
+        PairScene(const SharedPtr<CollisionShape>& shapeA, const SharedPtr<CollisionShape>& shapeB, float minDistance, float maxDistance)
+        {
+            std::mt19937 rng(PairCount);
+            std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> distance(minDistance, maxDistance);
+
+            for(uint32_t i = 0; i < PairCount; i++)
+            {
+                Vec3 direction(unit(rng), unit(rng), unit(rng));
+                while(Maths::Length2(direction) < 0.01f)
+                    direction = Vec3(unit(rng), unit(rng), unit(rng));
+
+                // Pairs sit far apart from each other, only the offset within a pair matters
+                const Vec3 origin((float)i * 10.0f, 0.0f, 0.0f);
+
+                RigidBody3DProperties properties;
+                properties.Shape       = shapeA;
+                properties.Position    = origin;
+                properties.Orientation = Quat(angle(rng), angle(rng), angle(rng));
+                Bodies.push_back(new BenchBody(properties));
+
+                properties.Shape       = shapeB;
+                properties.Position    = origin + direction.Normalised() * distance(rng);
+                properties.Orientation = Quat(angle(rng), angle(rng), angle(rng));
+                Bodies.push_back(new BenchBody(properties));
+            }
+
+            for(BenchBody* body : Bodies)
+                body->GetWorldSpaceTransform();
+
+            SearchAxes.resize(PairCount, Vec3(0.0f));
+        }
+
+        ~PairScene()
+        {
+            for(BenchBody* body : Bodies)
+                delete body;
+        }
+
+        uint32_t Collide(bool cacheAxes)
+        {
+            uint32_t collisions = 0;
+            for(uint32_t i = 0; i < PairCount; i++)
+            {
+                RigidBody3D* bodyA = Bodies[i * 2];
+                RigidBody3D* bodyB = Bodies[i * 2 + 1];
+
+                Vec3 uncachedAxis(0.0f);
+                CollisionData colData;
+                if(CollisionDetection::Get().CheckCollision(bodyA, bodyB, bodyA->GetCollisionShape().get(), bodyB->GetCollisionShape().get(), &colData,
+                                                            cacheAxes ? &SearchAxes[i] : &uncachedAxis))
+                    collisions++;
+            }
+            return collisions;
+        }
+    };
+
+    // Nanoseconds per pair of the best of Repeats passes over every pair, and how many of them collide
+    double MeasurePairs(PairScene& scene, bool gjk, bool cacheAxes, uint32_t& collisions)
+    {
+        CollisionDetection::Get().SetGJKEnabled(gjk);
+
+        // The untimed first pass is the previous step that filled the axis cache
+        collisions = scene.Collide(cacheAxes);
+
+        const double time = Benchmark::Measure(Repeats, [&]()
+                                               { Benchmark::DoNotOptimise(scene.Collide(cacheAxes)); });
+
+        CollisionDetection::Get().SetGJKEnabled(false);
+        return time * 1000000.0 / PairCount;
+    }
+
+    void ReportPairs(const char* name, const SharedPtr<CollisionShape>& shapeA, const SharedPtr<CollisionShape>& shapeB, float minDistance, float maxDistance)
+    {
+        PairScene scene(shapeA, shapeB, minDistance, maxDistance);
+
+        uint32_t satCollisions, gjkCollisions, cachedCollisions;
+        const double satTime    = MeasurePairs(scene, false, false, satCollisions);
+        const double gjkTime    = MeasurePairs(scene, true, false, gjkCollisions);
+        const double cachedTime = MeasurePairs(scene, true, true, cachedCollisions);
+
+        printf("%-28s SAT %7.1f ns (%4u hits), GJK/EPA %7.1f ns (%4u hits), GJK/EPA cached axis %7.1f ns (%4u hits)\n", name,
+               satTime, satCollisions, gjkTime, gjkCollisions, cachedTime, cachedCollisions);
+    }
+}
+
+// Cost per pair of the narrowphase test for randomly oriented pairs that passed the broadphase, with the default
+// separating axis test and with GJK/EPA, starting from the line between the centres or from the pair's cached axis
+LUMOS_BENCHMARK(NarrowphasePairs)
+{
+    SharedPtr<CollisionShape> box     = CreateSharedPtr<CuboidCollisionShape>(Vec3(0.5f));
+    SharedPtr<CollisionShape> capsule = CreateSharedPtr<CapsuleCollisionShape>(0.25f, 1.0f);
+
+    // The unit box reaches at most 0.87 from its centre and the capsule 0.75, so the separated pairs never touch
+    ReportPairs("box/box separated", box, box, 1.75f, 2.0f);
+    ReportPairs("box/box shallow", box, box, 1.0f, 1.2f);
+    ReportPairs("box/box deep", box, box, 0.2f, 0.6f);
+    ReportPairs("box/capsule separated", box, capsule, 1.65f, 1.9f);
+    ReportPairs("box/capsule shallow", box, capsule, 0.8f, 1.0f);
+    ReportPairs("box/capsule deep", box, capsule, 0.2f, 0.5f);
+}
@@ -0,0 +1,119 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Graphics/Renderers/RenderCommand.h>
+#include <Lumos/Maths/Transform.h>
+#include <Lumos/Maths/MathsUtilities.h>
+#include <random>
+#include <vector>
+
+using namespace Lumos;
+using namespace Lumos::Graphics;
+
+namespace
+{
+    // RenderCommand plus the material and pipeline state the sort reads, so no GPU objects are needed
+    struct SortBenchCommand : RenderCommand
+    {
+        bool depthTest;
+        uint32_t pipelineID;
+        uint32_t materialID;
+    };
+
+    std::vector<SortBenchCommand> MakeCommands(uint32_t count)
+    {
+        std::mt19937 rng(count);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_int_distribution<uint32_t> pipeline(1, 8);
+        std::uniform_int_distribution<uint32_t> material(1, 256);
+
+        std::vector<SortBenchCommand> commands(count);
+        for(SortBenchCommand& command : commands)
+        {
+            command.transform  = Mat4::Translation(Vec3(position(rng), position(rng), position(rng)));
+            command.depthTest  = (rng() % 10) != 0; // One in ten drawn without depth testing, e.g. transparent or overlay
+            command.pipelineID = pipeline(rng);
+            command.materialID = material(rng);
+        }
+        return commands;
+    }
+
+    // The previous path, kept here for comparison: BubbleSort with a comparator that recomputes camera distances
+    void BubbleSortCommands(TDArray<SortBenchCommand>& commands, Maths::Transform* camTransform)
+    {
+        Algorithms::BubbleSort(commands.begin(), commands.end(),
+                               [camTransform](SortBenchCommand& a, SortBenchCommand& b)
+                               {
+                                   if(a.depthTest && !b.depthTest)
+                                       return true;
+                                   if(!a.depthTest && b.depthTest)
+                                       return false;
+
+                                   return Maths::Distance(camTransform->GetWorldPosition(), a.transform.Translation()) < Maths::Distance(camTransform->GetWorldPosition(), b.transform.Translation());
+                               });
+    }
+
+    // Depth tested commands first, then the others ordered by distance from the camera
+    bool IsDrawOrderValid(const TDArray<SortBenchCommand>& commands, const Vec3& cameraPosition)
+    {
+        float lastDistance = -1.0f;
+        for(uint32_t i = 0; i < (uint32_t)commands.Size(); i++)
+        {
+            if(i > 0 && commands[i - 1].depthTest < commands[i].depthTest)
+                return false;
+
+            if(commands[i].depthTest)
+                continue;
+
+            const float distance = Maths::Distance2(cameraPosition, commands[i].transform.Translation());
+            if(distance < lastDistance)
+                return false;
+            lastDistance = distance;
+        }
+        return true;
+    }
+}
+
+// Render queue ordering at 1k, 10k and 100k commands: sort key plus radix sort against the previous BubbleSort.
+// BubbleSort is only run up to 10k commands, it takes minutes at 100k
+LUMOS_BENCHMARK(RenderQueueSort)
+{
+    Maths::Transform camera;
+    camera.SetLocalPosition(Vec3(10.0f, 5.0f, -20.0f));
+    camera.SetWorldMatrix(Mat4(1.0f));
+    const Vec3 cameraPosition = camera.GetWorldPosition();
+
+    const uint32_t counts[] = { 1000, 10000, 100000 };
+    for(uint32_t count : counts)
+    {
+        const std::vector<SortBenchCommand> source = MakeCommands(count);
+        TDArray<SortBenchCommand> commands;
+        TDArray<uint64_t> keys;
+        TDArray<uint32_t> indices;
+
+        auto restore = [&]()
+        {
+            commands.Clear();
+            for(const SortBenchCommand& command : source)
+                commands.PushBack(command);
+        };
+
+        const uint32_t repeats = count >= 100000 ? 5 : 20;
+        const double radixTime = Benchmark::Measure(repeats, restore, [&]()
+                                                    {
+                                                        for(SortBenchCommand& command : commands)
+                                                            command.sortKey = MakeRenderSortKey(command.depthTest, command.pipelineID, command.materialID,
+                                                                                                Maths::Distance2(cameraPosition, command.transform.Translation()));
+                                                        SortRenderCommands(commands, keys, indices); });
+        const bool radixValid = IsDrawOrderValid(commands, cameraPosition);
+
+        if(count > 10000)
+        {
+            printf("%6u commands: key + radix %8.3f ms (order %s), bubble sort skipped\n", count, radixTime, radixValid ? "ok" : "WRONG");
+            continue;
+        }
+
+        const double bubbleTime = Benchmark::Measure(count >= 10000 ? 1 : 3, restore, [&]()
+                                                     { BubbleSortCommands(commands, &camera); });
+        printf("%6u commands: key + radix %8.3f ms (order %s), bubble sort %10.3f ms, %.0fx\n", count, radixTime, radixValid ? "ok" : "WRONG", bubbleTime, bubbleTime / radixTime);
+    }
+}
@@ -0,0 +1,95 @@
+#include "Precompiled.h"
+#include "Benchmark.h"
+#include <Lumos/Scene/SceneGraph.h>
+#include <Lumos/Maths/Transform.h>
+#include <entt/entity/registry.hpp>
+#include <random>
+#include <vector>
+
+using namespace Lumos;
+
+namespace
+{
+    const uint32_t FrameCount = 60;
+
+    // Half of the entities stand alone, the other half sit in hierarchies of a root and childrenPerRoot children.
+    // movingFraction of the entities get a new local position every frame
+    struct SceneGraphScene
+    {
+        entt::registry Registry;
+        SceneGraph Graph;
+        std::vector<entt::entity> Entities;
+
+        SceneGraphScene(uint32_t count, uint32_t childrenPerRoot)
+        {
+            Graph.Init(Registry);
+
+            std::mt19937 rng(count);
+            std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+            const uint32_t standaloneCount = count / 2;
+            for(uint32_t i = 0; i < standaloneCount; i++)
+            {
+                const entt::entity entity = Registry.create();
+                Registry.emplace<Maths::Transform>(entity, Vec3(position(rng), position(rng), position(rng)));
+                Entities.push_back(entity);
+            }
+
+            entt::entity root = entt::null;
+            for(uint32_t i = standaloneCount; i < count; i++)
+            {
+                const entt::entity entity = Registry.create();
+                Registry.emplace<Maths::Transform>(entity, Vec3(position(rng), position(rng), position(rng)));
+                Entities.push_back(entity);
+
+                if((i - standaloneCount) % (childrenPerRoot + 1) == 0)
+                {
+                    Registry.emplace<Hierarchy>(entity);
+                    root = entity;
+                }
+                else
+                    Registry.emplace<Hierarchy>(entity, root);
+            }
+
+            Graph.Update(Registry);
+        }
+    };
+
+    // Average SceneGraph::Update time per frame with movingFraction of the entities moved before each one
+    double MeasureSceneGraph(uint32_t count, float movingFraction)
+    {
+        SceneGraphScene scene(count, 99);
+        std::mt19937 rng(count);
+        std::uniform_int_distribution<uint32_t> pick(0, count - 1);
+        const uint32_t movingCount = (uint32_t)(count * movingFraction);
+
+        double total = 0.0;
+        for(uint32_t frame = 0; frame < FrameCount; frame++)
+        {
+            for(uint32_t i = 0; i < movingCount; i++)
+            {
+                Maths::Transform& transform = scene.Registry.get<Maths::Transform>(scene.Entities[pick(rng)]);
+                transform.SetLocalPosition(transform.GetLocalPosition() + Vec3(0.01f));
+            }
+
+            total += Benchmark::Measure(1, [&]()
+                                        { scene.Graph.Update(scene.Registry); });
+        }
+
+        return total / FrameCount;
+    }
+}
+
+// SceneGraph::Update per frame for scenes of mostly static entities, half standalone and half in hierarchies of
+// 100, with none, 1% or all of them moving each frame
+LUMOS_BENCHMARK(SceneGraphUpdate)
+{
+    const uint32_t counts[] = { 10000, 100000 };
+    for(uint32_t count : counts)
+    {
+        const double staticTime = MeasureSceneGraph(count, 0.0f);
+        const double fewTime    = MeasureSceneGraph(count, 0.01f);
+        const double allTime    = MeasureSceneGraph(count, 1.0f);
+        printf("%6u entities: static %8.3f ms, 1%% moving %8.3f ms, all moving %8.3f ms\n", count, staticTime, fewTime, allTime);
+    }
+}
@@ -0,0 +1,167 @@
+project "Benchmarks"
+	kind "ConsoleApp"
+	language "C++"
+	editandcontinue "Off"
+
+	files
+	{
+		"Source/**.h",
+		"Source/**.cpp"
+	}
+
+	includedirs
+	{
+		"Source",
+		"../Lumos/Source/Lumos",
+	}
+
+	externalincludedirs
+	{
+		"%{IncludeDir.entt}",
+		"%{IncludeDir.GLFW}",
+		"%{IncludeDir.lua}",
+		"%{IncludeDir.stb}",
+		"%{IncludeDir.ImGui}",
+		"%{IncludeDir.OpenAL}",
+		"%{IncludeDir.Box2D}",
+		"%{IncludeDir.vulkan}",
+		"%{IncludeDir.External}",
+		"%{IncludeDir.freetype}",
+		"%{IncludeDir.SpirvCross}",
+		"%{IncludeDir.cereal}",
+		"%{IncludeDir.glm}",
+		"%{IncludeDir.msdfgen}",
+		"%{IncludeDir.msdf_atlas_gen}",
+		"%{IncludeDir.ozz}",
+		"%{IncludeDir.Lumos}",
+	}
+
+	links
+	{
+		"Lumos",
+		"lua",
+		"box2d",
+		"imgui",
+		"freetype",
+		"SpirvCross",
+		"meshoptimizer",
+		"msdf-atlas-gen",
+		"ozz_animation",
+		"ozz_animation_offline",
+		"ozz_base"
+	}
+
+	filter 'architecture:x86_64'
+		defines { "USE_VMA_ALLOCATOR", "LUMOS_SSE" }
+
+	filter "system:windows"
+		cppdialect "C++17"
+		staticruntime "Off"
+		systemversion "latest"
+		conformancemode "on"
+
+		defines
+		{
+			"LUMOS_PLATFORM_WINDOWS",
+			"LUMOS_RENDER_API_VULKAN",
+			"VK_USE_PLATFORM_WIN32_KHR",
+			"WIN32_LEAN_AND_MEAN",
+			"_CRT_SECURE_NO_WARNINGS",
+			"_DISABLE_EXTENDED_ALIGNED_STORAGE",
+			"_SILENCE_CXX17_ITERATOR_BASE_CLASS_DEPRECATION_WARNING",
+			"LUMOS_VOLK"
+		}
+
+		libdirs
+		{
+			"../Lumos/External/OpenAL/libs/Win32"
+		}
+
+		links
+		{
+			"glfw",
+			"OpenAL32"
+		}
+
+		disablewarnings { 4307 }
+
+	filter "system:macosx"
+		cppdialect "C++17"
+		staticruntime "Off"
+		systemversion "11.0"
+
+		defines
+		{
+			"LUMOS_PLATFORM_MACOS",
+			"LUMOS_PLATFORM_UNIX",
+			"LUMOS_RENDER_API_VULKAN",
+			"VK_EXT_metal_surface",
+			"LUMOS_IMGUI",
+			"LUMOS_VOLK"
+		}
+
+		linkoptions
+		{
+			"-framework Cocoa",
+			"-framework IOKit",
+			"-framework CoreVideo",
+			"-framework OpenAL",
+			"-framework QuartzCore"
+		}
+
+		links
+		{
+			"glfw",
+		}
+
+	filter "system:linux"
+		cppdialect "C++17"
+		staticruntime "Off"
+		systemversion "latest"
+
+		defines
+		{
+			"LUMOS_PLATFORM_LINUX",
+			"LUMOS_PLATFORM_UNIX",
+			"LUMOS_RENDER_API_VULKAN",
+			"VK_USE_PLATFORM_XCB_KHR",
+			"LUMOS_IMGUI",
+			"LUMOS_VOLK"
+		}
+
+		buildoptions
+		{
+			"-fpermissive",
+			"-Wattributes",
+			"-fPIC",
+			"-Wignored-attributes",
+			"-Wno-psabi"
+		}
+
+		links { "X11", "pthread", "dl", "atomic", "openal", "glfw"}
+
+		linkoptions { "-L%{cfg.targetdir}", "-Wl,-rpath=\\$$ORIGIN"}
+
+		filter {'system:linux', 'architecture:x86_64'}
+			buildoptions
+			{
+				"-msse4.1",
+			}
+
+	filter "configurations:Debug"
+		defines { "LUMOS_DEBUG", "_DEBUG" }
+		symbols "On"
+		runtime "Debug"
+		optimize "Off"
+
+	filter "configurations:Release"
+		defines { "LUMOS_RELEASE", "NDEBUG" }
+		optimize "Speed"
+		symbols "On"
+		runtime "Release"
+
+	filter "configurations:Production"
+		defines { "LUMOS_PRODUCTION", "NDEBUG" }
+		symbols "Off"
+		optimize "Full"
+		runtime "Release"
@@ -173,16 +173,23 @@ namespace Lumos
                 ImGui::Text("Bound SceneRenderer %u", Engine::Get().Statistics().BoundSceneRenderer);
                 if(ImGui::TreeNodeEx("Arenas", 0))
                 {
-                    uint64_t totalAllocated = 0;
+                    uint64_t totalCommitted = 0;
+                    uint64_t totalReserved  = 0;
                     for(int i = 0; i < GetArenaCount(); i++)
                     {
-                        auto arena = GetArena(i);
-                        totalAllocated += arena->Size;
-                        float percentageFull = (float)arena->Position / (float)arena->Size;
+                        ArenaStats stats = ArenaGetStats(GetArena(i));
+                        totalCommitted += stats.Committed;
+                        totalReserved += stats.Reserved;
+                        float percentageFull = (float)stats.Used / (float)stats.Committed;
                         ImGui::ProgressBar(percentageFull);
-                        Lumos::ImGuiUtilities::Tooltip((Lumos::StringUtilities::BytesToString(arena->Position) + " / " + Lumos::StringUtilities::BytesToString(arena->Size)).c_str());
+                        Lumos::ImGuiUtilities::Tooltip((Lumos::StringUtilities::BytesToString(stats.Used) + " / " + Lumos::StringUtilities::BytesToString(stats.Committed)
+                                                        + "\nHigh Water Mark : " + Lumos::StringUtilities::BytesToString(stats.HighWaterMark)
+                                                        + "\nReserved : " + Lumos::StringUtilities::BytesToString(stats.Reserved)
+                                                        + "\nBlocks : " + std::to_string(stats.BlockCount))
+                                                           .c_str());
                     }
-                    ImGui::Text("Total %s", Lumos::StringUtilities::BytesToString(totalAllocated).c_str());
+                    ImGui::Text("Committed %s", Lumos::StringUtilities::BytesToString(totalCommitted).c_str());
+                    ImGui::Text("Reserved %s", Lumos::StringUtilities::BytesToString(totalReserved).c_str());
                     ImGui::TreePop();
                 }
 
@@ -848,7 +848,7 @@ namespace Lumos
                         textureCreated              = true;
                         std::string assetPathString = std::string((const char*)CurrentEnty->AssetPath.str, CurrentEnty->AssetPath.size);
                         if(!m_Editor->GetAssetManager()->AssetExists(assetPathString))
-                            CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->LoadTextureAsset(assetPathString, true);
+                            CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->LoadTextureAsset(assetPathString, true, AssetStreamPriority::Visible);
                         else
                             CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->GetAssetData(assetPathString).As<Graphics::Texture2D>();
                         textureId = CurrentEnty->Thumbnail ? CurrentEnty->Thumbnail : m_FileIcon;
@@ -867,7 +867,7 @@ namespace Lumos
                         String8 sceneScreenShotAssetPath = PushStr8F(scratch.arena, "%s/Scenes/Cache/%s.png", (const char*)Str8Lit("//Assets").str, (const char*)fileName.str);
 
                         if(!m_Editor->GetAssetManager()->AssetExists(std::string((const char*)sceneScreenShotAssetPath.str, sceneScreenShotAssetPath.size)))
-                            CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->LoadTextureAsset(std::string((const char*)sceneScreenShotAssetPath.str, sceneScreenShotAssetPath.size), true);
+                            CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->LoadTextureAsset(std::string((const char*)sceneScreenShotAssetPath.str, sceneScreenShotAssetPath.size), true, AssetStreamPriority::Visible);
                         else
                             CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->GetAssetData(std::string((const char*)sceneScreenShotAssetPath.str, sceneScreenShotAssetPath.size)).As<Graphics::Texture2D>();
                         textureId = CurrentEnty->Thumbnail ? CurrentEnty->Thumbnail : m_FileIcon;
@@ -898,7 +898,7 @@ namespace Lumos
 
                             textureCreated = true;
                             if(!m_Editor->GetAssetManager()->AssetExists(thumbnailpathStdString))
-                                CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->LoadTextureAsset(thumbnailAssetPathStdString, true);
+                                CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->LoadTextureAsset(thumbnailAssetPathStdString, true, AssetStreamPriority::Visible);
                             else
                                 CurrentEnty->Thumbnail = m_Editor->GetAssetManager()->GetAssetData(thumbnailAssetPathStdString).As<Graphics::Texture2D>();
                             textureId = CurrentEnty->Thumbnail ? CurrentEnty->Thumbnail : m_FileIcon;
@@ -7,133 +7,181 @@ namespace Lumos
 
     AStar::AStar(const TDArray<PathNode*>& nodes)
     {
-        HashMapInit(&m_NodeData);
+        HashMapInit(&m_NodeIndices);
 
-        // Create node data
-        for(auto it = nodes.begin(); it != nodes.end(); ++it)
+        const uint32_t nodeCount = (uint32_t)nodes.Size();
+        m_Nodes.Resize(nodeCount);
+        for(uint32_t i = 0; i < nodeCount; i++)
         {
-            QueueablePathNode* pathNode = new QueueablePathNode(*it);
-            HashMapInsert(&m_NodeData, *it, pathNode);
+            PathNode* node = nodes[i];
+            m_Nodes[i]     = node;
+            HashMapInsert(&m_NodeIndices, node, i);
         }
+
+        // Flatten the connections. Edges to nodes outside of this graph are dropped
+        m_EdgeOffsets.Resize(nodeCount + 1);
+        for(uint32_t i = 0; i < nodeCount; i++)
+        {
+            PathNode* node   = m_Nodes[i];
+            m_EdgeOffsets[i] = (uint32_t)m_Edges.Size();
+
+            for(size_t edgeIndex = 0; edgeIndex < node->NumConnections(); edgeIndex++)
+            {
+                PathEdge* edge        = node->Edge(edgeIndex);
+                const uint32_t target = GetNodeIndex(edge->OtherNode(node));
+                if(target == InvalidNode)
+                    continue;
+
+                m_EdgeTargets.PushBack(target);
+                m_Edges.PushBack(edge);
+            }
+        }
+        m_EdgeOffsets[nodeCount] = (uint32_t)m_Edges.Size();
+
+        m_State.Init(nodeCount);
+        m_Path.Reserve(nodeCount);
     }
 
     AStar::~AStar()
     {
+        HashMapDeinit(&m_NodeIndices);
+    }
 
-        ForHashMapEach(PathNode*, QueueablePathNode*, &m_NodeData, it)
+    uint32_t AStar::GetNodeIndex(PathNode* node) const
+    {
+        uint32_t index = InvalidNode;
+        HashMapFind(&m_NodeIndices, node, &index);
+        return index;
+    }
+
+    void AStar::SearchState::Init(uint32_t nodeCount)
+    {
+        m_Nodes.Resize(nodeCount);
+        for(SearchNode& searchNode : m_Nodes)
+            searchNode.Generation = 0;
+
+        m_OpenList.Init(nodeCount);
+        m_Generation  = 0;
+        m_ClosedCount = 0;
+    }
+
+    void AStar::SearchState::BeginSearch()
+    {
+        m_OpenList.Clear();
+        m_ClosedCount = 0;
+
+        // Invalidate node data from the previous search. Generation 0 is never used for a search,
+        // so only a wrap around needs to touch every node
+        m_Generation++;
+        if(m_Generation == 0)
         {
-            QueueablePathNode* value = *it.value;
-            delete value;
+            for(SearchNode& searchNode : m_Nodes)
+                searchNode.Generation = 0;
+            m_Generation = 1;
         }
     }
 
     void AStar::Reset()
     {
         // Clear caches
-        m_OpenList = PathNodePriorityQueue();
-        m_ClosedList.Clear();
         m_Path.Clear();
-
-        // Reset node data
-        ForHashMapEach(PathNode*, QueueablePathNode*, &m_NodeData, it)
-        {
-            QueueablePathNode* value = *it.value;
-            value->Parent            = nullptr;
-            value->fScore            = std::numeric_limits<float>::max();
-            value->gScore            = std::numeric_limits<float>::max();
-        }
+        m_PathCost = 0.0f;
+        m_State.BeginSearch();
     }
 
     bool AStar::FindPath(PathNode* start, PathNode* end)
+    {
+        return FindPath(GetNodeIndex(start), GetNodeIndex(end));
+    }
+
+    bool AStar::FindPath(uint32_t start, uint32_t end)
     {
         // Clear caches
-        Reset();
+        m_Path.Clear();
+        m_PathCost = 0.0f;
 
-        QueueablePathNode* startNode = nullptr;
-        if(HashMapFind(&m_NodeData, start, &startNode))
-        {
-            // Add start node to open list
-            startNode->gScore = 0.0f;
-            startNode->fScore = startNode->node->HeuristicValue(*end);
-            m_OpenList.Push(startNode);
-        }
+        return FindPath(start, end, m_State, m_Path, m_PathCost);
+    }
+
+    bool AStar::FindPath(uint32_t start, uint32_t end, SearchState& state, TDArray<PathNode*>& outPath, float& outCost) const
+    {
+        LUMOS_PROFILE_FUNCTION();
+        ASSERT(state.m_Nodes.Size() == m_Nodes.Size(), "Search state was initialised for a different graph");
+
+        state.BeginSearch();
+
+        const uint32_t nodeCount = (uint32_t)m_Nodes.Size();
+        if(start >= nodeCount || end >= nodeCount)
+            return false;
+
+        TDArray<SearchState::SearchNode>& searchNodes = state.m_Nodes;
+        PathNodePriorityQueue& openList               = state.m_OpenList;
+        const uint32_t generation                     = state.m_Generation;
+
+        PathNode* endNode = m_Nodes[end];
+
+        // Add start node to open list
+        SearchState::SearchNode& startNode = searchNodes[start];
+        startNode.gScore                   = 0.0f;
+        startNode.Parent                   = InvalidNode;
+        startNode.Generation               = generation;
+        startNode.Closed                   = false;
+        openList.Push(start, m_Nodes[start]->HeuristicValue(*endNode));
 
         bool success = false;
-        while(!m_OpenList.empty())
+        while(!openList.Empty())
         {
-            QueueablePathNode* p = m_OpenList.Top();
-
-            // Move this node to the closed list
-            m_OpenList.Pop();
-            m_ClosedList.PushBack(p);
+            // Move the best node to the closed list
+            const uint32_t p                 = openList.Pop();
+            SearchState::SearchNode& current = searchNodes[p];
+            current.Closed                   = true;
+            state.m_ClosedCount++;
 
             // Check if this is the end node
-            if(p->node == end)
+            if(p == end)
             {
                 success = true;
                 break;
             }
 
             // For each node connected to the next node
-            for(size_t i = 0; i < p->node->NumConnections(); i++)
+            for(uint32_t edgeIndex = m_EdgeOffsets[p]; edgeIndex < m_EdgeOffsets[p + 1]; edgeIndex++)
             {
-                PathEdge* pq = p->node->Edge(i);
+                PathEdge* pq = m_Edges[edgeIndex];
 
                 // Skip an edge that cannot be traversed
                 if(!pq->Traversable())
                     continue;
 
-                QueueablePathNode* q         = nullptr;
-                QueueablePathNode* otherNode = nullptr;
-                auto otherNodePtr            = pq->OtherNode(p->node);
-                HashMapFind(&m_NodeData, otherNodePtr, &q);
+                const uint32_t q                   = m_EdgeTargets[edgeIndex];
+                SearchState::SearchNode& neighbour = searchNodes[q];
+                const bool visited                 = neighbour.Generation == generation;
+                const float gScore                 = current.gScore + pq->Cost();
 
-                // Calculate new scores
-                float gScore = p->gScore + pq->Cost();
-                float fScore = gScore + q->node->HeuristicValue(*end);
-
-                // Search for this node on open and closed lists
-                //  auto closedIt = std::find(m_ClosedList.begin(), m_ClosedList.end(), q);
-                //  auto openIt   = m_OpenList.Find(q);
-
-                QueueablePathNode* closedNode = nullptr;
-                for(auto node : m_ClosedList)
+                if(!visited)
                 {
-                    if(node == q)
-                    {
-                        closedNode = q;
-                        break;
-                    }
+                    // Add this path to the open list if it has yet to be considered
+                    neighbour.gScore     = gScore;
+                    neighbour.Parent     = p;
+                    neighbour.Generation = generation;
+                    neighbour.Closed     = false;
+                    openList.Push(q, gScore + m_Nodes[q]->HeuristicValue(*endNode));
                 }
-
-                QueueablePathNode* openNode = nullptr;
-                for(auto node : m_OpenList)
+                else if(gScore < neighbour.gScore)
                 {
-                    if(node == q)
-                    {
-                        openNode = q;
-                        break;
-                    }
-                }
+                    // This path is more efficient than the previous best
+                    const float fScore = gScore + m_Nodes[q]->HeuristicValue(*endNode);
+                    neighbour.gScore   = gScore;
+                    neighbour.Parent   = p;
 
-                if(closedNode || openNode)
-                {
-                    // Check if this path is more efficient that the previous best
-                    if(q->gScore > gScore)
+                    // An inconsistent heuristic can improve a closed node, so it is opened again
+                    if(neighbour.Closed)
                     {
-                        q->Parent = p;
-                        q->gScore = gScore;
-                        q->fScore = fScore;
-                        m_OpenList.Update();
+                        neighbour.Closed = false;
+                        openList.Push(q, fScore);
                     }
-                }
-                else
-                {
-                    // Add this path to the open list if it has yet to be considered
-                    q->Parent = p;
-                    q->gScore = gScore;
-                    q->fScore = fScore;
-                    m_OpenList.Push(q);
+                    else
+                        openList.DecreaseKey(q, fScore);
                 }
             }
         }
@@ -141,18 +189,18 @@ namespace Lumos
         // If successful then reconstruct the best path
         if(success)
         {
+            outCost = searchNodes[end].gScore;
+
             // Add nodes to path
-            QueueablePathNode* n = m_ClosedList.Back();
-            while(n)
-            {
-                m_Path.PushBack(n->node);
-                n = n->Parent;
-            }
+            const u32 pathStart = (u32)outPath.Size();
+            for(uint32_t n = end; n != InvalidNode; n = searchNodes[n].Parent)
+                outPath.PushBack(m_Nodes[n]);
 
             // Reverse path to be ordered start to end
-            for(u32 i = 0; i < (u32)m_Path.Size() / 2; i++)
+            const u32 pathLength = (u32)outPath.Size() - pathStart;
+            for(u32 i = 0; i < pathLength / 2; i++)
             {
-                Swap(m_Path[i], m_Path[m_Path.Size() - i - 1]);
+                Swap(outPath[pathStart + i], outPath[pathStart + pathLength - i - 1]);
             }
         }
 
@@ -2,28 +2,95 @@
 
 #include "PathNode.h"
 #include "PathNodePriorityQueue.h"
-#include "QueueablePathNode.h"
 #include "Core/DataStructures/Map.h"
 
 namespace Lumos
 {
+    class PathEdge;
+
+    // Nodes are indexed once on construction and the graph is flattened into adjacency arrays. Per-node search
+    // state is tagged with a search generation, so starting a search does not touch every node, and no memory
+    // is allocated per search. Edge traversability and weights are read live from the PathEdges.
     class AStar
     {
     public:
+        static const uint32_t InvalidNode = ~0u;
+
+        // Scratch memory for one search at a time. The graph itself is only read while searching, so any
+        // number of threads can search it concurrently with their own SearchState
+        class SearchState
+        {
+        public:
+            void Init(uint32_t nodeCount);
+
+        private:
+            friend class AStar;
+            friend class HierarchicalAStar;
+
+            struct SearchNode
+            {
+                float gScore;
+                uint32_t Parent;
+                uint32_t Generation; // Search the scores belong to, older values are treated as unvisited
+                bool Closed;
+            };
+
+            void BeginSearch();
+
+            TDArray<SearchNode> m_Nodes;
+            PathNodePriorityQueue m_OpenList;
+            uint32_t m_Generation  = 0;
+            uint32_t m_ClosedCount = 0;
+        };
+
         explicit AStar(const TDArray<PathNode*>& nodes);
         virtual ~AStar();
 
         void Reset();
         bool FindPath(PathNode* start, PathNode* end);
+        bool FindPath(uint32_t start, uint32_t end);
+
+        // Thread safe as long as the graph is not modified during the search. The path is appended to outPath
+        bool FindPath(uint32_t start, uint32_t end, SearchState& state, TDArray<PathNode*>& outPath, float& outCost) const;
+
+        // Index of a node passed to the constructor, InvalidNode if it is not part of this graph
+        uint32_t GetNodeIndex(PathNode* node) const;
+
+        uint32_t GetNodeCount() const
+        {
+            return (uint32_t)m_Nodes.Size();
+        }
 
-        PathNodePriorityQueue OpenList() const
+        PathNode* GetNode(uint32_t index) const
         {
-            return m_OpenList;
+            return m_Nodes[index];
         }
 
-        const TDArray<QueueablePathNode*>& ClosedList() const
+        // Edges of a node are [GetEdgeBegin(node), GetEdgeEnd(node)), and lead to GetEdgeTarget(edge)
+        uint32_t GetEdgeBegin(uint32_t node) const
         {
-            return m_ClosedList;
+            return m_EdgeOffsets[node];
+        }
+
+        uint32_t GetEdgeEnd(uint32_t node) const
+        {
+            return m_EdgeOffsets[node + 1];
+        }
+
+        uint32_t GetEdgeTarget(uint32_t edge) const
+        {
+            return m_EdgeTargets[edge];
+        }
+
+        PathEdge* GetEdge(uint32_t edge) const
+        {
+            return m_Edges[edge];
+        }
+
+        // Nodes expanded by the last search
+        uint32_t ClosedCount() const
+        {
+            return m_State.m_ClosedCount;
         }
 
         const TDArray<PathNode*>& Path() const
@@ -33,13 +100,18 @@ namespace Lumos
 
         float PathCost() const
         {
-            return m_ClosedList.Back()->gScore;
+            return m_PathCost;
         }
 
     private:
-        HashMap(PathNode*, QueueablePathNode*) m_NodeData;
-        PathNodePriorityQueue m_OpenList;
-        TDArray<QueueablePathNode*> m_ClosedList;
+        TDArray<PathNode*> m_Nodes;
+        TDArray<uint32_t> m_EdgeOffsets; // Edges of node i are [m_EdgeOffsets[i], m_EdgeOffsets[i + 1])
+        TDArray<uint32_t> m_EdgeTargets;
+        TDArray<PathEdge*> m_Edges;
+        HashMap(PathNode*, uint32_t) m_NodeIndices;
+
+        SearchState m_State;
         TDArray<PathNode*> m_Path;
+        float m_PathCost = 0.0f;
     };
 }
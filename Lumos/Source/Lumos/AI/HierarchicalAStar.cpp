@@ -0,0 +1,654 @@
+#include "Precompiled.h"
+#include "HierarchicalAStar.h"
+#include "PathEdge.h"
+#include "Maths/MathsUtilities.h"
+
+namespace Lumos
+{
+    namespace
+    {
+        // Runs of this many crossings or more get an entrance at each end instead of one in the middle
+        const uint32_t LongEntranceLength = 6;
+
+        uint64_t ClusterCellKey(const Vec3& position, float invClusterSize)
+        {
+            const uint64_t x = (uint64_t)(int64_t)Maths::Floor(position.x * invClusterSize) & 0x1FFFFF;
+            const uint64_t y = (uint64_t)(int64_t)Maths::Floor(position.y * invClusterSize) & 0x1FFFFF;
+            const uint64_t z = (uint64_t)(int64_t)Maths::Floor(position.z * invClusterSize) & 0x1FFFFF;
+            return (x << 42) | (y << 21) | z;
+        }
+    }
+
+    HierarchicalAStar::HierarchicalAStar(const TDArray<PathNode*>& nodes, float clusterSize)
+        : m_Graph(nodes)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        ASSERT(clusterSize > 0.0f);
+
+        const uint32_t nodeCount = m_Graph.GetNodeCount();
+        m_NodeClusters.Resize(nodeCount);
+        m_EntranceSlots.Resize(nodeCount, AStar::InvalidNode);
+        m_LocalState.Init(nodeCount);
+        m_AbstractState.Init(nodeCount);
+
+        // Group the nodes by grid cell
+        HashMap(uint64_t, uint32_t) cells;
+        HashMapInit(&cells);
+
+        const float invClusterSize = 1.0f / clusterSize;
+        for(uint32_t i = 0; i < nodeCount; i++)
+        {
+            const uint64_t key = ClusterCellKey(m_Graph.GetNode(i)->GetPosition(), invClusterSize);
+
+            uint32_t clusterIndex;
+            if(!HashMapFind(&cells, key, &clusterIndex))
+            {
+                clusterIndex = (uint32_t)m_Clusters.Size();
+                m_Clusters.EmplaceBack();
+                HashMapInsert(&cells, key, clusterIndex);
+            }
+
+            m_NodeClusters[i] = clusterIndex;
+            m_Clusters[clusterIndex].Nodes.PushBack(i);
+        }
+
+        HashMapDeinit(&cells);
+
+        // Collect the edges between each pair of clusters. Every edge is stored in both directions, so only
+        // the one leaving the lower cluster is kept
+        HashMap(uint64_t, uint32_t) borders;
+        HashMapInit(&borders);
+
+        for(uint32_t i = 0; i < nodeCount; i++)
+        {
+            const uint32_t clusterA = m_NodeClusters[i];
+            for(uint32_t edge = m_Graph.GetEdgeBegin(i); edge < m_Graph.GetEdgeEnd(i); edge++)
+            {
+                const uint32_t clusterB = m_NodeClusters[m_Graph.GetEdgeTarget(edge)];
+                if(clusterA >= clusterB)
+                    continue;
+
+                const uint64_t key = ((uint64_t)clusterA << 32) | clusterB;
+
+                uint32_t borderIndex;
+                if(!HashMapFind(&borders, key, &borderIndex))
+                {
+                    borderIndex     = (uint32_t)m_Borders.Size();
+                    Border& border  = m_Borders.EmplaceBack();
+                    border.ClusterA = clusterA;
+                    border.ClusterB = clusterB;
+                    HashMapInsert(&borders, key, borderIndex);
+
+                    m_Clusters[clusterA].Borders.PushBack(borderIndex);
+                    m_Clusters[clusterB].Borders.PushBack(borderIndex);
+                }
+
+                m_Borders[borderIndex].Sources.PushBack(i);
+                m_Borders[borderIndex].Edges.PushBack(edge);
+            }
+        }
+
+        HashMapDeinit(&borders);
+
+        RebuildDirtyClusters();
+    }
+
+    void HierarchicalAStar::OnEdgeChanged(PathEdge* edge)
+    {
+        const uint32_t a = m_Graph.GetNodeIndex(edge->NodeA());
+        const uint32_t b = m_Graph.GetNodeIndex(edge->NodeB());
+        if(a == AStar::InvalidNode || b == AStar::InvalidNode)
+            return;
+
+        m_Clusters[m_NodeClusters[a]].Dirty = true;
+        m_Clusters[m_NodeClusters[b]].Dirty = true;
+        m_AnyDirty                          = true;
+    }
+
+    void HierarchicalAStar::RebuildDirtyClusters()
+    {
+        if(!m_AnyDirty)
+            return;
+
+        LUMOS_PROFILE_FUNCTION();
+
+        // Borders of a dirty cluster pick their entrances again
+        for(Border& border : m_Borders)
+        {
+            if(m_Clusters[border.ClusterA].Dirty || m_Clusters[border.ClusterB].Dirty)
+                BuildBorderEntrances(border);
+        }
+
+        // That can move the entrances of the clusters next to it, whose cached paths are then stale as well
+        TDArray<uint32_t> rebuild;
+        for(uint32_t clusterIndex = 0; clusterIndex < (uint32_t)m_Clusters.Size(); clusterIndex++)
+        {
+            const Cluster& cluster = m_Clusters[clusterIndex];
+
+            bool affected = cluster.Dirty;
+            for(uint32_t borderIndex : cluster.Borders)
+            {
+                const Border& border = m_Borders[borderIndex];
+                affected |= m_Clusters[border.ClusterA].Dirty || m_Clusters[border.ClusterB].Dirty;
+            }
+
+            if(!affected)
+                continue;
+
+            const bool entrancesChanged = BuildClusterEntrances(clusterIndex);
+            if(cluster.Dirty || entrancesChanged)
+                rebuild.PushBack(clusterIndex);
+        }
+
+        for(uint32_t clusterIndex : rebuild)
+            BuildClusterPaths(clusterIndex);
+
+        for(Cluster& cluster : m_Clusters)
+            cluster.Dirty = false;
+        m_AnyDirty = false;
+    }
+
+    void HierarchicalAStar::BuildBorderEntrances(Border& border)
+    {
+        border.Entrances.Clear();
+
+        TDArray<uint32_t> crossings;
+        for(uint32_t i = 0; i < (uint32_t)border.Edges.Size(); i++)
+        {
+            if(m_Graph.GetEdge(border.Edges[i])->Traversable())
+                crossings.PushBack(i);
+        }
+
+        if(crossings.Empty())
+            return;
+
+        auto IsAdjacent = [this](uint32_t a, uint32_t b)
+        {
+            if(a == b)
+                return true;
+
+            for(uint32_t edge = m_Graph.GetEdgeBegin(a); edge < m_Graph.GetEdgeEnd(a); edge++)
+            {
+                if(m_Graph.GetEdgeTarget(edge) == b && m_Graph.GetEdge(edge)->Traversable())
+                    return true;
+            }
+            return false;
+        };
+
+        // Group crossings that sit next to each other on both sides into runs
+        const uint32_t crossingCount = (uint32_t)crossings.Size();
+        TDArray<uint32_t> runs;
+        runs.Resize(crossingCount);
+        for(uint32_t i = 0; i < crossingCount; i++)
+            runs[i] = i;
+
+        auto FindRun = [&runs](uint32_t i)
+        {
+            while(runs[i] != i)
+                i = runs[i] = runs[runs[i]];
+            return i;
+        };
+
+        for(uint32_t i = 0; i < crossingCount; i++)
+        {
+            const uint32_t sourceI = border.Sources[crossings[i]];
+            const uint32_t targetI = m_Graph.GetEdgeTarget(border.Edges[crossings[i]]);
+
+            for(uint32_t j = i + 1; j < crossingCount; j++)
+            {
+                const uint32_t sourceJ = border.Sources[crossings[j]];
+                const uint32_t targetJ = m_Graph.GetEdgeTarget(border.Edges[crossings[j]]);
+
+                if(IsAdjacent(sourceI, sourceJ) || IsAdjacent(targetI, targetJ))
+                    runs[FindRun(i)] = FindRun(j);
+            }
+        }
+
+        auto CrossingPosition = [this, &border, &crossings](uint32_t i)
+        {
+            const uint32_t crossing = crossings[i];
+            const Vec3& source      = m_Graph.GetNode(border.Sources[crossing])->GetPosition();
+            const Vec3& target      = m_Graph.GetNode(m_Graph.GetEdgeTarget(border.Edges[crossing]))->GetPosition();
+            return (source + target) * 0.5f;
+        };
+
+        auto FarthestFrom = [&](uint32_t run, const Vec3& point)
+        {
+            uint32_t best      = run;
+            float bestDistance = -1.0f;
+            for(uint32_t i = 0; i < crossingCount; i++)
+            {
+                if(FindRun(i) != run)
+                    continue;
+
+                const float distance = Maths::Length2(CrossingPosition(i) - point);
+                if(distance > bestDistance)
+                {
+                    best         = i;
+                    bestDistance = distance;
+                }
+            }
+            return best;
+        };
+
+        // Short runs get one entrance in the middle, long ones one at each end
+        for(uint32_t run = 0; run < crossingCount; run++)
+        {
+            if(FindRun(run) != run)
+                continue;
+
+            uint32_t count = 0;
+            Vec3 centre(0.0f);
+            for(uint32_t i = 0; i < crossingCount; i++)
+            {
+                if(FindRun(i) == run)
+                {
+                    centre += CrossingPosition(i);
+                    count++;
+                }
+            }
+            centre /= (float)count;
+
+            if(count >= LongEntranceLength)
+            {
+                const uint32_t first  = FarthestFrom(run, centre);
+                const uint32_t second = FarthestFrom(run, CrossingPosition(first));
+                border.Entrances.PushBack(crossings[first]);
+                border.Entrances.PushBack(crossings[second]);
+            }
+            else
+            {
+                uint32_t best      = run;
+                float bestDistance = FLT_MAX;
+                for(uint32_t i = 0; i < crossingCount; i++)
+                {
+                    if(FindRun(i) != run)
+                        continue;
+
+                    const float distance = Maths::Length2(CrossingPosition(i) - centre);
+                    if(distance < bestDistance)
+                    {
+                        best         = i;
+                        bestDistance = distance;
+                    }
+                }
+                border.Entrances.PushBack(crossings[best]);
+            }
+        }
+    }
+
+    bool HierarchicalAStar::BuildClusterEntrances(uint32_t clusterIndex)
+    {
+        Cluster& cluster = m_Clusters[clusterIndex];
+
+        TDArray<uint32_t> previous = cluster.Entrances;
+        for(uint32_t node : cluster.Entrances)
+            m_EntranceSlots[node] = AStar::InvalidNode;
+
+        cluster.Entrances.Clear();
+        cluster.Links.Clear();
+
+        for(uint32_t borderIndex : cluster.Borders)
+        {
+            const Border& border = m_Borders[borderIndex];
+            for(uint32_t crossing : border.Entrances)
+            {
+                const uint32_t source = border.Sources[crossing];
+                const uint32_t target = m_Graph.GetEdgeTarget(border.Edges[crossing]);
+                const uint32_t local  = border.ClusterA == clusterIndex ? source : target;
+
+                uint32_t& slot = m_EntranceSlots[local];
+                if(slot == AStar::InvalidNode)
+                {
+                    slot = (uint32_t)cluster.Entrances.Size();
+                    cluster.Entrances.PushBack(local);
+                }
+
+                Link& link    = cluster.Links.EmplaceBack();
+                link.Entrance = slot;
+                link.Target   = local == source ? target : source;
+                link.Edge     = m_Graph.GetEdge(border.Edges[crossing]);
+            }
+        }
+
+        if(previous.Size() != cluster.Entrances.Size())
+            return true;
+
+        for(uint32_t i = 0; i < (uint32_t)previous.Size(); i++)
+        {
+            if(previous[i] != cluster.Entrances[i])
+                return true;
+        }
+        return false;
+    }
+
+    void HierarchicalAStar::BuildClusterPaths(uint32_t clusterIndex)
+    {
+        Cluster& cluster             = m_Clusters[clusterIndex];
+        const uint32_t entranceCount = (uint32_t)cluster.Entrances.Size();
+
+        cluster.Paths.Resize(entranceCount * entranceCount);
+        cluster.PathNodes.Clear();
+
+        for(uint32_t i = 0; i < entranceCount; i++)
+        {
+            const uint32_t source = cluster.Entrances[i];
+            SearchCluster(clusterIndex, source, AStar::InvalidNode);
+
+            for(uint32_t j = 0; j < entranceCount; j++)
+            {
+                IntraPath& path = cluster.Paths[i * entranceCount + j];
+                path.Cost       = GetSearchCost(cluster.Entrances[j]);
+                path.Offset     = (uint32_t)cluster.PathNodes.Size();
+                path.Length     = 0;
+
+                if(i == j || path.Cost == FLT_MAX)
+                    continue;
+
+                for(uint32_t n = cluster.Entrances[j]; n != source; n = m_LocalState.m_Nodes[n].Parent)
+                    cluster.PathNodes.PushBack(n);
+
+                path.Length = (uint32_t)cluster.PathNodes.Size() - path.Offset;
+                for(uint32_t k = 0; k < path.Length / 2; k++)
+                    Swap(cluster.PathNodes[path.Offset + k], cluster.PathNodes[path.Offset + path.Length - k - 1]);
+            }
+        }
+    }
+
+    void HierarchicalAStar::SearchCluster(uint32_t clusterIndex, uint32_t source, uint32_t goal)
+    {
+        AStar::SearchState& state = m_LocalState;
+        state.BeginSearch();
+
+        TDArray<AStar::SearchState::SearchNode>& searchNodes = state.m_Nodes;
+        PathNodePriorityQueue& openList                      = state.m_OpenList;
+        const uint32_t generation                            = state.m_Generation;
+
+        PathNode* goalNode = goal != AStar::InvalidNode ? m_Graph.GetNode(goal) : nullptr;
+        auto Heuristic     = [this, goalNode](uint32_t node)
+        {
+            return goalNode ? m_Graph.GetNode(node)->HeuristicValue(*goalNode) : 0.0f;
+        };
+
+        AStar::SearchState::SearchNode& sourceNode = searchNodes[source];
+        sourceNode.gScore                          = 0.0f;
+        sourceNode.Parent                          = AStar::InvalidNode;
+        sourceNode.Generation                      = generation;
+        sourceNode.Closed                          = false;
+        openList.Push(source, Heuristic(source));
+
+        while(!openList.Empty())
+        {
+            const uint32_t p                        = openList.Pop();
+            AStar::SearchState::SearchNode& current = searchNodes[p];
+            current.Closed                          = true;
+            state.m_ClosedCount++;
+
+            if(p == goal)
+                break;
+
+            for(uint32_t edgeIndex = m_Graph.GetEdgeBegin(p); edgeIndex < m_Graph.GetEdgeEnd(p); edgeIndex++)
+            {
+                const uint32_t q = m_Graph.GetEdgeTarget(edgeIndex);
+                PathEdge* pq     = m_Graph.GetEdge(edgeIndex);
+                if(m_NodeClusters[q] != clusterIndex || !pq->Traversable())
+                    continue;
+
+                AStar::SearchState::SearchNode& neighbour = searchNodes[q];
+                const float gScore                        = current.gScore + pq->Cost();
+
+                if(neighbour.Generation != generation)
+                {
+                    neighbour.gScore     = gScore;
+                    neighbour.Parent     = p;
+                    neighbour.Generation = generation;
+                    neighbour.Closed     = false;
+                    openList.Push(q, gScore + Heuristic(q));
+                }
+                else if(gScore < neighbour.gScore)
+                {
+                    neighbour.gScore = gScore;
+                    neighbour.Parent = p;
+
+                    if(neighbour.Closed)
+                    {
+                        neighbour.Closed = false;
+                        openList.Push(q, gScore + Heuristic(q));
+                    }
+                    else
+                        openList.DecreaseKey(q, gScore + Heuristic(q));
+                }
+            }
+        }
+    }
+
+    float HierarchicalAStar::GetSearchCost(uint32_t node) const
+    {
+        const AStar::SearchState::SearchNode& searchNode = m_LocalState.m_Nodes[node];
+        return searchNode.Generation == m_LocalState.m_Generation && searchNode.Closed ? searchNode.gScore : FLT_MAX;
+    }
+
+    bool HierarchicalAStar::AppendClusterPath(uint32_t clusterIndex, uint32_t source, uint32_t goal)
+    {
+        SearchCluster(clusterIndex, source, goal);
+        m_ExpandedCount += m_LocalState.m_ClosedCount;
+
+        if(GetSearchCost(goal) == FLT_MAX)
+            return false;
+
+        const uint32_t offset = (uint32_t)m_Path.Size();
+        for(uint32_t n = goal; n != source; n = m_LocalState.m_Nodes[n].Parent)
+            m_Path.PushBack(m_Graph.GetNode(n));
+
+        const uint32_t length = (uint32_t)m_Path.Size() - offset;
+        for(uint32_t i = 0; i < length / 2; i++)
+            Swap(m_Path[offset + i], m_Path[offset + length - i - 1]);
+
+        return true;
+    }
+
+    bool HierarchicalAStar::FindPath(PathNode* start, PathNode* end, uint32_t refineSegments)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        RebuildDirtyClusters();
+
+        m_AbstractPath.Clear();
+        m_Path.Clear();
+        m_RefinedSegments = 0;
+        m_PathCost        = 0.0f;
+        m_ExpandedCount   = 0;
+
+        const uint32_t s = m_Graph.GetNodeIndex(start);
+        const uint32_t e = m_Graph.GetNodeIndex(end);
+        if(s == AStar::InvalidNode || e == AStar::InvalidNode)
+            return false;
+
+        if(s == e)
+        {
+            m_AbstractPath.PushBack(s);
+            m_Path.PushBack(start);
+            return true;
+        }
+
+        // Connect the start and end to the entrances of their clusters. Edges are undirected, so searching
+        // out from the end gives the cost of reaching it
+        const uint32_t startCluster   = m_NodeClusters[s];
+        const uint32_t endCluster     = m_NodeClusters[e];
+        const Cluster& startEntrances = m_Clusters[startCluster];
+        const Cluster& endEntrances   = m_Clusters[endCluster];
+
+        SearchCluster(startCluster, s, AStar::InvalidNode);
+        m_ExpandedCount += m_LocalState.m_ClosedCount;
+
+        m_StartCosts.Resize(startEntrances.Entrances.Size());
+        for(uint32_t i = 0; i < (uint32_t)startEntrances.Entrances.Size(); i++)
+            m_StartCosts[i] = GetSearchCost(startEntrances.Entrances[i]);
+
+        const float directCost = startCluster == endCluster ? GetSearchCost(e) : FLT_MAX;
+
+        SearchCluster(endCluster, e, AStar::InvalidNode);
+        m_ExpandedCount += m_LocalState.m_ClosedCount;
+
+        m_EndCosts.Resize(endEntrances.Entrances.Size());
+        for(uint32_t i = 0; i < (uint32_t)endEntrances.Entrances.Size(); i++)
+            m_EndCosts[i] = GetSearchCost(endEntrances.Entrances[i]);
+
+        // Search the abstract graph
+        AStar::SearchState& state                            = m_AbstractState;
+        TDArray<AStar::SearchState::SearchNode>& searchNodes = state.m_Nodes;
+        PathNodePriorityQueue& openList                      = state.m_OpenList;
+        state.BeginSearch();
+        const uint32_t generation = state.m_Generation;
+
+        auto Relax = [&](uint32_t from, uint32_t to, float gScore)
+        {
+            AStar::SearchState::SearchNode& node = searchNodes[to];
+            const float fScore                   = gScore + m_Graph.GetNode(to)->HeuristicValue(*end);
+
+            if(node.Generation != generation)
+            {
+                node.gScore     = gScore;
+                node.Parent     = from;
+                node.Generation = generation;
+                node.Closed     = false;
+                openList.Push(to, fScore);
+            }
+            else if(gScore < node.gScore)
+            {
+                node.gScore = gScore;
+                node.Parent = from;
+
+                if(node.Closed)
+                {
+                    node.Closed = false;
+                    openList.Push(to, fScore);
+                }
+                else
+                    openList.DecreaseKey(to, fScore);
+            }
+        };
+
+        Relax(AStar::InvalidNode, s, 0.0f);
+
+        bool success = false;
+        while(!openList.Empty())
+        {
+            const uint32_t p      = openList.Pop();
+            searchNodes[p].Closed = true;
+            state.m_ClosedCount++;
+
+            if(p == e)
+            {
+                success = true;
+                break;
+            }
+
+            const float gScore  = searchNodes[p].gScore;
+            const uint32_t slot = m_EntranceSlots[p];
+
+            if(p == s)
+            {
+                for(uint32_t i = 0; i < (uint32_t)m_StartCosts.Size(); i++)
+                {
+                    if(m_StartCosts[i] != FLT_MAX && startEntrances.Entrances[i] != s)
+                        Relax(s, startEntrances.Entrances[i], m_StartCosts[i]);
+                }
+
+                if(directCost != FLT_MAX)
+                    Relax(s, e, directCost);
+            }
+            else if(slot != AStar::InvalidNode)
+            {
+                const Cluster& cluster       = m_Clusters[m_NodeClusters[p]];
+                const uint32_t entranceCount = (uint32_t)cluster.Entrances.Size();
+                for(uint32_t i = 0; i < entranceCount; i++)
+                {
+                    const float cost = cluster.Paths[slot * entranceCount + i].Cost;
+                    if(i != slot && cost != FLT_MAX)
+                        Relax(p, cluster.Entrances[i], gScore + cost);
+                }
+
+                if(m_NodeClusters[p] == endCluster && m_EndCosts[slot] != FLT_MAX)
+                    Relax(p, e, gScore + m_EndCosts[slot]);
+            }
+
+            if(slot != AStar::InvalidNode)
+            {
+                for(const Link& link : m_Clusters[m_NodeClusters[p]].Links)
+                {
+                    if(link.Entrance == slot && link.Edge->Traversable())
+                        Relax(p, link.Target, gScore + link.Edge->Cost());
+                }
+            }
+        }
+
+        m_ExpandedCount += state.m_ClosedCount;
+        if(!success)
+            return false;
+
+        m_PathCost = searchNodes[e].gScore;
+        for(uint32_t n = e; n != AStar::InvalidNode; n = searchNodes[n].Parent)
+            m_AbstractPath.PushBack(n);
+
+        const uint32_t length = (uint32_t)m_AbstractPath.Size();
+        for(uint32_t i = 0; i < length / 2; i++)
+            Swap(m_AbstractPath[i], m_AbstractPath[length - i - 1]);
+
+        m_Path.PushBack(start);
+        RefinePath(refineSegments);
+        return true;
+    }
+
+    bool HierarchicalAStar::RefinePath(uint32_t segmentCount)
+    {
+        for(; segmentCount > 0 && !IsPathComplete(); segmentCount--)
+        {
+            RefineSegment(m_AbstractPath[m_RefinedSegments], m_AbstractPath[m_RefinedSegments + 1]);
+            m_RefinedSegments++;
+        }
+
+        return !IsPathComplete();
+    }
+
+    void HierarchicalAStar::RefineFullPath()
+    {
+        RefinePath((uint32_t)m_AbstractPath.Size());
+    }
+
+    void HierarchicalAStar::RefineSegment(uint32_t from, uint32_t to)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t clusterIndex = m_NodeClusters[from];
+
+        // Link into the next cluster
+        if(m_NodeClusters[to] != clusterIndex)
+        {
+            m_Path.PushBack(m_Graph.GetNode(to));
+            return;
+        }
+
+        // Between two entrances, copy the cached path
+        const uint32_t fromSlot = m_EntranceSlots[from];
+        const uint32_t toSlot   = m_EntranceSlots[to];
+        if(fromSlot != AStar::InvalidNode && toSlot != AStar::InvalidNode)
+        {
+            const Cluster& cluster = m_Clusters[clusterIndex];
+            const IntraPath& path  = cluster.Paths[fromSlot * cluster.Entrances.Size() + toSlot];
+            for(uint32_t i = 0; i < path.Length; i++)
+                m_Path.PushBack(m_Graph.GetNode(cluster.PathNodes[path.Offset + i]));
+            return;
+        }
+
+        // From the start or to the end, search inside the cluster
+        const bool found = AppendClusterPath(clusterIndex, from, to);
+        ASSERT(found, "Cluster changed since the path was found");
+    }
+
+    uint32_t HierarchicalAStar::GetEntranceCount() const
+    {
+        uint32_t count = 0;
+        for(const Cluster& cluster : m_Clusters)
+            count += (uint32_t)cluster.Entrances.Size();
+        return count;
+    }
+}
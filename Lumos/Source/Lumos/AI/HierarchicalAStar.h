@@ -0,0 +1,134 @@
+#pragma once
+
+#include "AStar.h"
+
+namespace Lumos
+{
+    // Hierarchical A* (HPA*) over a PathNode graph. Nodes are grouped into clusters by position on a uniform
+    // grid of clusterSize cells. Where clusters touch, each run of connected border edges gets one or two
+    // entrances, and the paths between every pair of entrances inside a cluster are searched once and cached.
+    // A query only searches this small abstract graph, plus the start and end clusters. The concrete path is
+    // then refined from the cached segments a few at a time, so a long route does not have to be expanded
+    // before the agent can start following it.
+    // Paths go through entrances, so they can be slightly longer than the ones plain A* finds.
+    class HierarchicalAStar
+    {
+    public:
+        HierarchicalAStar(const TDArray<PathNode*>& nodes, float clusterSize);
+
+        // Call after changing an edge's traversability or weight. The clusters on either side of it are
+        // rebuilt before the next search
+        void OnEdgeChanged(PathEdge* edge);
+        void RebuildDirtyClusters();
+
+        // Searches the abstract graph and refines the first refineSegments segments of the result
+        bool FindPath(PathNode* start, PathNode* end, uint32_t refineSegments = 2);
+
+        // Appends the next segments of the last path found. Returns false once the path is complete
+        bool RefinePath(uint32_t segmentCount = 1);
+        void RefineFullPath();
+
+        bool IsPathComplete() const
+        {
+            return m_RefinedSegments + 1 >= (uint32_t)m_AbstractPath.Size();
+        }
+
+        // Refined part of the path, starting at the start node
+        const TDArray<PathNode*>& Path() const
+        {
+            return m_Path;
+        }
+
+        // Cost of the full path, including the segments not refined yet
+        float PathCost() const
+        {
+            return m_PathCost;
+        }
+
+        // Nodes expanded by the last FindPath and any refinement since, across every level
+        uint32_t ExpandedCount() const
+        {
+            return m_ExpandedCount;
+        }
+
+        uint32_t GetClusterCount() const
+        {
+            return (uint32_t)m_Clusters.Size();
+        }
+
+        uint32_t GetEntranceCount() const;
+
+        const AStar& GetGraph() const
+        {
+            return m_Graph;
+        }
+
+    private:
+        // A path between two entrances of the same cluster. Nodes are stored without the first entrance
+        struct IntraPath
+        {
+            float Cost;
+            uint32_t Offset;
+            uint32_t Length;
+        };
+
+        // Edge from an entrance into a neighbouring cluster
+        struct Link
+        {
+            uint32_t Entrance; // Slot in this cluster
+            uint32_t Target;   // Node in the other cluster
+            PathEdge* Edge;
+        };
+
+        struct Cluster
+        {
+            TDArray<uint32_t> Nodes;
+            TDArray<uint32_t> Borders;   // Indices into m_Borders
+            TDArray<uint32_t> Entrances; // Nodes of the abstract graph in this cluster
+            TDArray<IntraPath> Paths;    // Entrances.Size() squared, FLT_MAX cost if not connected in the cluster
+            TDArray<uint32_t> PathNodes;
+            TDArray<Link> Links;
+            bool Dirty = true;
+        };
+
+        // Edges crossing between two clusters, and the ones picked as entrances
+        struct Border
+        {
+            uint32_t ClusterA;
+            uint32_t ClusterB;
+            TDArray<uint32_t> Sources;   // Node in ClusterA
+            TDArray<uint32_t> Edges;     // From the source to a node in ClusterB
+            TDArray<uint32_t> Entrances; // Indices into Edges
+        };
+
+        void BuildBorderEntrances(Border& border);
+        bool BuildClusterEntrances(uint32_t clusterIndex);
+        void BuildClusterPaths(uint32_t clusterIndex);
+
+        // Searches from source without leaving the cluster. With goal set to InvalidNode the whole cluster is
+        // explored, otherwise the search stops at goal
+        void SearchCluster(uint32_t clusterIndex, uint32_t source, uint32_t goal);
+        bool AppendClusterPath(uint32_t clusterIndex, uint32_t source, uint32_t goal);
+        float GetSearchCost(uint32_t node) const;
+
+        void RefineSegment(uint32_t from, uint32_t to);
+
+        AStar m_Graph;
+        TDArray<uint32_t> m_NodeClusters;
+        TDArray<uint32_t> m_EntranceSlots; // Slot of each node in its cluster's Entrances, InvalidNode if none
+        TDArray<Cluster> m_Clusters;
+        TDArray<Border> m_Borders;
+        bool m_AnyDirty = true;
+
+        AStar::SearchState m_LocalState;
+        AStar::SearchState m_AbstractState;
+        TDArray<float> m_StartCosts; // Start to each entrance of its cluster
+        TDArray<float> m_EndCosts;   // Each entrance of the end cluster to the end
+
+        TDArray<uint32_t> m_AbstractPath;
+        TDArray<PathNode*> m_Path;
+        uint32_t m_RefinedSegments = 0;
+        float m_PathCost           = 0.0f;
+        uint32_t m_ExpandedCount   = 0;
+    };
+}
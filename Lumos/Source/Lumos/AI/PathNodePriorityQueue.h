@@ -1,48 +1,123 @@
 #pragma once
-#include "QueueablePathNode.h"
-#include <vector>
+#include "Core/DataStructures/TDArray.h"
+
 namespace Lumos
 {
-
-    class PathNodePriorityQueue : public std::vector<QueueablePathNode*>
+    // Indexed binary min-heap of node indices keyed by f score. Each node's heap slot is tracked so its key
+    // can be decreased in place. Storage is sized once with Init, so pushing and popping never allocate
+    class PathNodePriorityQueue
     {
     public:
-        PathNodePriorityQueue()
-            : std::vector<QueueablePathNode*>()
-        //, m_comp()
+        static const uint32_t InvalidIndex = ~0u;
+
+        void Init(uint32_t nodeCount)
         {
-            // std::make_heap(begin(), end(), m_comp);
+            m_Heap.Reserve(nodeCount);
+            m_Keys.Resize(nodeCount);
+            m_Positions.Resize(nodeCount);
         }
 
-        void Push(QueueablePathNode* item)
+        void Clear()
         {
-            push_back(item);
-            // std::push_heap(begin(), end(), m_comp);
+            m_Heap.Clear();
         }
 
-        void Pop()
+        bool Empty() const
         {
-            // std::pop_heap(begin(), end(), m_comp);
-            pop_back();
+            return m_Heap.Empty();
         }
 
-        QueueablePathNode* Top() const
+        uint32_t Size() const
         {
-            return front();
+            return (uint32_t)m_Heap.Size();
         }
 
-        std::vector<QueueablePathNode*>::const_iterator Find(QueueablePathNode* item) const
+        uint32_t Top() const
         {
-            return std::find(cbegin(), cend(), item);
+            return m_Heap[0];
         }
 
-        void Update()
+        void Push(uint32_t node, float key)
         {
-            // std::make_heap(begin(), end(), m_comp);
+            m_Keys[node]      = key;
+            m_Positions[node] = (uint32_t)m_Heap.Size();
+            m_Heap.PushBack(node);
+            SiftUp(m_Positions[node]);
+        }
+
+        uint32_t Pop()
+        {
+            const uint32_t top  = m_Heap[0];
+            const uint32_t last = m_Heap.Back();
+            m_Heap.PopBack();
+
+            if(!m_Heap.Empty())
+            {
+                m_Heap[0]         = last;
+                m_Positions[last] = 0;
+                SiftDown(0);
+            }
+            return top;
+        }
+
+        // The node must be on the heap and the new key must not be larger than the current one
+        void DecreaseKey(uint32_t node, float key)
+        {
+            m_Keys[node] = key;
+            SiftUp(m_Positions[node]);
         }
 
     private:
-        // greater_ptr<QueueablePathNode> m_comp;
-    };
+        void SiftUp(uint32_t position)
+        {
+            const uint32_t node = m_Heap[position];
+            const float key     = m_Keys[node];
+
+            while(position > 0)
+            {
+                const uint32_t parentPosition = (position - 1) / 2;
+                const uint32_t parent         = m_Heap[parentPosition];
+                if(m_Keys[parent] <= key)
+                    break;
 
-}
\ No newline at end of file
+                m_Heap[position]    = parent;
+                m_Positions[parent] = position;
+                position            = parentPosition;
+            }
+
+            m_Heap[position]  = node;
+            m_Positions[node] = position;
+        }
+
+        void SiftDown(uint32_t position)
+        {
+            const uint32_t count = (uint32_t)m_Heap.Size();
+            const uint32_t node  = m_Heap[position];
+            const float key      = m_Keys[node];
+
+            while(true)
+            {
+                uint32_t child = position * 2 + 1;
+                if(child >= count)
+                    break;
+
+                if(child + 1 < count && m_Keys[m_Heap[child + 1]] < m_Keys[m_Heap[child]])
+                    child++;
+
+                if(key <= m_Keys[m_Heap[child]])
+                    break;
+
+                m_Heap[position]              = m_Heap[child];
+                m_Positions[m_Heap[position]] = position;
+                position                      = child;
+            }
+
+            m_Heap[position]  = node;
+            m_Positions[node] = position;
+        }
+
+        TDArray<uint32_t> m_Heap;      // Node indices in heap order
+        TDArray<float> m_Keys;         // Keyed by node index
+        TDArray<uint32_t> m_Positions; // Heap slot of each node, only valid while it is on the heap
+    };
+}
@@ -0,0 +1,238 @@
+#include "Precompiled.h"
+#include "PathQueryService.h"
+#include "Maths/MathsUtilities.h"
+
+namespace Lumos
+{
+    PathQueryService::PathQueryService(const AStar& graph, uint32_t maxBatchSize)
+        : m_Graph(graph)
+        , m_MaxBatchSize(maxBatchSize)
+    {
+        ASSERT(maxBatchSize > 0);
+        m_Batch.Resize(maxBatchSize);
+
+        const uint32_t workerCount = Maths::Max(1u, System::JobSystem::GetThreadCount());
+        m_WorkerStates.Resize(workerCount);
+        for(AStar::SearchState& state : m_WorkerStates)
+            state.Init(graph.GetNodeCount());
+    }
+
+    PathQueryService::~PathQueryService()
+    {
+        System::JobSystem::Wait(m_Context);
+    }
+
+    PathQueryID PathQueryService::Submit(PathNode* start, PathNode* end, PathQueryPriority priority, uint64_t userData)
+    {
+        PathQuery query;
+        query.ID       = m_NextID++;
+        query.Start    = m_Graph.GetNodeIndex(start);
+        query.End      = m_Graph.GetNodeIndex(end);
+        query.UserData = userData;
+        query.Priority = priority;
+
+        if(m_NextID == 0)
+            m_NextID = 1;
+
+        // Nodes outside of the graph fail straight away
+        if(query.Start == AStar::InvalidNode || query.End == AStar::InvalidNode)
+        {
+            Complete(query, false, 0.0f, nullptr);
+            return query.ID;
+        }
+
+        m_Pending[(uint32_t)priority].Queries.PushBack(query);
+        return query.ID;
+    }
+
+    void PathQueryService::Cancel(PathQueryID id)
+    {
+        for(PendingQueue& queue : m_Pending)
+        {
+            for(uint32_t i = queue.Head; i < (uint32_t)queue.Queries.Size(); i++)
+            {
+                if(queue.Queries[i].ID == id)
+                {
+                    // Left in place and skipped when the batch is built
+                    queue.Queries[i].ID = 0;
+                    return;
+                }
+            }
+        }
+
+        // Only read once the batch has finished, so this is safe while it runs
+        for(uint32_t i = 0; i < m_BatchSize; i++)
+        {
+            if(m_Batch[i].Query.ID == id)
+            {
+                m_Batch[i].Cancelled = true;
+                return;
+            }
+        }
+    }
+
+    void PathQueryService::Update()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        // Never block the caller on a batch that is still running
+        if(System::JobSystem::IsBusy(m_Context))
+            return;
+
+        if(m_CompletedRead == (uint32_t)m_Completed.Size())
+        {
+            m_Completed.Clear();
+            m_CompletedPaths.Clear();
+            m_CompletedRead = 0;
+        }
+
+        CollectBatch();
+        LaunchBatch();
+    }
+
+    void PathQueryService::Flush()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        System::JobSystem::Wait(m_Context);
+        CollectBatch();
+    }
+
+    bool PathQueryService::PollCompleted(PathQueryResult& result)
+    {
+        if(m_CompletedRead == (uint32_t)m_Completed.Size())
+            return false;
+
+        result = m_Completed[m_CompletedRead++];
+        return true;
+    }
+
+    PathNode* const* PathQueryService::GetPath(const PathQueryResult& result) const
+    {
+        return result.PathLength > 0 ? &m_CompletedPaths[result.PathOffset] : nullptr;
+    }
+
+    uint32_t PathQueryService::GetPendingCount() const
+    {
+        uint32_t count = 0;
+        for(const PendingQueue& queue : m_Pending)
+            count += (uint32_t)queue.Queries.Size() - queue.Head;
+        return count;
+    }
+
+    void PathQueryService::CollectBatch()
+    {
+        const uint32_t firstResult = (uint32_t)m_Completed.Size();
+
+        // Walk backwards so requeued queries keep their original order at the front of their queue
+        for(int32_t i = (int32_t)m_BatchSize - 1; i >= 0; i--)
+        {
+            BatchSlot& slot = m_Batch[i];
+            if(slot.Cancelled)
+                continue;
+
+            if(slot.Processed)
+            {
+                Complete(slot.Query, slot.Success, slot.Cost, &slot.Path);
+            }
+            else
+            {
+                PendingQueue& queue = m_Pending[(uint32_t)slot.Query.Priority];
+                ASSERT(queue.Head > 0);
+                queue.Queries[--queue.Head] = slot.Query;
+            }
+        }
+
+        // Results were added in reverse
+        const uint32_t collected = (uint32_t)m_Completed.Size() - firstResult;
+        for(uint32_t i = 0; i < collected / 2; i++)
+            Swap(m_Completed[firstResult + i], m_Completed[m_Completed.Size() - i - 1]);
+
+        m_BatchSize = 0;
+
+        // Drop the consumed prefix of each queue once it dominates the queue
+        for(PendingQueue& queue : m_Pending)
+        {
+            const uint32_t count = (uint32_t)queue.Queries.Size();
+            if(queue.Head == 0 || queue.Head < count / 2)
+                continue;
+
+            for(uint32_t i = queue.Head; i < count; i++)
+                queue.Queries[i - queue.Head] = queue.Queries[i];
+            queue.Queries.Resize(count - queue.Head);
+            queue.Head = 0;
+        }
+    }
+
+    void PathQueryService::LaunchBatch()
+    {
+        // Highest priority first, oldest first within a priority
+        m_BatchSize = 0;
+        for(int32_t priority = (int32_t)PathQueryPriority::Count - 1; priority >= 0 && m_BatchSize < m_MaxBatchSize; priority--)
+        {
+            PendingQueue& queue = m_Pending[priority];
+            while(queue.Head < (uint32_t)queue.Queries.Size() && m_BatchSize < m_MaxBatchSize)
+            {
+                const PathQuery& query = queue.Queries[queue.Head++];
+                if(query.ID == 0)
+                    continue;
+
+                BatchSlot& slot = m_Batch[m_BatchSize++];
+                slot.Query      = query;
+                slot.Cost       = 0.0f;
+                slot.Success    = false;
+                slot.Processed  = false;
+                slot.Cancelled  = false;
+                slot.Path.Clear();
+            }
+        }
+
+        if(m_BatchSize == 0)
+            return;
+
+        const uint32_t workerCount = Maths::Min((uint32_t)m_WorkerStates.Size(), m_BatchSize);
+        m_NextSlot.store(0, std::memory_order_relaxed);
+        m_BatchStart = Timer::Now();
+
+        System::JobSystem::Dispatch(m_Context, workerCount, 1, [this](JobDispatchArgs args)
+                                    { ProcessBatch(args.jobIndex); });
+    }
+
+    void PathQueryService::ProcessBatch(uint32_t worker)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        AStar::SearchState& state = m_WorkerStates[worker];
+
+        while(true)
+        {
+            const uint32_t slotIndex = m_NextSlot.fetch_add(1, std::memory_order_relaxed);
+            if(slotIndex >= m_BatchSize)
+                break;
+
+            BatchSlot& slot = m_Batch[slotIndex];
+            slot.Success    = m_Graph.FindPath(slot.Query.Start, slot.Query.End, state, slot.Path, slot.Cost);
+            slot.Processed  = true;
+
+            // Every worker finishes at least one query, so the queue always makes progress
+            if(Timer::Duration(m_BatchStart, Timer::Now(), 1000.0f) > m_TimeBudget)
+                break;
+        }
+    }
+
+    void PathQueryService::Complete(const PathQuery& query, bool success, float cost, const TDArray<PathNode*>* path)
+    {
+        PathQueryResult& result = m_Completed.EmplaceBack();
+        result.ID               = query.ID;
+        result.UserData         = query.UserData;
+        result.Success          = success;
+        result.Cost             = cost;
+        result.PathOffset       = (uint32_t)m_CompletedPaths.Size();
+        result.PathLength       = 0;
+
+        if(success && path)
+        {
+            for(PathNode* node : *path)
+                m_CompletedPaths.PushBack(node);
+            result.PathLength = (uint32_t)path->Size();
+        }
+    }
+}
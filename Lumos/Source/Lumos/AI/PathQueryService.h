@@ -0,0 +1,113 @@
+#pragma once
+
+#include "AStar.h"
+#include "Core/JobSystem.h"
+#include "Utilities/Timer.h"
+
+namespace Lumos
+{
+    enum class PathQueryPriority : uint8_t
+    {
+        Low = 0,
+        Normal,
+        High,
+        Count
+    };
+
+    typedef uint32_t PathQueryID; // 0 is never a valid query
+
+    struct PathQueryResult
+    {
+        PathQueryID ID;
+        uint64_t UserData;
+        bool Success;
+        float Cost;
+        uint32_t PathOffset; // Use PathQueryService::GetPath to read the nodes
+        uint32_t PathLength;
+    };
+
+    // Resolves path requests against one AStar graph in batches on the JobSystem workers, so searches never
+    // run on the thread that submits them. Update collects the finished batch into the completion queue and
+    // launches the next one, taking requests in priority order. Each worker searches with its own
+    // AStar::SearchState and stops picking up requests once the batch's time budget is spent; requests it
+    // did not reach go back to the front of the queue.
+    // Submit, Cancel, Update and PollCompleted must be called from the same thread, and the graph must not be
+    // modified while a batch is in flight (call Flush first).
+    class LUMOS_EXPORT PathQueryService
+    {
+    public:
+        explicit PathQueryService(const AStar& graph, uint32_t maxBatchSize = 256);
+        ~PathQueryService();
+
+        PathQueryID Submit(PathNode* start, PathNode* end, PathQueryPriority priority = PathQueryPriority::Normal, uint64_t userData = 0);
+
+        // Results of a cancelled query are discarded, even if its batch is already running
+        void Cancel(PathQueryID id);
+
+        // Call once per frame
+        void Update();
+
+        // Wait for the batch in flight and collect its results
+        void Flush();
+
+        // Results and their paths stay valid until every completed result has been polled and Update is called
+        bool PollCompleted(PathQueryResult& result);
+        PathNode* const* GetPath(const PathQueryResult& result) const;
+
+        void SetTimeBudget(float milliseconds) { m_TimeBudget = milliseconds; }
+        float GetTimeBudget() const { return m_TimeBudget; }
+
+        uint32_t GetPendingCount() const;
+        bool IsBusy() const { return System::JobSystem::IsBusy(m_Context); }
+
+    private:
+        struct PathQuery
+        {
+            PathQueryID ID;
+            uint32_t Start;
+            uint32_t End;
+            uint64_t UserData;
+            PathQueryPriority Priority;
+        };
+
+        struct BatchSlot
+        {
+            PathQuery Query;
+            TDArray<PathNode*> Path;
+            float Cost;
+            bool Success;
+            bool Processed;
+            bool Cancelled;
+        };
+
+        // FIFO per priority. Taken requests advance Head, and unprocessed ones are put back in front of it
+        struct PendingQueue
+        {
+            TDArray<PathQuery> Queries;
+            uint32_t Head = 0;
+        };
+
+        void CollectBatch();
+        void LaunchBatch();
+        void ProcessBatch(uint32_t worker);
+        void Complete(const PathQuery& query, bool success, float cost, const TDArray<PathNode*>* path);
+
+        const AStar& m_Graph;
+        uint32_t m_MaxBatchSize;
+        float m_TimeBudget = 2.0f; // Milliseconds per batch
+
+        PendingQueue m_Pending[(uint32_t)PathQueryPriority::Count];
+        PathQueryID m_NextID = 1;
+
+        TDArray<BatchSlot> m_Batch;
+        uint32_t m_BatchSize = 0;
+        std::atomic<uint32_t> m_NextSlot { 0 };
+        TimeStamp m_BatchStart;
+        TDArray<AStar::SearchState> m_WorkerStates;
+        System::JobSystem::Context m_Context;
+
+        TDArray<PathQueryResult> m_Completed;
+        TDArray<PathNode*> m_CompletedPaths;
+        uint32_t m_CompletedRead = 0;
+    };
+}
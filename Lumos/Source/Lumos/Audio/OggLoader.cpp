@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "OggLoader.h"
 #include "Core/OS/FileSystem.h"
+#include "Core/Asset/AssetCache.h"
 #include "Sound.h"
 
 #define STB_VORBIS_HEADER_ONLY
@@ -8,6 +9,56 @@
 
 namespace Lumos
 {
+    // Cooked ogg files hold the decoded mono samples, a cache hit skips vorbis decoding
+    struct CookedAudioInfo
+    {
+        float FreqRate;
+        uint32_t BitRate;
+        uint32_t Size;
+        uint32_t Channels;
+        double Length;
+    };
+
+    static bool LoadCookedOgg(const std::string& physicalPath, AudioData& data)
+    {
+        CookedAsset cooked;
+        if(!AssetCache::Get().Load(physicalPath, AssetType::Audio, 0, cooked))
+            return false;
+
+        CookedAudioInfo info;
+        CookedAssetReader reader = cooked.GetReader();
+        if(!reader.Read(info))
+            return false;
+
+        reader.Align();
+        const uint8_t* samples = reader.ReadArray<uint8_t>(info.Size);
+        if(!samples)
+            return false;
+
+        data.FreqRate = info.FreqRate;
+        data.BitRate  = info.BitRate;
+        data.Size     = info.Size;
+        data.Channels = info.Channels;
+        data.Length   = info.Length;
+        data.Data.Resize(info.Size);
+        MemoryCopy(data.Data.Data(), samples, info.Size);
+        return true;
+    }
+
+    static void StoreCookedOgg(const std::string& physicalPath, const AudioData& data)
+    {
+        if(!AssetCache::Get().IsEnabled())
+            return;
+
+        const CookedAudioInfo info = { data.FreqRate, data.BitRate, data.Size, data.Channels, data.Length };
+
+        CookedAssetWriter writer;
+        writer.Write(info);
+        writer.Align();
+        writer.Write(data.Data.Data(), data.Size);
+        AssetCache::Get().Store(physicalPath, AssetType::Audio, 0, writer);
+    }
+
     AudioData LoadOgg(const std::string& fileName)
     {
         AudioData data = AudioData();
@@ -18,6 +69,9 @@ namespace Lumos
             LINFO("Failed to load Ogg file : File Not Found");
         }
 
+        if(LoadCookedOgg(physicalPath, data))
+            return data;
+
         const auto m_FileHandle = fopen(physicalPath.c_str(), "rb");
 
         if(!m_FileHandle)
@@ -51,6 +105,7 @@ namespace Lumos
 
         fclose(m_FileHandle);
 
+        StoreCookedOgg(physicalPath, data);
         return data;
     }
 }
@@ -1,15 +1,18 @@
 #pragma once
 
 #include "Core/Core.h"
+#include "Core/Asset/Asset.h"
 #include "AudioData.h"
 
 namespace Lumos
 {
-    class LUMOS_EXPORT Sound
+    class LUMOS_EXPORT Sound : public Asset
     {
         friend class SoundManager;
 
     public:
+        SET_ASSET_TYPE(AssetType::Audio);
+
         static SharedPtr<Sound> Create(const std::string& name, const std::string& extension);
         virtual ~Sound() = default;
 
@@ -32,5 +32,73 @@ namespace Lumos
                 }
             }
         }
+
+        // Maps a float to a uint32_t whose unsigned ordering matches the float ordering
+        inline uint32_t FloatToSortableKey(float value)
+        {
+            uint32_t bits;
+            MemoryCopy(&bits, &value, sizeof(float));
+            return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+        }
+
+        // Stable LSD radix sort of 64 bit keys, one byte per pass. Values are moved along with
+        // their keys and passes where every key shares the same digit are skipped.
+        // Scratch buffers must hold count elements. The sorted result ends up in keys/values.
+        template <typename Value>
+        void RadixSort(uint64_t* keys, Value* values, uint64_t* scratchKeys, Value* scratchValues, uint32_t count)
+        {
+            if(count < 2)
+                return;
+
+            uint32_t histograms[8][256] = {};
+            for(uint32_t i = 0; i < count; i++)
+            {
+                uint64_t key = keys[i];
+                for(uint32_t pass = 0; pass < 8; pass++)
+                    histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+            }
+
+            uint64_t* srcKeys = keys;
+            uint64_t* dstKeys = scratchKeys;
+            Value* srcValues  = values;
+            Value* dstValues  = scratchValues;
+
+            for(uint32_t pass = 0; pass < 8; pass++)
+            {
+                uint32_t shift      = pass * 8;
+                uint32_t* histogram = histograms[pass];
+
+                if(histogram[(srcKeys[0] >> shift) & 0xFF] == count)
+                    continue;
+
+                uint32_t offset = 0;
+                for(uint32_t i = 0; i < 256; i++)
+                {
+                    uint32_t bucketCount = histogram[i];
+                    histogram[i]         = offset;
+                    offset += bucketCount;
+                }
+
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    uint64_t key   = srcKeys[i];
+                    uint32_t dst   = histogram[(key >> shift) & 0xFF]++;
+                    dstKeys[dst]   = key;
+                    dstValues[dst] = Move(srcValues[i]);
+                }
+
+                Swap(srcKeys, dstKeys);
+                Swap(srcValues, dstValues);
+            }
+
+            if(srcKeys != keys)
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    keys[i]   = srcKeys[i];
+                    values[i] = Move(srcValues[i]);
+                }
+            }
+        }
     }
 }
\ No newline at end of file
@@ -30,6 +30,7 @@
 #include "Core/DataStructures/TDArray.h"
 #include "Core/CommandLine.h"
 #include "Core/Asset/AssetManager.h"
+#include "Core/Asset/AssetCache.h"
 #include "Scripting/Lua/LuaManager.h"
 #include "ImGui/ImGuiManager.h"
 #include "Events/ApplicationEvent.h"
@@ -106,7 +107,7 @@ namespace Lumos
         CommandLine* cmdline = Internal::CoreSystem::GetCmdLine();
         if(cmdline->OptionBool(Str8Lit("help")))
         {
-            LINFO("Print this help.\n Option 1 : EnableVulkanValidation");
+            LINFO("Print this help.\n Option 1 : EnableVulkanValidation\n Option 2 : DisableAssetCache");
         }
 
         Engine::Get();
@@ -184,10 +185,10 @@ namespace Lumos
 
         System::JobSystem::Context context;
 
-        System::JobSystem::Execute(context, [](JobDispatchArgs args)
+        System::JobSystem::Execute(context, [](JobDispatchArgs /*args*/)
                                    { Lumos::Input::Get(); });
 
-        System::JobSystem::Execute(context, [this](JobDispatchArgs args)
+        System::JobSystem::Execute(context, [this](JobDispatchArgs /*args*/)
                                    {
                                        auto audioManager = AudioManager::Create();
                                        if (audioManager)
@@ -195,13 +196,13 @@ namespace Lumos
                                            m_SystemManager->RegisterSystem<AudioManager>(audioManager);
                                        } });
 
-        System::JobSystem::Execute(context, [this](JobDispatchArgs args)
+        System::JobSystem::Execute(context, [this](JobDispatchArgs /*args*/)
                                    {
                                        m_SystemManager->RegisterSystem<LumosPhysicsEngine>();
                                        m_SystemManager->RegisterSystem<B2PhysicsEngine>();
                                        LINFO("Initialised Physics Manager"); });
 
-        System::JobSystem::Execute(context, [this](JobDispatchArgs args)
+        System::JobSystem::Execute(context, [this](JobDispatchArgs /*args*/)
                                    { m_SceneManager->LoadCurrentList(); });
 
         m_ImGuiManager = CreateUniquePtr<ImGuiManager>(false);
@@ -252,6 +253,7 @@ namespace Lumos
         m_SystemManager.reset();
         m_ImGuiManager.reset();
         LuaManager::Release();
+        AssetCache::Release();
 
         Graphics::Pipeline::ClearCache();
         Graphics::RenderPass::ClearCache();
@@ -353,6 +355,10 @@ namespace Lumos
     void Application::MountFileSystemPaths()
     {
         FileSystem::Get().SetAssetRoot(PushStr8F(m_Arena, "%sAssets", m_ProjectSettings.m_ProjectRoot.c_str()));
+
+        // Cooked assets live next to the asset registry. DisableAssetCache forces every asset through its importer
+        AssetCache::Get().SetCacheFolder(m_ProjectSettings.m_ProjectRoot + "AssetCache/");
+        AssetCache::Get().SetEnabled(!Internal::CoreSystem::GetCmdLine()->OptionBool(Str8Lit("DisableAssetCache")));
     }
 
     Scene* Application::GetCurrentScene() const
@@ -465,13 +471,26 @@ namespace Lumos
         }
 
         System::JobSystem::Context context;
+        uint32_t animationNode = UINT32_MAX;
+        uint32_t cullingNode   = UINT32_MAX;
 
         {
             LUMOS_PROFILE_SCOPE("Application::Update");
             OnUpdate(ts);
 
-            System::JobSystem::Execute(context, [](JobDispatchArgs args)
-                                       { Application::UpdateSystems(); });
+            // Systems, animation and culling run while this thread builds the UI. Rendering waits for animation
+            // and culling, the systems carry on until their transforms are synced at the end of the frame
+            Scene* scene = m_SceneManager->GetCurrentScene();
+            m_FrameGraph.Clear();
+            m_FrameGraph.AddTask([](JobDispatchArgs /*args*/)
+                                 { Application::UpdateSystems(); });
+
+            if(scene && GetEditorState() != EditorState::Paused && GetEditorState() != EditorState::Preview)
+                animationNode = scene->AddAnimationTasks(m_FrameGraph);
+            if(scene && !m_Minimized && !m_DisableMainSceneRenderer)
+                cullingNode = m_SceneRenderer->AddCullingTasks(m_FrameGraph, scene);
+
+            m_FrameGraph.Run(context);
             m_Updates++;
         }
 
@@ -498,6 +517,11 @@ namespace Lumos
             LUMOS_PROFILE_SCOPE("Application::Render");
             Engine::Get().ResetStats();
 
+            if(animationNode != UINT32_MAX)
+                m_FrameGraph.Wait(animationNode);
+            if(cullingNode != UINT32_MAX)
+                m_FrameGraph.Wait(cullingNode);
+
             Graphics::Renderer::GetRenderer()->Begin();
             OnRender();
             m_ImGuiManager->OnNewFrame();
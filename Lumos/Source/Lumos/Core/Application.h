@@ -7,6 +7,7 @@
 #include "Maths/MathsFwd.h"
 #include "Maths/Vector2.h"
 #include "Core/Function.h"
+#include "Core/JobSystem.h"
 
 #include <thread>
 
@@ -238,6 +239,9 @@ namespace Lumos
         UniquePtr<Timer> m_Timer;
         SharedPtr<AssetManager> m_AssetManager;
 
+        // Frame work run on the job system alongside the main thread: systems, animation and mesh culling
+        System::JobSystem::TaskGraph m_FrameGraph;
+
         AppState m_CurrentState   = AppState::Loading;
         EditorState m_EditorState = EditorState::Preview;
         AppType m_AppType         = AppType::Editor;
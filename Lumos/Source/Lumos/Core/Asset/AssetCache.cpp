@@ -0,0 +1,361 @@
+#include "Precompiled.h"
+#include "AssetCache.h"
+#include "Core/OS/FileSystem.h"
+#include "Maths/MathsUtilities.h"
+#include <cstdio>
+#include <inttypes.h>
+
+namespace Lumos
+{
+    static const uint32_t CookedAssetMagic   = 0x41434D4C; // "LMCA"
+    static const uint32_t CookedAssetVersion = 1;
+    static const uint64_t CookedAssetAlign   = 16;
+
+    // Identifies the exact contents a blob was cooked from. Size and time are checked first, the content hash
+    // only when they differ, so touching a file without changing it doesn't force a re-import
+    struct CookedFileRecord
+    {
+        uint64_t Size;
+        uint64_t ModifiedTime;
+        uint64_t ContentHash;
+    };
+
+    // Blob layout: CookedAssetHeader, DependencyCount { path, CookedFileRecord } entries, then the payload
+    // at PayloadOffset
+    struct CookedAssetHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t Type;
+        uint32_t DependencyCount;
+        uint64_t SettingsHash;
+        uint64_t PayloadOffset;
+        uint64_t PayloadSize;
+        CookedFileRecord Source;
+    };
+
+    struct CookedAssetInfo
+    {
+        CookedAssetHeader Header;
+        TDArray<std::string> DependencyPaths;
+        TDArray<CookedFileRecord> Dependencies;
+    };
+
+    static uint64_t AlignCookedOffset(uint64_t offset)
+    {
+        return (offset + CookedAssetAlign - 1) & ~(CookedAssetAlign - 1);
+    }
+
+    static bool HashFile(const std::string& path, uint64_t& outHash)
+    {
+        int64_t size  = 0;
+        uint8_t* data = FileSystem::MapFile(path, size);
+        if(!data)
+        {
+            // Empty files can't be mapped
+            outHash = AssetCache::Hash(nullptr, 0);
+            return FileSystem::FileExists(path);
+        }
+
+        outHash = AssetCache::Hash(data, (uint64_t)size);
+        FileSystem::UnmapFile(data, size);
+        return true;
+    }
+
+    static bool CreateFileRecord(const std::string& path, CookedFileRecord& outRecord)
+    {
+        const int64_t size = FileSystem::GetFileSize(path);
+        if(size < 0)
+            return false;
+
+        outRecord.Size         = (uint64_t)size;
+        outRecord.ModifiedTime = FileSystem::GetFileModifiedTime(path);
+        return HashFile(path, outRecord.ContentHash);
+    }
+
+    // Returns false if the file changed since the record was made. Sets refresh if only its time did
+    static bool CheckFileRecord(const std::string& path, CookedFileRecord& record, bool& refresh)
+    {
+        const int64_t size = FileSystem::GetFileSize(path);
+        if(size < 0 || (uint64_t)size != record.Size)
+            return false;
+
+        const uint64_t modifiedTime = FileSystem::GetFileModifiedTime(path);
+        if(modifiedTime == record.ModifiedTime)
+            return true;
+
+        uint64_t hash = 0;
+        if(!HashFile(path, hash) || hash != record.ContentHash)
+            return false;
+
+        record.ModifiedTime = modifiedTime;
+        refresh             = true;
+        return true;
+    }
+
+    static void WriteCookedInfo(CookedAssetWriter& writer, const CookedAssetInfo& info)
+    {
+        writer.Write(info.Header);
+        for(uint32_t i = 0; i < info.Header.DependencyCount; i++)
+        {
+            writer.WriteString(info.DependencyPaths[i]);
+            writer.Write(info.Dependencies[i]);
+        }
+        writer.Align();
+    }
+
+    static bool ReadCookedInfo(CookedAssetReader& reader, CookedAssetInfo& info)
+    {
+        if(!reader.Read(info.Header) || info.Header.Magic != CookedAssetMagic || info.Header.Version != CookedAssetVersion)
+            return false;
+
+        info.DependencyPaths.Resize(info.Header.DependencyCount);
+        info.Dependencies.Resize(info.Header.DependencyCount);
+        for(uint32_t i = 0; i < info.Header.DependencyCount; i++)
+        {
+            reader.ReadString(info.DependencyPaths[i]);
+            reader.Read(info.Dependencies[i]);
+        }
+        reader.Align();
+
+        return reader.IsValid();
+    }
+
+    void CookedAssetWriter::Write(const void* data, uint64_t size)
+    {
+        if(size == 0)
+            return;
+
+        const uint64_t offset = (uint64_t)m_Data.Size();
+        if(offset + size > (uint64_t)m_Data.Capacity())
+            m_Data.Reserve(Maths::Max<size_t>(m_Data.Capacity() * 2, offset + size));
+
+        m_Data.Resize(offset + size);
+        MemoryCopy(m_Data.Data() + offset, data, size);
+    }
+
+    void CookedAssetWriter::WriteString(const std::string& value)
+    {
+        Write((uint32_t)value.size());
+        Write(value.data(), value.size());
+    }
+
+    void CookedAssetWriter::Align()
+    {
+        static const uint8_t padding[CookedAssetAlign] = {};
+        Write(padding, AlignCookedOffset(Size()) - Size());
+    }
+
+    const void* CookedAssetReader::Read(uint64_t size)
+    {
+        if(!m_Valid || size > m_Size - m_Offset)
+        {
+            m_Valid = false;
+            return nullptr;
+        }
+
+        const void* data = m_Data + m_Offset;
+        m_Offset += size;
+        return data;
+    }
+
+    bool CookedAssetReader::ReadString(std::string& value)
+    {
+        uint32_t length = 0;
+        if(!Read(length))
+            return false;
+
+        const char* data = ReadArray<char>(length);
+        if(!data)
+            return false;
+
+        value.assign(data, length);
+        return true;
+    }
+
+    void CookedAssetReader::Align()
+    {
+        const uint64_t aligned = AlignCookedOffset(m_Offset);
+        if(aligned > m_Size)
+            m_Valid = false;
+        else
+            m_Offset = aligned;
+    }
+
+    CookedAsset::~CookedAsset()
+    {
+        Release();
+    }
+
+    void CookedAsset::Release()
+    {
+        FileSystem::UnmapFile(m_Mapping, m_MappingSize);
+        m_Mapping     = nullptr;
+        m_MappingSize = 0;
+        m_Payload     = nullptr;
+        m_PayloadSize = 0;
+    }
+
+    void AssetCache::SetCacheFolder(const std::string& folder)
+    {
+        m_CacheFolder = folder;
+        if(!m_CacheFolder.empty())
+            FileSystem::CreateFolderIfDoesntExist(m_CacheFolder);
+    }
+
+    bool AssetCache::Load(const std::string& sourcePath, AssetType type, uint64_t settingsHash, CookedAsset& outAsset)
+    {
+        outAsset.Release();
+        if(!IsEnabled())
+            return false;
+
+        LUMOS_PROFILE_FUNCTION();
+        const std::string blobPath = GetBlobPath(sourcePath, type, settingsHash);
+
+        int64_t size  = 0;
+        uint8_t* data = FileSystem::MapFile(blobPath, size);
+        if(!data)
+        {
+            m_MissCount++;
+            return false;
+        }
+
+        CookedAssetInfo info;
+        CookedAssetReader reader(data, (uint64_t)size);
+        bool valid   = ReadCookedInfo(reader, info);
+        bool refresh = false;
+
+        valid = valid && info.Header.Type == (uint32_t)type && info.Header.SettingsHash == settingsHash;
+        valid = valid && info.Header.PayloadOffset + info.Header.PayloadSize <= (uint64_t)size;
+        valid = valid && CheckFileRecord(sourcePath, info.Header.Source, refresh);
+        for(uint32_t i = 0; valid && i < info.Header.DependencyCount; i++)
+            valid = CheckFileRecord(info.DependencyPaths[i], info.Dependencies[i], refresh);
+
+        if(!valid)
+        {
+            FileSystem::UnmapFile(data, size);
+            m_MissCount++;
+            return false;
+        }
+
+        if(refresh)
+        {
+            // Store the new times so the contents aren't hashed again on the next load. The header keeps its
+            // size, so only that part of the file is rewritten
+            FileSystem::UnmapFile(data, size);
+
+            CookedAssetWriter header;
+            WriteCookedInfo(header, info);
+            if(FILE* file = fopen(blobPath.c_str(), "r+b"))
+            {
+                fwrite(header.Data(), 1, (size_t)header.Size(), file);
+                fclose(file);
+            }
+
+            data = FileSystem::MapFile(blobPath, size);
+            if(!data || info.Header.PayloadOffset + info.Header.PayloadSize > (uint64_t)size)
+            {
+                FileSystem::UnmapFile(data, size);
+                m_MissCount++;
+                return false;
+            }
+        }
+
+        outAsset.m_Mapping     = data;
+        outAsset.m_MappingSize = size;
+        outAsset.m_Payload     = data + info.Header.PayloadOffset;
+        outAsset.m_PayloadSize = info.Header.PayloadSize;
+        m_HitCount++;
+        return true;
+    }
+
+    bool AssetCache::Store(const std::string& sourcePath, AssetType type, uint64_t settingsHash, const CookedAssetWriter& payload, const TDArray<std::string>* dependencies)
+    {
+        if(!IsEnabled())
+            return false;
+
+        LUMOS_PROFILE_FUNCTION();
+        CookedAssetInfo info;
+        info.Header.Magic           = CookedAssetMagic;
+        info.Header.Version         = CookedAssetVersion;
+        info.Header.Type            = (uint32_t)type;
+        info.Header.DependencyCount = dependencies ? (uint32_t)dependencies->Size() : 0;
+        info.Header.SettingsHash    = settingsHash;
+        info.Header.PayloadSize     = payload.Size();
+
+        if(!CreateFileRecord(sourcePath, info.Header.Source))
+            return false;
+
+        info.Dependencies.Resize(info.Header.DependencyCount);
+        for(uint32_t i = 0; i < info.Header.DependencyCount; i++)
+        {
+            info.DependencyPaths.PushBack((*dependencies)[i]);
+            if(!CreateFileRecord((*dependencies)[i], info.Dependencies[i]))
+                return false;
+        }
+
+        // Measure the header first, its size is part of it
+        {
+            CookedAssetWriter header;
+            WriteCookedInfo(header, info);
+            info.Header.PayloadOffset = header.Size();
+        }
+
+        CookedAssetWriter blob;
+        WriteCookedInfo(blob, info);
+        blob.Write(payload.Data(), payload.Size());
+
+        // Written aside and moved into place, so a reader on another thread never maps a partial blob
+        const std::string blobPath = GetBlobPath(sourcePath, type, settingsHash);
+        const std::string tempPath = blobPath + ".tmp" + std::to_string(m_TempIndex++);
+        if(!FileSystem::WriteFile(tempPath, (uint8_t*)blob.Data(), (uint32_t)blob.Size()))
+            return false;
+
+        if(std::rename(tempPath.c_str(), blobPath.c_str()) != 0)
+        {
+            // Windows won't rename over an existing file
+            std::remove(blobPath.c_str());
+            if(std::rename(tempPath.c_str(), blobPath.c_str()) != 0)
+            {
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void AssetCache::ResetStats()
+    {
+        m_HitCount  = 0;
+        m_MissCount = 0;
+    }
+
+    uint64_t AssetCache::Hash(const void* data, uint64_t size, uint64_t seed)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+        uint64_t hash        = seed;
+        for(uint64_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t AssetCache::Hash(const std::string& value, uint64_t seed)
+    {
+        return Hash(value.data(), value.size(), seed);
+    }
+
+    std::string AssetCache::GetBlobPath(const std::string& sourcePath, AssetType type, uint64_t settingsHash) const
+    {
+        uint64_t key = Hash(sourcePath);
+        key          = Hash(&type, sizeof(type), key);
+        key          = Hash(&settingsHash, sizeof(settingsHash), key);
+
+        char name[32];
+        snprintf(name, sizeof(name), "%016" PRIx64 ".lmca", key);
+        return m_CacheFolder + name;
+    }
+}
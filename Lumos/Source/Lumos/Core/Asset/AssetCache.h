@@ -0,0 +1,139 @@
+#pragma once
+#include "Asset.h"
+#include "Core/DataStructures/TDArray.h"
+#include "Utilities/TSingleton.h"
+#include <atomic>
+
+namespace Lumos
+{
+    // Builds the payload of a cooked asset. Values are copied in as raw bytes, so the reader can point straight
+    // into the mapped file
+    class CookedAssetWriter
+    {
+    public:
+        void Write(const void* data, uint64_t size);
+        void WriteString(const std::string& value);
+
+        template <typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Cooked data must be trivially copyable");
+            Write(&value, sizeof(T));
+        }
+
+        // Pads the payload so the next write starts on a 16 byte boundary
+        void Align();
+
+        const uint8_t* Data() const { return m_Data.Data(); }
+        uint64_t Size() const { return (uint64_t)m_Data.Size(); }
+
+    private:
+        TDArray<uint8_t> m_Data;
+    };
+
+    // Reads a payload written by CookedAssetWriter. Any read past the end fails and leaves the reader invalid
+    class CookedAssetReader
+    {
+    public:
+        CookedAssetReader(const uint8_t* data, uint64_t size)
+            : m_Data(data)
+            , m_Size(size)
+        {
+        }
+
+        const void* Read(uint64_t size);
+        bool ReadString(std::string& value);
+        void Align();
+
+        template <typename T>
+        bool Read(T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Cooked data must be trivially copyable");
+            const void* data = Read(sizeof(T));
+            if(data)
+                MemoryCopy(&value, data, sizeof(T));
+            return data != nullptr;
+        }
+
+        // Points into the payload. Only valid while the CookedAsset it came from is alive
+        template <typename T>
+        const T* ReadArray(uint64_t count)
+        {
+            return (const T*)Read(count * sizeof(T));
+        }
+
+        bool IsValid() const { return m_Valid; }
+
+    private:
+        const uint8_t* m_Data;
+        uint64_t m_Size;
+        uint64_t m_Offset = 0;
+        bool m_Valid      = true;
+    };
+
+    // A cooked blob mapped into memory. The payload stays valid until this is destroyed
+    class CookedAsset
+    {
+    public:
+        CookedAsset() = default;
+        ~CookedAsset();
+
+        CookedAsset(const CookedAsset&)            = delete;
+        CookedAsset& operator=(const CookedAsset&) = delete;
+
+        CookedAssetReader GetReader() const { return CookedAssetReader(m_Payload, m_PayloadSize); }
+        bool IsLoaded() const { return m_Mapping != nullptr; }
+
+    private:
+        friend class AssetCache;
+
+        void Release();
+
+        uint8_t* m_Mapping       = nullptr;
+        int64_t m_MappingSize    = 0;
+        const uint8_t* m_Payload = nullptr;
+        uint64_t m_PayloadSize   = 0;
+    };
+
+    // Cooked, ready to use copies of imported assets, kept in the project's AssetCache folder next to the asset
+    // registry. A blob is found by source path, asset type and import settings. It is only used while the source
+    // file and the dependencies stored with it are unchanged, so an edited source misses and the caller imports
+    // it again and stores the result over the stale blob.
+    // Load and Store can be called from any thread.
+    class AssetCache : public ThreadSafeSingleton<AssetCache>
+    {
+        friend class ThreadSafeSingleton<AssetCache>;
+
+    public:
+        // Empty disables the cache
+        void SetCacheFolder(const std::string& folder);
+        const std::string& GetCacheFolder() const { return m_CacheFolder; }
+
+        void SetEnabled(bool enabled) { m_Enabled = enabled; }
+        bool IsEnabled() const { return m_Enabled && !m_CacheFolder.empty(); }
+
+        // sourcePath is a physical path. Returns false if there is no up to date blob
+        bool Load(const std::string& sourcePath, AssetType type, uint64_t settingsHash, CookedAsset& outAsset);
+
+        // dependencies are other physical paths the cooked result was built from
+        bool Store(const std::string& sourcePath, AssetType type, uint64_t settingsHash, const CookedAssetWriter& payload, const TDArray<std::string>* dependencies = nullptr);
+
+        uint32_t GetHitCount() const { return m_HitCount.load(std::memory_order_relaxed); }
+        uint32_t GetMissCount() const { return m_MissCount.load(std::memory_order_relaxed); }
+        void ResetStats();
+
+        // FNV-1a. Stable across platforms, so blobs stay valid between builds
+        static uint64_t Hash(const void* data, uint64_t size, uint64_t seed = 14695981039346656037ull);
+        static uint64_t Hash(const std::string& value, uint64_t seed = 14695981039346656037ull);
+
+    private:
+        std::string GetBlobPath(const std::string& sourcePath, AssetType type, uint64_t settingsHash) const;
+
+        std::string m_CacheFolder;
+        bool m_Enabled = true;
+
+        std::atomic<uint32_t> m_HitCount  = 0;
+        std::atomic<uint32_t> m_MissCount = 0;
+        std::atomic<uint32_t> m_TempIndex = 0;
+    };
+}
@@ -3,21 +3,23 @@
 #include "AssetRegistry.h"
 #include "Core/Application.h"
 #include "Graphics/RHI/Texture.h"
-#include <future>
+#include "Core/OS/FileSystem.h"
+#include "Utilities/StringUtilities.h"
 #include <inttypes.h>
 
 namespace Lumos
 {
-    static std::vector<std::future<void>> m_Futures;
-
     AssetManager::AssetManager()
     {
         m_Arena         = ArenaAlloc(Megabytes(4));
         m_AssetRegistry = new AssetRegistry();
+        m_Streamer      = new AssetStreamer();
     }
 
     AssetManager::~AssetManager()
     {
+        // Joins the streaming threads before anything their requests point to goes away
+        delete m_Streamer;
         ArenaRelease(m_Arena);
         delete m_AssetRegistry;
     }
@@ -102,6 +104,7 @@ namespace Lumos
 
     void AssetManager::Update(float elapsedSeconds)
     {
+        m_Streamer->Update();
         m_AssetRegistry->Update(elapsedSeconds);
     }
 
@@ -133,41 +136,164 @@ namespace Lumos
         return true;
     }
 
-    static void LoadTexture2D(Graphics::Texture2D* tex, const std::string& path)
+    struct TextureStreamState
+    {
+        ImageLoadDesc LoadDesc = {};
+        std::string FilePath;
+    };
+
+    static void DecodeTexture2D(ImageLoadDesc& imageLoadDesc, const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
-        ImageLoadDesc imageLoadDesc = {};
-        imageLoadDesc.filePath      = path.c_str();
-        imageLoadDesc.maxHeight     = 256;
-        imageLoadDesc.maxWidth      = 256;
+        imageLoadDesc.filePath  = path.c_str();
+        imageLoadDesc.maxHeight = 256;
+        imageLoadDesc.maxWidth  = 256;
         Lumos::LoadImageFromFile(imageLoadDesc);
+    }
 
+    static void UploadTexture2D(Graphics::Texture2D* tex, const ImageLoadDesc& imageLoadDesc)
+    {
+        LUMOS_PROFILE_FUNCTION();
         Graphics::TextureDesc desc;
         desc.format = imageLoadDesc.outBits / 4 == 8 ? Graphics::RHIFormat::R8G8B8A8_Unorm : Graphics::RHIFormat::R32G32B32A32_Float;
-
-        Application::Get().SubmitToMainThread([tex, imageLoadDesc, desc]()
-                                              { tex->Load(imageLoadDesc.outWidth, imageLoadDesc.outHeight, imageLoadDesc.outPixels, desc); });
+        tex->Load(imageLoadDesc.outWidth, imageLoadDesc.outHeight, imageLoadDesc.outPixels, desc);
     }
 
-    bool AssetManager::LoadTexture(const std::string& filePath, SharedPtr<Graphics::Texture2D>& texture, bool thread)
+    bool AssetManager::LoadTexture(const std::string& filePath, SharedPtr<Graphics::Texture2D>& texture, bool thread, AssetStreamPriority priority)
     {
         texture = SharedPtr<Graphics::Texture2D>(Graphics::Texture2D::Create({}, 1, 1));
-        if(thread)
-            m_Futures.push_back(std::async(std::launch::async, &LoadTexture2D, texture.get(), filePath));
-        else
-            LoadTexture2D(texture.get(), filePath);
-
         AddAsset(filePath, texture);
+
+        if(!thread)
+        {
+            ImageLoadDesc imageLoadDesc = {};
+            DecodeTexture2D(imageLoadDesc, filePath);
+            UploadTexture2D(texture.get(), imageLoadDesc);
+            return true;
+        }
+
+        SharedPtr<TextureStreamState> state = CreateSharedPtr<TextureStreamState>();
+        state->FilePath                     = filePath;
+        Graphics::Texture2D* tex            = texture.get();
+        texture->SetFlag(AssetFlag::UnLoaded);
+
+        AssetStreamRequest request;
+        request.Load = [state]()
+        {
+            DecodeTexture2D(state->LoadDesc, state->FilePath);
+            return state->LoadDesc.outPixels != nullptr;
+        };
+        request.Upload = [tex, state](bool success)
+        {
+            tex->SetFlag(AssetFlag::UnLoaded, false);
+            if(!success)
+            {
+                LWARN("Failed to stream texture %s", state->FilePath.c_str());
+                tex->SetFlag(AssetFlag::Missing);
+                return;
+            }
+
+            UploadTexture2D(tex, state->LoadDesc);
+            tex->SetFlag(AssetFlag::Loaded);
+        };
+        request.Cancelled = [this, tex, state]()
+        {
+            delete[] state->LoadDesc.outPixels;
+
+            // Forget the placeholder so the next request for this file loads it again
+            UUID ID;
+            if(m_AssetRegistry->GetID(state->FilePath, ID) && m_AssetRegistry->Contains(ID) && (*m_AssetRegistry)[ID].data.get() == tex)
+                m_AssetRegistry->Remove(ID);
+        };
+
+        // The registry entry and the request itself
+        request.Target          = texture;
+        request.OwnerReferences = 2;
+
+        m_Streamer->Submit(Move(request), priority);
         return true;
     }
 
-    SharedPtr<Graphics::Texture2D> AssetManager::LoadTextureAsset(const std::string& filePath, bool thread)
+    SharedPtr<Graphics::Texture2D> AssetManager::LoadTextureAsset(const std::string& filePath, bool thread, AssetStreamPriority priority)
     {
         SharedPtr<Graphics::Texture2D> texture;
-        LoadTexture(filePath, texture, thread);
+        LoadTexture(filePath, texture, thread, priority);
         return texture;
     }
 
+    struct AssetStreamState
+    {
+        std::string FilePath;
+        std::string PhysicalPath;
+        AssetType Type;
+        SharedPtr<Asset> Result;
+    };
+
+    AssetStreamID AssetManager::LoadAssetAsync(const std::string& filePath, AssetType type, AssetStreamPriority priority)
+    {
+        auto pending = m_PendingLoads.find(filePath);
+        if(pending != m_PendingLoads.end())
+        {
+            m_Streamer->SetPriority(pending->second, priority);
+            return pending->second;
+        }
+
+        SharedPtr<AssetStreamState> state = CreateSharedPtr<AssetStreamState>();
+        state->FilePath                   = filePath;
+        state->Type                       = type;
+
+        if(type == AssetType::Audio && !FileSystem::Get().ResolvePhysicalPath(filePath, state->PhysicalPath))
+        {
+            LWARN("Failed to resolve path %s", filePath.c_str());
+            return 0;
+        }
+
+        AssetStreamRequest request;
+        request.Load = [state]()
+        {
+            LUMOS_PROFILE_SCOPE("AssetManager::LoadAssetAsync::Load");
+
+            // Models and fonts are parsed and their meshes, textures and atlas built here, only the GPU
+            // resources are left for Upload. Decoding and filling the OpenAL buffer are both safe off the main thread
+            if(state->Type == AssetType::Model)
+                state->Result = CreateSharedPtr<Graphics::Model>(state->FilePath, false);
+            else if(state->Type == AssetType::Font)
+                state->Result = CreateSharedPtr<Graphics::Font>(state->FilePath, false);
+            else if(state->Type == AssetType::Audio)
+                state->Result = Sound::Create(state->PhysicalPath, StringUtilities::GetFilePathExtension(state->FilePath));
+            else
+                return true;
+
+            return state->Result != nullptr;
+        };
+        request.Upload = [this, state](bool success)
+        {
+            LUMOS_PROFILE_SCOPE("AssetManager::LoadAssetAsync::Upload");
+            m_PendingLoads.erase(state->FilePath);
+
+            if(success && state->Type == AssetType::Model)
+                state->Result.As<Graphics::Model>()->CreateResources();
+            else if(success && state->Type == AssetType::Font)
+                state->Result.As<Graphics::Font>()->CreateAtlas();
+
+            if(!success || !state->Result)
+            {
+                LWARN("Failed to stream asset %s", state->FilePath.c_str());
+                return;
+            }
+
+            AddAsset(state->FilePath, state->Result);
+        };
+        request.Cancelled = [this, state]()
+        {
+            m_PendingLoads.erase(state->FilePath);
+        };
+
+        AssetStreamID ID         = m_Streamer->Submit(Move(request), priority);
+        m_PendingLoads[filePath] = ID;
+        return ID;
+    }
+
     static std::mutex s_AssetRegistryMutex;
 
     AssetMetaData& AssetRegistry::operator[](UUID handle)
@@ -9,6 +9,7 @@
 #include "Utilities/CombineHash.h"
 #include "Asset.h"
 #include "AssetMetaData.h"
+#include "AssetStreamer.h"
 
 namespace Lumos
 {
@@ -39,14 +40,23 @@ namespace Lumos
         bool LoadAsset(const std::string& filePath, SharedPtr<Graphics::Shader>& shader, bool keepUnreferenced = true);
 
         SharedPtr<Asset> operator[](UUID name) { return GetAsset(name); }
-        SharedPtr<Graphics::Texture2D> LoadTextureAsset(const std::string& filePath, bool thread);
+        // With thread set, returns a 1x1 placeholder that is filled in once the image has streamed in. The load
+        // is dropped if every reference to the placeholder is released first
+        SharedPtr<Graphics::Texture2D> LoadTextureAsset(const std::string& filePath, bool thread, AssetStreamPriority priority = AssetStreamPriority::Normal);
+
+        // Streams a Model, Font or Audio asset. It is added to the registry once loaded, check with AssetExists.
+        // Requesting a file that is already pending returns the same request. Returns 0 if the path can't be resolved
+        AssetStreamID LoadAssetAsync(const std::string& filePath, AssetType type, AssetStreamPriority priority = AssetStreamPriority::Normal);
 
         AssetRegistry* GetAssetRegistry() { return m_AssetRegistry; }
+        AssetStreamer* GetStreamer() { return m_Streamer; }
 
     protected:
-        bool LoadTexture(const std::string& filePath, SharedPtr<Graphics::Texture2D>& texture, bool thread);
+        bool LoadTexture(const std::string& filePath, SharedPtr<Graphics::Texture2D>& texture, bool thread, AssetStreamPriority priority);
 
         Arena* m_Arena;
         AssetRegistry* m_AssetRegistry;
+        AssetStreamer* m_Streamer;
+        std::unordered_map<std::string, AssetStreamID> m_PendingLoads;
     };
 }
@@ -0,0 +1,312 @@
+#include "Precompiled.h"
+#include "AssetStreamer.h"
+#include "Core/String.h"
+#include "Maths/MathsUtilities.h"
+#include "Utilities/Timer.h"
+
+namespace Lumos
+{
+    AssetStreamer::AssetStreamer(uint32_t threadCount)
+    {
+        threadCount = Maths::Max(1u, threadCount);
+        m_Threads.Reserve(threadCount);
+        for(uint32_t i = 0; i < threadCount; i++)
+            m_Threads.EmplaceBack([this, i]
+                                  { WorkerLoop(i); });
+    }
+
+    AssetStreamer::~AssetStreamer()
+    {
+        {
+            std::scoped_lock<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_WakeCondition.notify_all();
+
+        for(std::thread& thread : m_Threads)
+        {
+            if(thread.joinable())
+                thread.join();
+        }
+
+        // Callbacks are not run on shutdown, whatever they refer to may already be gone
+        for(StreamRequest* request : m_Requests)
+            delete request;
+    }
+
+    AssetStreamID AssetStreamer::Submit(AssetStreamRequest&& request, AssetStreamPriority priority)
+    {
+        StreamRequest* streamRequest = new StreamRequest();
+        streamRequest->Request       = Move(request);
+        streamRequest->ID            = m_NextID++;
+        streamRequest->Priority      = priority;
+        streamRequest->State         = RequestState::Queued;
+        streamRequest->Success       = false;
+        streamRequest->Cancelled     = false;
+
+        if(m_NextID == 0)
+            m_NextID = 1;
+
+        m_Requests.PushBack(streamRequest);
+        {
+            std::scoped_lock<std::mutex> lock(m_Mutex);
+            m_Queues[(uint32_t)priority].Requests.PushBack(streamRequest);
+        }
+        m_WakeCondition.notify_one();
+
+        return streamRequest->ID;
+    }
+
+    void AssetStreamer::Cancel(AssetStreamID id)
+    {
+        if(StreamRequest* request = FindRequest(id))
+            CancelRequest(request);
+    }
+
+    void AssetStreamer::CancelRequest(StreamRequest* request)
+    {
+        if(request->Cancelled)
+            return;
+
+        bool queued;
+        {
+            std::scoped_lock<std::mutex> lock(m_Mutex);
+            queued = request->State == RequestState::Queued;
+            if(queued)
+                RemoveFromQueue(request);
+        }
+
+        // A request a thread has already taken is released once it comes back
+        request->Cancelled = true;
+        if(queued)
+            Release(request, true);
+    }
+
+    void AssetStreamer::SetPriority(AssetStreamID id, AssetStreamPriority priority)
+    {
+        StreamRequest* request = FindRequest(id);
+        if(!request || request->Priority == priority)
+            return;
+
+        std::scoped_lock<std::mutex> lock(m_Mutex);
+        if(request->State == RequestState::Queued)
+        {
+            RemoveFromQueue(request);
+            m_Queues[(uint32_t)priority].Requests.PushBack(request);
+        }
+
+        // Also orders the uploads
+        request->Priority = priority;
+    }
+
+    bool AssetStreamer::IsPending(AssetStreamID id) const
+    {
+        return FindRequest(id) != nullptr;
+    }
+
+    void AssetStreamer::Update()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        {
+            std::scoped_lock<std::mutex> lock(m_Mutex);
+            for(StreamRequest* request : m_Loaded)
+                m_Uploads.PushBack(request);
+            m_Loaded.Clear();
+        }
+
+        // Nothing outside of the asset system wants these any more
+        for(int32_t i = (int32_t)m_Requests.Size() - 1; i >= 0; i--)
+        {
+            StreamRequest* request         = m_Requests[i];
+            const SharedPtr<Asset>& target = request->Request.Target;
+            if(!request->Cancelled && target && target.GetCounter()->GetReferenceCount() <= (int)request->Request.OwnerReferences)
+                CancelRequest(request);
+        }
+
+        RunUploads(true);
+    }
+
+    void AssetStreamer::Flush()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        while(!m_Requests.Empty())
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_IdleCondition.wait(lock, [this]
+                                     { return !m_Loaded.Empty() || (m_LoadingCount == 0 && !HasQueued()); });
+
+                for(StreamRequest* request : m_Loaded)
+                    m_Uploads.PushBack(request);
+                m_Loaded.Clear();
+            }
+
+            RunUploads(false);
+        }
+    }
+
+    void AssetStreamer::WorkerLoop(uint32_t threadIndex)
+    {
+        ThreadContext& threadContext = *GetThreadContext();
+        threadContext                = ThreadContextAlloc();
+        String8 name                 = PushStr8F(threadContext.ScratchArenas[0], "AssetStreamer_%u", threadIndex);
+        LUMOS_PROFILE_SETTHREADNAME((const char*)name.str);
+        SetThreadName(name);
+
+        while(true)
+        {
+            StreamRequest* request = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WakeCondition.wait(lock, [this, &request]
+                                     {
+                                         if(!m_Running)
+                                             return true;
+                                         request = PopQueued();
+                                         return request != nullptr; });
+
+                if(!m_Running)
+                    break;
+
+                request->State = RequestState::Loading;
+                m_LoadingCount++;
+            }
+
+            const bool success = request->Request.Load ? request->Request.Load() : true;
+
+            {
+                std::scoped_lock<std::mutex> lock(m_Mutex);
+                request->Success = success;
+                request->State   = RequestState::Loaded;
+                m_Loaded.PushBack(request);
+                m_LoadingCount--;
+            }
+            m_IdleCondition.notify_all();
+        }
+
+        ThreadContextRelease(&threadContext);
+    }
+
+    AssetStreamer::StreamRequest* AssetStreamer::PopQueued()
+    {
+        for(int32_t priority = (int32_t)AssetStreamPriority::Count - 1; priority >= 0; priority--)
+        {
+            RequestQueue& queue = m_Queues[priority];
+            if(queue.Head == (uint32_t)queue.Requests.Size())
+                continue;
+
+            StreamRequest* request = queue.Requests[queue.Head++];
+
+            // Drop the consumed prefix once it dominates the queue
+            if(queue.Head == (uint32_t)queue.Requests.Size())
+            {
+                queue.Requests.Clear();
+                queue.Head = 0;
+            }
+            else if(queue.Head >= (uint32_t)queue.Requests.Size() / 2)
+            {
+                const uint32_t count = (uint32_t)queue.Requests.Size();
+                for(uint32_t i = queue.Head; i < count; i++)
+                    queue.Requests[i - queue.Head] = queue.Requests[i];
+                queue.Requests.Resize(count - queue.Head);
+                queue.Head = 0;
+            }
+
+            return request;
+        }
+
+        return nullptr;
+    }
+
+    bool AssetStreamer::HasQueued() const
+    {
+        for(const RequestQueue& queue : m_Queues)
+        {
+            if(queue.Head < (uint32_t)queue.Requests.Size())
+                return true;
+        }
+
+        return false;
+    }
+
+    AssetStreamer::StreamRequest* AssetStreamer::FindRequest(AssetStreamID id) const
+    {
+        for(StreamRequest* request : m_Requests)
+        {
+            if(request->ID == id)
+                return request;
+        }
+
+        return nullptr;
+    }
+
+    void AssetStreamer::RemoveFromQueue(StreamRequest* request)
+    {
+        // Only search past Head, the consumed prefix can hold stale pointers
+        RequestQueue& queue  = m_Queues[(uint32_t)request->Priority];
+        const uint32_t count = (uint32_t)queue.Requests.Size();
+        for(uint32_t i = queue.Head; i < count; i++)
+        {
+            if(queue.Requests[i] != request)
+                continue;
+
+            for(uint32_t j = i + 1; j < count; j++)
+                queue.Requests[j - 1] = queue.Requests[j];
+            queue.Requests.PopBack();
+            return;
+        }
+    }
+
+    void AssetStreamer::Release(StreamRequest* request, bool cancelled)
+    {
+        if(cancelled && request->Request.Cancelled)
+            request->Request.Cancelled();
+
+        m_Requests.RemoveIf([request](StreamRequest* other)
+                            { return other == request; });
+        delete request;
+    }
+
+    void AssetStreamer::RunUploads(bool budgeted)
+    {
+        if(m_Uploads.Empty())
+            return;
+
+        LUMOS_PROFILE_FUNCTION();
+
+        // Highest priority first, arrival order within a priority
+        StreamRequest** uploads = m_Uploads.Data();
+        std::stable_sort(uploads, uploads + m_Uploads.Size(), [](const StreamRequest* a, const StreamRequest* b)
+                         { return a->Priority > b->Priority; });
+
+        const TimeStamp start = Timer::Now();
+        uint32_t remaining    = 0;
+        bool budgetSpent      = false;
+        for(uint32_t i = 0; i < (uint32_t)m_Uploads.Size(); i++)
+        {
+            StreamRequest* request = m_Uploads[i];
+            if(request->Cancelled)
+            {
+                Release(request, true);
+                continue;
+            }
+
+            if(budgetSpent)
+            {
+                m_Uploads[remaining++] = request;
+                continue;
+            }
+
+            if(request->Request.Upload)
+                request->Request.Upload(request->Success);
+            Release(request, false);
+
+            // At least one upload runs every frame, so a large asset cannot block the queue
+            budgetSpent = budgeted && Timer::Duration(start, Timer::Now(), 1000.0f) > m_UploadBudget;
+        }
+
+        m_Uploads.Resize(remaining);
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "Asset.h"
+#include "Core/Function.h"
+#include "Core/DataStructures/TDArray.h"
+#include <condition_variable>
+#include <mutex>
+
+namespace Lumos
+{
+    enum class AssetStreamPriority : uint8_t
+    {
+        Background = 0,
+        Normal,
+        Visible,
+        Count
+    };
+
+    typedef uint32_t AssetStreamID; // 0 is never a valid request
+
+    struct AssetStreamRequest
+    {
+        // Runs on a streaming thread. File IO and decoding only, nothing that touches the graphics API
+        Function<bool()> Load;
+
+        // Runs on the main thread after Load, within the per frame upload budget. Gets the result of Load
+        Function<void(bool)> Upload;
+
+        // Runs on the main thread if the request is dropped before Upload
+        Function<void()> Cancelled;
+
+        // Placeholder handed out to the caller, optional. The request is cancelled once Target has no more
+        // than OwnerReferences references left, which are the ones held by the asset system itself
+        SharedPtr<Asset> Target;
+        uint32_t OwnerReferences = 0;
+    };
+
+    // Loads assets on a small fixed pool of threads. Requests are taken highest priority first, oldest first
+    // within a priority. Once loaded, their main thread stage runs from Update until the frame's upload budget
+    // is spent, so a bulk load is spread over several frames instead of stalling one.
+    // Submit, Cancel, SetPriority and Update must be called from the main thread.
+    class AssetStreamer
+    {
+    public:
+        explicit AssetStreamer(uint32_t threadCount = 2);
+        ~AssetStreamer();
+
+        AssetStreamID Submit(AssetStreamRequest&& request, AssetStreamPriority priority = AssetStreamPriority::Normal);
+
+        // Drops the request. If its Load is already running the result is discarded
+        void Cancel(AssetStreamID id);
+
+        // Requests that have started loading keep their place
+        void SetPriority(AssetStreamID id, AssetStreamPriority priority);
+
+        // Call once per frame. Cancels requests that lost their references and runs uploads
+        void Update();
+
+        // Waits for every request and uploads all of them, ignoring the budget
+        void Flush();
+
+        void SetUploadBudget(float milliseconds) { m_UploadBudget = milliseconds; }
+        float GetUploadBudget() const { return m_UploadBudget; }
+
+        uint32_t GetPendingCount() const { return (uint32_t)m_Requests.Size(); }
+        bool IsPending(AssetStreamID id) const;
+
+    private:
+        enum class RequestState : uint8_t
+        {
+            Queued,
+            Loading,
+            Loaded
+        };
+
+        struct StreamRequest
+        {
+            AssetStreamRequest Request;
+            AssetStreamID ID;
+            AssetStreamPriority Priority;
+            RequestState State;
+            bool Success;
+            bool Cancelled;
+        };
+
+        // FIFO per priority. Taking a request advances Head
+        struct RequestQueue
+        {
+            TDArray<StreamRequest*> Requests;
+            uint32_t Head = 0;
+        };
+
+        void WorkerLoop(uint32_t threadIndex);
+        void CancelRequest(StreamRequest* request);
+        StreamRequest* PopQueued();
+        bool HasQueued() const;
+        StreamRequest* FindRequest(AssetStreamID id) const;
+        void RemoveFromQueue(StreamRequest* request);
+        void Release(StreamRequest* request, bool cancelled);
+        void RunUploads(bool budgeted);
+
+        // Every request in flight, owned by the main thread
+        TDArray<StreamRequest*> m_Requests;
+        AssetStreamID m_NextID = 1;
+
+        // Guarded by m_Mutex
+        RequestQueue m_Queues[(uint32_t)AssetStreamPriority::Count];
+        TDArray<StreamRequest*> m_Loaded;
+        uint32_t m_LoadingCount = 0;
+        bool m_Running          = true;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_WakeCondition;
+        std::condition_variable m_IdleCondition;
+        TDArray<std::thread> m_Threads;
+
+        TDArray<StreamRequest*> m_Uploads; // Loaded requests waiting for the main thread, main thread only
+        float m_UploadBudget = 2.0f;       // Milliseconds per frame
+    };
+}
@@ -99,7 +99,7 @@ namespace Lumos
     HashMapClearRaw((HashMapRaw*)(MAP), HashMapElemSize(MAP))
 
 #define HashMapDeinit(MAP) \
-    HashMapDeinitRaw((HashMapRaw*)(MAP), HashMapElemSize(MAP))
+    HashMapDeinitRaw((HashMapRaw*)(MAP))
 
 #define ForHashMapEach(K, V, MAP, IT)                    \
     struct Concat(_dummy_, __LINE__)                     \
@@ -122,7 +122,7 @@ namespace Lumos
 
     static inline void HashMapInitRaw(HashMapRaw* map)
     {
-        HashMapRaw empty = { 0 };
+        HashMapRaw empty = {};
         *map             = empty;
     }
 
@@ -139,7 +139,7 @@ namespace Lumos
             delete[] map->data;
         }
 
-        HashMapRaw empty = { 0 };
+        HashMapRaw empty = {};
         *map             = empty;
     }
 
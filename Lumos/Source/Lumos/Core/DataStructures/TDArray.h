@@ -134,9 +134,9 @@ namespace Lumos
 
     template <class T>
     TDArray<T>::TDArray(const TDArray<T>& other)
-        : m_Arena(other.m_Arena)
-        , m_Size(0)
+        : m_Size(0)
         , m_Capacity(0)
+        , m_Arena(other.m_Arena)
     {
         CopyElements(other);
     }
@@ -64,7 +64,7 @@ namespace Lumos
 
         ~Function() { ExecuteOperation(FunctionErasedOperation::Destruct, nullptr); }
 
-        Function(Function&& other)
+        Function(Function&& other) noexcept
         {
             functionStub      = other.functionStub;
             functionOperation = other.functionOperation;
@@ -7,7 +7,6 @@
 #include <atomic>
 #include <thread>
 #include <condition_variable>
-#include <deque>
 #include <mutex>
 #ifdef LUMOS_PLATFORM_WINDOWS
 #define NOMINMAX
@@ -62,38 +61,126 @@ namespace Lumos
 
         namespace JobSystem
         {
-            struct Job
+            static const int64_t MaxJobsPerQueue   = 4096;
+            static const uint32_t MaxTasksPerQueue = 1024;
+
+            // Storage for one Execute/Dispatch call. The function is copied once and shared by all of its groups.
+            struct JobTask
             {
-                Context* ctx;
                 Function<void(JobDispatchArgs)> task;
-                uint32_t groupID;
-                uint32_t groupJobOffset;
-                uint32_t groupJobEnd;
+                Context* ctx;
+                uint32_t jobCount;
+                uint32_t groupSize;
                 uint32_t sharedmemory_size;
+                std::atomic<uint32_t> pendingGroups { 0 };
+                std::atomic_bool inUse { false };
+
+                // Called once every group has finished, before the context is signalled
+                void (*onComplete)(void* userData, uint32_t userIndex) = nullptr;
+                void* onCompleteData                                   = nullptr;
+                uint32_t onCompleteIndex                               = 0;
+            };
+
+            // One group of a task
+            struct Job
+            {
+                JobTask* task;
+                uint32_t groupID;
             };
 
+            // Fixed capacity Chase-Lev work stealing deque.
+            //    Push and Pop may only be called by the owning thread, Steal can be called from any thread.
             struct JobQueue
             {
-                std::deque<Job> queue;
-                std::mutex locker;
+                static const int64_t Mask = MaxJobsPerQueue - 1;
 
-                inline void push_back(const Job& item)
+                alignas(64) std::atomic<int64_t> top { 0 };
+                alignas(64) std::atomic<int64_t> bottom { 0 };
+                std::atomic<JobTask*> slotTasks[MaxJobsPerQueue];
+                std::atomic<uint32_t> slotGroups[MaxJobsPerQueue];
+
+                inline bool Push(const Job& job)
                 {
-                    std::scoped_lock lock(locker);
-                    queue.push_back(item);
+                    int64_t b = bottom.load(std::memory_order_relaxed);
+                    int64_t t = top.load(std::memory_order_acquire);
+                    if(b - t >= MaxJobsPerQueue)
+                        return false;
+
+                    slotTasks[b & Mask].store(job.task, std::memory_order_relaxed);
+                    slotGroups[b & Mask].store(job.groupID, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                    return true;
                 }
 
-                inline bool pop_front(Job& item)
+                inline bool Pop(Job& job)
                 {
-                    std::scoped_lock lock(locker);
-                    if(queue.empty())
+                    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+                    bottom.store(b, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    int64_t t = top.load(std::memory_order_relaxed);
+
+                    if(t > b)
                     {
+                        bottom.store(b + 1, std::memory_order_relaxed);
                         return false;
                     }
-                    item = Move(queue.front());
-                    queue.pop_front();
+
+                    job.task    = slotTasks[b & Mask].load(std::memory_order_relaxed);
+                    job.groupID = slotGroups[b & Mask].load(std::memory_order_relaxed);
+
+                    if(t == b)
+                    {
+                        // Last job in the queue, race any thieves for it
+                        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                        bottom.store(b + 1, std::memory_order_relaxed);
+                        return won;
+                    }
+
                     return true;
                 }
+
+                inline bool Steal(Job& job)
+                {
+                    int64_t t = top.load(std::memory_order_acquire);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    int64_t b = bottom.load(std::memory_order_acquire);
+
+                    if(t >= b)
+                        return false;
+
+                    job.task    = slotTasks[t & Mask].load(std::memory_order_relaxed);
+                    job.groupID = slotGroups[t & Mask].load(std::memory_order_relaxed);
+                    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                }
+
+                // Owner only. Thieves only ever free up space, so this many pushes are guaranteed to succeed
+                inline int64_t FreeSpace() const
+                {
+                    return MaxJobsPerQueue - (bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_acquire));
+                }
+            };
+
+            struct WorkerQueue
+            {
+                JobQueue jobs;
+                JobTask tasks[MaxTasksPerQueue];
+                uint32_t nextTask = 0;
+
+                // Only called by the owning thread. Returns nullptr if every task slot is still in flight
+                inline JobTask* AllocateTask()
+                {
+                    for(uint32_t i = 0; i < MaxTasksPerQueue; ++i)
+                    {
+                        JobTask* task = &tasks[nextTask++ % MaxTasksPerQueue];
+                        if(!task->inUse.load(std::memory_order_acquire))
+                        {
+                            task->inUse.store(true, std::memory_order_relaxed);
+                            return task;
+                        }
+                    }
+                    return nullptr;
+                }
             };
 
             // This structure is responsible to stop worker thread loops.
@@ -102,11 +189,14 @@ namespace Lumos
             {
                 uint32_t numCores   = 0;
                 uint32_t numThreads = 0;
-                JobQueue* jobQueuePerThread;
+
+                // One queue per worker thread, plus a shared queue at index numThreads for all other threads.
+                //    The owner side of the shared queue is serialised with externalLock.
+                WorkerQueue* queues = nullptr;
+                SpinLock externalLock;
                 std::atomic_bool alive { true };
                 std::condition_variable wakeCondition;
                 std::mutex wakeMutex;
-                std::atomic<uint32_t> nextQueue { 0 };
                 TDArray<std::thread> threads;
 
                 ~InternalState()
@@ -143,47 +233,116 @@ namespace Lumos
                         waker.join();
                 #endif
                     
-                    delete[] jobQueuePerThread;
+                    delete[] queues;
                 }
             };
             static InternalState* internal_state = nullptr;
 
-            // Start working on a job queue
-            //    After the job queue is finished, it can switch to an other queue and steal jobs from there
-            inline void work(uint32_t startingQueue)
+            // Index of the queue owned by this thread. Threads outside the job system share the external queue
+            static thread_local uint32_t t_QueueIndex = UINT32_MAX;
+            static thread_local uint32_t t_RandomState = 0;
+
+            inline uint32_t GetQueueIndex()
             {
-                LUMOS_PROFILE_FUNCTION_LOW();
-                Job job;
-                for(uint32_t i = 0; i < internal_state->numThreads; ++i)
+                return t_QueueIndex < internal_state->numThreads ? t_QueueIndex : internal_state->numThreads;
+            }
+
+            inline uint32_t NextRandom()
+            {
+                if(t_RandomState == 0)
+                    t_RandomState = (uint32_t)(IntFromPtr(&t_RandomState) >> 4) | 1u;
+
+                // xorshift32
+                t_RandomState ^= t_RandomState << 13;
+                t_RandomState ^= t_RandomState >> 17;
+                t_RandomState ^= t_RandomState << 5;
+                return t_RandomState;
+            }
+
+            inline void ExecuteJob(const Job& job)
+            {
+                JobTask* task = job.task;
+
+                JobDispatchArgs args;
+                args.groupID = job.groupID;
+                if(task->sharedmemory_size > 0)
                 {
-                    JobQueue& job_queue = internal_state->jobQueuePerThread[startingQueue % internal_state->numThreads];
-                    while(job_queue.pop_front(job))
-                    {
-                        JobDispatchArgs args;
-                        args.groupID = job.groupID;
-                        if(job.sharedmemory_size > 0)
-                        {
-                            thread_local static TDArray<uint8_t> shared_allocation_data;
-                            shared_allocation_data.Reserve(job.sharedmemory_size);
-                            args.sharedmemory = shared_allocation_data.Data();
-                        }
-                        else
-                        {
-                            args.sharedmemory = nullptr;
-                        }
+                    thread_local static TDArray<uint8_t> shared_allocation_data;
+                    shared_allocation_data.Reserve(task->sharedmemory_size);
+                    args.sharedmemory = shared_allocation_data.Data();
+                }
+                else
+                {
+                    args.sharedmemory = nullptr;
+                }
 
-                        for(uint32_t j = job.groupJobOffset; j < job.groupJobEnd; ++j)
-                        {
-                            args.jobIndex          = j;
-                            args.groupIndex        = j - job.groupJobOffset;
-                            args.isFirstJobInGroup = (j == job.groupJobOffset);
-                            args.isLastJobInGroup  = (j == job.groupJobEnd - 1);
-                            job.task(args);
-                        }
+                const uint32_t groupJobOffset = job.groupID * task->groupSize;
+                const uint32_t groupJobEnd    = Maths::Min(groupJobOffset + task->groupSize, task->jobCount);
+                for(uint32_t j = groupJobOffset; j < groupJobEnd; ++j)
+                {
+                    args.jobIndex          = j;
+                    args.groupIndex        = j - groupJobOffset;
+                    args.isFirstJobInGroup = (j == groupJobOffset);
+                    args.isLastJobInGroup  = (j == groupJobEnd - 1);
+                    task->task(args);
+                }
 
-                        job.ctx->counter.fetch_sub(1);
-                    }
-                    startingQueue++; // go to next queue
+                Context* ctx = task->ctx;
+                if(task->pendingGroups.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    auto onComplete          = task->onComplete;
+                    void* onCompleteData     = task->onCompleteData;
+                    uint32_t onCompleteIndex = task->onCompleteIndex;
+
+                    // Last group of the task, release captures and hand the slot back to its owner
+                    task->task = Function<void(JobDispatchArgs)>();
+                    task->inUse.store(false, std::memory_order_release);
+
+                    if(onComplete)
+                        onComplete(onCompleteData, onCompleteIndex);
+                }
+
+                ctx->counter.fetch_sub(1);
+            }
+
+            // Pop from this thread's own queue, otherwise try to steal from a random victim
+            inline bool FindJob(uint32_t queueIndex, Job& job)
+            {
+                const uint32_t queueCount = internal_state->numThreads + 1;
+                WorkerQueue& ownQueue     = internal_state->queues[queueIndex];
+
+                if(queueIndex == internal_state->numThreads)
+                {
+                    internal_state->externalLock.lock();
+                    bool found = ownQueue.jobs.Pop(job);
+                    internal_state->externalLock.unlock();
+                    if(found)
+                        return true;
+                }
+                else if(ownQueue.jobs.Pop(job))
+                {
+                    return true;
+                }
+
+                const uint32_t firstVictim = NextRandom() % queueCount;
+                for(uint32_t i = 0; i < queueCount; ++i)
+                {
+                    const uint32_t victim = (firstVictim + i) % queueCount;
+                    if(victim != queueIndex && internal_state->queues[victim].jobs.Steal(job))
+                        return true;
+                }
+
+                return false;
+            }
+
+            // Execute jobs until this thread's queue is empty and nothing could be stolen
+            inline void work(uint32_t queueIndex)
+            {
+                LUMOS_PROFILE_FUNCTION_LOW();
+                Job job;
+                while(FindJob(queueIndex, job))
+                {
+                    ExecuteJob(job);
                 }
             }
 
@@ -204,13 +363,14 @@ namespace Lumos
                 internal_state->numThreads = Lumos::Maths::Max(1u, internal_state->numCores - reservedThreads);
 
                 // Keep one for update thread
-                internal_state->jobQueuePerThread = new JobQueue[internal_state->numThreads];
+                internal_state->queues = new WorkerQueue[internal_state->numThreads + 1];
                 internal_state->threads.Reserve(internal_state->numThreads);
 
                 for(uint32_t threadID = 0; threadID < internal_state->numThreads; ++threadID)
                 {
                     std::thread& worker = internal_state->threads.EmplaceBack([threadID]
                                                                               {
+                                t_QueueIndex = threadID;
                                 ThreadContext& threadContext = *GetThreadContext();
                                 threadContext = ThreadContextAlloc();
                                 String8 name = PushStr8F(threadContext.ScratchArenas[0], "JobSystem_%u", threadID);
@@ -296,53 +456,132 @@ namespace Lumos
                 return internal_state->numThreads;
             }
 
+            uint32_t GetThreadIndex()
+            {
+                return GetQueueIndex();
+            }
+
+            static bool DispatchInternal(Context& ctx, uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task, size_t sharedmemory_size,
+                                         void (*onComplete)(void*, uint32_t), void* onCompleteData, uint32_t onCompleteIndex, bool canWait = true);
+
             void Execute(Context& ctx, const Function<void(JobDispatchArgs)>& task)
             {
                 LUMOS_PROFILE_FUNCTION_LOW();
-                // Context state is updated:
-                ctx.counter.fetch_add(1);
+                Dispatch(ctx, 1, 1, task);
+            }
 
+            void Dispatch(Context& ctx, uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task, size_t sharedmemory_size)
+            {
+                LUMOS_PROFILE_FUNCTION_LOW();
+                DispatchInternal(ctx, jobCount, groupSize, task, sharedmemory_size, nullptr, nullptr, 0);
+            }
+
+            bool TryDispatch(Context& ctx, uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task)
+            {
+                LUMOS_PROFILE_FUNCTION_LOW();
+                return DispatchInternal(ctx, jobCount, groupSize, task, 0, nullptr, nullptr, 0, false);
+            }
+
+            // Back-pressure for a dispatch that can't queue its work yet. Executes the oldest job waiting in any queue, the
+            //    one a worker would take next, so new work never runs ahead of work queued before it
+            static void HelpWithOldestJob()
+            {
+                internal_state->wakeCondition.notify_all();
+
+                const uint32_t queueCount = internal_state->numThreads + 1;
+                const uint32_t queueIndex = GetQueueIndex();
                 Job job;
-                job.ctx               = &ctx;
-                job.task              = task;
-                job.groupID           = 0;
-                job.groupJobOffset    = 0;
-                job.groupJobEnd       = 1;
-                job.sharedmemory_size = 0;
+                for(uint32_t i = 0; i < queueCount; ++i)
+                {
+                    if(internal_state->queues[(queueIndex + i) % queueCount].jobs.Steal(job))
+                    {
+                        ExecuteJob(job);
+                        return;
+                    }
+                }
 
-                internal_state->jobQueuePerThread[internal_state->nextQueue.fetch_add(1) % internal_state->numThreads].push_back(job);
-                internal_state->wakeCondition.notify_one();
+                // Everything queued is already executing on other threads
+                std::this_thread::yield();
             }
 
-            void Dispatch(Context& ctx, uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task, size_t sharedmemory_size)
+            static bool DispatchInternal(Context& ctx, uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task, size_t sharedmemory_size,
+                                         void (*onComplete)(void*, uint32_t), void* onCompleteData, uint32_t onCompleteIndex, bool canWait)
             {
-                LUMOS_PROFILE_FUNCTION_LOW();
                 if(jobCount == 0 || groupSize == 0)
                 {
-                    return;
+                    if(onComplete)
+                        onComplete(onCompleteData, onCompleteIndex);
+                    return true;
                 }
 
                 const uint32_t groupCount = DispatchGroupCount(jobCount, groupSize);
 
+                const uint32_t queueIndex = GetQueueIndex();
+                const bool externalQueue  = queueIndex == internal_state->numThreads;
+                WorkerQueue& queue        = internal_state->queues[queueIndex];
+
+                // Every task slot is in flight: help with queued jobs until one is handed back
+                JobTask* jobTask = nullptr;
+                while(true)
+                {
+                    if(externalQueue)
+                        internal_state->externalLock.lock();
+
+                    if(canWait || queue.jobs.FreeSpace() >= (int64_t)groupCount)
+                        jobTask = queue.AllocateTask();
+
+                    if(jobTask)
+                        break;
+
+                    if(externalQueue)
+                        internal_state->externalLock.unlock();
+
+                    if(!canWait)
+                        return false;
+
+                    HelpWithOldestJob();
+                }
+
                 // Context state is updated:
                 ctx.counter.fetch_add(groupCount);
 
-                Job job;
-                job.ctx               = &ctx;
-                job.task              = task;
-                job.sharedmemory_size = (uint32_t)sharedmemory_size;
-
-                for(uint32_t groupID = 0; groupID < groupCount; ++groupID)
+                jobTask->task              = task;
+                jobTask->ctx               = &ctx;
+                jobTask->jobCount          = jobCount;
+                jobTask->groupSize         = groupSize;
+                jobTask->sharedmemory_size = (uint32_t)sharedmemory_size;
+                jobTask->onComplete        = onComplete;
+                jobTask->onCompleteData    = onCompleteData;
+                jobTask->onCompleteIndex   = onCompleteIndex;
+                jobTask->pendingGroups.store(groupCount, std::memory_order_relaxed);
+
+                uint32_t pushedGroups = 0;
+                while(true)
                 {
-                    // For each group, generate one real job:
-                    job.groupID        = groupID;
-                    job.groupJobOffset = groupID * groupSize;
-                    job.groupJobEnd    = std::min(job.groupJobOffset + groupSize, jobCount);
+                    while(pushedGroups < groupCount && queue.jobs.Push({ jobTask, pushedGroups }))
+                    {
+                        ++pushedGroups;
+                    }
+
+                    if(externalQueue)
+                        internal_state->externalLock.unlock();
 
-                    internal_state->jobQueuePerThread[internal_state->nextQueue.fetch_add(1) % internal_state->numThreads].push_back(job);
+                    if(pushedGroups == groupCount)
+                        break;
+
+                    // The queue is full, help with queued jobs until there is room for the remaining groups
+                    HelpWithOldestJob();
+
+                    if(externalQueue)
+                        internal_state->externalLock.lock();
                 }
 
-                internal_state->wakeCondition.notify_one();
+                if(groupCount > 1)
+                    internal_state->wakeCondition.notify_all();
+                else
+                    internal_state->wakeCondition.notify_one();
+
+                return true;
             }
 
             uint32_t DispatchGroupCount(uint32_t jobCount, uint32_t groupSize)
@@ -357,26 +596,197 @@ namespace Lumos
                 return ctx.counter.load() > 0;
             }
 
+            // Help out with any jobs that are standing by, from this thread's queue or stolen from others, until done returns true
+            template <typename Predicate>
+            inline void HelpUntil(Predicate done)
+            {
+                if(done())
+                    return;
+
+                // Wake any threads that might be sleeping:
+                internal_state->wakeCondition.notify_all();
+
+                const uint32_t queueIndex = GetQueueIndex();
+                Job job;
+                while(!done())
+                {
+                    if(FindJob(queueIndex, job))
+                    {
+                        ExecuteJob(job);
+                    }
+                    else
+                    {
+                        // Remaining jobs are currently executing on other threads.
+                        //    Allow to swap out this thread by OS to not spin endlessly for nothing
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
             void Wait(const Context& ctx)
             {
                 LUMOS_PROFILE_FUNCTION_LOW();
-                if(IsBusy(ctx))
+                HelpUntil([&ctx]()
+                          { return !IsBusy(ctx); });
+            }
+
+            TaskGraph::~TaskGraph()
+            {
+                delete[] m_NodeStates;
+            }
+
+            uint32_t TaskGraph::AddTask(const Function<void(JobDispatchArgs)>& task)
+            {
+                return AddDispatch(1, 1, task);
+            }
+
+            uint32_t TaskGraph::AddDispatch(uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task)
+            {
+                Node& node     = m_Nodes.emplace_back();
+                node.task      = task;
+                node.jobCount  = jobCount;
+                node.groupSize = groupSize;
+                return (uint32_t)m_Nodes.size() - 1;
+            }
+
+            void TaskGraph::AddDependency(uint32_t before, uint32_t node)
+            {
+                ASSERT(before < m_Nodes.size() && node < m_Nodes.size() && before != node);
+                m_Nodes[before].successors.PushBack(node);
+                m_Nodes[node].predecessorCount++;
+            }
+
+            void TaskGraph::AddDependency(const Context& ctx, uint32_t node)
+            {
+                ASSERT(node < m_Nodes.size());
+                m_Nodes[node].contextDependencies.PushBack(&ctx);
+            }
+
+            void TaskGraph::Run(Context& ctx)
+            {
+                LUMOS_PROFILE_FUNCTION_LOW();
+                const uint32_t nodeCount = (uint32_t)m_Nodes.size();
+                if(nodeCount == 0)
+                    return;
+
+#ifdef LUMOS_ENABLE_ASSERTS
+                // A node in a cycle never starts, and a node waiting on the graph's own context waits on itself.
+                //    Either way ctx would never become idle
+                ASSERT(!HasCycle(), "TaskGraph has a dependency cycle");
+                for(const Node& graphNode : m_Nodes)
                 {
-                    // Wake any threads that might be sleeping:
-                    internal_state->wakeCondition.notify_all();
+                    for(const Context* dependency : graphNode.contextDependencies)
+                        ASSERT(dependency != &ctx, "TaskGraph node waits on the context it runs in");
+                }
+#endif
+
+                if(m_StateCapacity < nodeCount)
+                {
+                    delete[] m_NodeStates;
+                    m_NodeStates    = new NodeState[nodeCount];
+                    m_StateCapacity = nodeCount;
+                }
+
+                m_Context = &ctx;
+
+                // Each node holds the context busy until its successors have been released
+                ctx.counter.fetch_add(nodeCount);
+
+                for(uint32_t i = 0; i < nodeCount; ++i)
+                {
+                    m_NodeStates[i].pendingPredecessors.store(m_Nodes[i].predecessorCount, std::memory_order_relaxed);
+                    m_NodeStates[i].finished.store(false, std::memory_order_relaxed);
+                }
+
+                for(uint32_t i = 0; i < nodeCount; ++i)
+                {
+                    if(m_Nodes[i].predecessorCount == 0)
+                        SubmitNode(i);
+                }
+            }
+
+            void TaskGraph::Wait(uint32_t node) const
+            {
+                LUMOS_PROFILE_FUNCTION_LOW();
+                ASSERT(m_Context && node < m_Nodes.size());
+                HelpUntil([this, node]()
+                          { return IsFinished(node); });
+            }
+
+            bool TaskGraph::IsFinished(uint32_t node) const
+            {
+                return m_NodeStates[node].finished.load(std::memory_order_acquire);
+            }
+
+            void TaskGraph::Clear()
+            {
+                m_Nodes.clear();
+                m_Context = nullptr;
+            }
 
-                    // work() will pick up any jobs that are on stand by and execute them on this thread:
-                    work(internal_state->nextQueue.fetch_add(1) % internal_state->numThreads);
+            bool TaskGraph::HasCycle() const
+            {
+                // Kahn's algorithm, every node is reached only if there's no cycle
+                const uint32_t nodeCount = (uint32_t)m_Nodes.size();
+                TDArray<uint32_t> pending(nodeCount);
+                TDArray<uint32_t> ready;
+                ready.Reserve(nodeCount);
+                for(uint32_t i = 0; i < nodeCount; ++i)
+                {
+                    pending[i] = m_Nodes[i].predecessorCount;
+                    if(pending[i] == 0)
+                        ready.PushBack(i);
+                }
+
+                uint32_t visited = 0;
+                while(!ready.Empty())
+                {
+                    const uint32_t node = ready.Back();
+                    ready.PopBack();
+                    visited++;
 
-                    while(IsBusy(ctx))
+                    for(uint32_t successor : m_Nodes[node].successors)
                     {
-                        // If we are here, then there are still remaining jobs that work() couldn't pick up.
-                        //    In this case those jobs are not standing by on a queue but currently executing
-                        //    on other threads, so they cannot be picked up by this thread.
-                        //    Allow to swap out this thread by OS to not spin endlessly for nothing
-                        std::this_thread::yield();
+                        if(--pending[successor] == 0)
+                            ready.PushBack(successor);
                     }
                 }
+
+                return visited != nodeCount;
+            }
+
+            void TaskGraph::SubmitNode(uint32_t node)
+            {
+                if(m_Nodes[node].contextDependencies.Empty())
+                {
+                    LaunchNode(node);
+                    return;
+                }
+
+                Execute(*m_Context, [this, node](JobDispatchArgs /*args*/)
+                        {
+                            for(const Context* dependency : m_Nodes[node].contextDependencies)
+                                JobSystem::Wait(*dependency);
+                            LaunchNode(node); });
+            }
+
+            void TaskGraph::LaunchNode(uint32_t node)
+            {
+                const Node& graphNode = m_Nodes[node];
+                DispatchInternal(*m_Context, graphNode.jobCount, graphNode.groupSize, graphNode.task, 0, &TaskGraph::OnNodeFinished, this, node);
+            }
+
+            void TaskGraph::OnNodeFinished(void* userData, uint32_t node)
+            {
+                TaskGraph* graph = static_cast<TaskGraph*>(userData);
+                graph->m_NodeStates[node].finished.store(true, std::memory_order_release);
+                for(uint32_t successor : graph->m_Nodes[node].successors)
+                {
+                    if(graph->m_NodeStates[successor].pendingPredecessors.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        graph->SubmitNode(successor);
+                }
+
+                graph->m_Context->counter.fetch_sub(1);
             }
         }
     }
@@ -1,5 +1,8 @@
 #pragma once
 #include "Core/Function.h"
+#include "Core/DataStructures/TDArray.h"
+#include <vector>
+#include <atomic>
 
 struct JobDispatchArgs
 {
@@ -22,6 +25,9 @@ namespace Lumos
 
             uint32_t GetThreadCount();
 
+            // Index of the calling thread in [0, GetThreadCount()]. Threads outside the job system all share GetThreadCount()
+            uint32_t GetThreadIndex();
+
             struct Context
             {
                 std::atomic<uint32_t> counter { 0 };
@@ -34,8 +40,14 @@ namespace Lumos
             //	jobCount	: how many jobs to generate for this task.
             //	groupSize	: how many jobs to execute per thread. Jobs inside a group execute serially. It might be worth to increase for small jobs
             //	func		: receives a JobDispatchArgs as parameter
+            //	If this thread's queue is full, the calling thread executes the oldest queued jobs until there is room
             void Dispatch(Context& ctx, uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task, size_t sharedmemory_size = 0);
 
+            // Like Dispatch, but never executes a job on the calling thread. Returns false, having dispatched nothing,
+            //    if this thread's queue can't take every group, for callers that must not take on other jobs (e.g. they
+            //    wait on jobs that spin on the caller)
+            bool TryDispatch(Context& ctx, uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task);
+
             uint32_t DispatchGroupCount(uint32_t jobCount, uint32_t groupSize);
 
             // Check if any threads are working currently or not
@@ -43,6 +55,67 @@ namespace Lumos
 
             // Wait until all threads become idle
             void Wait(const Context& ctx);
+
+            // Jobs with dependency edges between them. A node is submitted by the thread that finishes its last
+            //    predecessor, so nothing blocks between stages. The graph must stay alive and unmodified until
+            //    the context passed to Run is no longer busy.
+            class TaskGraph
+            {
+            public:
+                TaskGraph() = default;
+                ~TaskGraph();
+
+                // Add a single job, returns the node index used to add dependencies
+                uint32_t AddTask(const Function<void(JobDispatchArgs)>& task);
+
+                // Add a node that behaves like Dispatch. The node finishes once all of its jobs have finished
+                uint32_t AddDispatch(uint32_t jobCount, uint32_t groupSize, const Function<void(JobDispatchArgs)>& task);
+
+                // node will not start until before has finished
+                void AddDependency(uint32_t before, uint32_t node);
+
+                // node will not start until ctx is no longer busy. The thread waiting on ctx executes other jobs meanwhile.
+                //    ctx can't be the context the graph is run with
+                void AddDependency(const Context& ctx, uint32_t node);
+
+                // Submit every node without predecessors. ctx is busy until every node has finished
+                void Run(Context& ctx);
+
+                // Wait until one node of a running graph has finished, executing other jobs meanwhile
+                void Wait(uint32_t node) const;
+                bool IsFinished(uint32_t node) const;
+
+                void Clear();
+                uint32_t GetNodeCount() const { return (uint32_t)m_Nodes.size(); }
+
+            private:
+                struct Node
+                {
+                    Function<void(JobDispatchArgs)> task;
+                    uint32_t jobCount         = 1;
+                    uint32_t groupSize        = 1;
+                    uint32_t predecessorCount = 0;
+                    TDArray<uint32_t> successors;
+                    TDArray<const Context*> contextDependencies;
+                };
+
+                struct NodeState
+                {
+                    std::atomic<uint32_t> pendingPredecessors { 0 };
+                    std::atomic<bool> finished { false };
+                };
+
+                bool HasCycle() const;
+                void SubmitNode(uint32_t node);
+                void LaunchNode(uint32_t node);
+                static void OnNodeFinished(void* graph, uint32_t node);
+
+                // Nodes own captures and arrays, so they live in a std::vector rather than a TDArray, which zeroes cleared elements
+                std::vector<Node> m_Nodes;
+                NodeState* m_NodeStates  = nullptr;
+                uint32_t m_StateCapacity = 0;
+                Context* m_Context       = nullptr;
+            };
         }
     }
 }
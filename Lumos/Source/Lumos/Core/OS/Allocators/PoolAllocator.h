@@ -18,7 +18,7 @@ namespace Lumos
             if(!arena)
             {
                 m_ArenaOwned = true;
-                m_Arena      = ArenaAlloc((uint64_t)((float)poolSize * 1.1f));
+                m_Arena      = ArenaAlloc(poolSize);
             }
 
             ASSERT(m_Arena, "Arena not allocated");
@@ -32,13 +32,7 @@ namespace Lumos
 
         ~PoolAllocator()
         {
-            while(m_HeadPool)
-            {
-                Node* nextPool    = m_HeadPool->next;
-                m_Arena->Position = reinterpret_cast<uint64_t>(m_HeadPool);
-                m_HeadPool        = nextPool;
-            }
-
+            // Pools pushed into a shared arena are reclaimed when that arena is cleared or released
             if(m_ArenaOwned)
                 ArenaRelease(m_Arena);
         }
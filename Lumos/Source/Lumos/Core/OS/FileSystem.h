@@ -39,6 +39,11 @@ namespace Lumos
         static bool FolderExists(const std::string& path);
         static void CreateFolderIfDoesntExist(const std::string& path);
         static int64_t GetFileSize(const std::string& path);
+        static uint64_t GetFileModifiedTime(const std::string& path);
+
+        // Maps the whole file read only. Returns nullptr if it can't be opened or is empty
+        static uint8_t* MapFile(const std::string& path, int64_t& outSize);
+        static void UnmapFile(uint8_t* data, int64_t size);
 
         static uint8_t* ReadFile(const std::string& path);
         static bool ReadFile(const std::string& path, void* buffer, int64_t size = -1);
@@ -1,8 +1,21 @@
 #include "Precompiled.h"
 #include "Memory.h"
 
+#ifdef LUMOS_PLATFORM_WINDOWS
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 namespace Lumos
 {
+    static const uint64_t ARENA_HEADER_SIZE     = sizeof(Arena);
+    static const uint64_t ARENA_DEFAULT_RESERVE = Megabytes(64ull);
+    static const uint64_t ARENA_COMMIT_SIZE     = Kilobytes(64ull);
+
+    static_assert(sizeof(Arena) == 128, "Arena header should stay a multiple of the cache line size");
+
 #ifndef LUMOS_PRODUCTION
     static Arena* s_Arenas[256]; // For Stats
     static int s_CurrentArenaCount = 0;
@@ -75,22 +88,91 @@ namespace Lumos
     }
 
     // Arenas
-    Arena* ArenaAlloc(uint64_t size)
+    static uint64_t AlignPow2(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    static void* ReserveMemory(uint64_t size)
+    {
+#ifdef LUMOS_PLATFORM_WINDOWS
+        return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+        void* result = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return result == MAP_FAILED ? nullptr : result;
+#endif
+    }
+
+    static bool CommitMemory(void* ptr, uint64_t size)
+    {
+#ifdef LUMOS_PLATFORM_WINDOWS
+        return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+    }
+
+    static void ReleaseMemory(void* ptr, uint64_t size)
+    {
+#ifdef LUMOS_PLATFORM_WINDOWS
+        VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+        munmap(ptr, size);
+#endif
+    }
+
+    static Arena* ArenaAllocBlock(uint64_t size)
+    {
+        const uint64_t minimumSize = size + ARENA_HEADER_SIZE;
+        const uint64_t reserveSize = AlignPow2(minimumSize > ARENA_DEFAULT_RESERVE ? minimumSize : ARENA_DEFAULT_RESERVE, ARENA_COMMIT_SIZE);
+        const uint64_t commitSize  = ARENA_COMMIT_SIZE;
+
+        void* memory = ReserveMemory(reserveSize);
+        if(!memory || !CommitMemory(memory, commitSize))
+        {
+            if(memory)
+                ReleaseMemory(memory, reserveSize);
+            ASSERT(false, "Failed to reserve arena memory");
+            return nullptr;
+        }
+
+        Arena* block          = (Arena*)memory;
+        block->Prev           = nullptr;
+        block->Current        = block;
+        block->BasePosition   = 0;
+        block->Position       = ARENA_HEADER_SIZE;
+        block->CommitPosition = commitSize;
+        block->Size           = reserveSize;
+        block->Align          = alignof(std::max_align_t);
+        block->HighWaterMark  = ARENA_HEADER_SIZE;
+        block->Chain          = false;
+
+#if defined(LUMOS_PROFILE) && defined(TRACY_ENABLE) && LUMOS_TRACK_MEMORY
+        TracyAlloc(block, reserveSize);
+#endif
+        return block;
+    }
+
+    static void ArenaReleaseBlock(Arena* block)
     {
-        Arena* arena          = (Arena*)malloc(sizeof(Arena) + size);
-        arena->Position       = sizeof(Arena);
-        arena->CommitPosition = sizeof(Arena);
-        arena->Align          = alignof(std::max_align_t);
-        arena->Size           = size;
-        arena->Ptr            = arena;
+#if defined(LUMOS_PROFILE) && defined(TRACY_ENABLE) && LUMOS_TRACK_MEMORY
+        TracyFree(block);
+#endif
+        ReleaseMemory(block, block->Size);
+    }
+
+    Arena* ArenaAlloc(uint64_t size, bool chain)
+    {
+        Arena* arena = ArenaAllocBlock(size);
+        if(!arena)
+            return nullptr;
+
+        arena->Chain = chain;
 
 #ifndef LUMOS_PRODUCTION
         if(s_CurrentArenaCount < 256)
             s_Arenas[s_CurrentArenaCount++] = arena;
 #endif
-#if defined(LUMOS_PROFILE) && defined(TRACY_ENABLE) && LUMOS_TRACK_MEMORY
-        TracyAlloc(arena, size);
-#endif
 
         return arena;
     }
@@ -105,31 +187,84 @@ namespace Lumos
         if(arena)
         {
 #ifndef LUMOS_PRODUCTION
-            s_CurrentArenaCount--;
+            for(int i = 0; i < s_CurrentArenaCount; i++)
+            {
+                if(s_Arenas[i] == arena)
+                {
+                    s_Arenas[i] = s_Arenas[--s_CurrentArenaCount];
+                    break;
+                }
+            }
 #endif
-            free(arena);
+            Arena* block = arena->Current;
+            while(block)
+            {
+                Arena* prev = block->Prev;
+                ArenaReleaseBlock(block);
+                block = prev;
+            }
+        }
+    }
 
-#if defined(LUMOS_PROFILE) && defined(TRACY_ENABLE) && LUMOS_TRACK_MEMORY
-            TracyFree(arena);
-#endif
+    // Chains a new block able to hold size bytes onto the arena and makes it current
+    static Arena* ArenaChainBlock(Arena* arena, uint64_t size)
+    {
+        if(!arena->Chain)
+        {
+            ASSERT(false, "Not enough space in the arena");
+            return nullptr;
         }
+
+        Arena* block    = arena->Current;
+        Arena* newBlock = ArenaAllocBlock(size);
+        if(!newBlock)
+            return nullptr;
+
+        newBlock->Prev         = block;
+        newBlock->BasePosition = block->BasePosition + block->Size;
+        arena->Current         = newBlock;
+        return newBlock;
+    }
+
+    // Moves the position of block, which must have room for size bytes, committing memory as needed
+    static void* ArenaAdvance(Arena* arena, Arena* block, uint64_t size)
+    {
+        const uint64_t newPos = block->Position + size;
+        if(newPos > block->CommitPosition)
+        {
+            uint64_t commitPos = AlignPow2(newPos, ARENA_COMMIT_SIZE);
+            if(commitPos > block->Size)
+                commitPos = block->Size;
+            if(!CommitMemory((uint8_t*)block + block->CommitPosition, commitPos - block->CommitPosition))
+            {
+                ASSERT(false, "Failed to commit arena memory");
+                return nullptr;
+            }
+            block->CommitPosition = commitPos;
+        }
+
+        void* ptr       = (uint8_t*)block + block->Position;
+        block->Position = newPos;
+
+        if(block->BasePosition + newPos > arena->HighWaterMark)
+            arena->HighWaterMark = block->BasePosition + newPos;
+        return ptr;
     }
 
     void* ArenaPushNoZero(Arena* arena, uint64_t size)
     {
         ASSERT(arena != nullptr);
-        uint64_t alignedSize = (size + arena->Align - 1) & ~(arena->Align - 1);
-        uint64_t newPos      = arena->Position + alignedSize;
+        uint64_t alignedSize = AlignPow2(size, arena->Align);
+        Arena* block         = arena->Current;
 
-        if(newPos > arena->Size)
+        if(block->Position + alignedSize > block->Size)
         {
-            ASSERT(false, "Not enough space in the arena");
-            return nullptr;
+            block = ArenaChainBlock(arena, alignedSize);
+            if(!block)
+                return nullptr;
         }
 
-        void* ptr       = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(arena->Ptr) + arena->Position);
-        arena->Position = newPos;
-        return ptr;
+        return ArenaAdvance(arena, block, alignedSize);
     }
 
     void* ArenaPushAligner(Arena* arena, uint64_t alignment)
@@ -137,20 +272,23 @@ namespace Lumos
         ASSERT(arena != nullptr);
         ASSERT((alignment & (alignment - 1)) == 0); // Ensure alignment is a power of 2
 
-        uint64_t currentAddr      = reinterpret_cast<uintptr_t>(arena->Ptr) + arena->Position;
-        uint64_t alignedAddr      = (currentAddr + alignment - 1) & ~(alignment - 1);
-        uint64_t alignmentPadding = alignedAddr - currentAddr;
-        uint64_t newPos           = arena->Position + alignmentPadding;
+        Arena* block         = arena->Current;
+        uint64_t currentAddr = reinterpret_cast<uintptr_t>(block) + block->Position;
+        uint64_t padding     = AlignPow2(currentAddr, alignment) - currentAddr;
 
-        if(newPos > arena->Size)
+        if(block->Position + padding > block->Size)
         {
-            ASSERT(false, "Not enough space in the arena");
-            return nullptr; // Not enough space in the arena
+            // Align the start of a new block instead
+            block = ArenaChainBlock(arena, alignment);
+            if(!block)
+                return nullptr;
+
+            currentAddr = reinterpret_cast<uintptr_t>(block) + block->Position;
+            padding     = AlignPow2(currentAddr, alignment) - currentAddr;
         }
 
-        void* ptr       = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(arena->Ptr) + newPos);
-        arena->Position = newPos;
-        return ptr;
+        uint8_t* ptr = (uint8_t*)ArenaAdvance(arena, block, padding);
+        return ptr ? ptr + padding : nullptr;
     }
 
     void* ArenaPush(Arena* arena, uint64_t size)
@@ -166,8 +304,23 @@ namespace Lumos
     void ArenaPopTo(Arena* arena, uint64_t pos)
     {
         ASSERT(arena != nullptr);
-        ASSERT(pos <= arena->Position);
-        arena->Position = pos;
+        if(pos < ARENA_HEADER_SIZE)
+            pos = ARENA_HEADER_SIZE;
+        ASSERT(pos <= ArenaPos(arena));
+
+        // Release chained blocks that don't reach past their header at the new position. A position inside
+        // a block's header, or the unused end of the block before it, is the end of the previous block
+        Arena* block = arena->Current;
+        while(block->Prev && pos < block->BasePosition + ARENA_HEADER_SIZE)
+        {
+            Arena* prev = block->Prev;
+            ArenaReleaseBlock(block);
+            block = prev;
+        }
+
+        const uint64_t blockPos = pos - block->BasePosition;
+        arena->Current          = block;
+        block->Position         = blockPos < block->Position ? blockPos : block->Position;
     }
 
     void ArenaSetAutoAlign(Arena* arena, uint64_t align)
@@ -179,26 +332,53 @@ namespace Lumos
     void ArenaPop(Arena* arena, uint64_t size)
     {
         ASSERT(arena != nullptr);
-        ASSERT(size <= arena->Position);
-        arena->Position -= size;
+
+        // Pushes never straddle blocks, so count the bytes back block by block, skipping the header of each
+        // chained block and the unused end of the one before it
+        Arena* block = arena->Current;
+        while(block->Prev && size > block->Position - ARENA_HEADER_SIZE)
+        {
+            size -= block->Position - ARENA_HEADER_SIZE;
+            block = block->Prev;
+        }
+
+        const uint64_t used = block->Position - ARENA_HEADER_SIZE;
+        ASSERT(size <= used);
+        ArenaPopTo(arena, block->BasePosition + block->Position - (size < used ? size : used));
     }
 
     void ArenaClear(Arena* arena)
     {
-        ASSERT(arena != nullptr);
-        arena->Position = sizeof(Arena);
+        ArenaPopTo(arena, 0);
     }
 
     uint64_t ArenaPos(Arena* arena)
     {
         ASSERT(arena != nullptr);
-        return arena->Position;
+        Arena* block = arena->Current;
+        return block->BasePosition + block->Position;
+    }
+
+    ArenaStats ArenaGetStats(Arena* arena)
+    {
+        ASSERT(arena != nullptr);
+        ArenaStats stats    = {};
+        stats.Used          = ArenaPos(arena);
+        stats.HighWaterMark = arena->HighWaterMark;
+
+        for(Arena* block = arena->Current; block; block = block->Prev)
+        {
+            stats.Committed += block->CommitPosition;
+            stats.Reserved += block->Size;
+            stats.BlockCount++;
+        }
+        return stats;
     }
 
     ArenaTemp ArenaTempBegin(Arena* arena)
     {
         ASSERT(arena != nullptr);
-        return { arena, arena->Position };
+        return { arena, ArenaPos(arena) };
     }
 
     void ArenaTempEnd(ArenaTemp temp)
@@ -13,14 +13,30 @@ namespace Lumos
         static void DeleteFunc(void* p);
     };
 
+    // Arenas reserve address space up front and commit pages as they are pushed into, so resident memory
+    // follows actual use. When a reservation runs out a new block is chained on, unless the arena was
+    // created with chaining disabled. The Arena* handed out is the first block and owns the chain.
     struct Arena
     {
-        uint64_t Position;
-        uint64_t CommitPosition;
+        Arena* Prev;             // Previous block in the chain
+        Arena* Current;          // Block pushes go to, only valid on the first block
+        uint64_t BasePosition;   // Position of this block within the whole chain
+        uint64_t Position;       // Relative to this block, starts after the header
+        uint64_t CommitPosition; // Bytes of this block backed by memory
+        uint64_t Size;           // Bytes of address space reserved for this block
         uint64_t Align;
-        uint64_t Size;
-        Arena* Ptr;
-        uint64_t _unused_[3];
+        uint64_t HighWaterMark; // Highest position reached over the arena's lifetime
+        bool Chain;
+        uint8_t _unused_[63];
+    };
+
+    struct ArenaStats
+    {
+        uint64_t Used;
+        uint64_t Committed;
+        uint64_t Reserved;
+        uint64_t HighWaterMark;
+        uint32_t BlockCount;
     };
 
     struct ArenaTemp
@@ -32,7 +48,8 @@ namespace Lumos
     int GetArenaCount();
     Arena* GetArena(int index);
 
-    Arena* ArenaAlloc(uint64_t size);
+    // size is the minimum reservation. Nothing beyond the header is committed until it is used
+    Arena* ArenaAlloc(uint64_t size, bool chain = true);
     Arena* ArenaAllocDefault();
     void ArenaRelease(Arena* arena);
     void* ArenaPushNoZero(Arena* arena, uint64_t size);
@@ -43,6 +60,7 @@ namespace Lumos
     void ArenaPop(Arena* arena, uint64_t size);
     void ArenaClear(Arena* arena);
     uint64_t ArenaPos(Arena* arena);
+    ArenaStats ArenaGetStats(Arena* arena);
     ArenaTemp ArenaTempBegin(Arena* arena);
     void ArenaTempEnd(ArenaTemp temp);
 
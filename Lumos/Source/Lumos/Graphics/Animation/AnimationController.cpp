@@ -5,14 +5,18 @@
 #include "Graphics/Renderers/DebugRenderer.h"
 #include "Graphics/RHI/DescriptorSet.h"
 #include "Graphics/RHI/Shader.h"
+#include "Core/Buffer.h"
 #include "Core/Application.h"
 #include "Core/Asset/AssetManager.h"
 #include "Maths/MathsUtilities.h"
 
 #include <ozz/animation/runtime/animation.h>
+#include <ozz/animation/runtime/blending_job.h>
 #include <ozz/animation/runtime/sampling_job.h>
 #include <ozz/animation/runtime/skeleton.h>
+#include <ozz/animation/runtime/skeleton_utils.h>
 #include <ozz/base/containers/vector.h>
+#include <ozz/base/maths/simd_math.h>
 #include <ozz/base/maths/soa_transform.h>
 #include <ozz/base/memory/unique_ptr.h>
 
@@ -32,42 +36,129 @@ namespace Lumos
 {
     namespace Graphics
     {
+        static const size_t InvalidState = ~(size_t)0;
+
+        // Blend weights per SoA joint. SimdFloat4 loses its alignment attribute as a template argument, so they
+        // live in an aligned allocation instead of an ozz::vector
+        class JointWeightArray
+        {
+        public:
+            using Span = decltype(ozz::animation::BlendingJob::Layer::joint_weights);
+
+            JointWeightArray() = default;
+            ~JointWeightArray() { Memory::AlignedFree(m_Data); }
+
+            JointWeightArray(const JointWeightArray&)            = delete;
+            JointWeightArray& operator=(const JointWeightArray&) = delete;
+
+            void Resize(uint32_t count, ozz::math::SimdFloat4 value)
+            {
+                if(count > m_Capacity)
+                {
+                    Memory::AlignedFree(m_Data);
+                    m_Data     = (ozz::math::SimdFloat4*)Memory::AlignedAlloc(count * sizeof(ozz::math::SimdFloat4), 16);
+                    m_Capacity = count;
+                }
+
+                m_Count = count;
+                for(uint32_t i = 0; i < count; i++)
+                    m_Data[i] = value;
+            }
+
+            void Clear() { m_Count = 0; }
+            bool Empty() const { return m_Count == 0; }
+
+            ozz::math::SimdFloat4& operator[](uint32_t index) { return m_Data[index]; }
+            const ozz::math::SimdFloat4& operator[](uint32_t index) const { return m_Data[index]; }
+            Span GetSpan() const { return Span(m_Data, m_Count); }
+
+        private:
+            ozz::math::SimdFloat4* m_Data = nullptr;
+            uint32_t m_Count              = 0;
+            uint32_t m_Capacity           = 0;
+        };
+
+        struct AnimationLayer
+        {
+            std::string Name;
+            AnimationBlendMode Mode = AnimationBlendMode::Override;
+            float Weight            = 1.0f;
+
+            size_t State = 0;
+            float Time   = 0.0f;
+
+            // State being faded out
+            size_t PreviousState = InvalidState;
+            float PreviousTime   = 0.0f;
+            float FadeTime       = 0.0f;
+            float FadeDuration   = 0.0f;
+
+            std::string MaskRoot;
+            bool MaskDirty = false;
+            JointWeightArray JointWeights; // Empty covers every joint
+
+            // Two slots so a crossfade keeps the outgoing state's cache warm. Current is the slot of State
+            ozz::animation::SamplingJob::Context Contexts[2];
+            ozz::vector<ozz::math::SoaTransform> Locals[2];
+            uint32_t Current = 0;
+        };
+
         struct AnimationData
         {
+            AnimationData()
+            {
+                AnimationLayer* base = new AnimationLayer();
+                base->Name           = "Base";
+                m_Layers.PushBack(base);
+            }
+
+            ~AnimationData()
+            {
+                for(AnimationLayer* layer : m_Layers)
+                    delete layer;
+            }
+
+            TDArray<AnimationLayer*> m_Layers;
+            ozz::vector<ozz::animation::BlendingJob::Layer> m_BlendLayers;
+            ozz::vector<ozz::animation::BlendingJob::Layer> m_AdditiveLayers;
+            JointWeightArray m_BaseJointWeights;
+
+            // Time skipped by LOD, applied on the next update that runs
+            float m_PendingTime    = 0.0f;
+            uint32_t m_FrameCounter = 0;
+            bool m_HasPose          = false;
+
             TDArray<SharedPtr<Animation>> m_AnimationStates;
             TDArray<std::string> m_AnimationNames;
             ozz::vector<ozz::math::Float4x4> m_JointWorldMats;
-            TDArray<Mat4> m_BindPoses;
+            ozz::vector<ozz::math::Float4x4> m_BindPoses; // Kept in ozz form so skinning stays in SIMD registers
             ozz::vector<uint16_t> m_JointRemap;
+
+            // Skinning matrices go into the descriptor set's uniform storage once it exists, and into
+            // m_SkinningMatrices until then or when the backend has no CPU side storage
+            TDArray<Mat4> m_SkinningMatrices;
+            Mat4* m_UploadTarget      = nullptr;
+            uint32_t m_UploadCapacity = 0;
+            uint32_t m_JointCount     = 0;
+            bool m_SkinningDirty      = false;
         };
 
-        Mat4 ConvertToGLM(const ozz::math::Float4x4& ozzMat)
+        // Both are column major
+        static ozz::math::Float4x4 ConvertToOzz(const Mat4& mat)
         {
-            LUMOS_PROFILE_FUNCTION_LOW();
-            Mat4 glmMat;
-
-            // Assuming ozz::math::Float4x4 is column-major
-            float matrix[16];
-            for(int r = 0; r < 4; r++)
-            {
-                float result[4];
-                std::memcpy(result, ozzMat.cols + r, sizeof(ozzMat.cols[r]));
-                float dresult[4];
-                for(int j = 0; j < 4; j++)
-                {
-                    dresult[j] = result[j];
-                }
-                //_mm_store_ps(result,p.cols[r]);
-                std::memcpy(matrix + r * 4, dresult, sizeof(dresult));
-            }
-
-            glmMat = Mat4(matrix);
-            return glmMat;
+            ozz::math::Float4x4 ozzMat;
+            for(int c = 0; c < 4; c++)
+                ozzMat.cols[c] = ozz::math::simd_float4::LoadPtrU(mat.values + c * 4);
+            return ozzMat;
         }
 
         AnimationController::AnimationController()
         {
             m_Data = new AnimationData();
+
+            // Spread reduced rate updates of different controllers over different frames
+            static std::atomic<uint32_t> s_FramePhase = 0;
+            m_Data->m_FrameCounter                    = s_FramePhase.fetch_add(1, std::memory_order_relaxed);
         }
 
         AnimationController::AnimationController(const AnimationController& copy) = default;
@@ -77,59 +168,340 @@ namespace Lumos
             delete m_Data;
         }
 
-        void AnimationController::Update(float& animationTime, SamplingContext& context)
+        void AnimationController::Update(float deltaTime, SamplingContext& context)
         {
             LUMOS_PROFILE_FUNCTION();
-            if(m_Data->m_AnimationStates.Empty())
+            AnimationData& data = *m_Data;
+            if(data.m_AnimationStates.Empty() || !m_Skeleton.get() || !m_Skeleton->IsValid())
                 return;
-            m_Data->m_JointWorldMats = ozz::vector<ozz::math::Float4x4>();
 
-            float ratio = animationTime / m_Data->m_AnimationStates[m_StateIndex]->GetAnimation().duration();
-            if(ratio >= 1.0f)
+            // Reduced LOD keeps the last pose for the frames in between
+            data.m_PendingTime += deltaTime;
+            data.m_FrameCounter++;
+            if(data.m_HasPose && (data.m_FrameCounter & ((1u << Maths::Min(m_LOD, 31u)) - 1)) != 0)
+                return;
+
+            deltaTime          = data.m_PendingTime;
+            data.m_PendingTime = 0.0f;
+
+            const ozz::animation::Skeleton& skeleton = m_Skeleton->GetSkeleton();
+            const int numJoints                      = skeleton.num_joints();
+            const int numSoaJoints                   = skeleton.num_soa_joints();
+            context.resize(numJoints);
+            context.resizeSao(numSoaJoints);
+
+            const bool baseOnly = m_LOD >= 2;
+            for(uint32_t layerIndex = 0; layerIndex < (uint32_t)data.m_Layers.Size(); layerIndex++)
             {
-                animationTime = 0.0f;
-                ratio         = 0.0f;
+                AnimationLayer& layer = *data.m_Layers[layerIndex];
+                if(layerIndex > 0 && (baseOnly || layer.Weight <= 0.0f))
+                    continue;
+
+                if(layer.MaskDirty)
+                    BuildLayerMask(layer);
+
+                layer.Time += deltaTime;
+                if(layer.PreviousState != InvalidState)
+                {
+                    layer.PreviousTime += deltaTime;
+                    layer.FadeTime += deltaTime;
+                    if(baseOnly || layer.FadeTime >= layer.FadeDuration || layer.PreviousState >= data.m_AnimationStates.Size())
+                        layer.PreviousState = InvalidState;
+                }
+
+                SampleState(layer, layer.Current, layer.State, layer.Time);
+                if(layer.PreviousState != InvalidState)
+                    SampleState(layer, layer.Current ^ 1, layer.PreviousState, layer.PreviousTime);
+            }
+
+            BlendLayers(context);
+            UpdateLocalTransforms(context);
+
+            if(data.m_JointWorldMats.size() != (size_t)numJoints)
+                data.m_JointWorldMats.resize(numJoints);
+
+            // Setup local-to-model conversion job.
+            ozz::animation::LocalToModelJob ltmJob;
+            ltmJob.skeleton = &skeleton;
+            ltmJob.input    = ozz::make_span(context.GetLocalTransforms());
+            ltmJob.output   = ozz::make_span(data.m_JointWorldMats);
+
+            // Runs ltm job.
+            if(!ltmJob.Run())
+            {
+                LERROR("Failed to run ozz LocalToModelJob");
             }
 
-            if(m_Skeleton.get() && m_Skeleton->IsValid())
+            UpdateSkinning();
+            data.m_HasPose = true;
+        }
+
+        void AnimationController::SampleState(AnimationLayer& layer, uint32_t slot, size_t state, float& time)
+        {
+            LUMOS_PROFILE_FUNCTION_LOW();
+            const ozz::animation::Animation& animation = m_Data->m_AnimationStates[state]->GetAnimation();
+            const int numJoints                        = m_Skeleton->GetSkeleton().num_joints();
+            const int numSoaJoints                     = m_Skeleton->GetSkeleton().num_soa_joints();
+
+            // Sized once, after that the cache is reused every frame
+            if(layer.Contexts[slot].max_tracks() < numJoints)
+                layer.Contexts[slot].Resize(numJoints);
+            if(layer.Locals[slot].size() != (size_t)numSoaJoints)
+                layer.Locals[slot].resize(numSoaJoints);
+
+            const float duration = animation.duration();
+            if(duration > 0.0f && time >= duration)
+                time = fmodf(time, duration);
+
+            ozz::animation::SamplingJob samplingJob;
+            samplingJob.animation = &animation;
+            samplingJob.context   = &layer.Contexts[slot];
+            samplingJob.ratio     = duration > 0.0f ? time / duration : 0.0f;
+            samplingJob.output    = ozz::make_span(layer.Locals[slot]);
+            if(!samplingJob.Run())
             {
-                context.resize(m_Skeleton->GetSkeleton().num_joints());
-                context.resizeSao(m_Skeleton->GetSkeleton().num_soa_joints());
-                UpdateSampling(ratio, context);
+                LERROR("ozz animation sampling job failed!");
+            }
+        }
+
+        void AnimationController::BuildLayerMask(AnimationLayer& layer)
+        {
+            layer.MaskDirty = false;
+            layer.JointWeights.Clear();
+            if(layer.MaskRoot.empty() || !m_Skeleton || !m_Skeleton->IsValid())
+                return;
+
+            const ozz::animation::Skeleton& skeleton = m_Skeleton->GetSkeleton();
+            const int root                           = ozz::animation::FindJoint(skeleton, layer.MaskRoot.c_str());
+            if(root < 0)
+            {
+                LWARN("Animation layer mask joint %s not found", layer.MaskRoot.c_str());
+                return;
+            }
+
+            layer.JointWeights.Resize((uint32_t)skeleton.num_soa_joints(), ozz::math::simd_float4::zero());
+            ozz::animation::IterateJointsDF(
+                skeleton, [&layer](int joint, int)
+                {
+                    ozz::math::SimdFloat4& soaWeight = layer.JointWeights[joint / 4];
+                    soaWeight                        = ozz::math::SetI(soaWeight, ozz::math::simd_float4::one(), joint % 4); },
+                root);
+        }
+
+        void AnimationController::BlendLayers(SamplingContext& context)
+        {
+            LUMOS_PROFILE_FUNCTION_LOW();
+            AnimationData& data         = *m_Data;
+            AnimationLayer& base        = *data.m_Layers[0];
+            const bool baseOnly         = m_LOD >= 2;
+            const uint32_t numSoaJoints = (uint32_t)m_Skeleton->GetSkeleton().num_soa_joints();
+            ozz::vector<ozz::math::SoaTransform>& output = context.GetLocalTransforms();
+
+            data.m_BlendLayers.clear();
+            data.m_AdditiveLayers.clear();
+
+            // Override layers take their share of the weight away from the base layer on the joints they cover
+            bool baseMasked = false;
+            if(!baseOnly)
+            {
+                for(uint32_t layerIndex = 1; layerIndex < (uint32_t)data.m_Layers.Size(); layerIndex++)
+                {
+                    const AnimationLayer& layer = *data.m_Layers[layerIndex];
+                    if(layer.Mode != AnimationBlendMode::Override || layer.Weight <= 0.0f)
+                        continue;
+
+                    if(!baseMasked)
+                    {
+                        data.m_BaseJointWeights.Resize(numSoaJoints, ozz::math::simd_float4::one());
+                        baseMasked = true;
+                    }
+
+                    const ozz::math::SimdFloat4 layerWeight = ozz::math::simd_float4::Load1(Maths::Min(layer.Weight, 1.0f));
+                    for(uint32_t i = 0; i < numSoaJoints; i++)
+                    {
+                        const ozz::math::SimdFloat4 covered = layer.JointWeights.Empty() ? layerWeight : layerWeight * layer.JointWeights[i];
+                        data.m_BaseJointWeights[i]          = data.m_BaseJointWeights[i] * (ozz::math::simd_float4::one() - covered);
+                    }
+                }
+            }
+
+            // A layer that is crossfading contributes both of its states
+            auto AddLayer = [&data](ozz::vector<ozz::animation::BlendingJob::Layer>& layers, const AnimationLayer& layer, float weight, const JointWeightArray* jointWeights)
+            {
+                float fade = 1.0f;
+                if(layer.PreviousState != InvalidState)
+                {
+                    fade = layer.FadeTime / layer.FadeDuration;
+
+                    ozz::animation::BlendingJob::Layer& previous = layers.emplace_back();
+                    previous.weight                              = weight * (1.0f - fade);
+                    previous.transform                           = ozz::make_span(layer.Locals[layer.Current ^ 1]);
+                    if(jointWeights && !jointWeights->Empty())
+                        previous.joint_weights = jointWeights->GetSpan();
+                }
 
-                if(m_Data->m_JointWorldMats.size() != m_Skeleton->GetSkeleton().num_joints())
-                    m_Data->m_JointWorldMats.resize(m_Skeleton->GetSkeleton().num_joints());
+                ozz::animation::BlendingJob::Layer& current = layers.emplace_back();
+                current.weight                              = weight * fade;
+                current.transform                           = ozz::make_span(layer.Locals[layer.Current]);
+                if(jointWeights && !jointWeights->Empty())
+                    current.joint_weights = jointWeights->GetSpan();
+            };
 
-                // Setup local-to-model conversion job.
-                ozz::animation::LocalToModelJob ltmJob;
-                ltmJob.skeleton = &m_Skeleton->GetSkeleton();
-                ltmJob.input    = ozz::make_span(context.GetLocalTransforms());
-                ltmJob.output   = ozz::make_span(m_Data->m_JointWorldMats);
+            AddLayer(data.m_BlendLayers, base, 1.0f, baseMasked ? &data.m_BaseJointWeights : nullptr);
 
-                // Runs ltm job.
-                if(!ltmJob.Run())
+            if(!baseOnly)
+            {
+                for(uint32_t layerIndex = 1; layerIndex < (uint32_t)data.m_Layers.Size(); layerIndex++)
                 {
-                    LERROR("Failed to run ozz LocalToModelJob");
+                    const AnimationLayer& layer = *data.m_Layers[layerIndex];
+                    if(layer.Weight <= 0.0f)
+                        continue;
+
+                    if(layer.Mode == AnimationBlendMode::Override)
+                        AddLayer(data.m_BlendLayers, layer, Maths::Min(layer.Weight, 1.0f), &layer.JointWeights);
+                    else
+                        AddLayer(data.m_AdditiveLayers, layer, layer.Weight, &layer.JointWeights);
                 }
             }
+
+            // Nothing to blend, use the sampled pose as it is
+            if(data.m_BlendLayers.size() == 1 && data.m_AdditiveLayers.empty())
+            {
+                const ozz::vector<ozz::math::SoaTransform>& locals = base.Locals[base.Current];
+                std::copy(locals.begin(), locals.end(), output.begin());
+                return;
+            }
+
+            ozz::animation::BlendingJob blendJob;
+            blendJob.layers          = ozz::make_span(data.m_BlendLayers);
+            blendJob.additive_layers = ozz::make_span(data.m_AdditiveLayers);
+            blendJob.rest_pose       = m_Skeleton->GetSkeleton().joint_rest_poses();
+            blendJob.output          = ozz::make_span(output);
+            if(!blendJob.Run())
+            {
+                LERROR("ozz animation blending job failed!");
+            }
+        }
+
+        void AnimationController::UpdateSkinning()
+        {
+            LUMOS_PROFILE_FUNCTION_LOW();
+            AnimationData& data       = *m_Data;
+            const uint32_t jointCount = (uint32_t)Maths::Min(data.m_JointWorldMats.size(), data.m_BindPoses.size());
+
+            Mat4* output   = data.m_UploadTarget;
+            uint32_t count = jointCount;
+            if(output)
+            {
+                count = Maths::Min(jointCount, data.m_UploadCapacity);
+            }
+            else
+            {
+                if(data.m_SkinningMatrices.Size() != jointCount)
+                    data.m_SkinningMatrices.Resize(jointCount);
+                output = data.m_SkinningMatrices.Data();
+            }
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                const ozz::math::Float4x4 skin = data.m_JointWorldMats[i] * data.m_BindPoses[i];
+                for(int c = 0; c < 4; c++)
+                    ozz::math::StorePtrU(skin.cols[c], output[i].values + c * 4);
+            }
+
+            data.m_JointCount    = count;
+            data.m_SkinningDirty = true;
         }
 
         void AnimationController::SetSkeleton(const SharedPtr<Skeleton>& skeleton)
         {
             m_Skeleton = skeleton;
+
+            for(AnimationLayer* layer : m_Data->m_Layers)
+                layer->MaskDirty = !layer->MaskRoot.empty();
+        }
+
+        void AnimationController::SetCurrentState(size_t index, uint32_t layer)
+        {
+            AnimationLayer& animationLayer = *m_Data->m_Layers[layer];
+            if(animationLayer.State == index && animationLayer.PreviousState == InvalidState)
+                return;
+
+            animationLayer.State         = index;
+            animationLayer.Time          = 0.0f;
+            animationLayer.PreviousState = InvalidState;
         }
 
-        void AnimationController::SetCurrentState(const std::string& name)
+        void AnimationController::SetCurrentState(const std::string& name, uint32_t layer)
         {
             for(size_t i = 0; i < m_Data->m_AnimationNames.Size(); ++i)
             {
                 if(m_Data->m_AnimationNames[i] == name)
                 {
-                    m_StateIndex = i;
+                    SetCurrentState(i, layer);
                     return;
                 }
             }
         }
+
+        void AnimationController::CrossFade(size_t index, float duration, uint32_t layer)
+        {
+            AnimationLayer& animationLayer = *m_Data->m_Layers[layer];
+            if(animationLayer.State == index)
+                return;
+
+            if(duration <= 0.0f || m_LOD >= 2)
+            {
+                SetCurrentState(index, layer);
+                return;
+            }
+
+            // A fade that is still running is cut short, its outgoing state is dropped
+            animationLayer.PreviousState = animationLayer.State;
+            animationLayer.PreviousTime  = animationLayer.Time;
+            animationLayer.FadeTime      = 0.0f;
+            animationLayer.FadeDuration  = duration;
+            animationLayer.State         = index;
+            animationLayer.Time          = 0.0f;
+            animationLayer.Current ^= 1;
+        }
+
+        void AnimationController::SetTime(float time, uint32_t layer)
+        {
+            m_Data->m_Layers[layer]->Time = time;
+        }
+
+        size_t AnimationController::GetCurrentState(uint32_t layer) const
+        {
+            return m_Data->m_Layers[layer]->State;
+        }
+
+        uint32_t AnimationController::AddLayer(const std::string_view name, AnimationBlendMode mode, float weight)
+        {
+            AnimationLayer* layer = new AnimationLayer();
+            layer->Name           = name;
+            layer->Mode           = mode;
+            layer->Weight         = weight;
+            m_Data->m_Layers.PushBack(layer);
+            return (uint32_t)m_Data->m_Layers.Size() - 1;
+        }
+
+        uint32_t AnimationController::GetLayerCount() const
+        {
+            return (uint32_t)m_Data->m_Layers.Size();
+        }
+
+        void AnimationController::SetLayerWeight(uint32_t layer, float weight)
+        {
+            m_Data->m_Layers[layer]->Weight = weight;
+        }
+
+        void AnimationController::SetLayerMask(uint32_t layer, const std::string& rootJoint)
+        {
+            // Built on the next update, the skeleton may not be set yet
+            m_Data->m_Layers[layer]->MaskRoot  = rootJoint;
+            m_Data->m_Layers[layer]->MaskDirty = true;
+        }
         void AnimationController::AddState(const std::string_view name, const SharedPtr<Animation>& animation)
         {
             for(const auto& animName : m_Data->m_AnimationNames)
@@ -162,47 +534,66 @@ namespace Lumos
         SharedPtr<DescriptorSet> AnimationController::GetDescriptorSet()
         {
             LUMOS_PROFILE_FUNCTION_LOW();
+            AnimationData& data = *m_Data;
             if(!m_Descriptor)
             {
                 Graphics::DescriptorDesc descriptorDesc {};
                 descriptorDesc.layoutIndex = 3;
                 descriptorDesc.shader      = Application::Get().GetAssetManager()->GetAssetData("ForwardPBRAnim").As<Graphics::Shader>();
                 m_Descriptor               = SharedPtr<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(descriptorDesc));
+
+                // From now on Update writes the matrices straight into the uniform storage. Joints it never
+                // writes stay identity
+                Buffer* storage = m_Descriptor->GetUniformBufferLocalData(0);
+                if(storage && storage->Data)
+                {
+                    data.m_UploadTarget   = (Mat4*)storage->Data;
+                    data.m_UploadCapacity = storage->Size / sizeof(Mat4);
+
+                    for(uint32_t i = 0; i < data.m_UploadCapacity; i++)
+                        new(&data.m_UploadTarget[i]) Mat4(1.0f);
+
+                    // Convert the current pose from its ozz matrices again rather than copying the staged ones
+                    data.m_SkinningMatrices.Clear();
+                    data.m_JointCount = 0;
+                    if(data.m_HasPose)
+                        UpdateSkinning();
+                }
+
+                data.m_SkinningDirty = true;
             }
 
-            auto test = GetJointMatrices();
-            m_Descriptor->SetUniformBufferData(0, test.Data(), (uint32_t)(sizeof(Mat4) * test.Size()));
+            if(data.m_SkinningDirty)
+            {
+                if(data.m_UploadTarget)
+                {
+                    // Flags the storage for upload
+                    m_Descriptor->GetUniformBufferLocalData(0);
+                }
+                else
+                {
+                    if(data.m_SkinningMatrices.Empty())
+                    {
+                        LINFO("Using identy for joint matrices");
+                        data.m_SkinningMatrices.Resize(100, Mat4(1.0f));
+                    }
+                    m_Descriptor->SetUniformBufferData(0, data.m_SkinningMatrices.Data(), (uint32_t)(sizeof(Mat4) * data.m_SkinningMatrices.Size()));
+                }
+                data.m_SkinningDirty = false;
+            }
             m_Descriptor->Update();
 
             return m_Descriptor;
         }
 
-        TDArray<Mat4> AnimationController::GetJointMatrices()
+        const Mat4* AnimationController::GetJointMatrices() const
         {
-            LUMOS_PROFILE_FUNCTION_LOW();
-            TDArray<Mat4> glmMats;
-            for(size_t i = 0; i < m_Data->m_JointWorldMats.size(); i++)
-            {
-                ozz::math::Float4x4 skin_matrix = m_Data->m_JointWorldMats[i];
-                glmMats.PushBack(ConvertToGLM(skin_matrix) * m_Data->m_BindPoses[i]);
-            }
-
-            if(m_Data->m_JointWorldMats.empty())
-            {
-                LINFO("Using identy for joint matrices");
-                for(size_t i = 0; i < 100; i++)
-                    glmMats.PushBack(Mat4(1.0f));
-            }
-            return glmMats;
+            return m_Data->m_UploadTarget ? m_Data->m_UploadTarget : m_Data->m_SkinningMatrices.Data();
         }
 
-        bool IsLeaf(const ozz::animation::Skeleton& _skeleton, int _joint)
+        uint32_t AnimationController::GetJointCount() const
         {
-            const int num_joints = _skeleton.num_joints();
-            assert(_joint >= 0 && _joint < num_joints && "_joint index out of range");
-            const ozz::span<const int16_t>& parents = _skeleton.joint_parents();
-            const int next                          = _joint + 1;
-            return next == num_joints || parents[next] != _joint;
+            return m_Data->m_JointCount;
         }
 
         void AnimationController::DebugDraw(const Mat4& transform)
@@ -255,7 +646,7 @@ namespace Lumos
                 // uniform += 16;
 
                 // Only the joint is rendered for leaves, the bone model isn't.
-                if(IsLeaf(m_Skeleton->GetSkeleton(), i))
+                if(ozz::animation::IsLeaf(m_Skeleton->GetSkeleton(), i))
                 {
                     // Copy current joint's raw matrix.
                     DebugRenderer::DebugDrawSphere(0.1f, currentPos, Vec4(0.0f, 1.0f, 0.0f, 1.0f));
@@ -265,23 +656,15 @@ namespace Lumos
 
         void AnimationController::SetBindPoses(const TDArray<Mat4>& mats)
         {
-            m_Data->m_BindPoses = mats;
+            m_Data->m_BindPoses.resize(mats.Size());
+            for(uint32_t i = 0; i < (uint32_t)mats.Size(); i++)
+                m_Data->m_BindPoses[i] = ConvertToOzz(mats[i]);
         }
 
-        void AnimationController::UpdateSampling(float ratio, SamplingContext& context)
+        void AnimationController::UpdateLocalTransforms(SamplingContext& context)
         {
-            LUMOS_PROFILE_FUNCTION();
-            ozz::animation::SamplingJob sampling_job;
-            sampling_job.animation = &m_Data->m_AnimationStates[m_StateIndex]->GetAnimation();
-            sampling_job.context   = &context.m_Context;
-            sampling_job.ratio     = ratio;
-            sampling_job.output    = ozz::make_span(context.m_LocalSpaceSoaTransforms);
-            if(!sampling_job.Run())
-            {
-                LERROR("ozz animation sampling job failed!");
-            }
-
-            for(int i = 0; i < context.m_LocalSpaceSoaTransforms.size(); ++i)
+            LUMOS_PROFILE_FUNCTION_LOW();
+            for(size_t i = 0; i < context.m_LocalSpaceSoaTransforms.size(); ++i)
             {
                 ozz::math::SimdFloat4 translations[4];
                 ozz::math::SimdFloat4 scales[4];
@@ -291,9 +674,9 @@ namespace Lumos
                 ozz::math::Transpose3x4(&context.m_LocalSpaceSoaTransforms[i].scale.x, scales);
                 ozz::math::Transpose4x4(&context.m_LocalSpaceSoaTransforms[i].rotation.x, rotations);
 
-                for(int j = 0; j < 4; ++j)
+                for(size_t j = 0; j < 4; ++j)
                 {
-                    auto index = i * 4 + j;
+                    const size_t index = i * 4 + j;
                     if(index >= context.LocalTranslations.size())
                         break;
 
@@ -12,8 +12,18 @@ namespace Lumos
         class DescriptorSet;
         struct SamplingContext;
         struct AnimationData;
+        struct AnimationLayer;
+
+        enum class AnimationBlendMode : uint8_t
+        {
+            Override, // Replaces the layers below on the joints it covers
+            Additive  // Added on top of the layers below. Expects clips built as additive animations
+        };
 
         // Controls which animation (or animations) is playing on a mesh.
+        // Layer 0 is the base layer. Every layer plays one of the controller's states, can crossfade to another one
+        // and can be limited to part of the skeleton. Sampling caches are kept per layer, so playback only
+        // decompresses the keys that changed since the last update.
         class AnimationController : public Asset
         {
             friend class Model;
@@ -24,15 +34,37 @@ namespace Lumos
 
             virtual ~AnimationController();
 
-            void Update(float& animationTime, SamplingContext& context);
+            // Advances every layer, blends them and computes the skinning matrices. Only touches this controller
+            // and the context, so different controllers can be updated on different threads
+            void Update(float deltaTime, SamplingContext& context);
 
             void SetSkeleton(const SharedPtr<Skeleton>& skeleton);
-            void SetCurrentState(size_t index) { m_StateIndex = index; };
-            void SetCurrentState(const std::string& name);
+            void SetCurrentState(size_t index, uint32_t layer = 0);
+            void SetCurrentState(const std::string& name, uint32_t layer = 0);
             void AddState(const std::string_view name, const SharedPtr<Animation>& animation);
             void SetState(size_t index, const std::string_view name, const SharedPtr<Animation>& animation);
 
-            size_t GetCurrentState() const { return m_StateIndex; }
+            // Blends from the layer's current state to the new one over duration seconds. Does nothing if the
+            // state is already playing
+            void CrossFade(size_t index, float duration, uint32_t layer = 0);
+
+            // Time in seconds into the layer's current state
+            void SetTime(float time, uint32_t layer = 0);
+
+            size_t GetCurrentState(uint32_t layer = 0) const;
+
+            uint32_t AddLayer(const std::string_view name, AnimationBlendMode mode, float weight = 1.0f);
+            uint32_t GetLayerCount() const;
+            void SetLayerWeight(uint32_t layer, float weight);
+
+            // Limits the layer to a joint and its children, for example the spine for an upper body layer.
+            // An empty name covers the whole skeleton
+            void SetLayerMask(uint32_t layer, const std::string& rootJoint);
+
+            // Level 0 updates every frame and each level above halves the update rate. From level 2 only the base
+            // layer is sampled and crossfades cut straight to the new state
+            void SetLOD(uint32_t level) { m_LOD = level; }
+            uint32_t GetLOD() const { return m_LOD; }
 
             const SharedPtr<Skeleton>& GetSkeleton() const { return m_Skeleton; }
             const TDArray<std::string>& GetStateNames() const;
@@ -42,20 +74,27 @@ namespace Lumos
             static AssetType GetStaticType() { return AssetType::AnimationController; }
             virtual AssetType GetAssetType() const override { return GetStaticType(); }
 
-            TDArray<Mat4> GetJointMatrices();
+            // Skinning matrices from the last Update. Once the descriptor set exists they are written straight
+            // into its uniform buffer storage
+            const Mat4* GetJointMatrices() const;
+            uint32_t GetJointCount() const;
             void DebugDraw(const Mat4& transform);
 
             void SetBindPoses(const TDArray<Mat4>& mats);
 
         private:
-            void UpdateSampling(float ratio, SamplingContext& context);
+            void SampleState(AnimationLayer& layer, uint32_t slot, size_t state, float& time);
+            void BuildLayerMask(AnimationLayer& layer);
+            void BlendLayers(SamplingContext& context);
+            void UpdateLocalTransforms(SamplingContext& context);
+            void UpdateSkinning();
 
         private:
             SharedPtr<Skeleton> m_Skeleton;
             SharedPtr<DescriptorSet> m_Descriptor;
             AnimationData* m_Data;
 
-            size_t m_StateIndex = 0;
+            uint32_t m_LOD = 0;
         };
     }
 }
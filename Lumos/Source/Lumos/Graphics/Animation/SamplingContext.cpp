@@ -15,7 +15,6 @@ namespace Lumos
             , LocalRotations(other.LocalRotations)
             , m_LocalSpaceSoaTransforms(other.m_LocalSpaceSoaTransforms)
         {
-            m_Context.Resize(other.m_Context.max_tracks());
         }
 
         SamplingContext::~SamplingContext()
@@ -28,8 +27,6 @@ namespace Lumos
             LocalScales               = other.LocalScales;
             LocalRotations            = other.LocalRotations;
             m_LocalSpaceSoaTransforms = other.m_LocalSpaceSoaTransforms;
-
-            m_Context.Resize(other.m_Context.max_tracks());
             return *this;
         }
 
@@ -38,7 +35,6 @@ namespace Lumos
             if(m_Size != size)
             {
                 m_Size = size;
-                m_Context.Resize(size);
                 LocalTranslations.resize(size);
                 LocalScales.resize(size);
                 LocalRotations.resize(size);
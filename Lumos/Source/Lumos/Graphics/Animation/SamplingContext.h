@@ -6,7 +6,6 @@
 #include "Maths/Vector3.h"
 #include "Maths/Quaternion.h"
 
-#include <ozz/animation/runtime/sampling_job.h>
 #include <ozz/base/containers/vector.h>
 #include <ozz/base/maths/soa_transform.h>
 #include <ozz/base/memory/unique_ptr.h>
@@ -38,7 +37,6 @@ namespace Lumos
             void resizeSao(uint32_t size);
 
         private:
-            ozz::animation::SamplingJob::Context m_Context;
             ozz::vector<ozz::math::SoaTransform> m_LocalSpaceSoaTransforms;
 
             uint32_t m_SaoSize = 0;
@@ -155,7 +155,7 @@ namespace Lumos
         }
 
         template <typename T, typename S, int N, GeneratorFunction<S, N> GEN_FN>
-        static SharedPtr<Texture2D> CreateAndCacheAtlas(const std::string& fontName, float fontSize, const std::vector<GlyphGeometry>& glyphs, const FontGeometry& fontGeometry, const Configuration& config)
+        static Buffer GenerateAndCacheAtlas(const std::string& fontName, float fontSize, const std::vector<GlyphGeometry>& glyphs, const FontGeometry& fontGeometry, const Configuration& config, AtlasHeader& header)
         {
             LUMOS_PROFILE_FUNCTION();
             ImmediateAtlasGenerator<S, N, GEN_FN, BitmapAtlasStorage<T, N>> generator(config.width, config.height);
@@ -165,20 +165,12 @@ namespace Lumos
 
             msdfgen::BitmapConstRef<T, N> bitmap = (msdfgen::BitmapConstRef<T, N>)generator.atlasStorage();
 
-            AtlasHeader header;
             header.Width  = bitmap.width;
             header.Height = bitmap.height;
             CacheFontAtlas(fontName, fontSize, header, bitmap.pixels);
 
-            TextureDesc param;
-            param.minFilter       = TextureFilter::LINEAR;
-            param.magFilter       = TextureFilter::LINEAR;
-            param.format          = RHIFormat::R32G32B32A32_Float;
-            param.srgb            = false;
-            param.wrap            = TextureWrap::CLAMP;
-            param.generateMipMaps = false;
-            param.flags           = TextureFlags::Texture_Sampled;
-            return CreateCachedAtlas(header, (void*)bitmap.pixels);
+            // The generator owns the bitmap, so keep a copy until the texture is created
+            return Buffer::Copy(bitmap.pixels, uint32_t(bitmap.width * bitmap.height * sizeof(T) * N));
         }
 
         Font::Font(uint8_t* data, uint32_t dataSize, const std::string& name)
@@ -190,21 +182,47 @@ namespace Lumos
             Init();
         }
 
-        Font::Font(const std::string& filepath)
+        Font::Font(const std::string& filepath, bool createAtlas)
             : m_FilePath(filepath)
             , m_MSDFData(new MSDFData())
             , m_FontData(nullptr)
             , m_FontDataSize(0)
         {
-            Init();
+            if(createAtlas)
+                Init();
+            else
+                LoadAtlas();
         }
 
         Font::~Font()
         {
+            m_AtlasStorage.Release();
             delete m_MSDFData;
         }
 
         void Font::Init()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            LoadAtlas();
+            CreateAtlas();
+        }
+
+        void Font::CreateAtlas()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            if(!m_AtlasPixels)
+                return;
+
+            AtlasHeader header;
+            header.Width   = m_AtlasWidth;
+            header.Height  = m_AtlasHeight;
+            m_TextureAtlas = CreateCachedAtlas(header, m_AtlasPixels);
+
+            m_AtlasStorage.Release();
+            m_AtlasPixels = nullptr;
+        }
+
+        void Font::LoadAtlas()
         {
             LUMOS_PROFILE_FUNCTION();
             FontInput fontInput           = {};
@@ -423,36 +441,37 @@ namespace Lumos
             std::string fontName = m_FilePath;
 
             // Check cache here
-            Buffer storageBuffer;
             AtlasHeader header;
             void* pixels;
-            if(TryReadFontAtlasFromCache(fontName, (float)config.emSize, header, pixels, storageBuffer))
+            m_AtlasStorage.Release();
+            if(TryReadFontAtlasFromCache(fontName, (float)config.emSize, header, pixels, m_AtlasStorage))
             {
-                m_TextureAtlas = CreateCachedAtlas(header, pixels);
-                storageBuffer.Release();
+                m_AtlasPixels = pixels;
             }
             else
             {
                 bool floatingPointFormat = true;
-                SharedPtr<Texture2D> texture;
                 switch(config.imageType)
                 {
                 case ImageType::MSDF:
                     if(floatingPointFormat)
-                        texture = CreateAndCacheAtlas<float, float, 3, msdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config);
+                        m_AtlasStorage = GenerateAndCacheAtlas<float, float, 3, msdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config, header);
                     else
-                        texture = CreateAndCacheAtlas<byte, float, 3, msdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config);
+                        m_AtlasStorage = GenerateAndCacheAtlas<byte, float, 3, msdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config, header);
                     break;
                 case ImageType::MTSDF:
                     if(floatingPointFormat)
-                        texture = CreateAndCacheAtlas<float, float, 4, mtsdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config);
+                        m_AtlasStorage = GenerateAndCacheAtlas<float, float, 4, mtsdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config, header);
                     else
-                        texture = CreateAndCacheAtlas<byte, float, 4, mtsdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config);
+                        m_AtlasStorage = GenerateAndCacheAtlas<byte, float, 4, mtsdfGenerator>(fontName, (float)config.emSize, m_MSDFData->Glyphs, m_MSDFData->FontGeometry, config, header);
                     break;
                 }
 
-                m_TextureAtlas = texture;
+                m_AtlasPixels = m_AtlasStorage.Data;
             }
+
+            m_AtlasWidth  = header.Width;
+            m_AtlasHeight = header.Height;
         }
 
         SharedPtr<Font> Font::s_DefaultFont;
@@ -1,5 +1,6 @@
 #pragma once
 #include "Core/Asset/Asset.h"
+#include "Core/Buffer.h"
 
 namespace Lumos
 {
@@ -13,7 +14,8 @@ namespace Lumos
             class FontHolder;
 
         public:
-            Font(const std::string& filepath);
+            // Without createAtlas only the glyphs and atlas pixels are built, see LoadAtlas
+            Font(const std::string& filepath, bool createAtlas = true);
             Font(uint8_t* data, uint32_t dataSize, const std::string& name);
 
             virtual ~Font();
@@ -26,6 +28,13 @@ namespace Lumos
 
             void Init();
 
+            // Loads the glyphs and reads or generates the atlas pixels. Doesn't touch the graphics API, so it can
+            // run on any thread
+            void LoadAtlas();
+
+            // Creates the atlas texture from what LoadAtlas built. Main thread only
+            void CreateAtlas();
+
             static void InitDefaultFont();
             static void ShutdownDefaultFont();
             static SharedPtr<Font> GetDefaultFont();
@@ -39,6 +48,12 @@ namespace Lumos
             uint8_t* m_FontData;
             uint32_t m_FontDataSize;
 
+            // Atlas pixels kept from LoadAtlas until CreateAtlas
+            Buffer m_AtlasStorage;
+            void* m_AtlasPixels    = nullptr;
+            uint32_t m_AtlasWidth  = 0;
+            uint32_t m_AtlasHeight = 0;
+
         private:
             static SharedPtr<Font> s_DefaultFont;
         };
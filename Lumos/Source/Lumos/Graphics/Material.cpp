@@ -19,12 +19,20 @@ namespace Lumos::Graphics
 
     SharedPtr<Graphics::Texture2D> Material::s_DefaultTexture = nullptr;
 
+    // Models are imported on the asset streaming threads, so materials can be created concurrently
+    static uint32_t NextMaterialID()
+    {
+        static std::atomic<uint32_t> s_NextMaterialID(0);
+        return ++s_NextMaterialID;
+    }
+
     Material::Material(SharedPtr<Graphics::Shader>& shader, const MaterialProperties& properties, const PBRMataterialTextures& textures)
         : m_PBRMaterialTextures(textures)
         , m_Shader(shader)
     {
         LUMOS_PROFILE_FUNCTION();
 
+        m_ID    = NextMaterialID();
         m_Flags = 0;
         SetFlag(RenderFlags::DEPTHTEST);
         m_DescriptorSet      = nullptr;
@@ -41,6 +49,7 @@ namespace Lumos::Graphics
     {
         LUMOS_PROFILE_FUNCTION();
 
+        m_ID    = NextMaterialID();
         m_Flags = 0;
         SetFlag(RenderFlags::DEPTHTEST);
         m_DescriptorSet              = nullptr;
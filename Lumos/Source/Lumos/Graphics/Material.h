@@ -98,6 +98,7 @@ namespace Lumos
             SharedPtr<Shader> GetShader() const { return m_Shader; }
             DescriptorSet* GetDescriptorSet() const { return m_DescriptorSet; }
             const std::string& GetName() const { return m_Name; }
+            uint32_t GetID() const { return m_ID; } // Creation order id, used to group draws by material
             MaterialProperties* GetProperties() const { return m_MaterialProperties; }
 
             void Bind();
@@ -133,6 +134,7 @@ namespace Lumos
             std::string m_Name;
             bool m_TexturesUpdated = false;
             uint32_t m_Flags;
+            uint32_t m_ID;
 
             std::string m_MaterialPath;
 
@@ -15,6 +15,8 @@ namespace Lumos
 {
     namespace Graphics
     {
+        MeshOptimiseSettings Mesh::s_OptimiseSettings;
+
         Mesh::Mesh()
             : m_VertexBuffer(nullptr)
             , m_IndexBuffer(nullptr)
@@ -28,29 +30,44 @@ namespace Lumos
             , m_BoundingBox(mesh.m_BoundingBox)
             , m_Name(mesh.m_Name)
             , m_Material(mesh.m_Material)
+            , m_LODs(mesh.m_LODs)
         {
         }
 
         Mesh::Mesh(const TDArray<uint32_t>& indices, const TDArray<Vertex>& vertices)
+            : Mesh(indices.Data(), (uint32_t)indices.Size(), vertices.Data(), (uint32_t)vertices.Size())
+        {
+        }
+
+        Mesh::Mesh(const TDArray<uint32_t>& indices, const TDArray<Vertex>& vertices, const TDArray<MeshLOD>& lods)
+            : Mesh(indices.Data(), (uint32_t)indices.Size(), vertices.Data(), (uint32_t)vertices.Size(), lods.Data(), (uint32_t)lods.Size())
         {
+        }
+
+        Mesh::Mesh(const uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount, const MeshLOD* lods, uint32_t lodCount)
+        {
+            for(uint32_t i = 0; i < lodCount; i++)
+                m_LODs.PushBack(lods[i]);
+
             m_BoundingBox = {};
 
-            for(auto& vertex : vertices)
+            for(uint32_t i = 0; i < vertexCount; i++)
             {
-                m_BoundingBox.Merge(vertex.Position);
+                m_BoundingBox.Merge(vertices[i].Position);
             }
 
-            m_IndexBuffer  = SharedPtr<Graphics::IndexBuffer>(Graphics::IndexBuffer::Create((uint32_t*)indices.Data(), (uint32_t)indices.Size()));
-            m_VertexBuffer = SharedPtr<VertexBuffer>(VertexBuffer::Create((uint32_t)(sizeof(Graphics::Vertex) * vertices.Size()), vertices.Data(), BufferUsage::STATIC));
+            m_IndexBuffer  = SharedPtr<Graphics::IndexBuffer>(Graphics::IndexBuffer::Create((uint32_t*)indices, indexCount));
+            m_VertexBuffer = SharedPtr<VertexBuffer>(VertexBuffer::Create((uint32_t)(sizeof(Graphics::Vertex) * vertexCount), vertices, BufferUsage::STATIC));
 
 #ifndef LUMOS_PRODUCTION
-            m_Stats.VertexCount   = (uint32_t)vertices.Size();
+            m_Stats.VertexCount   = vertexCount;
             m_Stats.TriangleCount = m_Stats.VertexCount / 3;
-            m_Stats.IndexCount    = (uint32_t)indices.Size();
+            m_Stats.IndexCount    = GetLOD(0).IndexCount;
 #endif
         }
 
-        Mesh::Mesh(const TDArray<uint32_t>& indices, const TDArray<AnimVertex>& vertices)
+        Mesh::Mesh(const TDArray<uint32_t>& indices, const TDArray<AnimVertex>& vertices, const TDArray<MeshLOD>& lods)
+            : m_LODs(lods)
         {
             m_BoundingBox = {};
 
@@ -65,7 +82,7 @@ namespace Lumos
 #ifndef LUMOS_PRODUCTION
             m_Stats.VertexCount   = (uint32_t)vertices.Size();
             m_Stats.TriangleCount = m_Stats.VertexCount / 3;
-            m_Stats.IndexCount    = (uint32_t)indices.Size();
+            m_Stats.IndexCount    = GetLOD(0).IndexCount;
 #endif
         }
 
@@ -73,6 +90,137 @@ namespace Lumos
         {
         }
 
+        MeshLOD Mesh::GetLOD(uint32_t lod) const
+        {
+            if(m_LODs.Empty())
+                return { 0, m_IndexBuffer ? m_IndexBuffer->GetCount() : 0, 0.0f };
+
+            return m_LODs[Maths::Min(lod, (uint32_t)m_LODs.Size() - 1)];
+        }
+
+        uint32_t Mesh::SelectLOD(float pixelsPerUnit, float maxPixelError) const
+        {
+            // LODs are stored finest first, so their errors only grow
+            uint32_t lod = 0;
+            for(uint32_t i = 1; i < (uint32_t)m_LODs.Size(); i++)
+            {
+                if(m_LODs[i].Error * pixelsPerUnit > maxPixelError)
+                    break;
+                lod = i;
+            }
+
+            return lod;
+        }
+
+        static uint32_t GetVertexStreams(const Vertex* vertices, meshopt_Stream* streams)
+        {
+            streams[0] = { &vertices->Position, sizeof(Vec3), sizeof(Vertex) };
+            streams[1] = { &vertices->Colours, sizeof(Vec4), sizeof(Vertex) };
+            streams[2] = { &vertices->TexCoords, sizeof(Vec2), sizeof(Vertex) };
+            streams[3] = { &vertices->Normal, sizeof(Vec3), sizeof(Vertex) };
+            streams[4] = { &vertices->Tangent, sizeof(Vec3), sizeof(Vertex) };
+            streams[5] = { &vertices->Bitangent, sizeof(Vec3), sizeof(Vertex) };
+            return 6;
+        }
+
+        static uint32_t GetVertexStreams(const AnimVertex* vertices, meshopt_Stream* streams)
+        {
+            streams[0] = { &vertices->Position, sizeof(Vec3), sizeof(AnimVertex) };
+            streams[1] = { &vertices->Colours, sizeof(Vec4), sizeof(AnimVertex) };
+            streams[2] = { &vertices->TexCoords, sizeof(Vec2), sizeof(AnimVertex) };
+            streams[3] = { &vertices->Normal, sizeof(Vec3), sizeof(AnimVertex) };
+            streams[4] = { &vertices->Tangent, sizeof(Vec3), sizeof(AnimVertex) };
+            streams[5] = { &vertices->Bitangent, sizeof(Vec3), sizeof(AnimVertex) };
+            streams[6] = { vertices->BoneInfoIndices, sizeof(vertices->BoneInfoIndices), sizeof(AnimVertex) };
+            streams[7] = { vertices->Weights, sizeof(vertices->Weights), sizeof(AnimVertex) };
+            return 8;
+        }
+
+        template <typename VertexType>
+        static void OptimiseMesh(TDArray<uint32_t>& indices, TDArray<VertexType>& vertices, TDArray<MeshLOD>& lods)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            const MeshOptimiseSettings& settings = Mesh::GetOptimiseSettings();
+
+            lods.Clear();
+            if(indices.Empty() || vertices.Empty())
+                return;
+
+            const size_t indexCount = indices.Size();
+            size_t vertexCount      = vertices.Size();
+
+            if(settings.Optimise)
+            {
+                // Importers often emit a vertex per triangle corner, merge the identical ones first. Compared per
+                // attribute as the vertex structs have padding
+                meshopt_Stream streams[8];
+                const uint32_t streamCount = GetVertexStreams(vertices.Data(), streams);
+
+                TDArray<uint32_t> remap;
+                remap.Resize(vertexCount);
+                vertexCount = meshopt_generateVertexRemapMulti(remap.Data(), indices.Data(), indexCount, vertexCount, streams, streamCount);
+                meshopt_remapIndexBuffer(indices.Data(), indices.Data(), indexCount, remap.Data());
+
+                TDArray<VertexType> remapped;
+                remapped.Resize(vertexCount);
+                meshopt_remapVertexBuffer(remapped.Data(), vertices.Data(), vertices.Size(), sizeof(VertexType), remap.Data());
+                vertices = Move(remapped);
+
+                meshopt_optimizeVertexCache(indices.Data(), indices.Data(), indexCount, vertexCount);
+                meshopt_optimizeOverdraw(indices.Data(), indices.Data(), indexCount, &vertices[0].Position.x, vertexCount, sizeof(VertexType), 1.05f);
+            }
+
+            lods.PushBack({ 0, (uint32_t)indexCount, 0.0f });
+
+            if(settings.LODCount > 1)
+            {
+                const float* positions = &vertices[0].Position.x;
+                const float scale      = meshopt_simplifyScale(positions, vertexCount, sizeof(VertexType));
+
+                TDArray<uint32_t> lodIndices;
+                lodIndices.Resize(indexCount);
+
+                size_t targetCount = indexCount;
+                for(uint32_t lod = 1; lod < settings.LODCount; lod++)
+                {
+                    targetCount = size_t(targetCount * settings.LODReduction);
+
+                    // Each LOD is simplified from LOD 0, so the error doesn't build up along the chain
+                    float error        = 0.0f;
+                    const size_t count = meshopt_simplify(lodIndices.Data(), indices.Data(), indexCount, positions, vertexCount, sizeof(VertexType), targetCount, settings.LODTargetError, &error);
+
+                    // The error limit stopped the simplifier, coarser levels would come out the same
+                    if(count == 0 || count > lods.Back().IndexCount * 9 / 10)
+                        break;
+
+                    if(settings.Optimise)
+                        meshopt_optimizeVertexCache(lodIndices.Data(), lodIndices.Data(), count, vertexCount);
+
+                    const uint32_t offset = (uint32_t)indices.Size();
+                    indices.Resize(offset + count);
+                    MemoryCopy(indices.Data() + offset, lodIndices.Data(), count * sizeof(uint32_t));
+                    lods.PushBack({ offset, (uint32_t)count, error * scale });
+                }
+            }
+
+            if(settings.Optimise)
+            {
+                // Run over every LOD, LOD 0 is first so it decides the order
+                vertexCount = meshopt_optimizeVertexFetch(vertices.Data(), indices.Data(), indices.Size(), vertices.Data(), vertexCount, sizeof(VertexType));
+                vertices.Resize(vertexCount);
+            }
+        }
+
+        void Mesh::Optimise(TDArray<uint32_t>& indices, TDArray<Vertex>& vertices, TDArray<MeshLOD>& lods)
+        {
+            OptimiseMesh(indices, vertices, lods);
+        }
+
+        void Mesh::Optimise(TDArray<uint32_t>& indices, TDArray<AnimVertex>& vertices, TDArray<MeshLOD>& lods)
+        {
+            OptimiseMesh(indices, vertices, lods);
+        }
+
         void Mesh::GenerateNormals(Vertex* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount)
         {
             Vec3* normals = new Vec3[vertexCount];
@@ -128,6 +128,23 @@ namespace Lumos
             Vertex p2;
         };
 
+        // A range of the mesh's index buffer. LOD 0 is the full detail mesh, the rest index the same vertices
+        struct MeshLOD
+        {
+            uint32_t IndexOffset;
+            uint32_t IndexCount;
+            float Error; // Largest deviation from the full detail mesh, in object space units
+        };
+
+        // Applied by the importers before a mesh is created
+        struct MeshOptimiseSettings
+        {
+            bool Optimise        = true;  // Vertex cache, overdraw and vertex fetch order
+            uint32_t LODCount    = 4;     // Including LOD 0. 1 disables simplification
+            float LODReduction   = 0.5f;  // Target index count of each LOD relative to the one before
+            float LODTargetError = 0.05f; // Largest error a LOD may have, relative to the mesh size
+        };
+
         struct MeshStats
         {
             uint32_t TriangleCount;
@@ -142,7 +159,9 @@ namespace Lumos
             Mesh();
             Mesh(const Mesh& mesh);
             Mesh(const TDArray<uint32_t>& indices, const TDArray<Vertex>& vertices);
-            Mesh(const TDArray<uint32_t>& indices, const TDArray<AnimVertex>& vertices);
+            Mesh(const TDArray<uint32_t>& indices, const TDArray<Vertex>& vertices, const TDArray<MeshLOD>& lods);
+            Mesh(const uint32_t* indices, uint32_t indexCount, const Vertex* vertices, uint32_t vertexCount, const MeshLOD* lods = nullptr, uint32_t lodCount = 0);
+            Mesh(const TDArray<uint32_t>& indices, const TDArray<AnimVertex>& vertices, const TDArray<MeshLOD>& lods = {});
             virtual ~Mesh();
 
             const SharedPtr<VertexBuffer>& GetVertexBuffer() const { return m_VertexBuffer; }
@@ -157,6 +176,22 @@ namespace Lumos
             void SetName(const std::string& name) { m_Name = name; }
             const std::string& GetName() const { return m_Name; }
 
+            uint32_t GetLODCount() const { return m_LODs.Empty() ? 1 : (uint32_t)m_LODs.Size(); }
+            const TDArray<MeshLOD>& GetLODs() const { return m_LODs; }
+            MeshLOD GetLOD(uint32_t lod) const;
+
+            // Coarsest LOD whose error covers no more than maxPixelError pixels. pixelsPerUnit is the size on
+            // screen of one object space unit at the mesh's distance
+            uint32_t SelectLOD(float pixelsPerUnit, float maxPixelError) const;
+
+            // Reorders the mesh for the vertex cache, overdraw and vertex fetch, then appends the simplified LODs
+            // to indices. Fills lods with the range of every LOD, LOD 0 first
+            static void Optimise(TDArray<uint32_t>& indices, TDArray<Vertex>& vertices, TDArray<MeshLOD>& lods);
+            static void Optimise(TDArray<uint32_t>& indices, TDArray<AnimVertex>& vertices, TDArray<MeshLOD>& lods);
+
+            static void SetOptimiseSettings(const MeshOptimiseSettings& settings) { s_OptimiseSettings = settings; }
+            static const MeshOptimiseSettings& GetOptimiseSettings() { return s_OptimiseSettings; }
+
             static void GenerateNormals(Vertex* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount);
             static void GenerateTangentsAndBitangents(Vertex* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount);
 
@@ -185,6 +220,9 @@ namespace Lumos
             Maths::BoundingBox m_BoundingBox;
 
             std::string m_Name;
+            TDArray<MeshLOD> m_LODs; // Empty if the mesh has a single LOD
+
+            static MeshOptimiseSettings s_OptimiseSettings;
 
 #ifndef LUMOS_PRODUCTION
             MeshStats m_Stats;
@@ -18,11 +18,14 @@ namespace Lumos::Graphics
     {
     }
 
-    Model::Model(const std::string& filePath)
+    Model::Model(const std::string& filePath, bool createResources)
         : m_FilePath(filePath)
         , m_PrimitiveType(PrimitiveType::File)
     {
-        LoadModel(m_FilePath);
+        if(createResources)
+            LoadModel(m_FilePath);
+        else
+            ImportModel(m_FilePath);
     }
 
     Model::Model(const SharedPtr<Mesh>& mesh, PrimitiveType type)
@@ -41,24 +44,88 @@ namespace Lumos::Graphics
 
     Model::~Model()
     {
+        ReleaseImportData();
+    }
+
+    // The import data is never shared, so a copy made before CreateResources gets no resources
+    Model::Model(const Model& other)
+        : Asset(other)
+        , m_PrimitiveType(other.m_PrimitiveType)
+        , m_Meshes(other.m_Meshes)
+        , m_FilePath(other.m_FilePath)
+        , m_AnimFilePaths(other.m_AnimFilePaths)
+        , m_Skeleton(other.m_Skeleton)
+        , m_Animation(other.m_Animation)
+        , m_SamplingContext(other.m_SamplingContext)
+        , m_AnimationController(other.m_AnimationController)
+        , m_CurrentAnimation(other.m_CurrentAnimation)
+        , m_AnimationFadeDuration(other.m_AnimationFadeDuration)
+        , m_BindPoses(other.m_BindPoses)
+    {
+    }
+
+    Model& Model::operator=(const Model& other)
+    {
+        if(this != &other)
+        {
+            Model copy(other);
+            *this = Move(copy);
+        }
+        return *this;
     }
 
-    Model::Model(const Model&)            = default;
-    Model& Model::operator=(const Model&) = default;
-    Model::Model(Model&&)                 = default;
-    Model& Model::operator=(Model&&)      = default;
+    Model::Model(Model&& other)
+        : Model()
+    {
+        *this = Move(other);
+    }
+
+    Model& Model::operator=(Model&& other)
+    {
+        if(this != &other)
+        {
+            Asset::operator=(other);
+            m_PrimitiveType         = other.m_PrimitiveType;
+            m_Meshes                = Move(other.m_Meshes);
+            m_FilePath              = Move(other.m_FilePath);
+            m_AnimFilePaths         = Move(other.m_AnimFilePaths);
+            m_Skeleton              = Move(other.m_Skeleton);
+            m_Animation             = Move(other.m_Animation);
+            m_SamplingContext       = Move(other.m_SamplingContext);
+            m_AnimationController   = Move(other.m_AnimationController);
+            m_CurrentAnimation      = other.m_CurrentAnimation;
+            m_AnimationFadeDuration = other.m_AnimationFadeDuration;
+            m_BindPoses             = Move(other.m_BindPoses);
+            Swap(m_ImportData, other.m_ImportData);
+        }
+        return *this;
+    }
 
     void Model::LoadModel(const std::string& path)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(ImportModel(path))
+            CreateResources();
+    }
+
+    bool Model::ImportModel(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
         std::string physicalPath;
         if(!Lumos::FileSystem::Get().ResolvePhysicalPath(path, physicalPath))
         {
             LINFO("Failed to load Model - %s", path.c_str());
-            return;
+            return false;
         }
 
         std::string resolvedPath = physicalPath;
+        BeginImport();
+
+        if(LoadCooked(resolvedPath))
+        {
+            LINFO("Loaded Cooked Model - %s", path.c_str());
+            return true;
+        }
 
         const std::string fileExtension = StringUtilities::GetFilePathExtension(path);
 
@@ -69,15 +136,21 @@ namespace Lumos::Graphics
         else if(fileExtension == "fbx" || fileExtension == "FBX")
             LoadFBX(resolvedPath);
         else
+        {
             LERROR("Unsupported File Type : %s", fileExtension.c_str());
+            return false;
+        }
+
+        Cook(resolvedPath);
 
         LINFO("Loaded Model - %s", path.c_str());
+        return true;
     }
 
-    void Model::UpdateAnimation(const TimeStep& dt)
+    bool Model::PrepareAnimation()
     {
         if(m_Animation.Empty())
-            return;
+            return false;
 
         if(!m_SamplingContext)
         {
@@ -95,48 +168,39 @@ namespace Lumos::Graphics
             m_AnimationController->SetBindPoses(m_BindPoses);
         }
 
-        static float time = 0.0f;
-        time += (float)dt.GetSeconds();
-        m_AnimationController->SetCurrentState(m_CurrentAnimation);
-        m_AnimationController->Update(time, *m_SamplingContext.get());
+        return true;
     }
 
-    void Model::UpdateAnimation(const TimeStep& dt, float overrideTime)
+    void Model::UpdateAnimation(const TimeStep& dt)
     {
-        if(m_Animation.Empty())
+        if(!PrepareAnimation())
             return;
 
-        if(!m_SamplingContext)
-        {
-            m_SamplingContext = CreateSharedPtr<SamplingContext>();
-        }
+        // Switching animation blends from the current pose instead of snapping to the new clip
+        m_AnimationController->CrossFade(m_CurrentAnimation, m_AnimationFadeDuration);
+        m_AnimationController->Update((float)dt.GetSeconds(), *m_SamplingContext.get());
+    }
 
-        if(!m_AnimationController)
-        {
-            m_AnimationController = CreateSharedPtr<AnimationController>();
-            m_AnimationController->SetSkeleton(m_Skeleton);
-            for(auto anim : m_Animation)
-            {
-                m_AnimationController->AddState(anim->GetName(), anim);
-            }
-            m_AnimationController->SetBindPoses(m_BindPoses);
-        }
+    void Model::UpdateAnimation(const TimeStep& dt, float overrideTime)
+    {
+        if(!PrepareAnimation())
+            return;
 
         m_AnimationController->SetCurrentState(m_CurrentAnimation);
-        m_AnimationController->Update(overrideTime, *m_SamplingContext.get());
+        m_AnimationController->SetTime(overrideTime);
+        m_AnimationController->Update(0.0f, *m_SamplingContext.get());
     }
 
     TDArray<Mat4> Model::GetJointMatrices()
     {
-        if(m_Animation.Empty())
+        if(m_Animation.Empty() || !m_AnimationController)
             return {};
 
-        auto matrices = m_AnimationController->GetJointMatrices();
-
-        for(int i = 0; i < matrices.Size(); i++)
-        {
-            // matrices[i] = m_BindPoses[i] * matrices[i];
-        }
+        const Mat4* joints = m_AnimationController->GetJointMatrices();
+        TDArray<Mat4> matrices;
+        matrices.Resize(m_AnimationController->GetJointCount());
+        for(uint32_t i = 0; i < (uint32_t)matrices.Size(); i++)
+            matrices[i] = joints[i];
 
         return matrices;
     }
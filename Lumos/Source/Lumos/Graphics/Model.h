@@ -15,6 +15,13 @@ namespace Lumos
         class AnimationController;
         struct SamplingContext;
         class Mesh;
+        struct Vertex;
+        class Texture2D;
+        struct TextureDesc;
+        struct TextureLoadOptions;
+        struct MaterialProperties;
+        struct AnimVertex;
+        struct MeshLOD;
 
         class Model : public Asset
         {
@@ -26,7 +33,9 @@ namespace Lumos
 
         public:
             Model();
-            Model(const std::string& filePath);
+
+            // Without createResources the file is only imported, see ImportModel
+            Model(const std::string& filePath, bool createResources = true);
             Model(const SharedPtr<Mesh>& mesh, PrimitiveType type);
             Model(PrimitiveType type);
 
@@ -43,12 +52,16 @@ namespace Lumos
 
             uint32_t GetCurrentAnimationIndex() const { return m_CurrentAnimation; }
             void SetCurrentAnimationIndex(uint32_t index) { m_CurrentAnimation = index; }
+            void SetAnimationFadeDuration(float seconds) { m_AnimationFadeDuration = seconds; }
 
             const std::string& GetFilePath() const { return m_FilePath; }
             PrimitiveType GetPrimitiveType() { return m_PrimitiveType; }
             void SetPrimitiveType(PrimitiveType type) { m_PrimitiveType = type; }
             SET_ASSET_TYPE(AssetType::Model);
 
+            // Creates the animation controller and sampling context on first use. Returns false if the model
+            // is not animated. After this has run, UpdateAnimation does not allocate and can run on a worker
+            bool PrepareAnimation();
             void UpdateAnimation(const TimeStep& dt);
             void UpdateAnimation(const TimeStep& dt, float overrideTime);
 
@@ -71,7 +84,8 @@ namespace Lumos
             SharedPtr<SamplingContext> m_SamplingContext;
             SharedPtr<AnimationController> m_AnimationController;
 
-            uint32_t m_CurrentAnimation = 0;
+            uint32_t m_CurrentAnimation   = 0;
+            float m_AnimationFadeDuration = 0.25f;
 
             TDArray<Mat4> m_BindPoses;
 
@@ -79,8 +93,34 @@ namespace Lumos
             void LoadGLTF(const std::string& path);
             void LoadFBX(const std::string& path);
 
+            // What the importer or the cooked blob describes, kept from ImportModel until CreateResources.
+            // See ModelCooker.cpp
+            struct ImportData;
+            ImportData* m_ImportData = nullptr;
+
+            bool LoadCooked(const std::string& path);
+            void Cook(const std::string& path);
+            void BeginImport();
+            void ReleaseImportData();
+
         public:
             void LoadModel(const std::string& path);
+
+            // Reads the file, or its cooked blob, into CPU side meshes, materials and decoded textures. Doesn't
+            // touch the graphics API, so it can run on any thread
+            bool ImportModel(const std::string& path);
+
+            // Creates the GPU resources from what ImportModel read. Main thread only
+            void CreateResources();
+
+            // Called by the importers. Textures and materials are referenced by the index these return, -1 is none.
+            // A texture without pixels is decoded from filePath. Material textures are in the order albedo, normal,
+            // metallic, roughness, ao, emissive
+            int32_t ImportTexture(const std::string& name, const std::string& filePath, const TextureDesc& desc, const TextureLoadOptions& options, const uint8_t* pixels = nullptr, uint32_t width = 0, uint32_t height = 0);
+            int32_t ImportMaterial(const std::string& name, const char* shaderName, const MaterialProperties& properties, uint32_t flags, const int32_t textures[6]);
+            void ImportMesh(const std::string& name, int32_t material, TDArray<uint32_t>&& indices, TDArray<Vertex>&& vertices, TDArray<MeshLOD>&& lods);
+            void ImportMesh(const std::string& name, int32_t material, TDArray<uint32_t>&& indices, TDArray<AnimVertex>&& vertices, TDArray<MeshLOD>&& lods);
+            void ImportDependency(const std::string& path);
         };
     }
 }
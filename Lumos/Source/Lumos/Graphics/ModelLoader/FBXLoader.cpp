@@ -27,7 +27,8 @@ const uint32_t MAX_PATH_LENGTH = 260;
 
 namespace Lumos::Graphics
 {
-    std::string m_FBXModelDirectory;
+    // Per thread, models can be imported on several streaming threads at once
+    PerThread std::string m_FBXModelDirectory;
 
     enum class Orientation
     {
@@ -38,7 +39,7 @@ namespace Lumos::Graphics
         X_UP
     };
 
-    Orientation orientation = Orientation::Y_UP;
+    PerThread Orientation orientation = Orientation::Y_UP;
     float fbx_scale         = 1.f;
 
 #if 0
@@ -152,10 +153,10 @@ namespace Lumos::Graphics
         return aMesh->getGeometry()->getVertexCount() == 0;
     }
 
-    Graphics::Texture2D* LoadTexture(const ofbx::Material* material, ofbx::Texture::TextureType type)
+    int32_t LoadTexture(Model* model, const ofbx::Material* material, ofbx::Texture::TextureType type)
     {
         const ofbx::Texture* ofbxTexture = material->getTexture(type);
-        Graphics::Texture2D* texture2D   = nullptr;
+        int32_t texture                  = -1;
         if(ofbxTexture)
         {
             std::string stringFilepath;
@@ -189,21 +190,19 @@ namespace Lumos::Graphics
 
             if(fileFound)
             {
-                texture2D = Graphics::Texture2D::CreateFromFile(stringFilepath, stringFilepath);
+                texture = model->ImportTexture(stringFilepath, stringFilepath, TextureDesc(), TextureLoadOptions());
             }
         }
 
-        return texture2D;
+        return texture;
     }
 
-    SharedPtr<Material> LoadMaterial(const ofbx::Material* material, bool animated)
+    int32_t LoadMaterial(Model* model, const ofbx::Material* material, bool animated)
     {
         // auto shader = animated ? Application::Get().GetShaderLibrary()->GetAsset("//CoreShaders/ForwardPBR.shader") : Application::Get().GetShaderLibrary()->GetAsset("//CoreShaders/ForwardPBR.shader");
-        auto shader = Application::Get().GetAssetManager()->GetAssetData("ForwardPBR").As<Graphics::Shader>();
 
-        SharedPtr<Material> pbrMaterial = CreateSharedPtr<Material>(shader);
-
-        PBRMataterialTextures textures;
+        // albedo, normal, metallic, roughness, ao, emissive
+        int32_t textures[6];
         Graphics::MaterialProperties properties;
 
         properties.albedoColour = ToLumosVector(material->getDiffuseColor());
@@ -213,31 +212,28 @@ namespace Lumos::Graphics
         properties.roughness = roughness;
         properties.roughness = roughness;
 
-        textures.albedo = LoadTexture(material, ofbx::Texture::TextureType::DIFFUSE);
-        textures.normal = LoadTexture(material, ofbx::Texture::TextureType::NORMAL);
-        // textures.metallic = LoadTexture(material, ofbx::Texture::TextureType::REFLECTION);
-        textures.metallic  = LoadTexture(material, ofbx::Texture::TextureType::SPECULAR);
-        textures.roughness = LoadTexture(material, ofbx::Texture::TextureType::SHININESS);
-        textures.emissive  = LoadTexture(material, ofbx::Texture::TextureType::EMISSIVE);
-        textures.ao        = LoadTexture(material, ofbx::Texture::TextureType::AMBIENT);
+        textures[0] = LoadTexture(model, material, ofbx::Texture::TextureType::DIFFUSE);
+        textures[1] = LoadTexture(model, material, ofbx::Texture::TextureType::NORMAL);
+        // textures[2] = LoadTexture(model, material, ofbx::Texture::TextureType::REFLECTION);
+        textures[2] = LoadTexture(model, material, ofbx::Texture::TextureType::SPECULAR);
+        textures[3] = LoadTexture(model, material, ofbx::Texture::TextureType::SHININESS);
+        textures[5] = LoadTexture(model, material, ofbx::Texture::TextureType::EMISSIVE);
+        textures[4] = LoadTexture(model, material, ofbx::Texture::TextureType::AMBIENT);
 
-        if(!textures.albedo)
+        if(textures[0] < 0)
             properties.albedoMapFactor = 0.0f;
-        if(!textures.normal)
+        if(textures[1] < 0)
             properties.normalMapFactor = 0.0f;
-        if(!textures.metallic)
+        if(textures[2] < 0)
             properties.metallicMapFactor = 0.0f;
-        if(!textures.roughness)
+        if(textures[3] < 0)
             properties.roughnessMapFactor = 0.0f;
-        if(!textures.emissive)
+        if(textures[5] < 0)
             properties.emissiveMapFactor = 0.0f;
-        if(!textures.ao)
+        if(textures[4] < 0)
             properties.occlusionMapFactor = 0.0f;
 
-        pbrMaterial->SetTextures(textures);
-        pbrMaterial->SetMaterialProperites(properties);
-
-        return pbrMaterial;
+        return model->ImportMaterial("", "ForwardPBR", properties, (uint32_t)Material::RenderFlags::DEPTHTEST, textures);
     }
 
     Maths::Transform GetTransform(const ofbx::Object* mesh)
@@ -267,7 +263,7 @@ namespace Lumos::Graphics
         return transform;
     }
 
-    SharedPtr<Graphics::Mesh> LoadMesh(const ofbx::Mesh* fbxMesh, int32_t triangleStart, int32_t triangleEnd)
+    void LoadMesh(Model* model, const ofbx::Mesh* fbxMesh, int32_t triangleStart, int32_t triangleEnd)
     {
         const int32_t firstVertexOffset = triangleStart * 3;
         const int32_t lastVertexOffset  = triangleEnd * 3;
@@ -331,20 +327,19 @@ namespace Lumos::Graphics
                 material = fbxMesh->getMaterial(0);
         }
 
-        SharedPtr<Material> pbrMaterial;
+        int32_t pbrMaterial = -1;
         if(material)
         {
-            pbrMaterial = LoadMaterial(material, false);
+            pbrMaterial = LoadMaterial(model, material, false);
         }
 
-        auto mesh = CreateSharedPtr<Graphics::Mesh>(indicesArray, tempvertices);
-        mesh->SetName(fbxMesh->name);
-        if(material)
-            mesh->SetMaterial(pbrMaterial);
+        TDArray<Graphics::MeshLOD> lods;
+        Graphics::Mesh::Optimise(indicesArray, tempvertices, lods);
 
-        mesh->Graphics::Mesh::GenerateTangentsAndBitangents(tempvertices.Data(), uint32_t(vertexCount), indicesArray.Data(), uint32_t(indicesArray.Size()));
+        const uint32_t lod0IndexCount = lods.Empty() ? uint32_t(indicesArray.Size()) : lods[0].IndexCount;
+        Graphics::Mesh::GenerateTangentsAndBitangents(tempvertices.Data(), uint32_t(tempvertices.Size()), indicesArray.Data(), lod0IndexCount);
 
-        return mesh;
+        model->ImportMesh(fbxMesh->name, pbrMaterial, Move(indicesArray), Move(tempvertices), Move(lods));
     }
 
     Mat4 FbxMatrixToLM(const ofbx::Matrix& mat)
@@ -446,7 +441,7 @@ namespace Lumos::Graphics
 
             if(fbxMesh->getMaterialCount() < 2 || !geometry->getMaterials())
             {
-                m_Meshes.PushBack(LoadMesh(fbxMesh, 0, trianglesCount - 1));
+                LoadMesh(this, fbxMesh, 0, trianglesCount - 1);
             }
             else
             {
@@ -459,14 +454,14 @@ namespace Lumos::Graphics
                 {
                     if(rangeStartMaterial != materials[triangleIndex])
                     {
-                        m_Meshes.PushBack(LoadMesh(fbxMesh, rangeStart, triangleIndex - 1));
+                        LoadMesh(this, fbxMesh, rangeStart, triangleIndex - 1);
 
                         // Start a new range
                         rangeStart         = triangleIndex;
                         rangeStartMaterial = materials[triangleIndex];
                     }
                 }
-                m_Meshes.PushBack(LoadMesh(fbxMesh, rangeStart, trianglesCount - 1));
+                LoadMesh(this, fbxMesh, rangeStart, trianglesCount - 1);
             } }
 #ifdef THREAD_MESH_LOADING
         );
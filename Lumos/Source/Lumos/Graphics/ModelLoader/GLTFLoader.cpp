@@ -58,7 +58,6 @@ namespace Lumos::Graphics
 
     static HashMap(int, int) GLTF_COMPONENT_LENGTH_LOOKUP;
     static HashMap(int, int) GLTF_COMPONENT_BYTE_SIZE_LOOKUP;
-    static bool HashMapsInitialised = false;
     static Graphics::TextureWrap GetWrapMode(int mode)
     {
         switch(mode)
@@ -91,11 +90,11 @@ namespace Lumos::Graphics
         }
     }
 
-    TDArray<SharedPtr<Material>> LoadMaterials(tinygltf::Model& gltfModel)
+    TDArray<int32_t> LoadMaterials(Model* mainModel, tinygltf::Model& gltfModel)
     {
         LUMOS_PROFILE_FUNCTION();
-        TDArray<SharedPtr<Graphics::Texture2D>> loadedTextures;
-        TDArray<SharedPtr<Material>> loadedMaterials;
+        TDArray<int32_t> loadedTextures;
+        TDArray<int32_t> loadedMaterials;
         loadedTextures.Reserve(gltfModel.textures.size());
         loadedMaterials.Reserve(gltfModel.materials.size());
         bool animated = false;
@@ -161,8 +160,7 @@ namespace Lumos::Graphics
                     freeData = true;
                 }
 
-                Graphics::Texture2D* texture2D = Graphics::Texture2D::CreateFromSource(texWidth, texHeight, pixels, params);
-                loadedTextures.PushBack(SharedPtr<Graphics::Texture2D>(texture2D ? texture2D : nullptr));
+                loadedTextures.PushBack(mainModel->ImportTexture("", "", params, TextureLoadOptions(), pixels, texWidth, texHeight));
                 if(freeData)
                     free(pixels);
 
@@ -181,28 +179,28 @@ namespace Lumos::Graphics
                     return loadedTextures[tex.source];
                 }
             }
-            return SharedPtr<Graphics::Texture2D>();
+            return -1;
         };
 
         for(tinygltf::Material& mat : gltfModel.materials)
         {
             // TODO : if(isAnimated) Load deferredColourAnimated;
             // auto shader = Application::Get().GetShaderLibrary()->GetAsset("//CoreShaders/ForwardPBR.shader");
-            auto shader = Application::Get().GetAssetManager()->GetAssetData(animated ? "ForwardPBRAnim" : "ForwardPBR").As<Graphics::Shader>();
+            const char* shaderName = animated ? "ForwardPBRAnim" : "ForwardPBR";
 
-            SharedPtr<Material> pbrMaterial = CreateSharedPtr<Material>(shader);
-            PBRMataterialTextures textures;
+            // albedo, normal, metallic, roughness, ao, emissive
+            int32_t textures[6] = { -1, -1, -1, -1, -1, -1 };
             Graphics::MaterialProperties properties;
 
             const tinygltf::PbrMetallicRoughness& pbr = mat.pbrMetallicRoughness;
-            textures.albedo                           = TextureName(pbr.baseColorTexture.index);
-            textures.normal                           = TextureName(mat.normalTexture.index);
-            textures.ao                               = TextureName(mat.occlusionTexture.index);
-            textures.emissive                         = TextureName(mat.emissiveTexture.index);
-            textures.metallic                         = TextureName(pbr.metallicRoughnessTexture.index);
+            textures[0]                               = TextureName(pbr.baseColorTexture.index);
+            textures[1]                               = TextureName(mat.normalTexture.index);
+            textures[4]                               = TextureName(mat.occlusionTexture.index);
+            textures[5]                               = TextureName(mat.emissiveTexture.index);
+            textures[2]                               = TextureName(pbr.metallicRoughnessTexture.index);
 
             // TODO: correct way of handling this
-            if(textures.metallic)
+            if(textures[2] >= 0)
                 properties.workflow = PBR_WORKFLOW_METALLIC_ROUGHNESS;
             else
                 properties.workflow = PBR_WORKFLOW_SEPARATE_TEXTURES;
@@ -236,13 +234,13 @@ namespace Lumos::Graphics
                 if(metallicGlossinessWorkflow->second.Has("diffuseTexture"))
                 {
                     int index       = metallicGlossinessWorkflow->second.Get("diffuseTexture").Get("index").Get<int>();
-                    textures.albedo = loadedTextures[gltfModel.textures[index].source];
+                    textures[0]     = loadedTextures[gltfModel.textures[index].source];
                 }
 
                 if(metallicGlossinessWorkflow->second.Has("metallicGlossinessTexture"))
                 {
                     int index           = metallicGlossinessWorkflow->second.Get("metallicGlossinessTexture").Get("index").Get<int>();
-                    textures.roughness  = loadedTextures[gltfModel.textures[index].source];
+                    textures[3]         = loadedTextures[gltfModel.textures[index].source];
                     properties.workflow = PBR_WORKFLOW_SPECULAR_GLOSINESS;
                 }
 
@@ -280,26 +278,22 @@ namespace Lumos::Graphics
                 }
             }
 
-            pbrMaterial->SetTextures(textures);
-            pbrMaterial->SetMaterialProperites(properties);
-            pbrMaterial->SetName(mat.name);
+            uint32_t flags = (uint32_t)Graphics::Material::RenderFlags::DEPTHTEST;
 
             if(mat.doubleSided)
-                pbrMaterial->SetFlag(Graphics::Material::RenderFlags::TWOSIDED);
+                flags |= (uint32_t)Graphics::Material::RenderFlags::TWOSIDED;
 
             if(mat.alphaMode != "OPAQUE")
-                pbrMaterial->SetFlag(Graphics::Material::RenderFlags::ALPHABLEND);
+                flags |= (uint32_t)Graphics::Material::RenderFlags::ALPHABLEND;
 
-            loadedMaterials.PushBack(pbrMaterial);
+            loadedMaterials.PushBack(mainModel->ImportMaterial(mat.name, shaderName, properties, flags, textures));
         }
 
         return loadedMaterials;
     }
 
-    TDArray<Graphics::Mesh*> LoadMesh(tinygltf::Model& model, tinygltf::Mesh& mesh, TDArray<SharedPtr<Material>>& materials, Maths::Transform& parentTransform)
+    void LoadMesh(Model* mainModel, tinygltf::Model& model, tinygltf::Mesh& mesh, TDArray<int32_t>& materials, Maths::Transform& parentTransform)
     {
-        TDArray<Graphics::Mesh*> meshes;
-
         for(auto& primitive : mesh.primitives)
         {
             TDArray<Graphics::Vertex> vertices;
@@ -637,7 +631,7 @@ namespace Lumos::Graphics
                 Graphics::Mesh::GenerateTangentsAndBitangents(vertices.Data(), uint32_t(vertices.Size()), indices.Data(), uint32_t(indices.Size()));
 
             // Add mesh
-            Graphics::Mesh* lMesh;
+            int32_t materialIndex = primitive.material >= 0 && primitive.material < (int)materials.Size() ? materials[primitive.material] : -1;
 
             if(hasJoints || hasWeights)
             {
@@ -651,47 +645,20 @@ namespace Lumos::Graphics
                     animVertices[i].Bitangent = vertices[i].Bitangent;
                     animVertices[i].TexCoords = vertices[i].TexCoords;
                 }
-                lMesh = new Graphics::Mesh(indices, animVertices);
+                TDArray<Graphics::MeshLOD> lods;
+                Graphics::Mesh::Optimise(indices, animVertices, lods);
+                mainModel->ImportMesh(mesh.name, materialIndex, Move(indices), Move(animVertices), Move(lods));
             }
             else
-                lMesh = new Graphics::Mesh(indices, vertices);
-
-            // Moved from mesh
-            // Move this lbmesh
-            /*
-            // int lod = 2;
-            // float threshold = powf(0.7f, float(lod));
-
-            if(optimise)
             {
-                size_t indexCount         = indices.Size();
-                size_t vertexCount        = vertices.Size();
-
-                size_t target_index_count = size_t(indices.Size() * optimiseThreshold);
-
-                float target_error = 1e-3f;
-                float* resultError = nullptr;
-
-                auto newIndexCount = meshopt_simplify(indices.Data(), indices.Data(), indices.Size(), (const float*)(&vertices[0]), vertices.Size(), sizeof(Graphics::Vertex), target_index_count, target_error, resultError);
-
-                auto newVertexCount = meshopt_optimizeVertexFetch( // return vertices (not vertex attribute values)
-                    (vertices.Data()),
-                    (unsigned int*)(indices.Data()),
-                    newIndexCount, // total new indices (not faces)
-                    (vertices.Data()),
-                    (size_t)vertices.Size(), // total vertices (not vertex attribute values)
-                    sizeof(Graphics::Vertex)   // vertex stride
-                );
+                TDArray<Graphics::MeshLOD> lods;
+                Graphics::Mesh::Optimise(indices, vertices, lods);
+                mainModel->ImportMesh(mesh.name, materialIndex, Move(indices), Move(vertices), Move(lods));
             }
-
-            */
-            meshes.EmplaceBack(lMesh);
         }
-
-        return meshes;
     }
 
-    void LoadNode(Model* mainModel, int nodeIndex, const Mat4& parentTransform, tinygltf::Model& model, TDArray<SharedPtr<Material>>& materials, TDArray<TDArray<Graphics::Mesh*>>& meshes)
+    void LoadNode(Model* mainModel, int nodeIndex, const Mat4& parentTransform, tinygltf::Model& model, TDArray<int32_t>& materials)
     {
         LUMOS_PROFILE_FUNCTION();
         if(nodeIndex < 0)
@@ -752,35 +719,18 @@ namespace Lumos::Graphics
 
         if(node.mesh >= 0)
         {
-            int subIndex = 0;
+            LoadMesh(mainModel, model, model.meshes[node.mesh], materials, transform);
 
-            auto meshes = LoadMesh(model, model.meshes[node.mesh], materials, transform);
-
-            for(auto& mesh : meshes)
-            {
-                auto subname = model.meshes[node.mesh].name;
-                auto lMesh   = SharedPtr<Graphics::Mesh>(mesh);
-                lMesh->SetName(subname);
-
-                int materialIndex = model.meshes[node.mesh].primitives[subIndex].material;
-                if(materialIndex >= 0)
-                    lMesh->SetMaterial(materials[materialIndex]);
-
-                mainModel->AddMesh(lMesh);
-
-                // if (node.skin >= 0)
-                // {
-                // }
-
-                subIndex++;
-            }
+            // if (node.skin >= 0)
+            // {
+            // }
         }
 
         if(!node.children.empty())
         {
             for(int child : node.children)
             {
-                LoadNode(mainModel, child, transform.GetLocalMatrix(), model, materials, meshes);
+                LoadNode(mainModel, child, transform.GetLocalMatrix(), model, materials);
             }
         }
     }
@@ -808,72 +758,74 @@ namespace Lumos::Graphics
         return glmMat;
     }
 
-    void Model::LoadGLTF(const std::string& path)
+    static void InitialiseComponentLookups()
     {
-        LUMOS_PROFILE_FUNCTION();
+        HashMapInit(&GLTF_COMPONENT_LENGTH_LOOKUP);
+        HashMapInit(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP);
 
-        if(!HashMapsInitialised)
+        int key   = (int)TINYGLTF_TYPE_SCALAR;
+        int value = 1;
         {
-            HashMapInit(&GLTF_COMPONENT_LENGTH_LOOKUP);
-            HashMapInit(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP);
+            HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
+            key   = (int)TINYGLTF_TYPE_VEC2;
+            value = 2;
+            HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
+
+            key   = (int)TINYGLTF_TYPE_VEC3;
+            value = 3;
+            HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
+
+            key   = (int)TINYGLTF_TYPE_VEC4;
+            value = 4;
+            HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
+
+            key   = (int)TINYGLTF_TYPE_MAT2;
+            value = 4;
+            HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
+
+            key   = (int)TINYGLTF_TYPE_MAT3;
+            value = 9;
+            HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
+
+            key   = (int)TINYGLTF_TYPE_MAT4;
+            value = 16;
+            HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
+        }
 
-            int key   = (int)TINYGLTF_TYPE_SCALAR;
-            int value = 1;
-            {
-                HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
-                key   = (int)TINYGLTF_TYPE_VEC2;
-                value = 2;
-                HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
-
-                key   = (int)TINYGLTF_TYPE_VEC3;
-                value = 3;
-                HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
-
-                key   = (int)TINYGLTF_TYPE_VEC4;
-                value = 4;
-                HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
-
-                key   = (int)TINYGLTF_TYPE_MAT2;
-                value = 4;
-                HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
-
-                key   = (int)TINYGLTF_TYPE_MAT3;
-                value = 9;
-                HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
-
-                key   = (int)TINYGLTF_TYPE_MAT4;
-                value = 16;
-                HashMapInsert(&GLTF_COMPONENT_LENGTH_LOOKUP, key, value);
-            }
+        {
+            key   = (int)TINYGLTF_COMPONENT_TYPE_BYTE;
+            value = 1;
+            HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
 
-            {
-                key   = (int)TINYGLTF_COMPONENT_TYPE_BYTE;
-                value = 1;
-                HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
+            key   = (int)TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+            value = 1;
+            HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
 
-                key   = (int)TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
-                value = 1;
-                HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
+            key   = (int)TINYGLTF_COMPONENT_TYPE_SHORT;
+            value = 2;
+            HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
 
-                key   = (int)TINYGLTF_COMPONENT_TYPE_SHORT;
-                value = 2;
-                HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
+            key   = (int)TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+            value = 2;
+            HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
 
-                key   = (int)TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
-                value = 2;
-                HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
+            key   = (int)TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+            value = 4;
+            HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
 
-                key   = (int)TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
-                value = 4;
-                HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
+            key   = (int)TINYGLTF_COMPONENT_TYPE_FLOAT;
+            value = 4;
+            HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
+        }
+    }
 
-                key   = (int)TINYGLTF_COMPONENT_TYPE_FLOAT;
-                value = 4;
-                HashMapInsert(&GLTF_COMPONENT_BYTE_SIZE_LOOKUP, key, value);
-            }
+    void Model::LoadGLTF(const std::string& path)
+    {
+        LUMOS_PROFILE_FUNCTION();
 
-            HashMapsInitialised = true;
-        }
+        // Models can be imported on several streaming threads at once
+        static const bool lookupsInitialised = (InitialiseComponentLookups(), true);
+        (void)lookupsInitialised;
 
         tinygltf::Model model;
         tinygltf::TinyGLTF loader;
@@ -915,15 +867,27 @@ namespace Lumos::Graphics
         {
             LUMOS_PROFILE_SCOPE("Parse GLTF Model");
 
-            auto LoadedMaterials = LoadMaterials(model);
+            auto LoadedMaterials = LoadMaterials(this, model);
+
+            // External buffers and images are part of the cooked model too
+            const std::string directory = path.substr(0, path.find_last_of('/') + 1);
+            for(const tinygltf::Buffer& buffer : model.buffers)
+            {
+                if(!buffer.uri.empty() && buffer.uri.rfind("data:", 0) != 0)
+                    ImportDependency(directory + buffer.uri);
+            }
+            for(const tinygltf::Image& image : model.images)
+            {
+                if(!image.uri.empty() && image.uri.rfind("data:", 0) != 0)
+                    ImportDependency(directory + image.uri);
+            }
 
             std::string name = path.substr(path.find_last_of('/') + 1);
 
-            auto meshes                      = TDArray<TDArray<Graphics::Mesh*>>();
             const tinygltf::Scene& gltfScene = model.scenes[Lumos::Maths::Max(0, model.defaultScene)];
             for(size_t i = 0; i < gltfScene.nodes.size(); i++)
             {
-                LoadNode(this, gltfScene.nodes[i], Mat4(1.0f), model, LoadedMaterials, meshes);
+                LoadNode(this, gltfScene.nodes[i], Mat4(1.0f), model, LoadedMaterials);
             }
 
             auto skins = model.skins;
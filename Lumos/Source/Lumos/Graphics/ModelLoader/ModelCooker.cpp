@@ -0,0 +1,546 @@
+#include "Precompiled.h"
+#include "Graphics/Model.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/Material.h"
+#include "Graphics/RHI/Texture.h"
+#include "Core/Application.h"
+#include "Core/Asset/AssetManager.h"
+#include "Core/Asset/AssetCache.h"
+#include "Utilities/LoadImage.h"
+
+namespace Lumos::Graphics
+{
+    // Bump when the importers change what they build, so old blobs are ignored
+    static const uint32_t CookedModelVersion = 4;
+
+    // Shaders the importers give their materials
+    static const char* CookedModelShaders[] = { "ForwardPBR", "ForwardPBRAnim" };
+
+    struct Model::ImportData
+    {
+        struct TextureData
+        {
+            std::string Name;
+            std::string FilePath;
+            TextureDesc Desc;
+            TextureLoadOptions Options;
+            TDArray<uint8_t> Pixels;
+            const uint8_t* CookedPixels = nullptr; // Set instead of Pixels when they are in the cooked blob
+            uint32_t Width              = 0;
+            uint32_t Height             = 0;
+            bool Embedded               = false; // Came with the model, otherwise decoded from FilePath
+
+            const uint8_t* GetPixels() const { return CookedPixels ? CookedPixels : Pixels.Data(); }
+        };
+
+        struct MaterialData
+        {
+            std::string Name;
+            std::string ShaderName;
+            MaterialProperties Properties;
+            uint32_t Flags      = 0;
+            int32_t Textures[6] = { -1, -1, -1, -1, -1, -1 };
+        };
+
+        struct MeshData
+        {
+            std::string Name;
+            int32_t Material = -1;
+            TDArray<uint32_t> Indices;
+            TDArray<Vertex> Vertices;
+            TDArray<AnimVertex> AnimVertices;
+            TDArray<MeshLOD> LODs;
+
+            // Set instead of the arrays above when the mesh is in the cooked blob
+            const uint32_t* CookedIndices = nullptr;
+            const Vertex* CookedVertices  = nullptr;
+            const MeshLOD* CookedLODs     = nullptr;
+            uint32_t CookedIndexCount     = 0;
+            uint32_t CookedVertexCount    = 0;
+            uint32_t CookedLODCount       = 0;
+        };
+
+        TDArray<TextureData> Textures;
+        TDArray<MaterialData> Materials;
+        TDArray<MeshData> Meshes;
+        TDArray<std::string> Dependencies;
+        CookedAsset Cooked; // Keeps the blob mapped until the resources are created from it
+    };
+
+    // Payload layout: CookedModelInfo, the textures, the materials, then the meshes. Each array starts on a
+    // 16 byte boundary so meshes can be uploaded straight from the mapped file
+    struct CookedModelInfo
+    {
+        uint32_t TextureCount;
+        uint32_t MaterialCount;
+        uint32_t MeshCount;
+        uint32_t Padding;
+    };
+
+    struct CookedTextureInfo
+    {
+        TextureDesc Desc;
+        TextureLoadOptions Options;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Embedded;
+    };
+
+    // MaterialProperties isn't trivially copyable because of its Vec4, so the fields are written out one by one
+    struct CookedMaterialProperties
+    {
+        float AlbedoColour[4];
+        float Roughness;
+        float Metallic;
+        float Reflectance;
+        float Emissive;
+        float AlbedoMapFactor;
+        float MetallicMapFactor;
+        float RoughnessMapFactor;
+        float NormalMapFactor;
+        float EmissiveMapFactor;
+        float OcclusionMapFactor;
+        float AlphaCutoff;
+        float Workflow;
+    };
+
+    struct CookedMaterialInfo
+    {
+        CookedMaterialProperties Properties;
+        uint32_t Flags;
+        int32_t Textures[6];
+    };
+
+    struct CookedMeshInfo
+    {
+        int32_t Material;
+        uint32_t IndexCount;
+        uint32_t VertexCount;
+        uint32_t LODCount;
+    };
+
+    static uint64_t GetCookedModelSettingsHash()
+    {
+        // Embedded textures are resized to the max image size and meshes are optimised when imported
+        uint32_t settings[3] = { CookedModelVersion };
+        GetMaxImageDimensions(settings[1], settings[2]);
+
+        const MeshOptimiseSettings& optimiseSettings = Mesh::GetOptimiseSettings();
+        uint64_t hash                                = AssetCache::Hash(settings, sizeof(settings));
+        hash                                         = AssetCache::Hash(&optimiseSettings.Optimise, sizeof(bool), hash);
+        hash                                         = AssetCache::Hash(&optimiseSettings.LODCount, sizeof(uint32_t), hash);
+        hash                                         = AssetCache::Hash(&optimiseSettings.LODReduction, sizeof(float), hash);
+        return AssetCache::Hash(&optimiseSettings.LODTargetError, sizeof(float), hash);
+    }
+
+    static void CookMaterialProperties(const MaterialProperties& properties, CookedMaterialProperties& cooked)
+    {
+        cooked.AlbedoColour[0]    = properties.albedoColour.x;
+        cooked.AlbedoColour[1]    = properties.albedoColour.y;
+        cooked.AlbedoColour[2]    = properties.albedoColour.z;
+        cooked.AlbedoColour[3]    = properties.albedoColour.w;
+        cooked.Roughness          = properties.roughness;
+        cooked.Metallic           = properties.metallic;
+        cooked.Reflectance        = properties.reflectance;
+        cooked.Emissive           = properties.emissive;
+        cooked.AlbedoMapFactor    = properties.albedoMapFactor;
+        cooked.MetallicMapFactor  = properties.metallicMapFactor;
+        cooked.RoughnessMapFactor = properties.roughnessMapFactor;
+        cooked.NormalMapFactor    = properties.normalMapFactor;
+        cooked.EmissiveMapFactor  = properties.emissiveMapFactor;
+        cooked.OcclusionMapFactor = properties.occlusionMapFactor;
+        cooked.AlphaCutoff        = properties.alphaCutoff;
+        cooked.Workflow           = properties.workflow;
+    }
+
+    static void LoadMaterialProperties(const CookedMaterialProperties& cooked, MaterialProperties& properties)
+    {
+        properties.albedoColour       = Vec4(cooked.AlbedoColour[0], cooked.AlbedoColour[1], cooked.AlbedoColour[2], cooked.AlbedoColour[3]);
+        properties.roughness          = cooked.Roughness;
+        properties.metallic           = cooked.Metallic;
+        properties.reflectance        = cooked.Reflectance;
+        properties.emissive           = cooked.Emissive;
+        properties.albedoMapFactor    = cooked.AlbedoMapFactor;
+        properties.metallicMapFactor  = cooked.MetallicMapFactor;
+        properties.roughnessMapFactor = cooked.RoughnessMapFactor;
+        properties.normalMapFactor    = cooked.NormalMapFactor;
+        properties.emissiveMapFactor  = cooked.EmissiveMapFactor;
+        properties.occlusionMapFactor = cooked.OcclusionMapFactor;
+        properties.alphaCutoff        = cooked.AlphaCutoff;
+        properties.workflow           = cooked.Workflow;
+    }
+
+    static void SetMaterialTextures(PBRMataterialTextures& textures, const TDArray<SharedPtr<Texture2D>>& loaded, const int32_t indices[6])
+    {
+        SharedPtr<Texture2D>* slots[6] = { &textures.albedo, &textures.normal, &textures.metallic, &textures.roughness, &textures.ao, &textures.emissive };
+        for(uint32_t i = 0; i < 6; i++)
+        {
+            if(indices[i] >= 0 && indices[i] < (int32_t)loaded.Size())
+                *slots[i] = loaded[indices[i]];
+        }
+    }
+
+    void Model::BeginImport()
+    {
+        ReleaseImportData();
+        m_ImportData = new ImportData();
+    }
+
+    void Model::ReleaseImportData()
+    {
+        delete m_ImportData;
+        m_ImportData = nullptr;
+    }
+
+    int32_t Model::ImportTexture(const std::string& name, const std::string& filePath, const TextureDesc& desc, const TextureLoadOptions& options, const uint8_t* pixels, uint32_t width, uint32_t height)
+    {
+        if(!m_ImportData)
+            return -1;
+
+        // A file used by several materials is only decoded once
+        for(uint32_t i = 0; !pixels && i < (uint32_t)m_ImportData->Textures.Size(); i++)
+        {
+            if(!m_ImportData->Textures[i].Embedded && m_ImportData->Textures[i].FilePath == filePath)
+                return (int32_t)i;
+        }
+
+        ImportData::TextureData texture;
+        texture.Name     = name;
+        texture.FilePath = filePath;
+        texture.Desc     = desc;
+        texture.Options  = options;
+        texture.Embedded = pixels != nullptr;
+
+        if(pixels)
+        {
+            const uint64_t size = uint64_t(width) * uint64_t(height) * Texture::GetStrideFromFormat(desc.format);
+            texture.Pixels.Resize(size);
+            MemoryCopy(texture.Pixels.Data(), pixels, size);
+            texture.Width  = width;
+            texture.Height = height;
+        }
+        else
+        {
+            LUMOS_PROFILE_SCOPE("Model::ImportTexture::Decode");
+            ImageLoadDesc imageLoadDesc = {};
+            imageLoadDesc.filePath      = filePath.c_str();
+            if(!LoadImageFromFile(imageLoadDesc) || !imageLoadDesc.outPixels)
+            {
+                LWARN("Failed to load texture %s", filePath.c_str());
+                return -1;
+            }
+
+            const uint64_t size = uint64_t(imageLoadDesc.outWidth) * uint64_t(imageLoadDesc.outHeight) * imageLoadDesc.outBits / 8;
+            texture.Pixels.Resize(size);
+            MemoryCopy(texture.Pixels.Data(), imageLoadDesc.outPixels, size);
+            delete[] imageLoadDesc.outPixels;
+
+            texture.Desc.format = Texture::BitsToFormat(imageLoadDesc.outBits);
+            texture.Width       = imageLoadDesc.outWidth;
+            texture.Height      = imageLoadDesc.outHeight;
+        }
+
+        m_ImportData->Textures.PushBack(Move(texture));
+        return (int32_t)m_ImportData->Textures.Size() - 1;
+    }
+
+    int32_t Model::ImportMaterial(const std::string& name, const char* shaderName, const MaterialProperties& properties, uint32_t flags, const int32_t textures[6])
+    {
+        if(!m_ImportData)
+            return -1;
+
+        ImportData::MaterialData& material = m_ImportData->Materials.EmplaceBack();
+        material.Name                      = name;
+        material.ShaderName                = shaderName;
+        material.Properties                = properties;
+        material.Flags                     = flags;
+        for(uint32_t slot = 0; slot < 6; slot++)
+            material.Textures[slot] = textures[slot];
+
+        return (int32_t)m_ImportData->Materials.Size() - 1;
+    }
+
+    void Model::ImportMesh(const std::string& name, int32_t material, TDArray<uint32_t>&& indices, TDArray<Vertex>&& vertices, TDArray<MeshLOD>&& lods)
+    {
+        if(!m_ImportData)
+            return;
+
+        ImportData::MeshData& mesh = m_ImportData->Meshes.EmplaceBack();
+        mesh.Name                  = name;
+        mesh.Material              = material;
+        mesh.Indices               = Move(indices);
+        mesh.Vertices              = Move(vertices);
+        mesh.LODs                  = Move(lods);
+    }
+
+    void Model::ImportMesh(const std::string& name, int32_t material, TDArray<uint32_t>&& indices, TDArray<AnimVertex>&& vertices, TDArray<MeshLOD>&& lods)
+    {
+        if(!m_ImportData)
+            return;
+
+        ImportData::MeshData& mesh = m_ImportData->Meshes.EmplaceBack();
+        mesh.Name                  = name;
+        mesh.Material              = material;
+        mesh.Indices               = Move(indices);
+        mesh.AnimVertices          = Move(vertices);
+        mesh.LODs                  = Move(lods);
+    }
+
+    void Model::ImportDependency(const std::string& path)
+    {
+        if(m_ImportData)
+            m_ImportData->Dependencies.PushBack(path);
+    }
+
+    void Model::CreateResources()
+    {
+        if(!m_ImportData)
+            return;
+
+        LUMOS_PROFILE_FUNCTION();
+        const ImportData& importData = *m_ImportData;
+
+        TDArray<SharedPtr<Texture2D>> textures;
+        textures.Reserve(importData.Textures.Size());
+        for(const ImportData::TextureData& texture : importData.Textures)
+        {
+            SharedPtr<Texture2D> texture2D = SharedPtr<Texture2D>(Texture2D::CreateFromSource(texture.Width, texture.Height, (void*)texture.GetPixels(), texture.Desc, texture.Options));
+            if(texture2D && !texture.Name.empty())
+                texture2D->SetName(texture.Name);
+            if(texture2D && !texture.Embedded)
+                texture2D->SetFilepath(texture.FilePath);
+
+            textures.PushBack(texture2D);
+        }
+
+        TDArray<SharedPtr<Material>> materials;
+        materials.Reserve(importData.Materials.Size());
+        for(const ImportData::MaterialData& materialData : importData.Materials)
+        {
+            auto shader = Application::Get().GetAssetManager()->GetAssetData(materialData.ShaderName).As<Shader>();
+
+            PBRMataterialTextures materialTextures;
+            SetMaterialTextures(materialTextures, textures, materialData.Textures);
+
+            SharedPtr<Material> material = CreateSharedPtr<Material>(shader);
+            material->SetTextures(materialTextures);
+            material->SetMaterialProperites(materialData.Properties);
+            if(!materialData.Name.empty())
+                material->SetName(materialData.Name);
+            for(uint32_t bit = 0; bit < 32; bit++)
+                material->SetFlag((Material::RenderFlags)(1u << bit), (materialData.Flags & (1u << bit)) != 0);
+
+            materials.PushBack(material);
+        }
+
+        for(const ImportData::MeshData& meshData : importData.Meshes)
+        {
+            SharedPtr<Mesh> mesh;
+            if(meshData.CookedIndices)
+                mesh = CreateSharedPtr<Mesh>(meshData.CookedIndices, meshData.CookedIndexCount, meshData.CookedVertices, meshData.CookedVertexCount, meshData.CookedLODs, meshData.CookedLODCount);
+            else if(!meshData.AnimVertices.Empty())
+                mesh = CreateSharedPtr<Mesh>(meshData.Indices, meshData.AnimVertices, meshData.LODs);
+            else
+                mesh = CreateSharedPtr<Mesh>(meshData.Indices, meshData.Vertices, meshData.LODs);
+
+            mesh->SetName(meshData.Name);
+            if(meshData.Material >= 0 && meshData.Material < (int32_t)materials.Size())
+                mesh->SetMaterial(materials[meshData.Material]);
+
+            m_Meshes.PushBack(mesh);
+        }
+
+        ReleaseImportData();
+    }
+
+    void Model::Cook(const std::string& path)
+    {
+        if(!m_ImportData || !AssetCache::Get().IsEnabled())
+            return;
+
+        LUMOS_PROFILE_FUNCTION();
+        const ImportData& importData = *m_ImportData;
+
+        // Animated models keep going through the importer, the skeleton and clips are rebuilt by ozz
+        bool cookable = !m_Skeleton && m_Animation.Empty() && !importData.Meshes.Empty();
+        for(const ImportData::MeshData& mesh : importData.Meshes)
+            cookable = cookable && mesh.AnimVertices.Empty();
+
+        for(const ImportData::MaterialData& material : importData.Materials)
+        {
+            bool knownShader = false;
+            for(const char* name : CookedModelShaders)
+                knownShader = knownShader || material.ShaderName == name;
+            cookable = cookable && knownShader;
+        }
+
+        if(!cookable)
+            return;
+
+        CookedAssetWriter writer;
+        CookedModelInfo modelInfo = {};
+        modelInfo.TextureCount    = (uint32_t)importData.Textures.Size();
+        modelInfo.MaterialCount   = (uint32_t)importData.Materials.Size();
+        modelInfo.MeshCount       = (uint32_t)importData.Meshes.Size();
+        writer.Write(modelInfo);
+
+        for(const ImportData::TextureData& texture : importData.Textures)
+        {
+            CookedTextureInfo textureInfo = {};
+            textureInfo.Desc              = texture.Desc;
+            textureInfo.Options           = texture.Options;
+            textureInfo.Width             = texture.Width;
+            textureInfo.Height            = texture.Height;
+            textureInfo.Embedded          = texture.Embedded ? 1 : 0;
+
+            // Textures from their own files are stored by path, so edits to them are picked up
+            writer.Write(textureInfo);
+            writer.WriteString(texture.Name);
+            writer.WriteString(texture.FilePath);
+            writer.Align();
+            if(texture.Embedded)
+                writer.Write(texture.GetPixels(), texture.Pixels.Size());
+            writer.Align();
+        }
+
+        for(const ImportData::MaterialData& material : importData.Materials)
+        {
+            CookedMaterialInfo materialInfo = {};
+            materialInfo.Flags              = material.Flags;
+            CookMaterialProperties(material.Properties, materialInfo.Properties);
+            for(uint32_t slot = 0; slot < 6; slot++)
+                materialInfo.Textures[slot] = material.Textures[slot];
+
+            writer.Write(materialInfo);
+            writer.WriteString(material.Name);
+            writer.WriteString(material.ShaderName);
+        }
+
+        for(const ImportData::MeshData& mesh : importData.Meshes)
+        {
+            CookedMeshInfo meshInfo = {};
+            meshInfo.Material       = mesh.Material;
+            meshInfo.IndexCount     = (uint32_t)mesh.Indices.Size();
+            meshInfo.VertexCount    = (uint32_t)mesh.Vertices.Size();
+            meshInfo.LODCount       = (uint32_t)mesh.LODs.Size();
+
+            writer.Write(meshInfo);
+            writer.WriteString(mesh.Name);
+            writer.Align();
+            writer.Write(mesh.Indices.Data(), meshInfo.IndexCount * sizeof(uint32_t));
+            writer.Align();
+            writer.Write(mesh.Vertices.Data(), meshInfo.VertexCount * sizeof(Vertex));
+            writer.Write(mesh.LODs.Data(), meshInfo.LODCount * sizeof(MeshLOD));
+            writer.Align();
+        }
+
+        AssetCache::Get().Store(path, AssetType::Model, GetCookedModelSettingsHash(), writer, &importData.Dependencies);
+    }
+
+    bool Model::LoadCooked(const std::string& path)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(!m_ImportData || !AssetCache::Get().Load(path, AssetType::Model, GetCookedModelSettingsHash(), m_ImportData->Cooked))
+            return false;
+
+        CookedAssetReader reader = m_ImportData->Cooked.GetReader();
+        CookedModelInfo modelInfo;
+        if(!reader.Read(modelInfo))
+        {
+            BeginImport();
+            return false;
+        }
+
+        // Where each cooked texture ended up, a texture file that fails to load leaves a gap
+        TDArray<int32_t> textureIndices;
+        textureIndices.Reserve(modelInfo.TextureCount);
+        for(uint32_t i = 0; i < modelInfo.TextureCount && reader.IsValid(); i++)
+        {
+            CookedTextureInfo textureInfo;
+            std::string name, filePath;
+            reader.Read(textureInfo);
+            reader.ReadString(name);
+            reader.ReadString(filePath);
+            reader.Align();
+
+            if(!textureInfo.Embedded)
+            {
+                textureIndices.PushBack(ImportTexture(name, filePath, textureInfo.Desc, textureInfo.Options));
+                continue;
+            }
+
+            const uint64_t size   = uint64_t(textureInfo.Width) * uint64_t(textureInfo.Height) * Texture::GetStrideFromFormat(textureInfo.Desc.format);
+            const uint8_t* pixels = reader.ReadArray<uint8_t>(size);
+            reader.Align();
+            if(!pixels)
+                break;
+
+            ImportData::TextureData& texture = m_ImportData->Textures.EmplaceBack();
+            texture.Name                     = name;
+            texture.FilePath                 = filePath;
+            texture.Desc                     = textureInfo.Desc;
+            texture.Options                  = textureInfo.Options;
+            texture.CookedPixels             = pixels;
+            texture.Width                    = textureInfo.Width;
+            texture.Height                   = textureInfo.Height;
+            texture.Embedded                 = true;
+            textureIndices.PushBack((int32_t)m_ImportData->Textures.Size() - 1);
+        }
+
+        for(uint32_t i = 0; i < modelInfo.MaterialCount && reader.IsValid(); i++)
+        {
+            CookedMaterialInfo materialInfo;
+            std::string name, shaderName;
+            reader.Read(materialInfo);
+            reader.ReadString(name);
+            reader.ReadString(shaderName);
+
+            int32_t textures[6];
+            for(uint32_t slot = 0; slot < 6; slot++)
+            {
+                const int32_t index = materialInfo.Textures[slot];
+                textures[slot]      = index >= 0 && index < (int32_t)textureIndices.Size() ? textureIndices[index] : -1;
+            }
+
+            MaterialProperties properties;
+            LoadMaterialProperties(materialInfo.Properties, properties);
+            ImportMaterial(name, shaderName.c_str(), properties, materialInfo.Flags, textures);
+        }
+
+        for(uint32_t i = 0; i < modelInfo.MeshCount && reader.IsValid(); i++)
+        {
+            CookedMeshInfo meshInfo;
+            std::string name;
+            reader.Read(meshInfo);
+            reader.ReadString(name);
+            reader.Align();
+            const uint32_t* indices = reader.ReadArray<uint32_t>(meshInfo.IndexCount);
+            reader.Align();
+            const Vertex* vertices = reader.ReadArray<Vertex>(meshInfo.VertexCount);
+            const MeshLOD* lods    = reader.ReadArray<MeshLOD>(meshInfo.LODCount);
+            reader.Align();
+
+            if(!indices || !vertices || (meshInfo.LODCount && !lods))
+                break;
+
+            ImportData::MeshData& mesh = m_ImportData->Meshes.EmplaceBack();
+            mesh.Name                  = name;
+            mesh.Material              = meshInfo.Material;
+            mesh.CookedIndices         = indices;
+            mesh.CookedVertices        = vertices;
+            mesh.CookedLODs            = lods;
+            mesh.CookedIndexCount      = meshInfo.IndexCount;
+            mesh.CookedVertexCount     = meshInfo.VertexCount;
+            mesh.CookedLODCount        = meshInfo.LODCount;
+        }
+
+        // A truncated blob falls back to the importer
+        if(!reader.IsValid() || m_ImportData->Meshes.Size() != modelInfo.MeshCount)
+        {
+            BeginImport();
+            return false;
+        }
+
+        return true;
+    }
+}
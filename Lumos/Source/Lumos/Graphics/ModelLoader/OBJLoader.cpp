@@ -9,33 +9,20 @@
 #include "Core/Application.h"
 #include "Core/Asset/AssetManager.h"
 
+#include <fstream>
+
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <ModelLoaders/tinyobjloader/tiny_obj_loader.h>
 
 namespace Lumos
 {
-    std::string m_Directory;
-    TDArray<SharedPtr<Graphics::Texture2D>> m_Textures;
-
-    SharedPtr<Graphics::Texture2D> LoadMaterialTextures(const std::string& typeName, TDArray<SharedPtr<Graphics::Texture2D>>& textures_loaded, const std::string& name, const std::string& directory, Graphics::TextureDesc format)
+    int32_t LoadMaterialTextures(Graphics::Model* model, const std::string& typeName, const std::string& name, const std::string& directory, Graphics::TextureDesc format)
     {
-        for(uint32_t j = 0; j < textures_loaded.Size(); j++)
-        {
-            if(std::strcmp(textures_loaded[j]->GetFilepath().c_str(), (directory + name).c_str()) == 0)
-            {
-                return textures_loaded[j];
-            }
-        }
-
-        { // If texture hasn't been loaded already, load it
-            Graphics::TextureLoadOptions options(false, true);
-            std::string filePath = directory + name;
-            filePath             = StringUtilities::BackSlashesToSlashes(filePath);
-            auto texture         = SharedPtr<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(typeName, filePath, format, options));
-            textures_loaded.PushBack(texture); // Store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
-
-            return texture;
-        }
+        // The model only decodes a file once, however many materials use it
+        Graphics::TextureLoadOptions options(false, true);
+        std::string filePath = directory + name;
+        filePath             = StringUtilities::BackSlashesToSlashes(filePath);
+        return model->ImportTexture(typeName, filePath, format, options);
     }
 
     void Graphics::Model::LoadOBJ(const std::string& path)
@@ -48,19 +35,35 @@ namespace Lumos
         std::vector<tinyobj::shape_t> shapes;
         std::vector<tinyobj::material_t> materials;
 
-        resolvedPath = StringUtilities::BackSlashesToSlashes(resolvedPath);
-        m_Directory  = StringUtilities::GetFileLocation(resolvedPath);
+        resolvedPath          = StringUtilities::BackSlashesToSlashes(resolvedPath);
+        std::string directory = StringUtilities::GetFileLocation(resolvedPath);
 
         std::string name = StringUtilities::GetFileName(resolvedPath);
 
         bool ok = tinyobj::LoadObj(
-            &attrib, &shapes, &materials, &error, (resolvedPath).c_str(), (m_Directory).c_str());
+            &attrib, &shapes, &materials, &error, (resolvedPath).c_str(), (directory).c_str());
 
         if(!ok)
         {
             LFATAL(error.c_str());
         }
 
+        // The cooked model is also invalidated by changes to its material libraries
+        {
+            std::string line;
+            std::ifstream file(resolvedPath);
+            while(std::getline(file, line))
+            {
+                if(line.rfind("mtllib", 0) != 0)
+                    continue;
+
+                const size_t start = line.find_first_not_of(" \t", 6);
+                const size_t end   = line.find_last_not_of(" \t\r");
+                if(start != std::string::npos)
+                    ImportDependency(directory + line.substr(start, end - start + 1));
+            }
+        }
+
         bool singleMesh = shapes.size() == 1;
 
         for(const auto& shape : shapes)
@@ -129,11 +132,9 @@ namespace Lumos
 
             // TODO : if(isAnimated) Load deferredColourAnimated;
             //  auto shader = Application::Get().GetShaderLibrary()->GetAsset("//CoreShaders/ForwardPBR.shader");
-            auto shader = Application::Get().GetAssetManager()->GetAssetData("ForwardPBR").As<Graphics::Shader>();
-
-            SharedPtr<Material> pbrMaterial = CreateSharedPtr<Material>(shader);
 
-            PBRMataterialTextures textures;
+            // albedo, normal, metallic, roughness, ao, emissive
+            int32_t textures[6] = { -1, -1, -1, -1, -1, -1 };
 
             if(shape.mesh.material_ids[0] >= 0)
             {
@@ -141,49 +142,49 @@ namespace Lumos
 
                 if(mp->diffuse_texname.length() > 0)
                 {
-                    SharedPtr<Graphics::Texture2D> texture = LoadMaterialTextures("Albedo", m_Textures, mp->diffuse_texname, m_Directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->diffuse_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.albedo = texture;
+                    int32_t texture = LoadMaterialTextures(this, "Albedo", mp->diffuse_texname, directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->diffuse_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                    if(texture >= 0)
+                        textures[0] = texture;
                 }
 
                 if(mp->bump_texname.length() > 0)
                 {
-                    SharedPtr<Graphics::Texture2D> texture = LoadMaterialTextures("Normal", m_Textures, mp->bump_texname, m_Directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->bump_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.normal = texture; // pbrMaterial->SetNormalMap(texture);
+                    int32_t texture = LoadMaterialTextures(this, "Normal", mp->bump_texname, directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->bump_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                    if(texture >= 0)
+                        textures[1] = texture; // pbrMaterial->SetNormalMap(texture);
                 }
 
                 if(mp->roughness_texname.length() > 0)
                 {
-                    SharedPtr<Graphics::Texture2D> texture = LoadMaterialTextures("Roughness", m_Textures, mp->roughness_texname.c_str(), m_Directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->roughness_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.roughness = texture;
+                    int32_t texture = LoadMaterialTextures(this, "Roughness", mp->roughness_texname.c_str(), directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->roughness_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                    if(texture >= 0)
+                        textures[3] = texture;
                 }
 
                 if(mp->metallic_texname.length() > 0)
                 {
-                    SharedPtr<Graphics::Texture2D> texture = LoadMaterialTextures("Metallic", m_Textures, mp->metallic_texname, m_Directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->metallic_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.metallic = texture;
+                    int32_t texture = LoadMaterialTextures(this, "Metallic", mp->metallic_texname, directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->metallic_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                    if(texture >= 0)
+                        textures[2] = texture;
                 }
 
                 if(mp->specular_highlight_texname.length() > 0)
                 {
-                    SharedPtr<Graphics::Texture2D> texture = LoadMaterialTextures("Metallic", m_Textures, mp->specular_highlight_texname, m_Directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->specular_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.metallic = texture;
+                    int32_t texture = LoadMaterialTextures(this, "Metallic", mp->specular_highlight_texname, directory, Graphics::TextureDesc(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->specular_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                    if(texture >= 0)
+                        textures[2] = texture;
                 }
             }
 
-            pbrMaterial->SetTextures(textures);
+            int32_t material = ImportMaterial("", "ForwardPBR", Graphics::MaterialProperties(), (uint32_t)Graphics::Material::RenderFlags::DEPTHTEST, textures);
 
-            auto mesh = CreateSharedPtr<Graphics::Mesh>(indices, vertices);
-            mesh->SetMaterial(pbrMaterial);
-            mesh->GenerateTangentsAndBitangents(vertices.Data(), uint32_t(numVertices), indices.Data(), uint32_t(numIndices));
+            TDArray<Graphics::MeshLOD> lods;
+            Graphics::Mesh::Optimise(indices, vertices, lods);
 
-            m_Meshes.PushBack(mesh);
+            const uint32_t lod0IndexCount = lods.Empty() ? uint32_t(indices.Size()) : lods[0].IndexCount;
+            Graphics::Mesh::GenerateTangentsAndBitangents(vertices.Data(), uint32_t(vertices.Size()), indices.Data(), lod0IndexCount);
 
-            m_Textures.Clear();
+            ImportMesh("", material, Move(indices), Move(vertices), Move(lods));
         }
     }
 
@@ -3,6 +3,11 @@
 #include "Maths/Random.h"
 #include "Maths/MathsUtilities.h"
 #include "Graphics/RHI/Texture.h"
+#include "Core/JobSystem.h"
+
+#ifdef LUMOS_SSE
+#include <smmintrin.h>
+#endif
 
 namespace Lumos
 {
@@ -18,89 +23,199 @@ namespace Lumos
         Init();
     }
 
+    // Below this many live particles the update stays on the calling thread
+    static const uint32_t PARALLEL_PARTICLE_THRESHOLD = 32768;
+    static const uint32_t PARTICLES_PER_JOB           = 16384; // Multiple of 4
+
+    // Rounded up to a multiple of 4 so the simulation loops can run whole groups of four
+    static uint32_t ParticleCapacity(uint32_t particleCount)
+    {
+        return (particleCount + 3) & ~3u;
+    }
+
     void ParticleEmitter::Update(float dt, Vec3 emitterPosition)
     {
         LUMOS_PROFILE_FUNCTION();
 
-        if(!m_Arena || !m_Particles || m_ParticleCount > m_Arena->Size / sizeof(Particle))
-        {
-            m_ParticleCount = 1024;
+        // The count can change without Init, e.g. when deserialised or edited, so also catch it shrinking
+        if(!m_Arena || m_Particles.Capacity != ParticleCapacity(m_ParticleCount))
             Init();
-        }
+
         m_NextParticleTime -= dt;
 
         if(m_NextParticleTime <= 0.0f)
         {
-            for(uint32_t i = 0; i < m_NumLaunchParticles; i++)
-            {
-                int unusedParticle = FirstUnusedParticle();
-                RespawnParticle(m_Particles[unusedParticle], emitterPosition);
-            }
+            // New particles go after the live ones. Once the emitter is full the rest of the launch is dropped
+            const uint32_t freeCount   = m_ParticleCount > m_Particles.AliveCount ? m_ParticleCount - m_Particles.AliveCount : 0;
+            const uint32_t launchCount = Maths::Min(m_NumLaunchParticles, freeCount);
+            for(uint32_t i = 0; i < launchCount; i++)
+                RespawnParticle(m_Particles.AliveCount++, emitterPosition);
 
             m_NextParticleTime += m_ParticleRate;
         }
 
-        // update all particles
-        for(uint32_t i = 0; i < m_ParticleCount; i++)
+        const uint32_t aliveCount = m_Particles.AliveCount;
+        if(aliveCount >= PARALLEL_PARTICLE_THRESHOLD)
         {
-            Particle& p = m_Particles[i];
-            p.Life -= dt;
-            if(p.Life > 0.0f)
-            {
-                p.Velocity += m_Gravity * dt;
-                p.Position += p.Velocity * dt;
-
-                if(m_FadeIn > 0.0f && p.Life > (m_ParticleLife - m_FadeIn))
-                    p.Colour.w = (m_ParticleLife - p.Life) / m_FadeIn;
-                else if(m_FadeOut > 0.0f && p.Life < m_FadeOut)
-                    p.Colour.w = 1.0f - ((m_FadeOut - p.Life) / m_FadeOut);
-            }
+            const uint32_t jobCount = (aliveCount + PARTICLES_PER_JOB - 1) / PARTICLES_PER_JOB;
+
+            System::JobSystem::Context ctx;
+            System::JobSystem::Dispatch(ctx, jobCount, 1, [this, dt, aliveCount](JobDispatchArgs args)
+                                        {
+                                            const uint32_t begin = args.jobIndex * PARTICLES_PER_JOB;
+                                            SimulateParticles(begin, Maths::Min(begin + PARTICLES_PER_JOB, aliveCount), dt); });
+            System::JobSystem::Wait(ctx);
         }
-    }
-
-    void ParticleEmitter::Init()
-    {
-        if(m_Arena)
-            ArenaRelease(m_Arena);
+        else
+            SimulateParticles(0, aliveCount, dt);
 
-        m_Arena     = ArenaAlloc((m_ParticleCount + 10) * sizeof(Particle));
-        m_Particles = PushArray(m_Arena, Particle, m_ParticleCount);
+        RemoveDeadParticles();
     }
 
-    void ParticleEmitter::RespawnParticle(Particle& particle, Vec3 emitterPosition)
+    void ParticleEmitter::SimulateParticles(uint32_t begin, uint32_t end, float dt)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
 
-        particle.Position = Vec3(m_Spread.x > Maths::M_EPSILON ? Random32::Rand(-m_Spread.x, m_Spread.x) : 0.0f, m_Spread.y > Maths::M_EPSILON ? Random32::Rand(-m_Spread.y, m_Spread.y) : 0.0f, m_Spread.z > Maths::M_EPSILON ? Random32::Rand(-m_Spread.z, m_Spread.z) : 0.0f) + emitterPosition;
-        particle.Colour   = m_InitialColour;
-        particle.Life     = m_ParticleLife + Random32::Rand(-m_LifeSpread, m_LifeSpread);
-        particle.Velocity = m_InitialVelocity + Vec3(m_VelocitySpread.x > Maths::M_EPSILON ? Random32::Rand(-m_VelocitySpread.x, m_VelocitySpread.x) : 0.0f, m_VelocitySpread.y > Maths::M_EPSILON ? Random32::Rand(-m_VelocitySpread.y, m_VelocitySpread.y) : 0.0f, m_VelocitySpread.z > Maths::M_EPSILON ? Random32::Rand(-m_VelocitySpread.z, m_VelocitySpread.z) : 0.0f);
-        particle.Size     = m_ParticleSize;
+        ParticleArrays& p   = m_Particles;
+        const float fadeIn  = m_FadeIn;
+        const float fadeOut = m_FadeOut;
+        const float life    = m_ParticleLife;
+
+#ifdef LUMOS_SSE
+        // Capacity is a multiple of 4 and begin is always a multiple of 4, so the last group of four can run
+        // past end into unused slots without leaving the arrays
+        const __m128 dtV         = _mm_set1_ps(dt);
+        const __m128 gravityX    = _mm_set1_ps(m_Gravity.x * dt);
+        const __m128 gravityY    = _mm_set1_ps(m_Gravity.y * dt);
+        const __m128 gravityZ    = _mm_set1_ps(m_Gravity.z * dt);
+        const __m128 zero        = _mm_setzero_ps();
+        const __m128 one         = _mm_set1_ps(1.0f);
+        const __m128 lifeV       = _mm_set1_ps(life);
+        const __m128 fadeInV     = _mm_set1_ps(fadeIn);
+        const __m128 fadeOutV    = _mm_set1_ps(fadeOut);
+        const __m128 fadeInEnd   = _mm_set1_ps(life - fadeIn);
+        const __m128 fadeInMask  = fadeIn > 0.0f ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+        const __m128 fadeOutMask = fadeOut > 0.0f ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+
+        for(uint32_t i = begin; i < end; i += 4)
+        {
+            const __m128 particleLife = _mm_sub_ps(_mm_load_ps(p.Life + i), dtV);
+            _mm_store_ps(p.Life + i, particleLife);
+
+            const __m128 velocityX = _mm_add_ps(_mm_load_ps(p.VelocityX + i), gravityX);
+            const __m128 velocityY = _mm_add_ps(_mm_load_ps(p.VelocityY + i), gravityY);
+            const __m128 velocityZ = _mm_add_ps(_mm_load_ps(p.VelocityZ + i), gravityZ);
+            _mm_store_ps(p.VelocityX + i, velocityX);
+            _mm_store_ps(p.VelocityY + i, velocityY);
+            _mm_store_ps(p.VelocityZ + i, velocityZ);
+
+            _mm_store_ps(p.PositionX + i, _mm_add_ps(_mm_load_ps(p.PositionX + i), _mm_mul_ps(velocityX, dtV)));
+            _mm_store_ps(p.PositionY + i, _mm_add_ps(_mm_load_ps(p.PositionY + i), _mm_mul_ps(velocityY, dtV)));
+            _mm_store_ps(p.PositionZ + i, _mm_add_ps(_mm_load_ps(p.PositionZ + i), _mm_mul_ps(velocityZ, dtV)));
+
+            // Fade in takes priority over fade out, particles outside both keep their alpha
+            const __m128 inMask   = _mm_and_ps(fadeInMask, _mm_cmpgt_ps(particleLife, fadeInEnd));
+            const __m128 outMask  = _mm_andnot_ps(inMask, _mm_and_ps(fadeOutMask, _mm_cmplt_ps(particleLife, fadeOutV)));
+            const __m128 inAlpha  = _mm_div_ps(_mm_sub_ps(lifeV, particleLife), fadeInV);
+            const __m128 outAlpha = _mm_sub_ps(one, _mm_div_ps(_mm_sub_ps(fadeOutV, particleLife), fadeOutV));
+
+            __m128 alpha = _mm_load_ps(p.Alpha + i);
+            alpha        = _mm_blendv_ps(alpha, inAlpha, inMask);
+            alpha        = _mm_blendv_ps(alpha, outAlpha, outMask);
+            _mm_store_ps(p.Alpha + i, alpha);
+        }
+#else
+        const Vec3 gravity = m_Gravity * dt;
+        for(uint32_t i = begin; i < end; i++)
+        {
+            const float particleLife = p.Life[i] - dt;
+            p.Life[i]                = particleLife;
+
+            p.VelocityX[i] += gravity.x;
+            p.VelocityY[i] += gravity.y;
+            p.VelocityZ[i] += gravity.z;
+            p.PositionX[i] += p.VelocityX[i] * dt;
+            p.PositionY[i] += p.VelocityY[i] * dt;
+            p.PositionZ[i] += p.VelocityZ[i] * dt;
+
+            if(fadeIn > 0.0f && particleLife > (life - fadeIn))
+                p.Alpha[i] = (life - particleLife) / fadeIn;
+            else if(fadeOut > 0.0f && particleLife < fadeOut)
+                p.Alpha[i] = 1.0f - ((fadeOut - particleLife) / fadeOut);
+        }
+#endif
     }
 
-    uint32_t lastUsedParticle = 0;
-    uint32_t ParticleEmitter::FirstUnusedParticle()
+    void ParticleEmitter::RemoveDeadParticles()
     {
         LUMOS_PROFILE_FUNCTION_LOW();
-        for(uint32_t i = lastUsedParticle; i < m_ParticleCount; ++i)
-        {
-            if(m_Particles[i].Life <= 0.0f)
-            {
-                lastUsedParticle = i;
-                return i;
-            }
-        }
 
-        for(uint32_t i = 0; i < lastUsedParticle; ++i)
+        // Swap the last live particle into each dead slot. Order is not kept, sorting happens at render time
+        ParticleArrays& p   = m_Particles;
+        uint32_t aliveCount = p.AliveCount;
+        uint32_t i          = 0;
+        while(i < aliveCount)
         {
-            if(m_Particles[i].Life <= 0.0f)
+            if(p.Life[i] > 0.0f)
             {
-                lastUsedParticle = i;
-                return i;
+                i++;
+                continue;
             }
+
+            const uint32_t last = --aliveCount;
+            p.PositionX[i]      = p.PositionX[last];
+            p.PositionY[i]      = p.PositionY[last];
+            p.PositionZ[i]      = p.PositionZ[last];
+            p.VelocityX[i]      = p.VelocityX[last];
+            p.VelocityY[i]      = p.VelocityY[last];
+            p.VelocityZ[i]      = p.VelocityZ[last];
+            p.Life[i]           = p.Life[last];
+            p.Alpha[i]          = p.Alpha[last];
+            p.Size[i]           = p.Size[last];
         }
-        lastUsedParticle = 0;
-        return 0;
+
+        p.AliveCount = aliveCount;
+    }
+
+    void ParticleEmitter::Init()
+    {
+        if(m_Arena)
+            ArenaRelease(m_Arena);
+
+        // Every array starts 16 byte aligned, the arena aligns pushes and the capacity keeps sizes a multiple of 16
+        const uint32_t capacity = ParticleCapacity(m_ParticleCount);
+        const uint64_t size     = (uint64_t)capacity * sizeof(float);
+
+        m_Arena                = ArenaAlloc(size * 9 + 256);
+        m_Particles.PositionX  = PushArray(m_Arena, float, capacity);
+        m_Particles.PositionY  = PushArray(m_Arena, float, capacity);
+        m_Particles.PositionZ  = PushArray(m_Arena, float, capacity);
+        m_Particles.VelocityX  = PushArray(m_Arena, float, capacity);
+        m_Particles.VelocityY  = PushArray(m_Arena, float, capacity);
+        m_Particles.VelocityZ  = PushArray(m_Arena, float, capacity);
+        m_Particles.Life       = PushArray(m_Arena, float, capacity);
+        m_Particles.Alpha      = PushArray(m_Arena, float, capacity);
+        m_Particles.Size       = PushArray(m_Arena, float, capacity);
+        m_Particles.AliveCount = 0;
+        m_Particles.Capacity   = capacity;
+    }
+
+    void ParticleEmitter::RespawnParticle(uint32_t index, Vec3 emitterPosition)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        const Vec3 position = Vec3(m_Spread.x > Maths::M_EPSILON ? Random32::Rand(-m_Spread.x, m_Spread.x) : 0.0f, m_Spread.y > Maths::M_EPSILON ? Random32::Rand(-m_Spread.y, m_Spread.y) : 0.0f, m_Spread.z > Maths::M_EPSILON ? Random32::Rand(-m_Spread.z, m_Spread.z) : 0.0f) + emitterPosition;
+        const Vec3 velocity = m_InitialVelocity + Vec3(m_VelocitySpread.x > Maths::M_EPSILON ? Random32::Rand(-m_VelocitySpread.x, m_VelocitySpread.x) : 0.0f, m_VelocitySpread.y > Maths::M_EPSILON ? Random32::Rand(-m_VelocitySpread.y, m_VelocitySpread.y) : 0.0f, m_VelocitySpread.z > Maths::M_EPSILON ? Random32::Rand(-m_VelocitySpread.z, m_VelocitySpread.z) : 0.0f);
+
+        m_Particles.PositionX[index] = position.x;
+        m_Particles.PositionY[index] = position.y;
+        m_Particles.PositionZ[index] = position.z;
+        m_Particles.VelocityX[index] = velocity.x;
+        m_Particles.VelocityY[index] = velocity.y;
+        m_Particles.VelocityZ[index] = velocity.z;
+        m_Particles.Life[index]      = m_ParticleLife + Random32::Rand(-m_LifeSpread, m_LifeSpread);
+        m_Particles.Alpha[index]     = m_InitialColour.w;
+        m_Particles.Size[index]      = m_ParticleSize;
     }
 
     void ParticleEmitter::SetTextureFromFile(const std::string& filePath)
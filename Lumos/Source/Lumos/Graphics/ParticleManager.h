@@ -9,21 +9,25 @@
 
 namespace Lumos
 {
-    struct Particle
+    // Particles are stored as one array per attribute so the update can work on four at a time.
+    // Live particles are always packed at the front: a particle that dies is replaced by the last live one,
+    // and new particles are appended after it.
+    struct ParticleArrays
     {
-        Vec3 Position, Velocity;
-        Vec4 Colour;
-        float Life;
-        float Size;
-
-        Particle()
-            : Position(0.0f)
-            , Velocity(0.0f)
-            , Colour(1.0f)
-            , Life(0.0f)
-            , Size(0.1f)
-        {
-        }
+        float* PositionX = nullptr;
+        float* PositionY = nullptr;
+        float* PositionZ = nullptr;
+        float* VelocityX = nullptr;
+        float* VelocityY = nullptr;
+        float* VelocityZ = nullptr;
+        float* Life      = nullptr;
+        float* Alpha     = nullptr; // Colour comes from the emitter's initial colour, only alpha fades
+        float* Size      = nullptr;
+
+        uint32_t AliveCount = 0;
+        uint32_t Capacity   = 0; // Rounded up to a multiple of 4
+
+        Vec3 GetPosition(uint32_t index) const { return Vec3(PositionX[index], PositionY[index], PositionZ[index]); }
     };
 
     class ParticleEmitter
@@ -130,7 +134,8 @@ namespace Lumos
 
         void SetTextureFromFile(const std::string& path);
 
-        Particle* GetParticles() { return m_Particles; }
+        const ParticleArrays& GetParticles() const { return m_Particles; }
+        uint32_t GetAliveCount() const { return m_Particles.AliveCount; }
 
         // Getter methods
         const SharedPtr<Graphics::Texture>& GetTexture() const { return m_Texture; }
@@ -184,10 +189,11 @@ namespace Lumos
 
     private:
         void Init();
-        uint32_t FirstUnusedParticle();
-        void RespawnParticle(Particle& particle, Vec3 emitterPosition = Vec3(0.0f));
+        void RespawnParticle(uint32_t index, Vec3 emitterPosition = Vec3(0.0f));
+        void SimulateParticles(uint32_t begin, uint32_t end, float dt);
+        void RemoveDeadParticles();
 
-        Particle* m_Particles = nullptr;
+        ParticleArrays m_Particles;
 
         SharedPtr<Graphics::Texture> m_Texture;
         uint32_t m_ParticleCount       = 1024;
@@ -27,6 +27,7 @@ namespace Lumos
         };
         static std::unordered_map<uint64_t, PipelineAsset> m_PipelineCache;
         static const float m_CacheLifeTime = 0.1f;
+        static uint32_t s_NextPipelineID   = 0;
 
         Pipeline* (*Pipeline::CreateFunc)(const PipelineDesc&) = nullptr;
 
@@ -102,6 +103,7 @@ namespace Lumos
             }
 
             SharedPtr<Pipeline> pipeline = SharedPtr<Pipeline>(Create(pipelineDesc));
+            pipeline->m_ID               = ++s_NextPipelineID;
             m_PipelineCache[hash]        = { pipeline, (float)Engine::GetTimeStep().GetElapsedSeconds() };
             return pipeline;
         }
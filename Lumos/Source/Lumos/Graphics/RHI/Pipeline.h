@@ -60,12 +60,16 @@ namespace Lumos
             uint32_t GetWidth();
             uint32_t GetHeight();
 
+            // Creation order id, used to group draws by pipeline when sorting render queues
+            uint32_t GetID() const { return m_ID; }
+
         protected:
             virtual void Bind(CommandBuffer* commandBuffer, uint32_t layer = 0) = 0;
             virtual void End(CommandBuffer* commandBuffer) { }
 
             static Pipeline* (*CreateFunc)(const PipelineDesc&);
             PipelineDesc m_Description;
+            uint32_t m_ID = 0;
         };
     }
 }
@@ -90,7 +90,7 @@ namespace Lumos
 
             static GraphicsContext* GetGraphicsContext();
             static SwapChain* GetMainSwapChain();
-            static void DrawMesh(CommandBuffer* commandBuffer, Graphics::Pipeline* pipeline, Graphics::Mesh* mesh);
+            static void DrawMesh(CommandBuffer* commandBuffer, Graphics::Pipeline* pipeline, Graphics::Mesh* mesh, uint32_t lod = 0);
 
         protected:
             static Renderer* (*CreateFunc)();
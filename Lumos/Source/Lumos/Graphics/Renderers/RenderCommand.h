@@ -1,5 +1,7 @@
 #pragma once
 #include "Maths/Matrix4.h"
+#include "Core/DataStructures/TDArray.h"
+#include "Core/Algorithms/Sort.h"
 
 namespace Lumos
 {
@@ -19,6 +21,67 @@ namespace Lumos
             Mat4 textureMatrix;
             bool animated                        = false;
             DescriptorSet* AnimatedDescriptorSet = nullptr;
+            uint32_t lod                         = 0;
+
+            // Packed depth test bucket, pipeline, material and view depth. See MakeRenderSortKey
+            uint64_t sortKey = 0;
         };
+
+        // Depth tested commands come first, grouped by pipeline then material and front to back within a group:
+        //   [63] 0 | [62..48] pipeline id | [47..32] material id | [31..0] squared view distance
+        // Commands without depth testing rely on draw order, so they go by distance first and the ids only break ties:
+        //   [63] 1 | [62..32] squared view distance | [31..16] pipeline id | [15..0] material id
+        // The ids are creation order ids rather than addresses, so the order does not depend on where objects were allocated
+        inline uint64_t MakeRenderSortKey(bool depthTest, uint32_t pipelineID, uint32_t materialID, float viewDistance2)
+        {
+            const uint64_t depth = Algorithms::FloatToSortableKey(viewDistance2);
+            if(depthTest)
+                return ((uint64_t)(pipelineID & 0x7FFF) << 48) | ((uint64_t)(materialID & 0xFFFF) << 32) | depth;
+
+            // Distances are never negative, so the sortable key's top bit is always set and can be dropped
+            return (1ull << 63) | ((depth & 0x7FFFFFFF) << 32) | ((uint64_t)(pipelineID & 0xFFFF) << 16) | (materialID & 0xFFFF);
+        }
+
+        // Stable sort of a command queue by each command's sortKey. keys and indices are scratch storage kept
+        // by the caller between frames
+        template <typename Command>
+        void SortRenderCommands(TDArray<Command>& commands, TDArray<uint64_t>& keys, TDArray<uint32_t>& indices)
+        {
+            uint32_t count = (uint32_t)commands.Size();
+            if(count < 2)
+                return;
+
+            keys.Resize(count * 2);
+            indices.Resize(count * 2);
+            for(uint32_t i = 0; i < count; i++)
+            {
+                keys[i]    = commands[i].sortKey;
+                indices[i] = i;
+            }
+
+            Algorithms::RadixSort(keys.Data(), indices.Data(), keys.Data() + count, indices.Data() + count, count);
+
+            // Apply the permutation in place by following its cycles
+            for(uint32_t i = 0; i < count; i++)
+            {
+                if(indices[i] == i)
+                    continue;
+
+                Command temp = commands[i];
+                uint32_t j   = i;
+                while(true)
+                {
+                    uint32_t k = indices[j];
+                    indices[j] = j;
+                    if(k == i)
+                    {
+                        commands[j] = temp;
+                        break;
+                    }
+                    commands[j] = commands[k];
+                    j           = k;
+                }
+            }
+        }
     }
 }
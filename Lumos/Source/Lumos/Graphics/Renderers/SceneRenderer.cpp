@@ -698,10 +698,59 @@ namespace Lumos::Graphics
             DebugRenderer::Release();
     }
 
+    static uint64_t GenerateSortKey(const RenderCommand& command, const Vec3& cameraPosition)
+    {
+        return MakeRenderSortKey(command.material->GetFlag(Material::RenderFlags::DEPTHTEST), command.pipeline->GetID(), command.material->GetID(),
+                                 Maths::Distance2(cameraPosition, command.transform.Translation()));
+    }
+
+    uint32_t SceneRenderer::AddCullingTasks(System::JobSystem::TaskGraph& graph, Scene* scene)
+    {
+        if(!scene->GetSettings().RenderSettings.Renderer3DEnabled)
+            return UINT32_MAX;
+
+        // Creating a group sorts its pools, so make sure it exists before the node runs
+        scene->GetRegistry().group<ModelComponent>(entt::get<Maths::Transform>);
+
+        m_GatheredScene = nullptr;
+        return graph.AddTask([this, scene](JobDispatchArgs /*args*/)
+                             {
+                                 GatherMeshBounds(scene);
+                                 m_GatheredScene = scene; });
+    }
+
+    void SceneRenderer::GatherMeshBounds(Scene* scene)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        auto group = scene->GetRegistry().group<ModelComponent>(entt::get<Maths::Transform>);
+
+        m_CulledMeshes.Clear();
+        m_MeshCuller.Clear();
+        for(auto entity : group)
+        {
+            if(!Entity(entity, scene).Active())
+                continue;
+
+            const auto& [model, trans] = group.get<ModelComponent, Maths::Transform>(entity);
+
+            if(!model.ModelRef)
+                continue;
+
+            auto& worldTransform = trans.GetWorldMatrix();
+            for(auto& mesh : model.ModelRef->GetMeshes())
+            {
+                m_CulledMeshes.PushBack({ model.ModelRef.get(), mesh.get(), &worldTransform });
+                m_MeshCuller.AddBox(mesh->GetBoundingBox().Transformed(worldTransform));
+            }
+        }
+    }
+
     void SceneRenderer::BeginScene(Scene* scene)
     {
         LUMOS_PROFILE_FUNCTION();
         auto& registry             = scene->GetRegistry();
+        const bool boundsGathered  = m_GatheredScene == scene;
+        m_GatheredScene            = nullptr;
         m_CurrentScene             = scene;
         m_Stats.FramesPerSecond    = 0;
         m_Stats.NumDrawCalls       = 0;
@@ -974,7 +1023,12 @@ namespace Lumos::Graphics
             m_ForwardData.m_DescriptorSet[3]->SetUniformBufferData(0, boneTransforms);
             m_ForwardData.m_DescriptorSet[3]->Update();
 
-            auto group = registry.group<ModelComponent>(entt::get<Maths::Transform>);
+            const Vec3 cameraPosition = m_CameraTransform->GetWorldPosition();
+
+            // Pixels covered by one world unit at a distance of one. Orthographic cameras don't shrink with distance
+            const bool orthographic   = m_Camera->IsOrthographic();
+            const float screenHeight  = (float)m_MainTexture->GetHeight();
+            const float lodPixelScale = orthographic ? screenHeight / (2.0f * m_Camera->GetScale()) : screenHeight * 0.5f / tanf(m_Camera->GetFOV() * Maths::M_DEGTORAD_2);
 
             Graphics::PipelineDesc pipelineDesc = {};
             pipelineDesc.shader                 = m_ForwardData.m_Shader;
@@ -992,126 +1046,146 @@ namespace Lumos::Graphics
             shadowPipelineDesc.DebugName               = "Shadow";
             shadowPipelineDesc.clearTargets            = false;
 
-            for(auto entity : group)
-            {
-                if(!Entity(entity, scene).Active())
-                    continue;
+            // Test the world bounds of every mesh against the camera and each shadow cascade in one batch.
+            // Bit 0 of a mesh's visibility is the camera, bit i + 1 is cascade i
+            if(!boundsGathered)
+                GatherMeshBounds(scene);
 
-                const auto& [model, trans] = group.get<ModelComponent, Maths::Transform>(entity);
+            const uint32_t cascadeCount = directionaLight ? m_ShadowData.m_ShadowMapNum : 0;
+            Maths::Frustum cullFrustums[1 + SHADOWMAP_MAX];
+            cullFrustums[0] = m_ForwardData.m_Frustum;
+            for(uint32_t i = 0; i < cascadeCount; i++)
+                cullFrustums[i + 1] = m_ShadowData.m_CascadeFrustums[i];
 
-                if(!model.ModelRef)
+            m_MeshCuller.Cull(cullFrustums, 1 + cascadeCount);
+
+            for(uint32_t meshIndex = 0; meshIndex < (uint32_t)m_CulledMeshes.Size(); meshIndex++)
+            {
+                const uint32_t visibility = m_MeshCuller.GetVisibility(meshIndex);
+                if(visibility == 0)
                     continue;
 
-                const auto& meshes = model.ModelRef->GetMeshes();
+                const CulledMesh& culled   = m_CulledMeshes[meshIndex];
+                Model* model               = culled.model;
+                Mesh* mesh                 = culled.mesh;
+                const Mat4& worldTransform = *culled.transform;
 
-                for(auto mesh : meshes)
+                // Measured from the nearest the bounds can be to the camera, so a large mesh isn't simplified
+                // while the camera is close to part of it
+                uint32_t lod = 0;
+                if(mesh->GetLODCount() > 1 && m_LODPixelError > 0.0f)
                 {
-                    auto& worldTransform = trans.GetWorldMatrix();
-                    auto bbCopy          = mesh->GetBoundingBox().Transformed(worldTransform);
-
-                    if(directionaLight)
-                    {
-                        for(uint32_t i = 0; i < m_ShadowData.m_ShadowMapNum; i++)
-                        {
-                            auto inside = m_ShadowData.m_CascadeFrustums[i].IsInside(bbCopy);
+                    const Vec3 scale = worldTransform.Scale();
+                    float distance   = 1.0f;
+                    if(!orthographic)
+                        distance = Maths::Max(Maths::Length(m_MeshCuller.GetCenter(meshIndex) - cameraPosition) - Maths::Length(m_MeshCuller.GetExtents(meshIndex)), m_Camera->GetNear());
 
-                            if(!inside)
-                                continue;
+                    lod = mesh->SelectLOD(lodPixelScale * Maths::Max(scale.x, Maths::Max(scale.y, scale.z)) / distance, m_LODPixelError);
+                }
 
-                            RenderCommand command;
-                            command.mesh      = mesh.get();
-                            command.transform = worldTransform;
-                            command.material  = mesh->GetMaterial() ? mesh->GetMaterial().get() : m_ForwardData.m_DefaultMaterial;
+                for(uint32_t i = 0; i < cascadeCount; i++)
+                {
+                    if(!(visibility & (1u << (i + 1))))
+                        continue;
 
-                            if(command.material->GetFlag(Material::RenderFlags::NOSHADOW))
-                                continue;
+                    RenderCommand command;
+                    command.mesh      = mesh;
+                    command.transform = worldTransform;
+                    command.lod       = lod;
+                    command.material  = mesh->GetMaterial() ? mesh->GetMaterial().get() : m_ForwardData.m_DefaultMaterial;
 
-                            Material* material = command.material ? command.material : m_ForwardData.m_DefaultMaterial;
-                            bool alphaBlend    = material->GetFlag(Material::RenderFlags::ALPHABLEND);
+                    if(command.material->GetFlag(Material::RenderFlags::NOSHADOW))
+                        continue;
 
-                            shadowPipelineDesc.transparencyEnabled = alphaBlend;
-                            shadowPipelineDesc.shader              = alphaBlend ? m_ShadowData.m_ShaderAlpha : m_ShadowData.m_Shader;
+                    Material* material = command.material ? command.material : m_ForwardData.m_DefaultMaterial;
+                    bool alphaBlend    = material->GetFlag(Material::RenderFlags::ALPHABLEND);
 
-                            // Bind here in case not bound in the loop below as meshes will be inside
-                            // cascade frustum and not the cameras
-                            command.material->Bind();
+                    shadowPipelineDesc.transparencyEnabled = alphaBlend;
+                    shadowPipelineDesc.shader              = alphaBlend ? m_ShadowData.m_ShaderAlpha : m_ShadowData.m_Shader;
 
-                            if(mesh->GetAnimVertexBuffer())
-                            {
-                                shadowPipelineDesc.shader = alphaBlend ? m_ShadowData.m_ShaderAnimAlpha : m_ShadowData.m_ShaderAnim;
+                    // Bind here in case not bound in the loop below as meshes will be inside
+                    // cascade frustum and not the cameras
+                    command.material->Bind();
 
-                                command.animated              = true;
-                                command.AnimatedDescriptorSet = model.ModelRef->GetAnimationController() ? model.ModelRef->GetAnimationController()->GetDescriptorSet() : m_ForwardData.m_DescriptorSet[3];
-                            }
-                            command.pipeline = Graphics::Pipeline::Get(shadowPipelineDesc);
+                    if(mesh->GetAnimVertexBuffer())
+                    {
+                        shadowPipelineDesc.shader = alphaBlend ? m_ShadowData.m_ShaderAnimAlpha : m_ShadowData.m_ShaderAnim;
 
-                            m_ShadowData.m_CascadeCommandQueue[i].PushBack(command);
-                        }
+                        command.animated              = true;
+                        command.AnimatedDescriptorSet = model->GetAnimationController() ? model->GetAnimationController()->GetDescriptorSet() : m_ForwardData.m_DescriptorSet[3];
                     }
+                    command.pipeline = Graphics::Pipeline::Get(shadowPipelineDesc);
 
-                    {
-                        auto inside = m_ForwardData.m_Frustum.IsInside(bbCopy);
+                    m_ShadowData.m_CascadeCommandQueue[i].PushBack(command);
+                }
 
-                        if(!inside)
-                            continue;
+                {
+                    if(!(visibility & 1u))
+                        continue;
 
-                        RenderCommand command;
-                        command.mesh      = mesh;
-                        command.transform = worldTransform;
-                        command.material  = mesh->GetMaterial() ? mesh->GetMaterial().get() : m_ForwardData.m_DefaultMaterial;
-
-                        // Update material buffers
-                        command.material->Bind();
-
-                        pipelineDesc.colourTargets[0]    = m_MainTexture;
-                        pipelineDesc.cullMode            = command.material->GetFlag(Material::RenderFlags::TWOSIDED) ? Graphics::CullMode::NONE : Graphics::CullMode::BACK;
-                        pipelineDesc.transparencyEnabled = command.material->GetFlag(Material::RenderFlags::ALPHABLEND);
-                        pipelineDesc.samples             = m_MainTextureSamples;
-                        pipelineDesc.polygonMode         = PolygonMode::FILL;
-                        if(m_MainTextureSamples > 1)
-                            pipelineDesc.resolveTexture = m_ResolveTexture;
-                        if(m_ForwardData.m_DepthTest && command.material->GetFlag(Material::RenderFlags::DEPTHTEST))
-                        {
-                            pipelineDesc.depthTarget = m_ForwardData.m_DepthTexture;
-                        }
+                    RenderCommand command;
+                    command.mesh      = mesh;
+                    command.transform = worldTransform;
+                    command.lod       = lod;
+                    command.material  = mesh->GetMaterial() ? mesh->GetMaterial().get() : m_ForwardData.m_DefaultMaterial;
+
+                    // Update material buffers
+                    command.material->Bind();
+
+                    pipelineDesc.colourTargets[0]    = m_MainTexture;
+                    pipelineDesc.cullMode            = command.material->GetFlag(Material::RenderFlags::TWOSIDED) ? Graphics::CullMode::NONE : Graphics::CullMode::BACK;
+                    pipelineDesc.transparencyEnabled = command.material->GetFlag(Material::RenderFlags::ALPHABLEND);
+                    pipelineDesc.samples             = m_MainTextureSamples;
+                    pipelineDesc.polygonMode         = PolygonMode::FILL;
+                    if(m_MainTextureSamples > 1)
+                        pipelineDesc.resolveTexture = m_ResolveTexture;
+                    if(m_ForwardData.m_DepthTest && command.material->GetFlag(Material::RenderFlags::DEPTHTEST))
+                    {
+                        pipelineDesc.depthTarget = m_ForwardData.m_DepthTexture;
+                    }
 
-                        if(mesh->GetAnimVertexBuffer())
-                        {
-                            pipelineDesc.shader           = m_ForwardData.m_AnimShader;
-                            command.animated              = true;
-                            command.AnimatedDescriptorSet = model.ModelRef->GetAnimationController() ? model.ModelRef->GetAnimationController()->GetDescriptorSet() : m_ForwardData.m_DescriptorSet[3];
-                        }
-                        else
-                            pipelineDesc.shader = m_ForwardData.m_Shader;
+                    if(mesh->GetAnimVertexBuffer())
+                    {
+                        pipelineDesc.shader           = m_ForwardData.m_AnimShader;
+                        command.animated              = true;
+                        command.AnimatedDescriptorSet = model->GetAnimationController() ? model->GetAnimationController()->GetDescriptorSet() : m_ForwardData.m_DescriptorSet[3];
+                    }
+                    else
+                        pipelineDesc.shader = m_ForwardData.m_Shader;
 #ifndef LUMOS_PRODUCTION
-                        static const char* debugName0 = "Forward PBR Transparent DepthTested";
-                        static const char* debugName1 = "Forward PBR DepthTested";
-                        static const char* debugName2 = "Forward PBR Transparent";
-                        static const char* debugName3 = "Forward PBR";
+                    static const char* debugName0 = "Forward PBR Transparent DepthTested";
+                    static const char* debugName1 = "Forward PBR DepthTested";
+                    static const char* debugName2 = "Forward PBR Transparent";
+                    static const char* debugName3 = "Forward PBR";
 
-                        if(pipelineDesc.depthTarget && pipelineDesc.transparencyEnabled)
-                        {
-                            pipelineDesc.DebugName = debugName0;
-                        }
-                        else if(pipelineDesc.depthTarget)
-                        {
-                            pipelineDesc.DebugName = debugName1;
-                        }
-                        else if(pipelineDesc.transparencyEnabled)
-                        {
-                            pipelineDesc.DebugName = debugName2;
-                        }
-                        else
-                        {
-                            pipelineDesc.DebugName = debugName3;
-                        }
+                    if(pipelineDesc.depthTarget && pipelineDesc.transparencyEnabled)
+                    {
+                        pipelineDesc.DebugName = debugName0;
+                    }
+                    else if(pipelineDesc.depthTarget)
+                    {
+                        pipelineDesc.DebugName = debugName1;
+                    }
+                    else if(pipelineDesc.transparencyEnabled)
+                    {
+                        pipelineDesc.DebugName = debugName2;
+                    }
+                    else
+                    {
+                        pipelineDesc.DebugName = debugName3;
+                    }
 #endif
 
-                        command.pipeline = Graphics::Pipeline::Get(pipelineDesc);
-                        m_ForwardData.m_CommandQueue.PushBack(command);
-                    }
+                    command.pipeline = Graphics::Pipeline::Get(pipelineDesc);
+                    command.sortKey  = GenerateSortKey(command, cameraPosition);
+                    m_ForwardData.m_CommandQueue.PushBack(command);
                 }
             }
+
+            {
+                LUMOS_PROFILE_SCOPE("Sort Meshes");
+                SortRenderCommands(m_ForwardData.m_CommandQueue, m_SortKeys, m_SortIndices);
+            }
         }
 
         m_Renderer2DData.m_CommandQueue2D.Clear();
@@ -1133,6 +1207,7 @@ namespace Lumos::Graphics
                 RenderCommand2D command;
                 command.renderable = &sprite;
                 command.transform  = trans.GetWorldMatrix();
+                command.sortKey    = Algorithms::FloatToSortableKey(command.transform.Translation()[2]);
                 m_Renderer2DData.m_CommandQueue2D.PushBack(command);
             };
 
@@ -1151,33 +1226,13 @@ namespace Lumos::Graphics
                 RenderCommand2D command;
                 command.renderable = &sprite;
                 command.transform  = trans.GetWorldMatrix();
+                command.sortKey    = Algorithms::FloatToSortableKey(command.transform.Translation()[2]);
                 m_Renderer2DData.m_CommandQueue2D.PushBack(command);
             };
 
-            {
-                LUMOS_PROFILE_SCOPE("Sort Meshes by distance from camera");
-                auto camTransform = m_CameraTransform;
-                if(!m_ForwardData.m_CommandQueue.Empty())
-                    Algorithms::BubbleSort(m_ForwardData.m_CommandQueue.begin(), m_ForwardData.m_CommandQueue.end(),
-                                           [camTransform](RenderCommand& a, RenderCommand& b)
-                                           {
-                                               if(a.material->GetFlag(Material::RenderFlags::DEPTHTEST) && !b.material->GetFlag(Material::RenderFlags::DEPTHTEST))
-                                                   return true;
-                                               if(!a.material->GetFlag(Material::RenderFlags::DEPTHTEST) && b.material->GetFlag(Material::RenderFlags::DEPTHTEST))
-                                                   return false;
-
-                                               return Maths::Distance(camTransform->GetWorldPosition(), a.transform.Translation()) < Maths::Distance(camTransform->GetWorldPosition(), b.transform.Translation());
-                                           });
-            }
-
             {
                 LUMOS_PROFILE_SCOPE("Sort sprites by z value");
-                if(!m_Renderer2DData.m_CommandQueue2D.Empty())
-                    Algorithms::BubbleSort(m_Renderer2DData.m_CommandQueue2D.begin(), m_Renderer2DData.m_CommandQueue2D.end(),
-                                           [](RenderCommand2D& a, RenderCommand2D& b)
-                                           {
-                                               return a.transform.Translation()[2] < b.transform.Translation()[2];
-                                           });
+                SortRenderCommands(m_Renderer2DData.m_CommandQueue2D, m_SortKeys, m_SortIndices);
             }
         }
     }
@@ -1655,7 +1710,7 @@ namespace Lumos::Graphics
 
                 command.pipeline->GetShader()->BindPushConstants(commandBuffer, pipeline);
                 Renderer::BindDescriptorSets(pipeline, commandBuffer, 0, currentDescriptors, command.animated ? 4 : 3);
-                Renderer::DrawMesh(commandBuffer, pipeline, mesh);
+                Renderer::DrawMesh(commandBuffer, pipeline, mesh, command.lod);
                 m_Stats.NumShadowObjects++;
             }
             commandBuffer->UnBindPipeline();
@@ -1712,7 +1767,7 @@ namespace Lumos::Graphics
 
             m_DepthPrePassShader->BindPushConstants(commandBuffer, pipeline);
             Renderer::BindDescriptorSets(pipeline, commandBuffer, 0, sets, command.animated ? 4 : 3);
-            Renderer::DrawMesh(commandBuffer, pipeline, mesh);
+            Renderer::DrawMesh(commandBuffer, pipeline, mesh, command.lod);
         }
     }
 
@@ -1903,7 +1958,7 @@ namespace Lumos::Graphics
 
             m_ForwardData.m_Shader->BindPushConstants(commandBuffer, pipeline);
             Renderer::BindDescriptorSets(pipeline, commandBuffer, 0, currentDescriptors, command.animated ? 4 : 3);
-            Renderer::DrawMesh(commandBuffer, pipeline, mesh);
+            Renderer::DrawMesh(commandBuffer, pipeline, mesh, command.lod);
         }
     }
 
@@ -4944,16 +4999,6 @@ namespace Lumos::Graphics
         return result;
     }
 
-    bool compareParticles(const Particle& a, const Particle& b, const Vec3& cameraPosition)
-    {
-        // Calculate squared distance from camera to particle
-        float distanceSqA = Maths::Length2(a.Position - cameraPosition);
-        float distanceSqB = Maths::Length2(b.Position - cameraPosition);
-
-        // Sort in descending order based on squared distance
-        return distanceSqA > distanceSqB;
-    }
-
     void SceneRenderer::ParticlePass()
     {
         LUMOS_PROFILE_FUNCTION();
@@ -4993,8 +5038,8 @@ namespace Lumos::Graphics
         for(auto& emitterEntity : emitterGroup)
         {
             const auto& [emitter, trans] = emitterGroup.get<ParticleEmitter, Maths::Transform>(emitterEntity);
-            Particle* particles          = emitter.GetParticles();
-            uint32_t particleCount       = emitter.GetParticleCount();
+            const ParticleArrays& particles = emitter.GetParticles();
+            const uint32_t particleCount    = particles.AliveCount;
 
             if(!particleCount)
                 continue;
@@ -5013,17 +5058,29 @@ namespace Lumos::Graphics
             pipelineDesc.depthBiasSlopeFactor    = -1.75f;
             m_ParticleData.m_Pipeline            = Graphics::Pipeline::Get(pipelineDesc);
 
-            if(emitter.GetSortParticles())
+            // Back to front through an index list, the particle arrays stay as the emitter packed them
+            const bool sorted = emitter.GetSortParticles() && particleCount > 1;
+            if(sorted)
             {
-                std::sort(&particles[0], &particles[particleCount - 1], [&](const Particle& a, const Particle& b)
-                          { return compareParticles(a, b, m_CameraTransform->GetWorldPosition()); });
+                m_SortKeys.Resize(particleCount * 2);
+                m_SortIndices.Resize(particleCount * 2);
+                for(uint32_t i = 0; i < particleCount; i++)
+                {
+                    const float distance2 = Maths::Length2(particles.GetPosition(i) - cameraPos);
+                    m_SortKeys[i]         = ~Algorithms::FloatToSortableKey(distance2);
+                    m_SortIndices[i]      = i;
+                }
+
+                Algorithms::RadixSort(m_SortKeys.Data(), m_SortIndices.Data(), m_SortKeys.Data() + particleCount, m_SortIndices.Data() + particleCount, particleCount);
             }
 
-            for(uint32_t i = 0; i < particleCount; i++)
+            const Vec4& initialColour = emitter.GetInitialColour();
+            for(uint32_t n = 0; n < particleCount; n++)
             {
-                auto& particle = particles[i];
-                if(particle.Life <= 0.0f)
-                    continue;
+                const uint32_t i    = sorted ? m_SortIndices[n] : n;
+                const Vec3 position = particles.GetPosition(i);
+                const float size    = particles.Size[i];
+                const float life    = particles.Life[i];
 
                 m_Stats.NumRenderedObjects++;
 
@@ -5039,39 +5096,39 @@ namespace Lumos::Graphics
                 auto alignType = emitter.GetAlignedType();
                 if(alignType == ParticleEmitter::Aligned2D)
                 {
-                    Vec3 rightOffset = Vec3(1.0f, 0.0f, 0.0f) * particle.Size * 0.5f;
-                    Vec3 upOffset    = Vec3(0.0f, 1.0f, 0.0f) * particle.Size * 0.5f;
+                    Vec3 rightOffset = Vec3(1.0f, 0.0f, 0.0f) * size * 0.5f;
+                    Vec3 upOffset    = Vec3(0.0f, 1.0f, 0.0f) * size * 0.5f;
 
-                    v1 = particle.Position - rightOffset - upOffset;
-                    v2 = particle.Position + rightOffset - upOffset;
-                    v3 = particle.Position + rightOffset + upOffset;
-                    v4 = particle.Position - rightOffset + upOffset;
+                    v1 = position - rightOffset - upOffset;
+                    v2 = position + rightOffset - upOffset;
+                    v3 = position + rightOffset + upOffset;
+                    v4 = position - rightOffset + upOffset;
                 }
                 else if(alignType == ParticleEmitter::Aligned3D)
                 {
                     Vec3 cameraRight = m_CameraTransform->GetRightDirection().Normalised();
                     Vec3 cameraUp    = m_CameraTransform->GetUpDirection().Normalised();
 
-                    Vec3 rightOffset = cameraRight * particle.Size * 0.5f;
-                    Vec3 upOffset    = cameraUp * particle.Size * 0.5f;
+                    Vec3 rightOffset = cameraRight * size * 0.5f;
+                    Vec3 upOffset    = cameraUp * size * 0.5f;
 
-                    v1 = particle.Position - rightOffset - upOffset;
-                    v2 = particle.Position + rightOffset - upOffset;
-                    v3 = particle.Position + rightOffset + upOffset;
-                    v4 = particle.Position - rightOffset + upOffset;
+                    v1 = position - rightOffset - upOffset;
+                    v2 = position + rightOffset - upOffset;
+                    v3 = position + rightOffset + upOffset;
+                    v4 = position - rightOffset + upOffset;
                 }
                 else
                 {
-                    Vec3 rightOffset = Vec3(particle.Size * 0.5f, 0.0f, 0.0f);
-                    Vec3 upOffset    = Vec3(0.0f, particle.Size * 0.5f, 0.0f);
+                    Vec3 rightOffset = Vec3(size * 0.5f, 0.0f, 0.0f);
+                    Vec3 upOffset    = Vec3(0.0f, size * 0.5f, 0.0f);
 
-                    v1 = particle.Position - rightOffset - upOffset;
-                    v2 = particle.Position + rightOffset - upOffset;
-                    v3 = particle.Position + rightOffset + upOffset;
-                    v4 = particle.Position - rightOffset + upOffset;
+                    v1 = position - rightOffset - upOffset;
+                    v2 = position + rightOffset - upOffset;
+                    v3 = position + rightOffset + upOffset;
+                    v4 = position - rightOffset + upOffset;
                 }
 
-                const Vec4 colour = particle.Colour;
+                const Vec4 colour = Vec4(initialColour.x, initialColour.y, initialColour.z, particles.Alpha[i]);
                 bool animated     = emitter.GetIsAnimated();
                 std::array<Vec2, 4> uv;
                 std::array<Vec4, 4> blendedUVs;
@@ -5080,7 +5137,7 @@ namespace Lumos::Graphics
 
                 if(animated)
                 {
-                    blendedUVs = emitter.GetBlendedAnimatedUVs(1.0f - (particle.Life / emitter.GetParticleLife()), emitter.GetAnimatedTextureRows(), blendAmount);
+                    blendedUVs = emitter.GetBlendedAnimatedUVs(1.0f - (life / emitter.GetParticleLife()), emitter.GetAnimatedTextureRows(), blendAmount);
                 }
                 else
                 {
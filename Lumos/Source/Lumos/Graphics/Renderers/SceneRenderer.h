@@ -1,6 +1,7 @@
 #pragma once
 #include "Graphics/Renderers/IRenderer.h"
 #include "Graphics/Renderable2D.h"
+#include "Maths/FrustumCuller.h"
 
 #define MAX_BOUND_TEXTURES 16
 
@@ -13,6 +14,14 @@ namespace Lumos
     struct SceneRenderSettings;
     struct UI_Widget;
 
+    namespace System
+    {
+        namespace JobSystem
+        {
+            class TaskGraph;
+        }
+    }
+
     namespace Maths
     {
         class Transform;
@@ -78,6 +87,10 @@ namespace Lumos
             void BeginScene(Scene* scene);
             void OnNewScene(Scene* scene);
 
+            // Adds a node gathering the bounds of the scene's meshes for the next BeginScene to cull, so it can run
+            //    alongside other frame work. The scene can't change until BeginScene. Returns UINT32_MAX if no node is added
+            uint32_t AddCullingTasks(System::JobSystem::TaskGraph& graph, Scene* scene);
+
             void OnRender();
             void OnUpdate(const TimeStep& timeStep, Scene* scene);
             void OnEvent(Event& e);
@@ -140,6 +153,7 @@ namespace Lumos
             {
                 Renderable2D* renderable = nullptr;
                 Mat4 transform;
+                uint64_t sortKey = 0;
             };
 
             typedef TDArray<RenderCommand2D> CommandQueue2D;
@@ -285,6 +299,10 @@ namespace Lumos
 
             void SetDisablePostProcess(bool disabled) { m_DisablePostProcess = disabled; }
 
+            // Largest error in pixels a mesh LOD may show on screen. 0 always draws LOD 0
+            void SetLODPixelError(float pixels) { m_LODPixelError = pixels; }
+            float GetLODPixelError() const { return m_LODPixelError; }
+
         private:
             void InitDebugRenderData();
             bool m_DebugRenderDataInitialised = false;
@@ -314,6 +332,23 @@ namespace Lumos
 
             TextVertexData* TextVertexBufferPtr = nullptr;
 
+            // Scratch storage for radix sorting the command queues by sort key
+            TDArray<uint64_t> m_SortKeys;
+            TDArray<uint32_t> m_SortIndices;
+
+            void GatherMeshBounds(Scene* scene);
+
+            // Meshes gathered for BeginScene, in the order their bounds were added to m_MeshCuller
+            struct CulledMesh
+            {
+                Model* model;
+                Mesh* mesh;
+                const Mat4* transform;
+            };
+            TDArray<CulledMesh> m_CulledMeshes;
+            Maths::FrustumCuller m_MeshCuller;
+            Scene* m_GatheredScene = nullptr;
+
             // Vertex data per frame in flight, per batch
             TDArray<TDArray<VertexData*>> m_ParticleBufferBase;
             TDArray<TDArray<VertexData*>> m_2DBufferBase;
@@ -332,6 +367,7 @@ namespace Lumos
             Scene* m_CurrentScene  = nullptr;
             bool m_GenerateBRDFLUT = false;
             bool m_SupportCompute  = false;
+            float m_LODPixelError  = 1.0f;
 
             // Temp
             bool m_DisablePostProcess = false;
@@ -0,0 +1,178 @@
+#include "Precompiled.h"
+#include "Maths/FrustumCuller.h"
+#include "Maths/Frustum.h"
+#include "Maths/BoundingBox.h"
+#include "Maths/MathsUtilities.h"
+#include "Core/JobSystem.h"
+
+#ifdef LUMOS_SSE
+#include <smmintrin.h>
+#endif
+
+namespace Lumos
+{
+    namespace Maths
+    {
+        // Below this many boxes the cull stays on the calling thread
+        static const uint32_t PARALLEL_CULL_THRESHOLD = 4096;
+        static const uint32_t BOXES_PER_JOB           = 2048; // Multiple of 4
+
+        void FrustumCuller::Clear()
+        {
+            m_Count = 0;
+            m_CenterX.Clear();
+            m_CenterY.Clear();
+            m_CenterZ.Clear();
+            m_ExtentX.Clear();
+            m_ExtentY.Clear();
+            m_ExtentZ.Clear();
+            m_Visibility.Clear();
+        }
+
+        void FrustumCuller::Reserve(uint32_t count)
+        {
+            count = (count + 3) & ~3u;
+            m_CenterX.Reserve(count);
+            m_CenterY.Reserve(count);
+            m_CenterZ.Reserve(count);
+            m_ExtentX.Reserve(count);
+            m_ExtentY.Reserve(count);
+            m_ExtentZ.Reserve(count);
+            m_Visibility.Reserve(count);
+        }
+
+        uint32_t FrustumCuller::AddBox(const BoundingBox& box)
+        {
+            const uint32_t index = m_Count++;
+            if(index == (uint32_t)m_CenterX.Size())
+            {
+                // Grow a group of four at a time, the padding is culled along with the rest and ignored
+                const uint32_t size = index + 4;
+                m_CenterX.Resize(size);
+                m_CenterY.Resize(size);
+                m_CenterZ.Resize(size);
+                m_ExtentX.Resize(size);
+                m_ExtentY.Resize(size);
+                m_ExtentZ.Resize(size);
+                m_Visibility.Resize(size);
+            }
+
+            const Vec3 center  = box.Center();
+            const Vec3 extents = box.Size() * 0.5f;
+            m_CenterX[index]   = center.x;
+            m_CenterY[index]   = center.y;
+            m_CenterZ[index]   = center.z;
+            m_ExtentX[index]   = extents.x;
+            m_ExtentY[index]   = extents.y;
+            m_ExtentZ[index]   = extents.z;
+
+            return index;
+        }
+
+        void FrustumCuller::Cull(const Frustum* frustums, uint32_t frustumCount)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            ASSERT(frustumCount <= MaxFrustums);
+
+            // Normal and distance of every plane, frustum after frustum
+            float planes[MaxFrustums * 6 * 4];
+            for(uint32_t f = 0; f < frustumCount; f++)
+            {
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const Plane& plane = frustums[f].GetPlane(p);
+                    float* out         = planes + (f * 6 + p) * 4;
+                    out[0]             = plane.Normal().x;
+                    out[1]             = plane.Normal().y;
+                    out[2]             = plane.Normal().z;
+                    out[3]             = plane.Distance();
+                }
+            }
+
+            const uint32_t count = (uint32_t)m_CenterX.Size();
+            if(count >= PARALLEL_CULL_THRESHOLD)
+            {
+                const uint32_t jobCount = (count + BOXES_PER_JOB - 1) / BOXES_PER_JOB;
+
+                System::JobSystem::Context ctx;
+                System::JobSystem::Dispatch(ctx, jobCount, 1, [this, &planes, frustumCount, count](JobDispatchArgs args)
+                                            {
+                                                const uint32_t begin = args.jobIndex * BOXES_PER_JOB;
+                                                CullRange(begin, Maths::Min(begin + BOXES_PER_JOB, count), planes, frustumCount); });
+                System::JobSystem::Wait(ctx);
+            }
+            else
+                CullRange(0, count, planes, frustumCount);
+        }
+
+        void FrustumCuller::CullRange(uint32_t begin, uint32_t end, const float* planes, uint32_t frustumCount)
+        {
+            LUMOS_PROFILE_FUNCTION_LOW();
+
+            // A box is outside a plane if even its corner furthest along the normal is behind it:
+            // dot(n, centre) + dot(|n|, extents) + d < 0
+#ifdef LUMOS_SSE
+            const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128 zero     = _mm_setzero_ps();
+
+            for(uint32_t i = begin; i < end; i += 4)
+            {
+                const __m128 centerX = _mm_loadu_ps(m_CenterX.Data() + i);
+                const __m128 centerY = _mm_loadu_ps(m_CenterY.Data() + i);
+                const __m128 centerZ = _mm_loadu_ps(m_CenterZ.Data() + i);
+                const __m128 extentX = _mm_loadu_ps(m_ExtentX.Data() + i);
+                const __m128 extentY = _mm_loadu_ps(m_ExtentY.Data() + i);
+                const __m128 extentZ = _mm_loadu_ps(m_ExtentZ.Data() + i);
+
+                __m128i visibility = _mm_setzero_si128();
+                for(uint32_t f = 0; f < frustumCount; f++)
+                {
+                    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                    for(uint32_t p = 0; p < 6; p++)
+                    {
+                        const __m128 plane   = _mm_loadu_ps(planes + (f * 6 + p) * 4);
+                        const __m128 normalX = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(0, 0, 0, 0));
+                        const __m128 normalY = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(1, 1, 1, 1));
+                        const __m128 normalZ = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(2, 2, 2, 2));
+                        const __m128 dist    = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(3, 3, 3, 3));
+
+                        __m128 d = _mm_add_ps(dist, _mm_mul_ps(normalX, centerX));
+                        d        = _mm_add_ps(d, _mm_mul_ps(normalY, centerY));
+                        d        = _mm_add_ps(d, _mm_mul_ps(normalZ, centerZ));
+                        d        = _mm_add_ps(d, _mm_mul_ps(_mm_and_ps(normalX, signMask), extentX));
+                        d        = _mm_add_ps(d, _mm_mul_ps(_mm_and_ps(normalY, signMask), extentY));
+                        d        = _mm_add_ps(d, _mm_mul_ps(_mm_and_ps(normalZ, signMask), extentZ));
+
+                        inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+                    }
+
+                    visibility = _mm_or_si128(visibility, _mm_and_si128(_mm_castps_si128(inside), _mm_set1_epi32(1 << f)));
+                }
+
+                _mm_storeu_si128((__m128i*)(m_Visibility.Data() + i), visibility);
+            }
+#else
+            for(uint32_t i = begin; i < end; i++)
+            {
+                uint32_t visibility = 0;
+                for(uint32_t f = 0; f < frustumCount; f++)
+                {
+                    bool inside = true;
+                    for(uint32_t p = 0; p < 6 && inside; p++)
+                    {
+                        const float* plane = planes + (f * 6 + p) * 4;
+                        const float d      = plane[3] + plane[0] * m_CenterX[i] + plane[1] * m_CenterY[i] + plane[2] * m_CenterZ[i]
+                                      + Maths::Abs(plane[0]) * m_ExtentX[i] + Maths::Abs(plane[1]) * m_ExtentY[i] + Maths::Abs(plane[2]) * m_ExtentZ[i];
+                        inside = d >= 0.0f;
+                    }
+
+                    if(inside)
+                        visibility |= 1u << f;
+                }
+
+                m_Visibility[i] = visibility;
+            }
+#endif
+        }
+    }
+}
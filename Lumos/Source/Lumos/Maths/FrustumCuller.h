@@ -0,0 +1,47 @@
+#pragma once
+#include "Core/DataStructures/TDArray.h"
+#include "Maths/Vector3.h"
+
+namespace Lumos
+{
+    namespace Maths
+    {
+        class BoundingBox;
+        class Frustum;
+
+        // Culls a batch of world space boxes against several frustums in one pass. Boxes are kept as packed
+        // centre and half extent arrays so four are tested against a plane at a time.
+        // Cull writes a mask per box with bit i set if the box is inside frustums[i]
+        class FrustumCuller
+        {
+        public:
+            static const uint32_t MaxFrustums = 32;
+
+            void Clear();
+            void Reserve(uint32_t count);
+
+            // Returns the index of the box's visibility mask
+            uint32_t AddBox(const BoundingBox& box);
+
+            void Cull(const Frustum* frustums, uint32_t frustumCount);
+
+            uint32_t GetBoxCount() const { return m_Count; }
+            uint32_t GetVisibility(uint32_t index) const { return m_Visibility[index]; }
+            Vec3 GetCenter(uint32_t index) const { return Vec3(m_CenterX[index], m_CenterY[index], m_CenterZ[index]); }
+            Vec3 GetExtents(uint32_t index) const { return Vec3(m_ExtentX[index], m_ExtentY[index], m_ExtentZ[index]); }
+
+        private:
+            void CullRange(uint32_t begin, uint32_t end, const float* planes, uint32_t frustumCount);
+
+            // Padded to a multiple of 4 boxes
+            TDArray<float> m_CenterX;
+            TDArray<float> m_CenterY;
+            TDArray<float> m_CenterZ;
+            TDArray<float> m_ExtentX;
+            TDArray<float> m_ExtentY;
+            TDArray<float> m_ExtentZ;
+            TDArray<uint32_t> m_Visibility;
+            uint32_t m_Count = 0;
+        };
+    }
+}
@@ -35,6 +35,26 @@ namespace Lumos
     __m128 Mat2MulAdj(__m128 vec1, __m128 vec2);
 
     float GetValue(const __m128& v, const int index);
+
+    // Loads four consecutive 16 byte vectors (Vec3, Vec4 or Quat) transposed, so x holds the four x
+    // components and so on. For Vec3 w is the padding, pass it back to StoreTransposed unchanged
+    inline void LoadTransposed(const float* v, __m128& x, __m128& y, __m128& z, __m128& w)
+    {
+        x = _mm_loadu_ps(v);
+        y = _mm_loadu_ps(v + 4);
+        z = _mm_loadu_ps(v + 8);
+        w = _mm_loadu_ps(v + 12);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+    }
+
+    inline void StoreTransposed(float* v, __m128 x, __m128 y, __m128 z, __m128 w)
+    {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(v, x);
+        _mm_storeu_ps(v + 4, y);
+        _mm_storeu_ps(v + 8, z);
+        _mm_storeu_ps(v + 12, w);
+    }
 }
 
 #endif
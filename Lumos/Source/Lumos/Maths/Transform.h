@@ -44,6 +44,11 @@ namespace Lumos
             const Vec3& GetLocalScale() const;
             const Quat& GetLocalOrientation() const;
 
+            // Set when the local transform changes. The SceneGraph only rebuilds world matrices of dirty
+            // transforms and their descendants, and clears the flag once it has
+            bool IsDirty() const { return m_Dirty; }
+            void SetDirty(bool dirty) { m_Dirty = dirty; }
+
             Vec3 GetUpDirection()
             {
                 Vec3 up = Vec3(0.0f, 1.0f, 0.0f);
@@ -71,6 +76,8 @@ namespace Lumos
             Vec3 m_LocalPosition;
             Vec3 m_LocalScale;
             Quat m_LocalOrientation;
+
+            bool m_Dirty = true;
         };
     }
 }
@@ -9,6 +9,7 @@
 
 #include "Maths/Transform.h"
 #include "Maths/MathsUtilities.h"
+#include "Core/JobSystem.h"
 #include "B2DebugDraw.h"
 
 #include <box2d/box2d.h>
@@ -18,16 +19,69 @@
 
 namespace Lumos
 {
+    // Box2D never has more than a solver task per worker and a handful of others unfinished at once, so with at most
+    // 64 workers a slot is always free
+    static const uint32_t MAX_B2_TASKS = 128;
+
+    // A Box2D parallel-for split into ranges. The stepping thread and the jobs dispatched for the task claim ranges
+    // until none are left, so a range never waits in a queue behind a job that blocks
+    struct B2Task
+    {
+        b2TaskCallback* Callback;
+        void* TaskContext;
+        int32_t ItemCount;
+        int32_t RangeSize;
+        int32_t RangeCount;
+        std::atomic<int32_t> NextRange { 0 };
+        std::atomic<int32_t> FinishedRanges { 0 };
+
+        // The stepping thread and each dispatched job, the slot can be reused once all have let go
+        std::atomic<uint32_t> References { 0 };
+    };
+
+    struct B2TaskPool
+    {
+        B2Task Tasks[MAX_B2_TASKS];
+        uint32_t NextTask = 0;
+        System::JobSystem::Context JobContext;
+    };
+
+    static void RunTaskRanges(B2Task* task)
+    {
+        int32_t range;
+        while((range = task->NextRange.fetch_add(1, std::memory_order_relaxed)) < task->RangeCount)
+        {
+            const int32_t start = range * task->RangeSize;
+            const int32_t end   = Maths::Min(start + task->RangeSize, task->ItemCount);
+
+            // Box2D only reads the worker index in tasks that never run alongside each other, so the range index
+            // is a unique one
+            if(start < end)
+                task->Callback(start, end, (uint32_t)range, task->TaskContext);
+
+            task->FinishedRanges.fetch_add(1, std::memory_order_release);
+        }
+    }
+
     B2PhysicsEngine::B2PhysicsEngine()
         : m_UpdateTimestep(1.0f / 60.f)
         , m_Paused(false)
     {
         m_DebugName = "Box2D Physics Engine";
+        m_TaskPool  = new B2TaskPool();
+
+        // One worker per job system thread, up to Box2D's limit of 64. The stepping thread stands in for the job
+        // thread it is waiting on, so this never asks for more threads than there are
+        m_WorkerCount = (int32_t)Maths::Clamp(System::JobSystem::GetThreadCount(), 1u, 64u);
 
-        b2Vec2 gravity      = { 0.0f, -9.81f };
-        b2WorldDef worldDef = b2DefaultWorldDef();
-        worldDef.gravity    = gravity;
-        m_B2DWorld          = b2CreateWorld(&worldDef);
+        b2Vec2 gravity           = { 0.0f, -9.81f };
+        b2WorldDef worldDef      = b2DefaultWorldDef();
+        worldDef.gravity         = gravity;
+        worldDef.workerCount     = m_WorkerCount;
+        worldDef.enqueueTask     = &B2PhysicsEngine::EnqueueTask;
+        worldDef.finishTask      = &B2PhysicsEngine::FinishTask;
+        worldDef.userTaskContext = this;
+        m_B2DWorld               = b2CreateWorld(&worldDef);
 
         b2AABB bounds = { { -FLT_MAX, -FLT_MAX }, { FLT_MAX, FLT_MAX } };
 
@@ -58,11 +112,15 @@ namespace Lumos
 
     B2PhysicsEngine::~B2PhysicsEngine()
     {
+        // Jobs for ranges the stepping thread already ran may still be queued
+        System::JobSystem::Wait(m_TaskPool->JobContext);
+        delete m_TaskPool;
     }
 
     void B2PhysicsEngine::SetDefaults()
     {
         m_UpdateTimestep = 1.0f / 60.f;
+        m_UpdateAccum    = 0.0f;
     }
 
     void B2PhysicsEngine::OnUpdate(const TimeStep& timeStep, Scene* scene)
@@ -71,29 +129,123 @@ namespace Lumos
 
         if(!m_Paused)
         {
-            b2World_Step(m_B2DWorld, (float)timeStep.GetSeconds(), 4);
+            m_UpdateAccum += (float)timeStep.GetSeconds();
+            const uint32_t stepCount = Maths::Min((uint32_t)(m_UpdateAccum / m_UpdateTimestep), m_MaxUpdatesPerFrame);
+            m_UpdateAccum -= stepCount * m_UpdateTimestep;
 
-            b2ContactEvents contactEvents = b2World_GetContactEvents(m_B2DWorld);
-            for(int i = 0; i < contactEvents.beginCount; ++i)
+            for(uint32_t step = 0; step < stepCount; ++step)
             {
-                b2ContactBeginTouchEvent event = contactEvents.beginEvents[i];
-                b2BodyId bodyIdA               = b2Shape_GetBody(event.shapeIdA);
-                b2BodyId bodyIdB               = b2Shape_GetBody(event.shapeIdB);
+                // Only the last step of the frame is interpolated from
+                if(step == stepCount - 1)
+                    StorePreviousTransforms(scene);
 
-                ContactCallback* callbackA = (ContactCallback*)b2Body_GetUserData(bodyIdA);
-                if(callbackA)
-                {
-                    callbackA->OnCollision(bodyIdA, bodyIdB, 1.0f); // event.approachSpeed);
-                }
-                ContactCallback* callbackB = (ContactCallback*)b2Body_GetUserData(bodyIdB);
-                if(callbackB)
+                b2World_Step(m_B2DWorld, m_UpdateTimestep, m_SubStepCount);
+
+                b2ContactEvents contactEvents = b2World_GetContactEvents(m_B2DWorld);
+                for(int i = 0; i < contactEvents.beginCount; ++i)
                 {
-                    callbackB->OnCollision(bodyIdB, bodyIdA, 1.0f); // event.approachSpeed);
+                    b2ContactBeginTouchEvent event = contactEvents.beginEvents[i];
+                    b2BodyId bodyIdA               = b2Shape_GetBody(event.shapeIdA);
+                    b2BodyId bodyIdB               = b2Shape_GetBody(event.shapeIdB);
+
+                    ContactCallback* callbackA = (ContactCallback*)b2Body_GetUserData(bodyIdA);
+                    if(callbackA)
+                    {
+                        callbackA->OnCollision(bodyIdA, bodyIdB, 1.0f); // event.approachSpeed);
+                    }
+                    ContactCallback* callbackB = (ContactCallback*)b2Body_GetUserData(bodyIdB);
+                    if(callbackB)
+                    {
+                        callbackB->OnCollision(bodyIdB, bodyIdA, 1.0f); // event.approachSpeed);
+                    }
                 }
             }
+
+            if(m_UpdateAccum >= m_UpdateTimestep)
+            {
+                LWARN("2D Physics too slow to run in real time!");
+                // Drop Time in the hope that it can continue to run in real-time
+                m_UpdateAccum = 0.0f;
+            }
         }
     }
 
+    void B2PhysicsEngine::StorePreviousTransforms(Scene* scene)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        if(!scene)
+            return;
+
+        auto view = scene->GetRegistry().view<RigidBody2DComponent>();
+        for(auto entity : view)
+            view.get<RigidBody2DComponent>(entity).GetRigidBody()->StorePreviousTransform();
+    }
+
+    void* B2PhysicsEngine::EnqueueTask(b2TaskCallback* task, int32_t itemCount, int32_t minRange, void* taskContext, void* userContext)
+    {
+        B2PhysicsEngine* engine = (B2PhysicsEngine*)userContext;
+        B2TaskPool* pool        = engine->m_TaskPool;
+
+        B2Task* userTask = nullptr;
+        for(uint32_t i = 0; i < MAX_B2_TASKS && !userTask; i++)
+        {
+            B2Task* slot = &pool->Tasks[pool->NextTask++ % MAX_B2_TASKS];
+            if(slot->References.load(std::memory_order_acquire) == 0)
+                userTask = slot;
+        }
+
+        if(!userTask)
+        {
+            // Can't happen, see MAX_B2_TASKS. Returning null tells Box2D the work has already been done
+            LERROR("Out of Box2D task slots");
+            task(0, itemCount, 0, taskContext);
+            return nullptr;
+        }
+
+        // Never more ranges than workers, and none smaller than Box2D asks for
+        const int32_t rangeCount = Maths::Max(1, Maths::Min(engine->m_WorkerCount, itemCount / Maths::Max(minRange, 1)));
+
+        userTask->Callback    = task;
+        userTask->TaskContext = taskContext;
+        userTask->ItemCount   = itemCount;
+        userTask->RangeCount  = rangeCount;
+        userTask->RangeSize   = (itemCount + rangeCount - 1) / rangeCount;
+        userTask->NextRange.store(0, std::memory_order_relaxed);
+        userTask->FinishedRanges.store(0, std::memory_order_relaxed);
+
+        // The stepping thread takes one range in FinishTask, jobs take the rest. A single range task, such as a solver
+        // worker that spins until worker 0 runs, still gets a job so the workers run side by side
+        const uint32_t jobCount = (uint32_t)Maths::Max(1, rangeCount - 1);
+        userTask->References.store(jobCount + 1, std::memory_order_release);
+
+        // Never run inline, a solver worker run here would spin before worker 0 was even enqueued
+        if(!System::JobSystem::TryDispatch(pool->JobContext, jobCount, 1, [userTask](JobDispatchArgs /*args*/)
+                                           {
+                                               RunTaskRanges(userTask);
+                                               userTask->References.fetch_sub(1, std::memory_order_release); }))
+        {
+            // The queue is full, FinishTask runs every range instead
+            userTask->References.store(1, std::memory_order_release);
+        }
+
+        return userTask;
+    }
+
+    void B2PhysicsEngine::FinishTask(void* userTask, void* userContext)
+    {
+        B2Task* task = (B2Task*)userTask;
+
+        // Run the ranges no job has claimed yet. Box2D finishes solver worker 0 first, so when no job has picked it
+        // up it runs here. Other jobs are never taken on while waiting, one of them could be a solver worker that
+        // spins until worker 0 has run
+        RunTaskRanges(task);
+        while(task->FinishedRanges.load(std::memory_order_acquire) < task->RangeCount)
+            std::this_thread::yield();
+
+        task->References.fetch_sub(1, std::memory_order_release);
+    }
+
     void B2PhysicsEngine::OnImGui()
     {
         ImGui::TextUnformatted("2D Physics Engine");
@@ -180,13 +332,16 @@ namespace Lumos
 
     void B2PhysicsEngine::SyncTransforms(Scene* scene)
     {
+        LUMOS_PROFILE_FUNCTION();
+
         if(m_Paused)
             return;
 
         if(!scene)
             return;
 
-        auto& registry = scene->GetRegistry();
+        const float alpha = Maths::Min(m_UpdateAccum / m_UpdateTimestep, 1.0f);
+        auto& registry    = scene->GetRegistry();
 
         auto group = registry.group<RigidBody2DComponent>(entt::get<Maths::Transform>);
 
@@ -197,8 +352,8 @@ namespace Lumos
             // if (!phys.GetRigidBody()->GetB2Body()->IsAwake())
             //     break;
 
-            trans.SetLocalPosition(Vec3(phys.GetRigidBody()->GetPosition(), trans.GetLocalPosition().z));
-            trans.SetLocalOrientation(Quat(Vec3(0.0f, 0.0f, Maths::ToDegrees(phys.GetRigidBody()->GetAngle()))));
+            trans.SetLocalPosition(Vec3(phys.GetRigidBody()->GetInterpolatedPosition(alpha), trans.GetLocalPosition().z));
+            trans.SetLocalOrientation(Quat(Vec3(0.0f, 0.0f, Maths::ToDegrees(phys.GetRigidBody()->GetInterpolatedAngle(alpha)))));
             trans.SetWorldMatrix(Mat4(1.0f)); // TODO: temp
         };
     }
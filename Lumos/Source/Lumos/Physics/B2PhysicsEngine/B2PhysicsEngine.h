@@ -8,6 +8,7 @@
 namespace Lumos
 {
     class TimeStep;
+    struct B2TaskPool;
 
     enum PhysicsDebugFlags2D : uint32_t
     {
@@ -49,16 +50,40 @@ namespace Lumos
         void SetDebugDrawFlags(uint32_t flags);
         void SetGravity(const Vec2& gravity);
 
+        // Writes body transforms to the scene, blended between the last two steps by the time left in the accumulator
         void SyncTransforms(Scene* scene);
 
+        float GetUpdateTimestep() const { return m_UpdateTimestep; }
+        void SetUpdateTimestep(float timestep) { m_UpdateTimestep = timestep; }
+
+        uint32_t GetMaxUpdatesPerFrame() const { return m_MaxUpdatesPerFrame; }
+        void SetMaxUpdatesPerFrame(uint32_t updates) { m_MaxUpdatesPerFrame = updates; }
+
+        int32_t GetSubStepCount() const { return m_SubStepCount; }
+        void SetSubStepCount(int32_t count) { m_SubStepCount = count; }
+
     private:
+        void StorePreviousTransforms(Scene* scene);
+
+        // Box2D task callbacks. The thread that steps the world runs a share of each task itself in FinishTask,
+        // the rest goes to the job system
+        static void* EnqueueTask(b2TaskCallback* task, int32_t itemCount, int32_t minRange, void* taskContext, void* userContext);
+        static void FinishTask(void* userTask, void* userContext);
+
         b2WorldId m_B2DWorld;
         b2DebugDraw m_DebugDraw;
 
         u32 m_DebugDrawFlags = 0;
 
         float m_UpdateTimestep;
-        bool m_Paused = true;
+        float m_UpdateAccum           = 0.0f;
+        uint32_t m_MaxUpdatesPerFrame = 5;
+        int32_t m_SubStepCount        = 4;
+        bool m_Paused                 = true;
+
+        // Tasks handed to Box2D that haven't finished yet
+        B2TaskPool* m_TaskPool = nullptr;
+        int32_t m_WorkerCount  = 1;
 
         int32_t m_VelocityIterations = 6;
         int32_t m_PositionIterations = 2;
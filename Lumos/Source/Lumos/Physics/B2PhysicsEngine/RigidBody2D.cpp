@@ -4,6 +4,7 @@
 #include "Core/Application.h"
 
 #include "Maths/Vector2.h"
+#include "Maths/MathsUtilities.h"
 #include <box2d/box2d.h>
 
 namespace Lumos
@@ -44,14 +45,16 @@ namespace Lumos
         b2Body_ApplyForceToCenter(m_B2Body, { v.x, v.y }, true);
     }
 
-    void RigidBody2D::SetPosition(const Vec2& pos) const
+    void RigidBody2D::SetPosition(const Vec2& pos)
     {
         b2Body_SetTransform(m_B2Body, { pos.x, pos.y }, b2Body_GetRotation(m_B2Body));
+        m_PreviousPosition = pos; // Teleport, don't interpolate from the old position
     }
 
-    void RigidBody2D::SetOrientation(float angle) const
+    void RigidBody2D::SetOrientation(float angle)
     {
         b2Body_SetTransform(m_B2Body, b2Body_GetPosition(m_B2Body), b2MakeRot(angle));
+        m_PreviousAngle = angle;
     }
 
     void RigidBody2D::SetIsStatic(bool isStatic)
@@ -79,6 +82,7 @@ namespace Lumos
 
         b2WorldId lWorldID = Application::Get().GetSystem<B2PhysicsEngine>()->GetB2World();
         m_B2Body           = b2CreateBody(lWorldID, &bodyDef);
+        StorePreviousTransform();
 
         if(params.shape == Shape::Circle)
         {
@@ -142,6 +146,23 @@ namespace Lumos
         return b2Rot_GetAngle(b2Body_GetRotation(m_B2Body));
     }
 
+    void RigidBody2D::StorePreviousTransform()
+    {
+        m_PreviousPosition = GetPosition();
+        m_PreviousAngle    = GetAngle();
+    }
+
+    Vec2 RigidBody2D::GetInterpolatedPosition(float alpha) const
+    {
+        return Maths::Lerp(m_PreviousPosition, GetPosition(), alpha);
+    }
+
+    float RigidBody2D::GetInterpolatedAngle(float alpha) const
+    {
+        // Blend the rotations rather than the angles so the shorter way round is taken
+        return b2Rot_GetAngle(b2NLerp(b2MakeRot(m_PreviousAngle), b2Body_GetRotation(m_B2Body), alpha));
+    }
+
     const Vec2 RigidBody2D::GetLinearVelocity() const
     {
         b2Vec2 vel = b2Body_GetLinearVelocity(m_B2Body);
@@ -53,8 +53,8 @@ namespace Lumos
         void SetLinearVelocity(const Vec2& v) const;
         void SetAngularVelocity(float velocity);
         void SetForce(const Vec2& v) const;
-        void SetPosition(const Vec2& pos) const;
-        void SetOrientation(float angle) const;
+        void SetPosition(const Vec2& pos);
+        void SetOrientation(float angle);
         void SetIsStatic(bool isStatic);
 
         const Vec2 GetLinearVelocity() const;
@@ -63,6 +63,11 @@ namespace Lumos
 
         Vec2 GetPosition() const;
         float GetAngle() const;
+
+        // Transform before the latest physics step, blended towards the current one for rendering
+        void StorePreviousTransform();
+        Vec2 GetInterpolatedPosition(float alpha) const;
+        float GetInterpolatedAngle(float alpha) const;
         Shape GetShapeType() const { return m_ShapeType; }
 
         void SetShape(Shape shape, const std::vector<Vec2>& customPositions = {});
@@ -112,5 +117,8 @@ namespace Lumos
         float m_Friction;
         bool m_AtRest;
         UUID m_UUID;
+
+        Vec2 m_PreviousPosition;
+        float m_PreviousAngle = 0.0f;
     };
 }
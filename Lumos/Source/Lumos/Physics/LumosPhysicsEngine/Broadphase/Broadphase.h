@@ -2,6 +2,8 @@
 
 #include "Physics/LumosPhysicsEngine/RigidBody3D.h"
 #include "Core/DataStructures/TDArray.h"
+#include "Maths/BoundingBox.h"
+#include "Maths/Ray.h"
 
 namespace Lumos
 {
@@ -12,11 +14,25 @@ namespace Lumos
         RigidBody3D* pObjectB;
     };
 
+    struct LUMOS_EXPORT RaycastHit
+    {
+        RigidBody3D* Body = nullptr;
+        float Distance    = 0.0f;
+    };
+
     class LUMOS_EXPORT Broadphase
     {
     public:
-        virtual ~Broadphase()                                                                                                                   = default;
-        virtual void FindPotentialCollisionPairs(RigidBody3D* rootObject, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) = 0;
-        virtual void DebugDraw()                                                                                                                = 0;
+        virtual ~Broadphase()                                                                                                                = default;
+        virtual void FindPotentialCollisionPairs(RigidBody3D** bodies, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) = 0;
+        virtual void DebugDraw()                                                                                                             = 0;
+
+        // Called before a body is destroyed so persistent structures can drop it
+        virtual void RemoveBody(RigidBody3D* /*body*/) { }
+
+        // Scene queries against the world space AABBs of bodies, only used when SupportsQueries returns true
+        virtual bool SupportsQueries() const { return false; }
+        virtual void QueryAABB(const Maths::BoundingBox& /*box*/, TDArray<RigidBody3D*>& /*bodies*/) { }
+        virtual bool Raycast(const Maths::Ray& /*ray*/, float /*maxDistance*/, RaycastHit& /*hit*/) { return false; }
     };
 }
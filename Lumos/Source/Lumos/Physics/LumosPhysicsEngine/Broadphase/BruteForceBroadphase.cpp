@@ -14,70 +14,57 @@ namespace Lumos
     {
     }
 
-    void BruteForceBroadphase::FindPotentialCollisionPairs(RigidBody3D* rootObject,
+    void BruteForceBroadphase::FindPotentialCollisionPairs(RigidBody3D** bodies,
                                                            TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount)
     {
         LUMOS_PROFILE_FUNCTION();
 
-        RigidBody3D* current = rootObject;
-        while(current)
+        // Every pair needs an awake body, so only awake bodies are paired with the others.
+        // Pairs of two static or at rest bodies are never visited
+        ArenaTemp scratch   = ScratchBegin(nullptr, 0);
+        uint32_t* awake     = PushArrayNoZero(scratch.arena, uint32_t, totalRigidBodyCount);
+        uint32_t awakeCount = 0;
+        for(uint32_t i = 0; i < totalRigidBodyCount; i++)
         {
-            if(current->GetCollisionShape())
-            {
-                RigidBody3D* current2 = rootObject;
-                {
-                    while(current2)
-                    {
-                        if(current2->GetCollisionShape())
-                        {
-                            RigidBody3D* obj1 = current;
-                            RigidBody3D* obj2 = current2;
-
-                            // Skip pairs of two at objects at rest
-                            if(obj1->GetIsAtRest() && obj2->GetIsAtRest())
-                                continue;
-
-                            // Skip pairs of two at static objects
-                            if(obj1->GetIsStatic() && obj2->GetIsStatic())
-                                continue;
-
-                            // Skip pairs of one static and one at rest
-                            if(obj1->GetIsAtRest() && obj2->GetIsStatic())
-                                continue;
+            RigidBody3D* body = bodies[i];
+            if(body->GetCollisionShape() && !body->GetIsAtRest() && !body->GetIsStatic())
+                awake[awakeCount++] = i;
+        }
 
-                            if(obj1->GetIsStatic() && obj2->GetIsAtRest())
-                                continue;
+        for(uint32_t a = 0; a < awakeCount; a++)
+        {
+            const uint32_t i  = awake[a];
+            RigidBody3D* obj1 = bodies[i];
 
-                            CollisionPair pair;
+            for(uint32_t j = 0; j < totalRigidBodyCount; j++)
+            {
+                RigidBody3D* obj2 = bodies[j];
+                if(j == i || !obj2->GetCollisionShape())
+                    continue;
 
-                            if(obj1 < obj2)
-                            {
-                                pair.pObjectA = obj1;
-                                pair.pObjectB = obj2;
-                            }
-                            else
-                            {
-                                pair.pObjectA = obj2;
-                                pair.pObjectB = obj1;
-                            }
+                // Pairs of two awake bodies are reached from both, keep the one from the lower index
+                const bool obj2Awake = !obj2->GetIsAtRest() && !obj2->GetIsStatic();
+                if(obj2Awake && j < i)
+                    continue;
 
-                            bool duplicate = false;
-                            for(int i = 0; i < collisionPairs.Size(); i++)
-                            {
-                                auto& pair2 = collisionPairs[i];
+                CollisionPair pair;
 
-                                if(pair.pObjectA == pair2.pObjectA && pair.pObjectB == pair2.pObjectB)
-                                {
-                                    duplicate = true;
-                                }
-                            }
-                            if(!duplicate)
-                                collisionPairs.EmplaceBack(pair);
-                        }
-                    }
+                if(obj1 < obj2)
+                {
+                    pair.pObjectA = obj1;
+                    pair.pObjectB = obj2;
+                }
+                else
+                {
+                    pair.pObjectA = obj2;
+                    pair.pObjectB = obj1;
                 }
+
+                collisionPairs.EmplaceBack(pair);
             }
         }
+
+        ScratchEnd(scratch);
     }
 
     void BruteForceBroadphase::DebugDraw()
@@ -12,7 +12,7 @@ namespace Lumos
         explicit BruteForceBroadphase(const Vec3& axis = Vec3(0.0f));
         virtual ~BruteForceBroadphase();
 
-        void FindPotentialCollisionPairs(RigidBody3D* rootObject, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) override;
+        void FindPotentialCollisionPairs(RigidBody3D** bodies, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) override;
         void DebugDraw() override;
 
     private:
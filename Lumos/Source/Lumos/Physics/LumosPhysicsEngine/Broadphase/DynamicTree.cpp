@@ -0,0 +1,444 @@
+#include "Precompiled.h"
+#include "DynamicTree.h"
+#include "Graphics/Renderers/DebugRenderer.h"
+
+namespace Lumos
+{
+    // Fat AABBs are enlarged by this in every direction
+    static const float TREE_AABB_MARGIN = 0.1f;
+    // Fat AABBs are also extended along the displacement so moving bodies need fewer reinserts
+    static const float TREE_DISPLACEMENT_MULTIPLIER = 4.0f;
+
+    static float SurfaceArea(const Vec3& boxMin, const Vec3& boxMax)
+    {
+        const Vec3 d = boxMax - boxMin;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    static Vec3 Vec3Min(const Vec3& a, const Vec3& b)
+    {
+        return Vec3(Maths::Min(a.x, b.x), Maths::Min(a.y, b.y), Maths::Min(a.z, b.z));
+    }
+
+    static Vec3 Vec3Max(const Vec3& a, const Vec3& b)
+    {
+        return Vec3(Maths::Max(a.x, b.x), Maths::Max(a.y, b.y), Maths::Max(a.z, b.z));
+    }
+
+    static bool Contains(const Vec3& outerMin, const Vec3& outerMax, const Vec3& innerMin, const Vec3& innerMax)
+    {
+        return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y && outerMin.z <= innerMin.z
+            && innerMax.x <= outerMax.x && innerMax.y <= outerMax.y && innerMax.z <= outerMax.z;
+    }
+
+    DynamicTree::DynamicTree()
+    {
+        m_Nodes.Reserve(64);
+    }
+
+    DynamicTree::~DynamicTree()
+    {
+    }
+
+    int32_t DynamicTree::AllocateNode()
+    {
+        if(m_FreeList == NullNode)
+        {
+            // Grow the pool and link the new nodes into the free list
+            const int32_t oldCount = (int32_t)m_Nodes.Size();
+            const int32_t newCount = oldCount == 0 ? 64 : oldCount * 2;
+            m_Nodes.Resize(newCount);
+
+            for(int32_t i = oldCount; i < newCount - 1; i++)
+            {
+                m_Nodes[i].Next   = i + 1;
+                m_Nodes[i].Height = -1;
+            }
+            m_Nodes[newCount - 1].Next   = NullNode;
+            m_Nodes[newCount - 1].Height = -1;
+            m_FreeList                   = oldCount;
+        }
+
+        const int32_t nodeId = m_FreeList;
+        TreeNode& node       = m_Nodes[nodeId];
+        m_FreeList           = node.Next;
+        node.Parent          = NullNode;
+        node.Child1          = NullNode;
+        node.Child2          = NullNode;
+        node.Height          = 0;
+        node.Body            = nullptr;
+        node.Moved           = false;
+        return nodeId;
+    }
+
+    void DynamicTree::FreeNode(int32_t nodeId)
+    {
+        TreeNode& node = m_Nodes[nodeId];
+        node.Next      = m_FreeList;
+        node.Height    = -1;
+        node.Body      = nullptr;
+        m_FreeList     = nodeId;
+    }
+
+    int32_t DynamicTree::CreateProxy(const Maths::BoundingBox& aabb, RigidBody3D* body)
+    {
+        const int32_t proxyId = AllocateNode();
+
+        const Vec3 margin(TREE_AABB_MARGIN);
+        TreeNode& node = m_Nodes[proxyId];
+        node.BoxMin    = aabb.m_Min - margin;
+        node.BoxMax    = aabb.m_Max + margin;
+        node.Body      = body;
+        node.Height    = 0;
+        node.Moved     = true;
+
+        InsertLeaf(proxyId);
+        m_ProxyCount++;
+
+        return proxyId;
+    }
+
+    void DynamicTree::DestroyProxy(int32_t proxyId)
+    {
+        ASSERT(proxyId >= 0 && proxyId < (int32_t)m_Nodes.Size() && m_Nodes[proxyId].IsLeaf());
+
+        RemoveLeaf(proxyId);
+        FreeNode(proxyId);
+        m_ProxyCount--;
+    }
+
+    bool DynamicTree::MoveProxy(int32_t proxyId, const Maths::BoundingBox& aabb, const Vec3& displacement)
+    {
+        ASSERT(proxyId >= 0 && proxyId < (int32_t)m_Nodes.Size() && m_Nodes[proxyId].IsLeaf());
+
+        const Vec3 margin(TREE_AABB_MARGIN);
+        Vec3 fatMin = aabb.m_Min - margin;
+        Vec3 fatMax = aabb.m_Max + margin;
+
+        // Predict the movement so the box does not need reinserting next step
+        const Vec3 d = displacement * TREE_DISPLACEMENT_MULTIPLIER;
+        fatMin       = Vec3Min(fatMin, fatMin + d);
+        fatMax       = Vec3Max(fatMax, fatMax + d);
+
+        const TreeNode& node = m_Nodes[proxyId];
+        if(Contains(node.BoxMin, node.BoxMax, aabb.m_Min, aabb.m_Max))
+        {
+            // The tree box still contains the body. Only reinsert if it has become far too large,
+            // for example after a fast body came to a stop
+            const Vec3 hugeMargin(4.0f * TREE_AABB_MARGIN);
+            if(Contains(fatMin - hugeMargin, fatMax + hugeMargin, node.BoxMin, node.BoxMax))
+                return false;
+        }
+
+        RemoveLeaf(proxyId);
+
+        TreeNode& movedNode = m_Nodes[proxyId];
+        movedNode.BoxMin    = fatMin;
+        movedNode.BoxMax    = fatMax;
+        movedNode.Moved     = true;
+
+        InsertLeaf(proxyId);
+        return true;
+    }
+
+    bool DynamicTree::TestFatAABBOverlap(int32_t proxyA, int32_t proxyB) const
+    {
+        const TreeNode& a = m_Nodes[proxyA];
+        const TreeNode& b = m_Nodes[proxyB];
+        return !(b.BoxMax.x < a.BoxMin.x || b.BoxMin.x > a.BoxMax.x
+                 || b.BoxMax.y < a.BoxMin.y || b.BoxMin.y > a.BoxMax.y
+                 || b.BoxMax.z < a.BoxMin.z || b.BoxMin.z > a.BoxMax.z);
+    }
+
+    void DynamicTree::InsertLeaf(int32_t leaf)
+    {
+        if(m_Root == NullNode)
+        {
+            m_Root                 = leaf;
+            m_Nodes[leaf].Parent = NullNode;
+            return;
+        }
+
+        // Find the best sibling using the surface area heuristic
+        const Vec3 leafMin = m_Nodes[leaf].BoxMin;
+        const Vec3 leafMax = m_Nodes[leaf].BoxMax;
+        int32_t index      = m_Root;
+        while(!m_Nodes[index].IsLeaf())
+        {
+            const TreeNode& node = m_Nodes[index];
+            const int32_t child1 = node.Child1;
+            const int32_t child2 = node.Child2;
+
+            const float area         = SurfaceArea(node.BoxMin, node.BoxMax);
+            const float combinedArea = SurfaceArea(Vec3Min(node.BoxMin, leafMin), Vec3Max(node.BoxMax, leafMax));
+
+            // Cost of creating a new parent for this node and the new leaf
+            const float cost = 2.0f * combinedArea;
+
+            // Minimum cost of pushing the leaf further down the tree
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            const TreeNode& node1 = m_Nodes[child1];
+            float cost1           = SurfaceArea(Vec3Min(node1.BoxMin, leafMin), Vec3Max(node1.BoxMax, leafMax)) + inheritanceCost;
+            if(!node1.IsLeaf())
+                cost1 -= SurfaceArea(node1.BoxMin, node1.BoxMax);
+
+            const TreeNode& node2 = m_Nodes[child2];
+            float cost2           = SurfaceArea(Vec3Min(node2.BoxMin, leafMin), Vec3Max(node2.BoxMax, leafMax)) + inheritanceCost;
+            if(!node2.IsLeaf())
+                cost2 -= SurfaceArea(node2.BoxMin, node2.BoxMax);
+
+            if(cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? child1 : child2;
+        }
+
+        const int32_t sibling   = index;
+        const int32_t newParent = AllocateNode();
+        const int32_t oldParent = m_Nodes[sibling].Parent;
+
+        TreeNode& parentNode = m_Nodes[newParent];
+        parentNode.Parent    = oldParent;
+        parentNode.BoxMin    = Vec3Min(m_Nodes[sibling].BoxMin, leafMin);
+        parentNode.BoxMax    = Vec3Max(m_Nodes[sibling].BoxMax, leafMax);
+        parentNode.Height    = m_Nodes[sibling].Height + 1;
+        parentNode.Child1    = sibling;
+        parentNode.Child2    = leaf;
+
+        if(oldParent != NullNode)
+        {
+            if(m_Nodes[oldParent].Child1 == sibling)
+                m_Nodes[oldParent].Child1 = newParent;
+            else
+                m_Nodes[oldParent].Child2 = newParent;
+        }
+        else
+        {
+            m_Root = newParent;
+        }
+
+        m_Nodes[sibling].Parent = newParent;
+        m_Nodes[leaf].Parent    = newParent;
+
+        RefitFrom(m_Nodes[leaf].Parent);
+    }
+
+    void DynamicTree::RemoveLeaf(int32_t leaf)
+    {
+        if(leaf == m_Root)
+        {
+            m_Root = NullNode;
+            return;
+        }
+
+        const int32_t parent      = m_Nodes[leaf].Parent;
+        const int32_t grandParent = m_Nodes[parent].Parent;
+        const int32_t sibling     = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+        if(grandParent != NullNode)
+        {
+            // Destroy the parent and connect the sibling to the grand parent
+            if(m_Nodes[grandParent].Child1 == parent)
+                m_Nodes[grandParent].Child1 = sibling;
+            else
+                m_Nodes[grandParent].Child2 = sibling;
+
+            m_Nodes[sibling].Parent = grandParent;
+            FreeNode(parent);
+
+            RefitFrom(grandParent);
+        }
+        else
+        {
+            m_Root                  = sibling;
+            m_Nodes[sibling].Parent = NullNode;
+            FreeNode(parent);
+        }
+    }
+
+    void DynamicTree::RefitFrom(int32_t index)
+    {
+        // Walk back up the tree fixing heights and boxes
+        while(index != NullNode)
+        {
+            index = Balance(index);
+
+            TreeNode& node        = m_Nodes[index];
+            const TreeNode& node1 = m_Nodes[node.Child1];
+            const TreeNode& node2 = m_Nodes[node.Child2];
+
+            node.Height = 1 + Maths::Max(node1.Height, node2.Height);
+            node.BoxMin = Vec3Min(node1.BoxMin, node2.BoxMin);
+            node.BoxMax = Vec3Max(node1.BoxMax, node2.BoxMax);
+
+            index = node.Parent;
+        }
+    }
+
+    // Perform a left or right rotation if node A is imbalanced. Returns the new root index of the subtree
+    int32_t DynamicTree::Balance(int32_t iA)
+    {
+        TreeNode* A = &m_Nodes[iA];
+        if(A->IsLeaf() || A->Height < 2)
+            return iA;
+
+        const int32_t iB = A->Child1;
+        const int32_t iC = A->Child2;
+        TreeNode* B      = &m_Nodes[iB];
+        TreeNode* C      = &m_Nodes[iC];
+
+        const int32_t balance = C->Height - B->Height;
+
+        // Rotate C up
+        if(balance > 1)
+        {
+            const int32_t iF = C->Child1;
+            const int32_t iG = C->Child2;
+            TreeNode* F      = &m_Nodes[iF];
+            TreeNode* G      = &m_Nodes[iG];
+
+            // Swap A and C
+            C->Child1 = iA;
+            C->Parent = A->Parent;
+            A->Parent = iC;
+
+            // A's old parent should point to C
+            if(C->Parent != NullNode)
+            {
+                if(m_Nodes[C->Parent].Child1 == iA)
+                    m_Nodes[C->Parent].Child1 = iC;
+                else
+                    m_Nodes[C->Parent].Child2 = iC;
+            }
+            else
+            {
+                m_Root = iC;
+            }
+
+            if(F->Height > G->Height)
+            {
+                C->Child2 = iF;
+                A->Child2 = iG;
+                G->Parent = iA;
+                A->BoxMin = Vec3Min(B->BoxMin, G->BoxMin);
+                A->BoxMax = Vec3Max(B->BoxMax, G->BoxMax);
+                C->BoxMin = Vec3Min(A->BoxMin, F->BoxMin);
+                C->BoxMax = Vec3Max(A->BoxMax, F->BoxMax);
+                A->Height = 1 + Maths::Max(B->Height, G->Height);
+                C->Height = 1 + Maths::Max(A->Height, F->Height);
+            }
+            else
+            {
+                C->Child2 = iG;
+                A->Child2 = iF;
+                F->Parent = iA;
+                A->BoxMin = Vec3Min(B->BoxMin, F->BoxMin);
+                A->BoxMax = Vec3Max(B->BoxMax, F->BoxMax);
+                C->BoxMin = Vec3Min(A->BoxMin, G->BoxMin);
+                C->BoxMax = Vec3Max(A->BoxMax, G->BoxMax);
+                A->Height = 1 + Maths::Max(B->Height, F->Height);
+                C->Height = 1 + Maths::Max(A->Height, G->Height);
+            }
+
+            return iC;
+        }
+
+        // Rotate B up
+        if(balance < -1)
+        {
+            const int32_t iD = B->Child1;
+            const int32_t iE = B->Child2;
+            TreeNode* D      = &m_Nodes[iD];
+            TreeNode* E      = &m_Nodes[iE];
+
+            // Swap A and B
+            B->Child1 = iA;
+            B->Parent = A->Parent;
+            A->Parent = iB;
+
+            // A's old parent should point to B
+            if(B->Parent != NullNode)
+            {
+                if(m_Nodes[B->Parent].Child1 == iA)
+                    m_Nodes[B->Parent].Child1 = iB;
+                else
+                    m_Nodes[B->Parent].Child2 = iB;
+            }
+            else
+            {
+                m_Root = iB;
+            }
+
+            if(D->Height > E->Height)
+            {
+                B->Child2 = iD;
+                A->Child1 = iE;
+                E->Parent = iA;
+                A->BoxMin = Vec3Min(C->BoxMin, E->BoxMin);
+                A->BoxMax = Vec3Max(C->BoxMax, E->BoxMax);
+                B->BoxMin = Vec3Min(A->BoxMin, D->BoxMin);
+                B->BoxMax = Vec3Max(A->BoxMax, D->BoxMax);
+                A->Height = 1 + Maths::Max(C->Height, E->Height);
+                B->Height = 1 + Maths::Max(A->Height, D->Height);
+            }
+            else
+            {
+                B->Child2 = iE;
+                A->Child1 = iD;
+                D->Parent = iA;
+                A->BoxMin = Vec3Min(C->BoxMin, D->BoxMin);
+                A->BoxMax = Vec3Max(C->BoxMax, D->BoxMax);
+                B->BoxMin = Vec3Min(A->BoxMin, E->BoxMin);
+                B->BoxMax = Vec3Max(A->BoxMax, E->BoxMax);
+                A->Height = 1 + Maths::Max(C->Height, D->Height);
+                B->Height = 1 + Maths::Max(A->Height, E->Height);
+            }
+
+            return iB;
+        }
+
+        return iA;
+    }
+
+    float DynamicTree::RayBoxDistance(const Vec3& origin, const Vec3& invDirection, const Vec3& boxMin, const Vec3& boxMax, float maxDistance)
+    {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            if(Maths::Abs(invDirection[axis]) == Maths::M_INFINITY)
+            {
+                // Parallel to this slab
+                if(origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+                    return -1.0f;
+                continue;
+            }
+
+            float t1 = (boxMin[axis] - origin[axis]) * invDirection[axis];
+            float t2 = (boxMax[axis] - origin[axis]) * invDirection[axis];
+            if(t1 > t2)
+                Swap(t1, t2);
+
+            tMin = Maths::Max(tMin, t1);
+            tMax = Maths::Min(tMax, t2);
+            if(tMin > tMax)
+                return -1.0f;
+        }
+
+        return tMin;
+    }
+
+    void DynamicTree::DebugDraw() const
+    {
+        for(const TreeNode& node : m_Nodes)
+        {
+            if(node.Height < 0)
+                continue;
+
+            const Vec4 colour = node.IsLeaf() ? Vec4(0.2f, 0.8f, 0.4f, 1.0f) : Vec4(0.8f, 0.2f, 0.4f, 1.0f);
+            DebugRenderer::DebugDraw(Maths::BoundingBox(node.BoxMin, node.BoxMax), colour, false, true, 0.02f);
+        }
+    }
+}
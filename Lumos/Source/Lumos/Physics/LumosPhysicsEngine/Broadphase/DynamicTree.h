@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Maths/Vector3.h"
+#include "Maths/BoundingBox.h"
+#include "Maths/Ray.h"
+#include "Maths/MathsUtilities.h"
+#include "Core/DataStructures/TDArray.h"
+
+namespace Lumos
+{
+    class RigidBody3D;
+
+    // Bounding volume hierarchy of enlarged ("fat") AABBs. Leaves are only reinserted when a body
+    // leaves its fat box, and tree rotations keep it balanced as leaves are inserted and removed.
+    // Based on the dynamic tree in Box2D.
+    class LUMOS_EXPORT DynamicTree
+    {
+    public:
+        static const int32_t NullNode = -1;
+
+        DynamicTree();
+        ~DynamicTree();
+
+        // Create a leaf for a tight AABB. The stored box is enlarged by the tree margin
+        int32_t CreateProxy(const Maths::BoundingBox& aabb, RigidBody3D* body);
+        void DestroyProxy(int32_t proxyId);
+
+        // Returns true if the proxy had to be reinserted. The displacement is used to extend
+        // the fat box in the direction of travel
+        bool MoveProxy(int32_t proxyId, const Maths::BoundingBox& aabb, const Vec3& displacement);
+
+        RigidBody3D* GetBody(int32_t proxyId) const { return m_Nodes[proxyId].Body; }
+        Maths::BoundingBox GetFatAABB(int32_t proxyId) const { return Maths::BoundingBox(m_Nodes[proxyId].BoxMin, m_Nodes[proxyId].BoxMax); }
+        bool WasMoved(int32_t proxyId) const { return m_Nodes[proxyId].Moved; }
+        void ClearMoved(int32_t proxyId) { m_Nodes[proxyId].Moved = false; }
+
+        bool TestFatAABBOverlap(int32_t proxyA, int32_t proxyB) const;
+
+        int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+        uint32_t GetProxyCount() const { return m_ProxyCount; }
+
+        // Calls callback(proxyId) for every leaf whose fat box overlaps aabb. Return false from the callback to stop
+        template <typename Callback>
+        void Query(const Vec3& boxMin, const Vec3& boxMax, Callback&& callback) const;
+
+        // Calls callback(proxyId, maxDistance) for every leaf whose fat box the ray enters within maxDistance.
+        // The callback returns the new max distance, so returning the hit distance clips the ray
+        // and returning 0 stops the query. The ray direction must be normalised
+        template <typename Callback>
+        void Raycast(const Maths::Ray& ray, float maxDistance, Callback&& callback) const;
+
+        void DebugDraw() const;
+
+        // Slab test, returns the distance the ray enters the box or a negative value on a miss
+        static float RayBoxDistance(const Vec3& origin, const Vec3& invDirection, const Vec3& boxMin, const Vec3& boxMax, float maxDistance);
+
+    private:
+        struct TreeNode
+        {
+            Vec3 BoxMin;
+            Vec3 BoxMax;
+            RigidBody3D* Body = nullptr;
+
+            union
+            {
+                int32_t Parent;
+                int32_t Next; // Free list
+            };
+
+            int32_t Child1 = NullNode;
+            int32_t Child2 = NullNode;
+            int32_t Height = -1; // Leaf = 0, free node = -1
+            bool Moved     = false;
+
+            bool IsLeaf() const { return Child1 == NullNode; }
+        };
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t nodeId);
+
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t index);
+        void RefitFrom(int32_t index);
+
+        TDArray<TreeNode> m_Nodes;
+        int32_t m_Root        = NullNode;
+        int32_t m_FreeList    = NullNode;
+        uint32_t m_ProxyCount = 0;
+    };
+
+    template <typename Callback>
+    void DynamicTree::Query(const Vec3& boxMin, const Vec3& boxMax, Callback&& callback) const
+    {
+        static const int32_t MaxStackSize = 256;
+        int32_t stack[MaxStackSize];
+        int32_t stackCount = 0;
+
+        if(m_Root != NullNode)
+            stack[stackCount++] = m_Root;
+
+        while(stackCount > 0)
+        {
+            const int32_t nodeId = stack[--stackCount];
+            const TreeNode& node = m_Nodes[nodeId];
+
+            if(node.BoxMax.x < boxMin.x || node.BoxMin.x > boxMax.x
+               || node.BoxMax.y < boxMin.y || node.BoxMin.y > boxMax.y
+               || node.BoxMax.z < boxMin.z || node.BoxMin.z > boxMax.z)
+                continue;
+
+            if(node.IsLeaf())
+            {
+                if(!callback(nodeId))
+                    return;
+            }
+            else
+            {
+                ASSERT(stackCount + 2 <= MaxStackSize, "DynamicTree query stack overflow");
+                stack[stackCount++] = node.Child1;
+                stack[stackCount++] = node.Child2;
+            }
+        }
+    }
+
+    template <typename Callback>
+    void DynamicTree::Raycast(const Maths::Ray& ray, float maxDistance, Callback&& callback) const
+    {
+        static const int32_t MaxStackSize = 256;
+        int32_t stack[MaxStackSize];
+        int32_t stackCount = 0;
+
+        const Vec3 invDirection(ray.Direction.x != 0.0f ? 1.0f / ray.Direction.x : Maths::M_INFINITY,
+                                ray.Direction.y != 0.0f ? 1.0f / ray.Direction.y : Maths::M_INFINITY,
+                                ray.Direction.z != 0.0f ? 1.0f / ray.Direction.z : Maths::M_INFINITY);
+
+        if(m_Root != NullNode)
+            stack[stackCount++] = m_Root;
+
+        while(stackCount > 0)
+        {
+            const int32_t nodeId = stack[--stackCount];
+            const TreeNode& node = m_Nodes[nodeId];
+
+            if(RayBoxDistance(ray.Origin, invDirection, node.BoxMin, node.BoxMax, maxDistance) < 0.0f)
+                continue;
+
+            if(node.IsLeaf())
+            {
+                maxDistance = callback(nodeId, maxDistance);
+                if(maxDistance <= 0.0f)
+                    return;
+            }
+            else
+            {
+                ASSERT(stackCount + 2 <= MaxStackSize, "DynamicTree raycast stack overflow");
+                stack[stackCount++] = node.Child1;
+                stack[stackCount++] = node.Child2;
+            }
+        }
+    }
+}
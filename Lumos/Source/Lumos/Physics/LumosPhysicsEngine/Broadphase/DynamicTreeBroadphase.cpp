@@ -0,0 +1,240 @@
+#include "Precompiled.h"
+#include "DynamicTreeBroadphase.h"
+#include "Physics/LumosPhysicsEngine/LumosPhysicsEngine.h"
+
+namespace Lumos
+{
+    static bool BoxesOverlap(const Maths::BoundingBox& a, const Maths::BoundingBox& b)
+    {
+        return !(b.m_Max.x < a.m_Min.x || b.m_Min.x > a.m_Max.x
+                 || b.m_Max.y < a.m_Min.y || b.m_Min.y > a.m_Max.y
+                 || b.m_Max.z < a.m_Min.z || b.m_Min.z > a.m_Max.z);
+    }
+
+    DynamicTreeBroadphase::DynamicTreeBroadphase()
+        : Broadphase()
+    {
+    }
+
+    DynamicTreeBroadphase::~DynamicTreeBroadphase()
+    {
+        HashMapDeinit(&m_Proxies);
+        HashSetDeinit(&m_PairSet);
+    }
+
+    uint64_t DynamicTreeBroadphase::PairKey(int32_t proxyA, int32_t proxyB)
+    {
+        const uint64_t low  = (uint64_t)(uint32_t)Maths::Min(proxyA, proxyB);
+        const uint64_t high = (uint64_t)(uint32_t)Maths::Max(proxyA, proxyB);
+        return (high << 32) | low;
+    }
+
+    void DynamicTreeBroadphase::FindPotentialCollisionPairs(RigidBody3D** bodies,
+                                                            TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        UpdateProxies(bodies, totalRigidBodyCount);
+        ValidatePairs();
+        FindNewPairs();
+
+        {
+            LUMOS_PROFILE_SCOPE("Emit Pairs");
+            for(const TreePair& treePair : m_Pairs)
+            {
+                RigidBody3D* body1 = treePair.BodyA;
+                RigidBody3D* body2 = treePair.BodyB;
+
+                // Skip pairs of two at objects at rest
+                if(body1->GetIsAtRest() && body2->GetIsAtRest())
+                    continue;
+
+                // Skip pairs of two at static objects
+                if(body1->GetIsStatic() && body2->GetIsStatic())
+                    continue;
+
+                // Skip pairs of one static and one at rest
+                if((body1->GetIsAtRest() && body2->GetIsStatic()) || (body1->GetIsStatic() && body2->GetIsAtRest()))
+                    continue;
+
+                // The cached pair only means the fat boxes overlap
+                if(!BoxesOverlap(body1->GetWorldSpaceAABB(), body2->GetWorldSpaceAABB()))
+                    continue;
+
+                CollisionPair pair;
+                if(body1 < body2)
+                {
+                    pair.pObjectA = body1;
+                    pair.pObjectB = body2;
+                }
+                else
+                {
+                    pair.pObjectA = body2;
+                    pair.pObjectB = body1;
+                }
+
+                collisionPairs.EmplaceBack(pair);
+            }
+        }
+    }
+
+    void DynamicTreeBroadphase::UpdateProxies(RigidBody3D** bodies, uint32_t bodyCount)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        m_Step++;
+        const float deltaTime = LumosPhysicsEngine::GetDeltaTime();
+
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            RigidBody3D* current = bodies[i];
+            if(current->GetCollisionShape())
+            {
+                const Maths::BoundingBox& aabb = current->GetWorldSpaceAABB();
+
+                ProxyInfo* info = (ProxyInfo*)HashMapFindPtr(&m_Proxies, current);
+                if(!info)
+                {
+                    ProxyInfo newInfo;
+                    newInfo.ProxyId      = m_Tree.CreateProxy(aabb, current);
+                    newInfo.LastSeenStep = m_Step;
+                    HashMapInsert(&m_Proxies, current, newInfo);
+                    m_MoveBuffer.PushBack(newInfo.ProxyId);
+                }
+                else
+                {
+                    info->LastSeenStep = m_Step;
+
+                    const Vec3 displacement = current->GetIsStatic() ? Vec3(0.0f) : current->GetLinearVelocity() * deltaTime;
+                    if(m_Tree.MoveProxy(info->ProxyId, aabb, displacement))
+                        m_MoveBuffer.PushBack(info->ProxyId);
+                }
+            }
+        }
+
+        // Bodies that lost their collision shape, or were destroyed without RemoveBody, were not seen this step
+        m_StaleBodies.Clear();
+        ForHashMapEach(RigidBody3D*, ProxyInfo, &m_Proxies, it)
+        {
+            if(it.value->LastSeenStep != m_Step)
+                m_StaleBodies.PushBack(*it.key);
+        }
+
+        for(RigidBody3D* body : m_StaleBodies)
+            RemoveBody(body);
+    }
+
+    void DynamicTreeBroadphase::ValidatePairs()
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        // Drop pairs whose proxies were destroyed or whose fat boxes separated. Stored bodies are only
+        // compared, never dereferenced, as they may have been destroyed.
+        uint32_t writeIndex = 0;
+        for(uint32_t i = 0; i < (uint32_t)m_Pairs.Size(); i++)
+        {
+            const TreePair& pair = m_Pairs[i];
+            if(m_Tree.GetBody(pair.ProxyA) != pair.BodyA || m_Tree.GetBody(pair.ProxyB) != pair.BodyB
+               || !m_Tree.TestFatAABBOverlap(pair.ProxyA, pair.ProxyB))
+            {
+                uint64_t key = PairKey(pair.ProxyA, pair.ProxyB);
+                HashSetRemove(&m_PairSet, key);
+                continue;
+            }
+
+            if(writeIndex != i)
+                m_Pairs[writeIndex] = pair;
+            writeIndex++;
+        }
+        m_Pairs.Resize(writeIndex);
+    }
+
+    void DynamicTreeBroadphase::FindNewPairs()
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        // Only moved proxies can have started overlapping something
+        for(int32_t queryProxy : m_MoveBuffer)
+        {
+            const Maths::BoundingBox fatAABB = m_Tree.GetFatAABB(queryProxy);
+            m_Tree.Query(fatAABB.m_Min, fatAABB.m_Max, [&](int32_t proxyId) -> bool
+                         {
+                             if(proxyId == queryProxy)
+                                 return true;
+
+                             // Both moved, the pair is found when the other proxy is queried
+                             if(m_Tree.WasMoved(proxyId) && proxyId > queryProxy)
+                                 return true;
+
+                             uint64_t key = PairKey(queryProxy, proxyId);
+                             if(HashSetContains(&m_PairSet, key))
+                                 return true;
+
+                             HashSetAdd(&m_PairSet, key);
+
+                             TreePair& pair = m_Pairs.EmplaceBack();
+                             pair.ProxyA    = queryProxy;
+                             pair.ProxyB    = proxyId;
+                             pair.BodyA     = m_Tree.GetBody(queryProxy);
+                             pair.BodyB     = m_Tree.GetBody(proxyId);
+                             return true; });
+        }
+
+        for(int32_t proxyId : m_MoveBuffer)
+            m_Tree.ClearMoved(proxyId);
+        m_MoveBuffer.Clear();
+    }
+
+    void DynamicTreeBroadphase::RemoveBody(RigidBody3D* body)
+    {
+        ProxyInfo* info = (ProxyInfo*)HashMapFindPtr(&m_Proxies, body);
+        if(!info)
+            return;
+
+        // Cached pairs referencing the proxy are dropped by ValidatePairs next step
+        m_Tree.DestroyProxy(info->ProxyId);
+        HashMapRemove(&m_Proxies, body);
+    }
+
+    void DynamicTreeBroadphase::QueryAABB(const Maths::BoundingBox& box, TDArray<RigidBody3D*>& bodies)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Tree.Query(box.m_Min, box.m_Max, [&](int32_t proxyId) -> bool
+                     {
+                         RigidBody3D* body = m_Tree.GetBody(proxyId);
+                         if(BoxesOverlap(box, body->GetWorldSpaceAABB()))
+                             bodies.PushBack(body);
+                         return true; });
+    }
+
+    bool DynamicTreeBroadphase::Raycast(const Maths::Ray& ray, float maxDistance, RaycastHit& hit)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        const Vec3 invDirection(ray.Direction.x != 0.0f ? 1.0f / ray.Direction.x : Maths::M_INFINITY,
+                                ray.Direction.y != 0.0f ? 1.0f / ray.Direction.y : Maths::M_INFINITY,
+                                ray.Direction.z != 0.0f ? 1.0f / ray.Direction.z : Maths::M_INFINITY);
+
+        hit.Body = nullptr;
+        m_Tree.Raycast(ray, maxDistance, [&](int32_t proxyId, float currentMax) -> float
+                       {
+                           RigidBody3D* body              = m_Tree.GetBody(proxyId);
+                           const Maths::BoundingBox& aabb = body->GetWorldSpaceAABB();
+
+                           const float distance = DynamicTree::RayBoxDistance(ray.Origin, invDirection, aabb.m_Min, aabb.m_Max, currentMax);
+                           if(distance < 0.0f)
+                               return currentMax;
+
+                           // Clip the ray so only closer leaves are visited
+                           hit.Body     = body;
+                           hit.Distance = distance;
+                           return distance; });
+
+        return hit.Body != nullptr;
+    }
+
+    void DynamicTreeBroadphase::DebugDraw()
+    {
+        m_Tree.DebugDraw();
+    }
+}
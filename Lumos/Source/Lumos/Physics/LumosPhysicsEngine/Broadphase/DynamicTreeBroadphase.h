@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Broadphase.h"
+#include "DynamicTree.h"
+#include "Core/DataStructures/Map.h"
+#include "Core/DataStructures/Set.h"
+
+namespace Lumos
+{
+    // Broadphase backed by a DynamicTree. Proxies persist between steps and only bodies that left their
+    // fat AABB are re-queried, so the overlapping pair list is kept up to date incrementally.
+    // Also answers AABB and ray queries against the last step's proxies.
+    class LUMOS_EXPORT DynamicTreeBroadphase : public Broadphase
+    {
+    public:
+        DynamicTreeBroadphase();
+        virtual ~DynamicTreeBroadphase();
+
+        void FindPotentialCollisionPairs(RigidBody3D** bodies, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) override;
+        void DebugDraw() override;
+
+        void RemoveBody(RigidBody3D* body) override;
+
+        bool SupportsQueries() const override { return true; }
+        void QueryAABB(const Maths::BoundingBox& box, TDArray<RigidBody3D*>& bodies) override;
+        bool Raycast(const Maths::Ray& ray, float maxDistance, RaycastHit& hit) override;
+
+        const DynamicTree& GetTree() const { return m_Tree; }
+
+    private:
+        struct ProxyInfo
+        {
+            int32_t ProxyId;
+            uint32_t LastSeenStep;
+        };
+
+        // Overlapping fat AABBs. Bodies are stored so a pair whose proxy was destroyed and reused is detected
+        struct TreePair
+        {
+            int32_t ProxyA;
+            int32_t ProxyB;
+            RigidBody3D* BodyA;
+            RigidBody3D* BodyB;
+        };
+
+        void UpdateProxies(RigidBody3D** bodies, uint32_t bodyCount);
+        void ValidatePairs();
+        void FindNewPairs();
+
+        static uint64_t PairKey(int32_t proxyA, int32_t proxyB);
+
+        DynamicTree m_Tree;
+        TDArray<int32_t> m_MoveBuffer;
+        TDArray<TreePair> m_Pairs;
+        TDArray<RigidBody3D*> m_StaleBodies;
+
+        HashMap(RigidBody3D*, ProxyInfo) m_Proxies = {};
+        HashSet(uint64_t) m_PairSet                = {};
+
+        uint32_t m_Step = 0;
+    };
+}
@@ -23,7 +23,7 @@ namespace Lumos
         ArenaRelease(m_Arena);
     }
 
-    void OctreeBroadphase::FindPotentialCollisionPairs(RigidBody3D* rootObject,
+    void OctreeBroadphase::FindPotentialCollisionPairs(RigidBody3D** bodies,
                                                        TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount)
     {
         LUMOS_PROFILE_FUNCTION();
@@ -35,11 +35,12 @@ namespace Lumos
         m_RootNode.boundingBox        = Maths::BoundingBox();
         m_RootNode.PhysicsObjects     = PushArrayNoZero(m_Arena, RigidBody3D*, totalRigidBodyCount);
 #define LEAF_COUNT 1024
-        m_Leaves = PushArrayNoZero(m_Arena, OctreeNode*, LEAF_COUNT);
+        m_Leaves       = PushArrayNoZero(m_Arena, OctreeNode*, LEAF_COUNT);
+        m_LeafCapacity = LEAF_COUNT;
 
-        RigidBody3D* current = rootObject;
-        while(current)
+        for(uint32_t i = 0; i < totalRigidBodyCount; i++)
         {
+            RigidBody3D* current = bodies[i];
             if(current->GetCollisionShape())
             {
                 LUMOS_PROFILE_SCOPE_LOW("Merge Bounding box and add Physics Object");
@@ -47,8 +48,6 @@ namespace Lumos
                 m_RootNode.PhysicsObjects[m_RootNode.PhysicsObjectCount] = current;
                 m_RootNode.PhysicsObjectCount++;
             }
-
-            current = current->m_Next;
         }
 
         m_RootNode.boundingBox.ExtendToCube();
@@ -67,6 +66,14 @@ namespace Lumos
             if(objectCount == 0)
                 continue;
 
+            // Leaves holding only static or at rest objects have no pairs to test
+            bool hasAwakeObject = false;
+            for(size_t i = 0; i < objectCount && !hasAwakeObject; ++i)
+                hasAwakeObject = node.PhysicsObjects[i] && !node.PhysicsObjects[i]->GetIsAtRest() && !node.PhysicsObjects[i]->GetIsStatic();
+
+            if(!hasAwakeObject)
+                continue;
+
             for(size_t i = 0; i < objectCount - 1; ++i)
             {
                 if(!node.PhysicsObjects[i])
@@ -81,8 +88,8 @@ namespace Lumos
 
                     RigidBody3D& obj2 = *node.PhysicsObjects[j];
 
-                    // Skip pairs of two at objects at rest
-                    if(obj1.GetIsAtRest() && obj2.GetIsAtRest())
+                    // Skip pairs of objects that are both static or at rest
+                    if((obj1.GetIsAtRest() || obj1.GetIsStatic()) && (obj2.GetIsAtRest() || obj2.GetIsStatic()))
                         continue;
 
                     if(!obj1.GetWorldSpaceAABB().IsInsideFast(obj2.GetWorldSpaceAABB()))
@@ -143,6 +150,15 @@ namespace Lumos
             // Ignore any subdivisions that contain no objects
             if(division.PhysicsObjectCount > 1)
             {
+                // Large scenes can have more leaves than the initial guess, grow the list in the arena
+                if(m_LeafCount == m_LeafCapacity)
+                {
+                    OctreeNode** leaves = PushArrayNoZero(m_Arena, OctreeNode*, m_LeafCapacity * 2);
+                    MemoryCopy(leaves, m_Leaves, sizeof(OctreeNode*) * m_LeafCount);
+                    m_Leaves = leaves;
+                    m_LeafCapacity *= 2;
+                }
+
                 m_Leaves[m_LeafCount] = &division;
                 m_LeafCount++;
             }
@@ -40,7 +40,7 @@ namespace Lumos
             Maths::BoundingBox boundingBox;
         };
 
-        void FindPotentialCollisionPairs(RigidBody3D* rootObject, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) override;
+        void FindPotentialCollisionPairs(RigidBody3D** bodies, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) override;
         void DebugDraw() override;
         void Divide(OctreeNode& node, size_t iteration);
         void DebugDrawOctreeNode(const OctreeNode& node);
@@ -50,7 +50,8 @@ namespace Lumos
         u32 m_MaxPartitionDepth;
         u32 m_MinPartitionSize;
 
-        uint32_t m_LeafCount = 0;
+        uint32_t m_LeafCount    = 0;
+        uint32_t m_LeafCapacity = 0;
         OctreeNode m_RootNode;
         OctreeNode** m_Leaves;
         Arena* m_Arena;
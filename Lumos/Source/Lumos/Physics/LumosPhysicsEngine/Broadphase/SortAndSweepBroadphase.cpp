@@ -0,0 +1,318 @@
+#include "Precompiled.h"
+#include "SortAndSweepBroadphase.h"
+#include "Core/Algorithms/Sort.h"
+#include <algorithm>
+
+#ifdef LUMOS_SSE
+#include <smmintrin.h>
+#endif
+
+namespace Lumos
+{
+    // Only switch axis when the new one is clearly better, a switch needs a full re-sort
+    static const float AXIS_SWITCH_THRESHOLD = 1.25f;
+
+    SortAndSweepBroadphase::SortAndSweepBroadphase()
+        : Broadphase()
+    {
+    }
+
+    SortAndSweepBroadphase::~SortAndSweepBroadphase()
+    {
+        HashMapDeinit(&m_LiveBodies);
+    }
+
+    void SortAndSweepBroadphase::FindPotentialCollisionPairs(RigidBody3D** bodies,
+                                                             TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        UpdateEntries(bodies, totalRigidBodyCount);
+        SortEntries();
+
+        {
+            LUMOS_PROFILE_SCOPE("Sweep");
+            BuildSweepBoxes();
+
+            const SweepBoxes& active   = m_ActiveBoxes;
+            const SweepBoxes& inactive = m_InactiveBoxes;
+
+            // Awake against awake
+            for(uint32_t i = 0; i < active.Count; i++)
+                SweepCandidates(active, i, active, i + 1, collisionPairs);
+
+            // Awake against static or at rest. Both lists are sorted by Min, so walk them together and sweep each box
+            // against the other list's boxes that start after it. Pairs of two inactive bodies are never visited
+            uint32_t a = 0;
+            uint32_t b = 0;
+            while(a < active.Count && b < inactive.Count)
+            {
+                if(active.Min[a] <= inactive.Min[b])
+                {
+                    SweepCandidates(active, a, inactive, b, collisionPairs);
+                    a++;
+                }
+                else
+                {
+                    // Most inactive boxes end before the next awake one starts
+                    if(inactive.Max[b] >= active.Min[a])
+                        SweepCandidates(inactive, b, active, a, collisionPairs);
+                    b++;
+                }
+            }
+        }
+    }
+
+    void SortAndSweepBroadphase::SweepCandidates(const SweepBoxes& boxes, uint32_t index, const SweepBoxes& candidates, uint32_t first, TDArray<CollisionPair>& collisionPairs)
+    {
+        // Candidates are sorted by Min, so they end where intervals start after this one ends
+        const uint32_t end = (uint32_t)(std::upper_bound(candidates.Min.Data() + first, candidates.Min.Data() + candidates.Count, boxes.Max[index]) - candidates.Min.Data());
+        RigidBody3D* body  = m_Entries[boxes.Entry[index]].Body;
+
+#ifdef LUMOS_SSE
+        const __m128 minB = _mm_set1_ps(boxes.MinB[index]);
+        const __m128 maxB = _mm_set1_ps(boxes.MaxB[index]);
+        const __m128 minC = _mm_set1_ps(boxes.MinC[index]);
+        const __m128 maxC = _mm_set1_ps(boxes.MaxC[index]);
+
+        // Four candidates at a time, the padding boxes past the last one overlap nothing
+        for(uint32_t j = first; j < end; j += 4)
+        {
+            const __m128 overlapB = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(candidates.MaxB.Data() + j), minB), _mm_cmple_ps(_mm_loadu_ps(candidates.MinB.Data() + j), maxB));
+            const __m128 overlapC = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(candidates.MaxC.Data() + j), minC), _mm_cmple_ps(_mm_loadu_ps(candidates.MinC.Data() + j), maxC));
+            const int hits        = _mm_movemask_ps(_mm_and_ps(overlapB, overlapC));
+            if(hits == 0)
+                continue;
+
+            for(uint32_t lane = 0; lane < 4 && j + lane < end; lane++)
+            {
+                if(hits & (1 << lane))
+                    AddPair(body, m_Entries[candidates.Entry[j + lane]].Body, collisionPairs);
+            }
+        }
+#else
+        for(uint32_t j = first; j < end; j++)
+        {
+            if(candidates.MaxB[j] < boxes.MinB[index] || candidates.MinB[j] > boxes.MaxB[index]
+               || candidates.MaxC[j] < boxes.MinC[index] || candidates.MinC[j] > boxes.MaxC[index])
+                continue;
+
+            AddPair(body, m_Entries[candidates.Entry[j]].Body, collisionPairs);
+        }
+#endif
+    }
+
+    void SortAndSweepBroadphase::AddPair(RigidBody3D* body1, RigidBody3D* body2, TDArray<CollisionPair>& collisionPairs)
+    {
+        CollisionPair pair;
+        if(body1 < body2)
+        {
+            pair.pObjectA = body1;
+            pair.pObjectB = body2;
+        }
+        else
+        {
+            pair.pObjectA = body2;
+            pair.pObjectB = body1;
+        }
+
+        collisionPairs.EmplaceBack(pair);
+    }
+
+    void SortAndSweepBroadphase::BuildSweepBoxes()
+    {
+        const uint32_t entryCount = (uint32_t)m_Entries.Size();
+        const uint32_t axisB      = (m_SweepAxis + 1) % 3;
+        const uint32_t axisC      = (m_SweepAxis + 2) % 3;
+
+        uint32_t activeCount = 0;
+        for(const SweepEntry& entry : m_Entries)
+        {
+            if(!entry.Static && !entry.AtRest)
+                activeCount++;
+        }
+
+        m_ActiveBoxes.Resize(activeCount);
+        m_InactiveBoxes.Resize(entryCount - activeCount);
+        m_ActiveBoxes.Count   = 0;
+        m_InactiveBoxes.Count = 0;
+
+        // Splitting the sorted entries keeps both lists sorted
+        for(uint32_t i = 0; i < entryCount; i++)
+        {
+            const SweepEntry& entry = m_Entries[i];
+            SweepBoxes& boxes       = (!entry.Static && !entry.AtRest) ? m_ActiveBoxes : m_InactiveBoxes;
+            const uint32_t index    = boxes.Count++;
+            boxes.Min[index]        = entry.Min;
+            boxes.Max[index]        = entry.Max;
+            boxes.MinB[index]       = entry.BoxMin[axisB];
+            boxes.MaxB[index]       = entry.BoxMax[axisB];
+            boxes.MinC[index]       = entry.BoxMin[axisC];
+            boxes.MaxC[index]       = entry.BoxMax[axisC];
+            boxes.Entry[index]      = i;
+        }
+    }
+
+    void SortAndSweepBroadphase::SweepBoxes::Resize(uint32_t count)
+    {
+        const uint32_t paddedCount = count + 3;
+        Count                      = count;
+        Min.Resize(paddedCount);
+        Max.Resize(paddedCount);
+        MinB.Resize(paddedCount);
+        MaxB.Resize(paddedCount);
+        MinC.Resize(paddedCount);
+        MaxC.Resize(paddedCount);
+        Entry.Resize(paddedCount);
+
+        // Inverted boxes overlap nothing, so the last group of four can be read past the end
+        for(uint32_t i = count; i < paddedCount; i++)
+        {
+            Min[i]   = FLT_MAX;
+            Max[i]   = -FLT_MAX;
+            MinB[i]  = FLT_MAX;
+            MaxB[i]  = -FLT_MAX;
+            MinC[i]  = FLT_MAX;
+            MaxC[i]  = -FLT_MAX;
+            Entry[i] = 0;
+        }
+    }
+
+    void SortAndSweepBroadphase::UpdateEntries(RigidBody3D** bodies, uint32_t bodyCount)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        // Gather the bodies that exist this step. Entries may still reference destroyed bodies,
+        // so they are only ever looked up by pointer and never dereferenced until confirmed live.
+        HashMapClear(&m_LiveBodies);
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            RigidBody3D* current = bodies[i];
+            if(current->GetCollisionShape())
+            {
+                uint32_t tracked = 0;
+                HashMapInsert(&m_LiveBodies, current, tracked);
+            }
+        }
+
+        // Remove stale entries, keeping the rest in their sorted order
+        uint32_t writeIndex = 0;
+        for(uint32_t i = 0; i < (uint32_t)m_Entries.Size(); i++)
+        {
+            uint32_t* tracked = (uint32_t*)HashMapFindPtr(&m_LiveBodies, m_Entries[i].Body);
+            if(!tracked)
+                continue;
+
+            *tracked = 1;
+            if(writeIndex != i)
+                m_Entries[writeIndex] = m_Entries[i];
+            writeIndex++;
+        }
+        m_Entries.Resize(writeIndex);
+
+        // Append new bodies, the sort will move them into place
+        m_AddedCount = 0;
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            RigidBody3D* current = bodies[i];
+            if(current->GetCollisionShape())
+            {
+                uint32_t* tracked = (uint32_t*)HashMapFindPtr(&m_LiveBodies, current);
+                if(*tracked == 0)
+                {
+                    SweepEntry& entry = m_Entries.EmplaceBack();
+                    entry.Body        = current;
+                    *tracked          = 1;
+                    m_AddedCount++;
+                }
+            }
+        }
+
+        Vec3 centreSum(0.0f);
+        Vec3 centreSquaredSum(0.0f);
+        for(SweepEntry& entry : m_Entries)
+        {
+            const Maths::BoundingBox& aabb = entry.Body->GetWorldSpaceAABB();
+            entry.BoxMin                   = aabb.m_Min;
+            entry.BoxMax                   = aabb.m_Max;
+            entry.Static                   = entry.Body->GetIsStatic();
+            entry.AtRest                   = entry.Body->GetIsAtRest();
+
+            const Vec3 centre = (aabb.m_Min + aabb.m_Max) * 0.5f;
+            centreSum += centre;
+            centreSquaredSum += centre * centre;
+        }
+
+        SelectSweepAxis(centreSum, centreSquaredSum);
+
+        for(SweepEntry& entry : m_Entries)
+        {
+            entry.Min = entry.BoxMin[m_SweepAxis];
+            entry.Max = entry.BoxMax[m_SweepAxis];
+        }
+    }
+
+    void SortAndSweepBroadphase::SelectSweepAxis(const Vec3& centreSum, const Vec3& centreSquaredSum)
+    {
+        m_AxisChanged = false;
+        if(m_Entries.Empty())
+            return;
+
+        const float invCount = 1.0f / (float)m_Entries.Size();
+        const Vec3 mean      = centreSum * invCount;
+        const Vec3 variance  = centreSquaredSum * invCount - mean * mean;
+
+        uint32_t bestAxis = 0;
+        if(variance.y > variance[bestAxis])
+            bestAxis = 1;
+        if(variance.z > variance[bestAxis])
+            bestAxis = 2;
+
+        if(bestAxis != m_SweepAxis && variance[bestAxis] > variance[m_SweepAxis] * AXIS_SWITCH_THRESHOLD)
+        {
+            m_SweepAxis   = bestAxis;
+            m_AxisChanged = true;
+        }
+    }
+
+    void SortAndSweepBroadphase::SortEntries()
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+        const uint32_t entryCount = (uint32_t)m_Entries.Size();
+
+        // Insertion sort is only cheap when the previous order is close. After an axis switch or
+        // a large batch of new bodies fall back to a radix sort.
+        if(m_AxisChanged || m_AddedCount > entryCount / 8 + 16)
+        {
+            m_SortKeys.Resize(entryCount);
+            m_ScratchKeys.Resize(entryCount);
+            m_ScratchEntries.Resize(entryCount);
+
+            for(uint32_t i = 0; i < entryCount; i++)
+                m_SortKeys[i] = Algorithms::FloatToSortableKey(m_Entries[i].Min);
+
+            Algorithms::RadixSort(m_SortKeys.Data(), m_Entries.Data(), m_ScratchKeys.Data(), m_ScratchEntries.Data(), entryCount);
+            return;
+        }
+
+        SweepEntry* entries = m_Entries.Data();
+        for(uint32_t i = 1; i < entryCount; i++)
+        {
+            if(entries[i - 1].Min <= entries[i].Min)
+                continue;
+
+            SweepEntry entry = entries[i];
+            uint32_t j       = i;
+            while(j > 0 && entries[j - 1].Min > entry.Min)
+            {
+                entries[j] = entries[j - 1];
+                j--;
+            }
+            entries[j] = entry;
+        }
+    }
+
+    void SortAndSweepBroadphase::DebugDraw()
+    {
+    }
+}
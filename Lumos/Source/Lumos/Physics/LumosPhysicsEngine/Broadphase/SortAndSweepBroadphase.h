@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Broadphase.h"
+#include "Core/DataStructures/Map.h"
+
+namespace Lumos
+{
+    // Single axis sort and sweep. The sorted interval list is kept between steps and re-sorted with an
+    // insertion sort, which is close to linear as bodies only move a little each step.
+    // The sweep axis is the one with the largest spread of body centres.
+    class LUMOS_EXPORT SortAndSweepBroadphase : public Broadphase
+    {
+    public:
+        SortAndSweepBroadphase();
+        virtual ~SortAndSweepBroadphase();
+
+        void FindPotentialCollisionPairs(RigidBody3D** bodies, TDArray<CollisionPair>& collisionPairs, uint32_t totalRigidBodyCount) override;
+        void DebugDraw() override;
+
+    private:
+        struct SweepEntry
+        {
+            float Min; // Interval on the sweep axis
+            float Max;
+            Vec3 BoxMin;
+            Vec3 BoxMax;
+            RigidBody3D* Body;
+            bool Static;
+            bool AtRest;
+        };
+
+        // The sweep only reads these, the sorted entries' boxes split per component so that candidates can be
+        // tested four at a time. Padded with three boxes past Count that overlap nothing
+        struct SweepBoxes
+        {
+            TDArray<float> Min; // Interval on the sweep axis
+            TDArray<float> Max;
+            TDArray<float> MinB; // Intervals on the other two axes
+            TDArray<float> MaxB;
+            TDArray<float> MinC;
+            TDArray<float> MaxC;
+            TDArray<uint32_t> Entry; // Index into m_Entries
+            uint32_t Count = 0;
+
+            void Resize(uint32_t count);
+        };
+
+        void UpdateEntries(RigidBody3D** bodies, uint32_t bodyCount);
+        void BuildSweepBoxes();
+        void SweepCandidates(const SweepBoxes& boxes, uint32_t index, const SweepBoxes& candidates, uint32_t first, TDArray<CollisionPair>& collisionPairs);
+        static void AddPair(RigidBody3D* body1, RigidBody3D* body2, TDArray<CollisionPair>& collisionPairs);
+        void SelectSweepAxis(const Vec3& centreSum, const Vec3& centreSquaredSum);
+        void SortEntries();
+
+        TDArray<SweepEntry> m_Entries; // Sorted by Min on m_SweepAxis
+        TDArray<SweepEntry> m_ScratchEntries;
+        SweepBoxes m_ActiveBoxes; // Neither static nor at rest
+        SweepBoxes m_InactiveBoxes;
+        TDArray<uint64_t> m_SortKeys;
+        TDArray<uint64_t> m_ScratchKeys;
+
+        HashMap(RigidBody3D*, uint32_t) m_LiveBodies = {};
+
+        uint32_t m_SweepAxis  = 0;
+        uint32_t m_AddedCount = 0;
+        bool m_AxisChanged    = true;
+    };
+}
@@ -41,89 +41,43 @@ namespace Lumos
         return inertia;
     }
 
-    TDArray<Vec3>& CapsuleCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void CapsuleCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, TDArray<Vec3>& out_axes) const
     {
         /* There is infinite edges so handle seperately */
-        return m_Axes;
+        out_axes.Clear();
     }
 
-    TDArray<CollisionEdge>& CapsuleCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void CapsuleCollisionShape::GetEdges(const RigidBody3D* currentObject, TDArray<CollisionEdge>& out_edges) const
     {
         /* There is infinite edges on a sphere so handle seperately */
-        return m_Edges;
+        out_edges.Clear();
     }
 
     void CapsuleCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Vec3& axis, Vec3* out_min, Vec3* out_max) const
     {
-        //        Mat4 transform = currentObject ? currentObject->GetWorldSpaceTransform() * m_LocalTransform : m_LocalTransform;
-        //        Vec3 pos       = transform[3];
-        //
-        //        Vec3 topPosition    = Vec3(transform * Vec4(0.0f, m_Height * 0.5f, 0.0f, 1.0f));
-        //        Vec3 bottomPosition = Vec3(transform * Vec4(0.0f, -m_Height * 0.5f, 0.0f, 1.0f));
-        //
-        //        // Transform the axis into the local coordinate space of the capsule
-        //        Mat4 inverseTransform = glm::affineInverse(transform);
-        //        Vec3 localAxis        = Vec3(inverseTransform * Vec4(axis, 1.0f));
-        //
-        //        float minProj = Maths::Dot(topPosition, localAxis) - m_Radius;
-        //        float maxProj = Maths::Dot(bottomPosition, localAxis) + m_Radius;
-        //
-        //        *out_min = topPosition + minProj * localAxis;
-        //        *out_max = bottomPosition + maxProj * localAxis;
-
-        float minCorrelation = FLT_MAX, maxCorrelation = -FLT_MAX;
-
-        Mat4 transform       = currentObject ? currentObject->GetWorldSpaceTransform() * m_LocalTransform : m_LocalTransform;
-        const Vec3 localAxis = transform.Transpose() * Vec4(axis, 1.0f);
-
-        Vec3 pos       = transform.GetPositionVector();
-        Vec3 minVertex = Vec3(0.0f), maxVertex = Vec3(0.0f);
-
-        Vec3 topPosition    = Vec3(transform * Vec4(0.0f, m_Height * 0.5f, 0.0f, 1.0f));
-        Vec3 bottomPosition = Vec3(transform * Vec4(0.0f, -m_Height * 0.5f, 0.0f, 1.0f));
-
-        // Transform the axis into the local coordinate space of the capsule
-        // Mat4 inverseTransform = glm::affineInverse(transform);
-        // Vec3 localAxis        = Vec3(inverseTransform * Vec4(axis, 1.0f));
-
-        float minProj = Maths::Dot(topPosition, localAxis) - m_Radius;
-        float maxProj = Maths::Dot(bottomPosition, localAxis) + m_Radius;
+        Mat4 transform        = currentObject ? currentObject->GetWorldSpaceTransform() * m_LocalTransform : m_LocalTransform;
+        const Vec3 local_axis = Maths::Transpose(Mat3(transform)) * axis;
 
         if(out_min)
-            *out_min = topPosition + minProj; // * localAxis;
+            *out_min = transform * Vec4(GetSupport(-local_axis), 1.0f);
         if(out_max)
-            *out_max = bottomPosition + maxProj; // * localAxis;
-
-        // Capsule Collision shape
-        //		for(size_t i = 0; i < m_Vertices.size(); ++i)
-        //		{
-        //			const float cCorrelation = Maths::Dot(local_axis, m_Vertices[i].pos);
-        //
-        //			if(cCorrelation > maxCorrelation)
-        //			{
-        //				maxCorrelation = cCorrelation;
-        //				maxVertex      = int(i);
-        //			}
-        //
-        //			if(cCorrelation <= minCorrelation)
-        //			{
-        //				minCorrelation = cCorrelation;
-        //				minVertex      = int(i);
-        //			}
-        //		}
+            *out_max = transform * Vec4(GetSupport(local_axis), 1.0f);
+    }
 
-        //		if(out_min)
-        //			*out_min = pos - axis * m_Radius;
-        //
-        //		if(out_max)
-        //			*out_max = pos + axis * m_Radius;
+    Vec3 CapsuleCollisionShape::GetSupport(const Vec3& direction) const
+    {
+        // Furthest end of the inner segment, pushed out by the radius
+        const float length = Maths::Length(direction);
+        const Vec3 end     = Vec3(0.0f, direction.y < 0.0f ? -m_Height * 0.5f : m_Height * 0.5f, 0.0f);
+        return length > Maths::M_EPSILON ? end + direction * (m_Radius / length) : end;
     }
 
     void CapsuleCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                             const Vec3& axis,
                                                             ReferencePolygon& refPolygon) const
     {
-        refPolygon.Faces[0]  = currentObject->GetPosition() + axis * m_Radius;
+        const Mat4& transform = currentObject->GetWorldSpaceTransform();
+        refPolygon.Faces[0]   = transform * Vec4(GetSupport(Maths::Transpose(Mat3(transform)) * axis), 1.0f);
         refPolygon.FaceCount = 1;
 
         refPolygon.Normal = axis;
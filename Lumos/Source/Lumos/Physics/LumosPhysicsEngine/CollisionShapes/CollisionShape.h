@@ -64,12 +64,13 @@ namespace Lumos
         //<----- USED BY COLLISION DETECTION ----->
         // Get all possible collision axes
         //	- This is a list of all the face normals ignoring any duplicates and parallel vectors.
-        virtual TDArray<Vec3>& GetCollisionAxes(const RigidBody3D* currentObject) = 0;
+        //  - Written to out_axes rather than member storage so the narrowphase can run on multiple threads.
+        virtual void GetCollisionAxes(const RigidBody3D* currentObject, TDArray<Vec3>& out_axes) const = 0;
 
         // Get all shape Edges
         //	- Returns a list of all edges AB that form the convex hull of the collision shape. These are
         //    used to check edge/edge collisions aswell as finding the closest point to a sphere. */
-        virtual TDArray<CollisionEdge>& GetEdges(const RigidBody3D* currentObject) = 0;
+        virtual void GetEdges(const RigidBody3D* currentObject, TDArray<CollisionEdge>& out_edges) const = 0;
 
         // Get the min/max vertices along a given axis
         virtual void GetMinMaxVertexOnAxis(
@@ -79,6 +80,10 @@ namespace Lumos
             Vec3* out_max) const
             = 0;
 
+        // Get the point of the shape furthest along a direction, both in the body's local space
+        //  - Used by GJK/EPA. Reads only the shape, so one shape can be shared by bodies tested on different threads.
+        virtual Vec3 GetSupport(const Vec3& direction) const = 0;
+
         // Get all data needed to build manifold
         //	- Computes the face that is closest to parallel to that of the given axis,
         //    returning the face (as a list of vertices), face normal and the planes
@@ -113,7 +118,5 @@ namespace Lumos
     protected:
         CollisionShapeType m_Type;
         Mat4 m_LocalTransform;
-        TDArray<CollisionEdge> m_Edges;
-        TDArray<Vec3> m_Axes;
     };
 }
@@ -14,8 +14,6 @@ namespace Lumos
         m_CubeHull             = CreateSharedPtr<BoundingBoxHull>();
         m_CubeHull->Set(-m_CuboidHalfDimensions, m_CuboidHalfDimensions);
         m_CubeHull->UpdateHull();
-        m_Axes.Resize(3);
-        m_Edges.Resize(m_CubeHull->GetNumEdges());
     }
 
     CuboidCollisionShape::CuboidCollisionShape(const Vec3& halfdims)
@@ -27,9 +25,6 @@ namespace Lumos
         m_CubeHull = CreateSharedPtr<BoundingBoxHull>();
         m_CubeHull->Set(-m_CuboidHalfDimensions, m_CuboidHalfDimensions);
         m_CubeHull->UpdateHull();
-
-        m_Axes.Resize(3);
-        m_Edges.Resize(m_CubeHull->GetNumEdges());
     }
 
     CuboidCollisionShape::~CuboidCollisionShape()
@@ -49,25 +44,25 @@ namespace Lumos
         return inertia;
     }
 
-    TDArray<Vec3>& CuboidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void CuboidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, TDArray<Vec3>& out_axes) const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         {
-            m_Axes.Resize(3);
+            out_axes.Resize(3);
 
             Mat3 objOrientation = Mat3(currentObject->GetOrientation());     //.RotationMatrix();
-            m_Axes[0]           = (objOrientation * Vec3(1.0f, 0.0f, 0.0f)); // X - Axis
-            m_Axes[1]           = (objOrientation * Vec3(0.0f, 1.0f, 0.0f)); // Y - Axis
-            m_Axes[2]           = (objOrientation * Vec3(0.0f, 0.0f, 1.0f)); // Z - Axis
+            out_axes[0]         = (objOrientation * Vec3(1.0f, 0.0f, 0.0f)); // X - Axis
+            out_axes[1]         = (objOrientation * Vec3(0.0f, 1.0f, 0.0f)); // Y - Axis
+            out_axes[2]         = (objOrientation * Vec3(0.0f, 0.0f, 1.0f)); // Z - Axis
         }
-
-        return m_Axes;
     }
 
-    TDArray<CollisionEdge>& CuboidCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void CuboidCollisionShape::GetEdges(const RigidBody3D* currentObject, TDArray<CollisionEdge>& out_edges) const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         {
+            out_edges.Resize(m_CubeHull->GetNumEdges());
+
             Mat4 transform = currentObject->GetWorldSpaceTransform() * m_LocalTransform;
             for(unsigned int i = 0; i < m_CubeHull->GetNumEdges(); ++i)
             {
@@ -75,10 +70,9 @@ namespace Lumos
                 Vec3 A               = transform * Vec4(m_CubeHull->GetVertex(edge.vStart).pos, 1.0f);
                 Vec3 B               = transform * Vec4(m_CubeHull->GetVertex(edge.vEnd).pos, 1.0f);
 
-                m_Edges[i] = { A, B };
+                out_edges[i] = { A, B };
             }
         }
-        return m_Edges;
     }
 
     void CuboidCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Vec3& axis, Vec3* out_min, Vec3* out_max) const
@@ -97,6 +91,13 @@ namespace Lumos
             *out_max = wsTransform * Vec4(m_CubeHull->GetVertex(vMax).pos, 1.0f);
     }
 
+    Vec3 CuboidCollisionShape::GetSupport(const Vec3& direction) const
+    {
+        return Vec3(direction.x < 0.0f ? -m_CuboidHalfDimensions.x : m_CuboidHalfDimensions.x,
+                    direction.y < 0.0f ? -m_CuboidHalfDimensions.y : m_CuboidHalfDimensions.y,
+                    direction.z < 0.0f ? -m_CuboidHalfDimensions.z : m_CuboidHalfDimensions.z);
+    }
+
     void CuboidCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                            const Vec3& axis,
                                                            ReferencePolygon& refPolygon) const
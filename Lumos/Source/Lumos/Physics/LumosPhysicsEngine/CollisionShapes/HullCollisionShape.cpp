@@ -12,13 +12,11 @@ namespace Lumos
     {
         m_HalfDimensions = Vec3(1.0f);
         m_Type           = CollisionShapeType::CollisionHull;
-        m_Axes.Resize(3);
 
         auto test = Lumos::SharedPtr<Lumos::Graphics::Mesh>(Lumos::Graphics::CreatePrimative(Lumos::Graphics::PrimitiveType::Cube));
         BuildFromMesh(test.get());
 
         m_LocalTransform = Mat4::Scale(m_HalfDimensions);
-        m_Edges.Resize(m_Hull->GetNumEdges());
     }
 
     HullCollisionShape::~HullCollisionShape()
@@ -59,8 +57,6 @@ namespace Lumos
         //     int vertexIdx[] = { (int)indices[i], (int)indices[i + 1], (int)indices[i + 2] };
         //     m_Hull->AddFace(normal, 3, vertexIdx);
         // }
-
-        // m_Edges.Resize(m_Hull->GetNumEdges());
     }
 
     // Mat3 HullCollisionShape::GetLocalInertiaTensor(float mass)
@@ -89,23 +85,25 @@ namespace Lumos
         return inertia;
     }
 
-    TDArray<Vec3>& HullCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void HullCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, TDArray<Vec3>& out_axes) const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         {
+            out_axes.Resize(3);
+
             Mat3 objOrientation = Mat3(currentObject->GetOrientation());
-            m_Axes[0]           = (objOrientation * Vec3(1.0f, 0.0f, 0.0f)); // X - Axis
-            m_Axes[1]           = (objOrientation * Vec3(0.0f, 1.0f, 0.0f)); // Y - Axis
-            m_Axes[2]           = (objOrientation * Vec3(0.0f, 0.0f, 1.0f)); // Z - Axis
+            out_axes[0]         = (objOrientation * Vec3(1.0f, 0.0f, 0.0f)); // X - Axis
+            out_axes[1]         = (objOrientation * Vec3(0.0f, 1.0f, 0.0f)); // Y - Axis
+            out_axes[2]         = (objOrientation * Vec3(0.0f, 0.0f, 1.0f)); // Z - Axis
         }
-
-        return m_Axes;
     }
 
-    TDArray<CollisionEdge>& HullCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void HullCollisionShape::GetEdges(const RigidBody3D* currentObject, TDArray<CollisionEdge>& out_edges) const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         {
+            out_edges.Resize(m_Hull->GetNumEdges());
+
             Mat4 transform = currentObject->GetWorldSpaceTransform() * m_LocalTransform;
             for(unsigned int i = 0; i < m_Hull->GetNumEdges(); ++i)
             {
@@ -113,10 +111,9 @@ namespace Lumos
                 Vec3 A               = transform * Vec4(m_Hull->GetVertex(edge.vStart).pos, 1.0f);
                 Vec3 B               = transform * Vec4(m_Hull->GetVertex(edge.vEnd).pos, 1.0f);
 
-                m_Edges[i] = { A, B };
+                out_edges[i] = { A, B };
             }
         }
-        return m_Edges;
     }
 
     void HullCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Vec3& axis, Vec3* out_min, Vec3* out_max) const
@@ -144,6 +141,17 @@ namespace Lumos
             *out_max = wsTransform * Vec4(m_Hull->GetVertex(vMax).pos, 1.0f);
     }
 
+    Vec3 HullCollisionShape::GetSupport(const Vec3& direction) const
+    {
+        if(!m_Hull || m_Hull->GetNumVertices() == 0)
+            return Vec3(0.0f);
+
+        int vMax;
+        m_Hull->GetMinMaxVerticesInAxis(Maths::Transpose(Mat3(m_LocalTransform)) * direction, nullptr, &vMax);
+
+        return m_LocalTransform * Vec4(m_Hull->GetVertex(vMax).pos, 1.0f);
+    }
+
     void HullCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                          const Vec3& axis,
                                                          ReferencePolygon& refPolygon) const
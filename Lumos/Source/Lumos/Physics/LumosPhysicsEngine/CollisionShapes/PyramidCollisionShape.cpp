@@ -17,9 +17,6 @@ namespace Lumos
         {
             ConstructPyramidHull();
         }
-
-        m_Axes.Resize(5);
-        m_Edges.Resize(m_PyramidHull->GetNumEdges());
     }
 
     PyramidCollisionShape::PyramidCollisionShape(const Vec3& halfdims)
@@ -48,9 +45,6 @@ namespace Lumos
         {
             ConstructPyramidHull();
         }
-
-        m_Axes.Resize(5);
-        m_Edges.Resize(m_PyramidHull->GetNumEdges());
     }
 
     PyramidCollisionShape::~PyramidCollisionShape()
@@ -68,10 +62,12 @@ namespace Lumos
         return inertia;
     }
 
-    TDArray<CollisionEdge>& PyramidCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void PyramidCollisionShape::GetEdges(const RigidBody3D* currentObject, TDArray<CollisionEdge>& out_edges) const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         {
+            out_edges.Resize(m_PyramidHull->GetNumEdges());
+
             Mat4 transform = currentObject->GetWorldSpaceTransform() * m_LocalTransform;
             for(unsigned int i = 0; i < m_PyramidHull->GetNumEdges(); ++i)
             {
@@ -79,27 +75,23 @@ namespace Lumos
                 Vec3 A               = transform * Vec4(m_PyramidHull->GetVertex(edge.vStart).pos, 1.0f);
                 Vec3 B               = transform * Vec4(m_PyramidHull->GetVertex(edge.vEnd).pos, 1.0f);
 
-                m_Edges[i] = { A, B };
+                out_edges[i] = { A, B };
             }
         }
-        return m_Edges;
     }
 
-    TDArray<Vec3>& PyramidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void PyramidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, TDArray<Vec3>& out_axes) const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         {
-            m_Axes.Clear();
-            m_Axes.Resize(5);
+            out_axes.Resize(5);
             const Mat3 objOrientation = Mat3(currentObject->GetOrientation());
-            m_Axes[0]                 = (objOrientation * m_Normals[0]);
-            m_Axes[1]                 = (objOrientation * m_Normals[1]);
-            m_Axes[2]                 = (objOrientation * m_Normals[2]);
-            m_Axes[3]                 = (objOrientation * m_Normals[3]);
-            m_Axes[4]                 = (objOrientation * m_Normals[4]);
+            out_axes[0]               = (objOrientation * m_Normals[0]);
+            out_axes[1]               = (objOrientation * m_Normals[1]);
+            out_axes[2]               = (objOrientation * m_Normals[2]);
+            out_axes[3]               = (objOrientation * m_Normals[3]);
+            out_axes[4]               = (objOrientation * m_Normals[4]);
         }
-
-        return m_Axes;
     }
 
     void PyramidCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Vec3& axis, Vec3* out_min, Vec3* out_max) const
@@ -117,6 +109,14 @@ namespace Lumos
             *out_max = wsTransform * Vec4(m_PyramidHull->GetVertex(vMax).pos, 1.0f);
     }
 
+    Vec3 PyramidCollisionShape::GetSupport(const Vec3& direction) const
+    {
+        int vMax;
+        m_PyramidHull->GetMinMaxVerticesInAxis(Maths::Transpose(Mat3(m_LocalTransform)) * direction, nullptr, &vMax);
+
+        return m_LocalTransform * Vec4(m_PyramidHull->GetVertex(vMax).pos, 1.0f);
+    }
+
     void PyramidCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                             const Vec3& axis,
                                                             ReferencePolygon& refPolygon) const
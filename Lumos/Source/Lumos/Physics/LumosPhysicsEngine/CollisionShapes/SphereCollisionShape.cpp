@@ -4,6 +4,7 @@
 #include "Graphics/Renderers/DebugRenderer.h"
 #include "Maths/BoundingSphere.h"
 #include "Maths/Matrix3.h"
+#include "Maths/MathsUtilities.h"
 
 namespace Lumos
 {
@@ -38,17 +39,16 @@ namespace Lumos
         return inertia;
     }
 
-    TDArray<Vec3>& SphereCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void SphereCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, TDArray<Vec3>& out_axes) const
     {
         /* There is infinite edges so handle seperately */
-        m_Axes.Clear();
-        return m_Axes;
+        out_axes.Clear();
     }
 
-    TDArray<CollisionEdge>& SphereCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void SphereCollisionShape::GetEdges(const RigidBody3D* currentObject, TDArray<CollisionEdge>& out_edges) const
     {
         /* There is infinite edges on a sphere so handle seperately */
-        return m_Edges;
+        out_edges.Clear();
     }
 
     void SphereCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Vec3& axis, Vec3* out_min, Vec3* out_max) const
@@ -65,6 +65,12 @@ namespace Lumos
             *out_max = pos + axis * m_Radius;
     }
 
+    Vec3 SphereCollisionShape::GetSupport(const Vec3& direction) const
+    {
+        const float length = Maths::Length(direction);
+        return length > Maths::M_EPSILON ? direction * (m_Radius / length) : Vec3(m_Radius, 0.0f, 0.0f);
+    }
+
     void SphereCollisionShape::GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                            const Vec3& axis,
                                                            ReferencePolygon& refPolygon) const
@@ -18,10 +18,11 @@ namespace Lumos
         // Collision Shape Functionality
         virtual Mat3 BuildInverseInertia(float invMass) const override;
 
-        virtual TDArray<Vec3>& GetCollisionAxes(const RigidBody3D* currentObject) override;
-        virtual TDArray<CollisionEdge>& GetEdges(const RigidBody3D* currentObject) override;
+        virtual void GetCollisionAxes(const RigidBody3D* currentObject, TDArray<Vec3>& out_axes) const override;
+        virtual void GetEdges(const RigidBody3D* currentObject, TDArray<CollisionEdge>& out_edges) const override;
 
         virtual void GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Vec3& axis, Vec3* out_min, Vec3* out_max) const override;
+        virtual Vec3 GetSupport(const Vec3& direction) const override;
         virtual void GetIncidentReferencePolygon(const RigidBody3D* currentObject,
                                                  const Vec3& axis,
                                                  ReferencePolygon& refPolygon) const override;
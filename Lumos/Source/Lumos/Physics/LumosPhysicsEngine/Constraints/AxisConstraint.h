@@ -23,6 +23,7 @@ namespace Lumos
         AxisConstraint(RigidBody3D* obj1, Axes axes);
 
         virtual void ApplyImpulse() override;
+        virtual RigidBody3D* GetBodyA() const override { return m_pObj1; }
         virtual void DebugDraw() const override;
         Axes GetAxes() { return m_Axes; }
 
@@ -13,6 +13,8 @@ namespace Lumos
         SpringConstraint(RigidBody3D* obj1, RigidBody3D* obj2, const Vec3& globalOnA, const Vec3& globalOnB, float springConstant, float dampingFactor);
 
         virtual void ApplyImpulse() override;
+        virtual RigidBody3D* GetBodyA() const override { return m_pObj1; }
+        virtual RigidBody3D* GetBodyB() const override { return m_pObj2; }
         virtual void DebugDraw() const override;
 
     protected:
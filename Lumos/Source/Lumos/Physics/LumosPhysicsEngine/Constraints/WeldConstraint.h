@@ -14,6 +14,8 @@ namespace Lumos
         WeldConstraint(RigidBody3D* obj1, RigidBody3D* obj2);
 
         virtual void ApplyImpulse() override;
+        virtual RigidBody3D* GetBodyA() const override { return m_pObj1; }
+        virtual RigidBody3D* GetBodyB() const override { return m_pObj2; }
         virtual void DebugDraw() const override;
 
     protected:
@@ -4,6 +4,8 @@
 #include "Narrowphase/CollisionDetection.h"
 #include "Broadphase/BruteForceBroadphase.h"
 #include "Broadphase/OctreeBroadphase.h"
+#include "Broadphase/SortAndSweepBroadphase.h"
+#include "Broadphase/DynamicTreeBroadphase.h"
 #include "RigidBody3D.h"
 #include "Integration.h"
 #include "Constraints/Constraint.h"
@@ -16,6 +18,7 @@
 #include "Scene/Entity.h"
 #include "Graphics/Renderers/DebugRenderer.h"
 #include "Maths/MathsUtilities.h"
+#include "Maths/SSEUtilities.h"
 #include "Maths/Transform.h"
 #include "ImGui/ImGuiUtilities.h"
 #include "Utilities/Colour.h"
@@ -26,6 +29,63 @@
 namespace Lumos
 {
 
+    struct NarrowphaseResult
+    {
+        uint32_t PairIndex;
+        bool HasManifold;
+        CollisionData ColData;
+        Manifold ContactManifold;
+    };
+
+    // Output of one narrowphase job group. Each group covers a contiguous range of broadphase pairs and
+    // is only written by the thread executing it, so no locking is needed and concatenating the buffers
+    // in group order yields the results in pair order.
+    struct NarrowphaseBuffer
+    {
+        TDArray<NarrowphaseResult> Results;
+    };
+
+    static const uint32_t NARROWPHASE_GROUP_SIZE = 32;
+
+    // Bodies connected through contacts or constraints. Islands share no dynamic bodies, so they can be
+    // solved independently and go to sleep as a whole. Offsets index the engine's grouped island arrays.
+    struct SimulationIsland
+    {
+        uint32_t BodyOffset;
+        uint32_t BodyCount;
+        uint32_t ManifoldOffset;
+        uint32_t ManifoldCount;
+        uint32_t ConstraintOffset;
+        uint32_t ConstraintCount;
+        bool HasDynamicBodies; // Static bodies only join islands through constraints
+        bool Awake;
+    };
+
+    static const uint32_t ISLAND_NONE = ~0u;
+
+    static uint32_t FindIslandRoot(TDArray<uint32_t>& parents, uint32_t index)
+    {
+        // Path halving keeps the trees flat without recursion
+        while(parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index          = parents[index];
+        }
+        return index;
+    }
+
+    static void UnionIslands(TDArray<uint32_t>& parents, uint32_t a, uint32_t b)
+    {
+        const uint32_t rootA = FindIslandRoot(parents, a);
+        const uint32_t rootB = FindIslandRoot(parents, b);
+
+        // Lowest index becomes the root, so island order only depends on body order
+        if(rootA < rootB)
+            parents[rootB] = rootA;
+        else if(rootB < rootA)
+            parents[rootA] = rootB;
+    }
+
     float LumosPhysicsEngine::s_UpdateTimestep = 1.0f / 60.0f;
 
     LumosPhysicsEngine::LumosPhysicsEngine(const LumosPhysicsEngineConfig& config)
@@ -33,17 +93,19 @@ namespace Lumos
         , m_UpdateAccum(0.0f)
         , m_Gravity(config.Gravity)
         , m_DampingFactor(config.DampingFactor)
-        , m_BroadphaseDetection(nullptr)
-        , m_IntegrationType(config.IntegrType)
-        , m_RootBody(nullptr)
+        , m_WarmStarting(config.WarmStarting)
         , m_BaumgarteScalar(config.BaumgarteScalar)
         , m_BaumgarteSlop(config.BaumgarteSlop)
+        , m_BroadphaseDetection(nullptr)
+        , m_IntegrationType(config.IntegrType)
     {
         m_DebugName = "Lumos3DPhysicsEngine";
         m_BroadphaseCollisionPairs.Reserve(1000);
 
         m_Allocator = new PoolAllocator<RigidBody3D>();
         m_Arena     = ArenaAlloc(Megabytes(4));
+
+        CollisionDetection::Get().SetGJKEnabled(config.GJKNarrowphase);
     }
 
     void LumosPhysicsEngine::SetDefaults()
@@ -60,6 +122,8 @@ namespace Lumos
 
     LumosPhysicsEngine::~LumosPhysicsEngine()
     {
+        HashMapDeinit(&m_ManifoldCache);
+        HashMapDeinit(&m_SearchAxisCache);
         CollisionDetection::Release();
     }
 
@@ -138,91 +202,142 @@ namespace Lumos
 
     void LumosPhysicsEngine::UpdatePhysics()
     {
-        m_ManifoldCount = 0;
-        m_Manifolds     = PushArrayNoZero(m_Arena, Manifold, 1000);
-
         // Check for collisions
         BroadPhaseCollisions();
         NarrowPhaseCollisions();
+        BuildIslands();
 
         // Solve collision constraints
         SolveConstraints();
         // Update movement
-        for(uint32_t i = 0; i < m_PositionIterations; i++)
-            UpdateRigidBodys();
+        UpdateRigidBodys();
 
-        RigidBody3D* current = m_RootBody;
-        while(current)
-        {
-            current->RestTest();
-            current = current->m_Next;
-        }
+        for(RigidBody3D* body : m_BodyStore.Bodies)
+            body->RestTest();
+
+        UpdateIslandSleep();
     }
 
     void LumosPhysicsEngine::UpdateRigidBodys()
     {
         LUMOS_PROFILE_SCOPE("Update Rigid Body");
 
+        RigidBodyStore& store    = m_BodyStore;
+        const uint32_t bodyCount = store.Size();
+
         m_Stats.StaticCount    = 0;
         m_Stats.RestCount      = 0;
-        m_Stats.RigidBodyCount = 0;
+        m_Stats.RigidBodyCount = bodyCount;
 
-        RigidBody3D* current = m_RootBody;
-        while(current)
+        // Mark the awake dynamic bodies, nothing else is integrated. Forces and torques are fixed for the
+        // step, so their accelerations are worked out here rather than on every position iteration
+        for(uint32_t i = 0; i < bodyCount; i++)
         {
-            if(current->m_AtRest)
+            const RigidBody3D* body = store.Bodies[i];
+            if(body->m_AtRest)
                 m_Stats.RestCount++;
-            if(current->m_Static)
+            if(body->m_Static)
                 m_Stats.StaticCount++;
 
-            m_Stats.RigidBodyCount++;
+            const bool integrate    = !body->m_Static && body->IsAwake();
+            store.IntegrateMasks[i] = integrate ? ~0u : 0u;
+            if(integrate)
+            {
+                store.LinearAccelerations[i]  = store.Forces[i] * store.InvMasses[i];
+                store.AngularAccelerations[i] = store.InvInertias[i] * store.Torques[i];
+            }
+        }
+
+        const float dt = s_UpdateTimestep / m_PositionIterations;
+        for(uint32_t i = 0; i < m_PositionIterations; i++)
+            IntegrateBodies(dt);
+
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            if(!store.IntegrateMasks[i])
+                continue;
+
+            // Mark cached world transform and AABB as invalid
+            RigidBody3D* body              = store.Bodies[i];
+            body->m_WSTransformInvalidated = true;
+            body->m_WSAabbInvalidated      = true;
 
-            UpdateRigidBody(current);
-            current = current->m_Next;
+            ASSERT(store.Orientations[i].IsValid());
+            ASSERT(store.Positions[i].IsValid());
         }
     }
 
     RigidBody3D* LumosPhysicsEngine::CreateBody(const RigidBody3DProperties& properties)
     {
-        m_RigidBodyCount++;
-
         void* mem = m_Allocator->Allocate();
-
-        RigidBody3D* body = new(mem) RigidBody3D();
-        // Add to world doubly linked list.
-        body->m_Prev = nullptr;
-        body->m_Next = m_RootBody;
-        if(m_RootBody)
-        {
-            m_RootBody->m_Prev = body;
-        }
-        m_RootBody = body;
-
-        return body;
+        return new(mem) RigidBody3D(RigidBody3DProperties(), &m_BodyStore);
     }
 
     void LumosPhysicsEngine::DestroyBody(RigidBody3D* body)
     {
-        m_RigidBodyCount--;
+        if(m_BroadphaseDetection)
+            m_BroadphaseDetection->RemoveBody(body);
+
+        // These become next step's warm start data, and the address may be reused by a new body
+        m_Manifolds.RemoveIf([body](const Manifold& manifold)
+                             { return manifold.NodeA() == body || manifold.NodeB() == body; });
+
+        // Takes the body out of m_BodyStore, moving the last body into its slot
+        body->~RigidBody3D();
+        m_Allocator->Deallocate(body);
+    }
 
-        // Remove world body list.
-        if(body->m_Prev)
+    void LumosPhysicsEngine::QueryAABB(const Maths::BoundingBox& box, TDArray<RigidBody3D*>& bodies)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(m_BroadphaseDetection && m_BroadphaseDetection->SupportsQueries())
         {
-            body->m_Prev->m_Next = body->m_Next;
+            m_BroadphaseDetection->QueryAABB(box, bodies);
+            return;
         }
 
-        if(body->m_Next)
+        for(RigidBody3D* body : m_BodyStore.Bodies)
         {
-            body->m_Next->m_Prev = body->m_Prev;
+            if(!body->GetCollisionShape())
+                continue;
+
+            const Maths::BoundingBox& aabb = body->GetWorldSpaceAABB();
+            if(aabb.m_Max.x < box.m_Min.x || aabb.m_Min.x > box.m_Max.x
+               || aabb.m_Max.y < box.m_Min.y || aabb.m_Min.y > box.m_Max.y
+               || aabb.m_Max.z < box.m_Min.z || aabb.m_Min.z > box.m_Max.z)
+                continue;
+
+            bodies.PushBack(body);
         }
+    }
+
+    bool LumosPhysicsEngine::Raycast(const Maths::Ray& ray, float maxDistance, RaycastHit& hit)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(m_BroadphaseDetection && m_BroadphaseDetection->SupportsQueries())
+            return m_BroadphaseDetection->Raycast(ray, maxDistance, hit);
 
-        if(body == m_RootBody)
+        const Vec3 invDirection(ray.Direction.x != 0.0f ? 1.0f / ray.Direction.x : Maths::M_INFINITY,
+                                ray.Direction.y != 0.0f ? 1.0f / ray.Direction.y : Maths::M_INFINITY,
+                                ray.Direction.z != 0.0f ? 1.0f / ray.Direction.z : Maths::M_INFINITY);
+
+        hit.Body = nullptr;
+        for(RigidBody3D* body : m_BodyStore.Bodies)
         {
-            m_RootBody = body->m_Next;
+            if(!body->GetCollisionShape())
+                continue;
+
+            const Maths::BoundingBox& aabb = body->GetWorldSpaceAABB();
+            const float distance           = DynamicTree::RayBoxDistance(ray.Origin, invDirection, aabb.m_Min, aabb.m_Max, maxDistance);
+            if(distance < 0.0f)
+                continue;
+
+            hit.Body     = body;
+            hit.Distance = distance;
+            maxDistance  = distance;
         }
 
-        body->~RigidBody3D();
-        m_Allocator->Deallocate(body);
+        return hit.Body != nullptr;
     }
 
     void LumosPhysicsEngine::SyncTransforms(Scene* scene)
@@ -263,137 +378,263 @@ namespace Lumos
         return ans;
     }
 
-    void LumosPhysicsEngine::UpdateRigidBody(RigidBody3D* obj) const
+#ifdef LUMOS_SSE
+    // IntegrateBodies four bodies at a time. Each lane repeats the scalar loop's operations in the same order, and
+    // lanes holding bodies that aren't integrated are written back unchanged
+    static void IntegrateBodiesWide(RigidBodyStore& store, IntegrationType type, const Vec3& gravityImpulse, float damping, float dt)
     {
-        LUMOS_PROFILE_FUNCTION_LOW();
-
-        s_UpdateTimestep /= m_PositionIterations;
-
-        if(!obj->GetIsStatic() && obj->IsAwake())
+        const __m128 zero         = _mm_setzero_ps();
+        const __m128 half         = _mm_set1_ps(0.5f);
+        const __m128 signBit      = _mm_set1_ps(-0.0f);
+        const __m128 timeStep     = _mm_set1_ps(dt);
+        const __m128 dampingWide  = _mm_set1_ps(damping);
+        const __m128 gravityX     = _mm_set1_ps(gravityImpulse.x);
+        const __m128 gravityY     = _mm_set1_ps(gravityImpulse.y);
+        const __m128 gravityZ     = _mm_set1_ps(gravityImpulse.z);
+        const bool semiImplicit   = type == IntegrationType::SEMI_IMPLICIT_EULER;
+        const uint32_t paddedSize = store.PaddedSize();
+
+        for(uint32_t i = 0; i < paddedSize; i += 4)
         {
-            const float damping = m_DampingFactor;
+            const __m128 mask = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&store.IntegrateMasks[i]));
+            if(_mm_movemask_ps(mask) == 0)
+                continue;
+
+            // Vec3 is padded to 16 bytes, the fourth component of each Vec3 load is that padding
+            __m128 px, py, pz, pPad;
+            __m128 vx, vy, vz, vPad;
+            __m128 wx, wy, wz, wPad;
+            __m128 qx, qy, qz, qw;
+            __m128 ax, ay, az, aPad;
+            __m128 alphaX, alphaY, alphaZ, alphaPad;
+            LoadTransposed(&store.Positions[i].x, px, py, pz, pPad);
+            LoadTransposed(&store.LinearVelocities[i].x, vx, vy, vz, vPad);
+            LoadTransposed(&store.AngularVelocities[i].x, wx, wy, wz, wPad);
+            LoadTransposed(&store.Orientations[i].x, qx, qy, qz, qw);
+            LoadTransposed(&store.LinearAccelerations[i].x, ax, ay, az, aPad);
+            LoadTransposed(&store.AngularAccelerations[i].x, alphaX, alphaY, alphaZ, alphaPad);
+            const __m128 invMass = _mm_loadu_ps(&store.InvMasses[i]);
+            const __m128 factor  = _mm_loadu_ps(&store.AngularFactors[i]);
 
             // Apply gravity
-            if(obj->m_InvMass > 0.0f)
-                obj->m_LinearVelocity += m_Gravity * s_UpdateTimestep;
+            const __m128 hasMass = _mm_cmpgt_ps(invMass, zero);
+            __m128 newVX         = _mm_add_ps(vx, _mm_and_ps(hasMass, gravityX));
+            __m128 newVY         = _mm_add_ps(vy, _mm_and_ps(hasMass, gravityY));
+            __m128 newVZ         = _mm_add_ps(vz, _mm_and_ps(hasMass, gravityZ));
 
-            switch(m_IntegrationType)
+            __m128 newPX, newPY, newPZ;
+            if(semiImplicit)
             {
-            case IntegrationType::EXPLICIT_EULER:
-            {
-                // Update position
-                obj->m_Position += obj->m_LinearVelocity * s_UpdateTimestep;
-
                 // Update linear velocity (v = u + at)
-                obj->m_LinearVelocity += obj->m_Force * obj->m_InvMass * s_UpdateTimestep;
+                newVX = _mm_add_ps(newVX, _mm_mul_ps(_mm_mul_ps(newVX, invMass), timeStep));
+                newVY = _mm_add_ps(newVY, _mm_mul_ps(_mm_mul_ps(newVY, invMass), timeStep));
+                newVZ = _mm_add_ps(newVZ, _mm_mul_ps(_mm_mul_ps(newVZ, invMass), timeStep));
 
                 // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+                newVX = _mm_mul_ps(newVX, dampingWide);
+                newVY = _mm_mul_ps(newVY, dampingWide);
+                newVZ = _mm_mul_ps(newVZ, dampingWide);
 
-                // Update orientation
-                obj->m_Orientation += obj->m_Orientation * Quat(obj->m_AngularVelocity * s_UpdateTimestep);
-                // obj->m_Orientation = obj->m_Orientation + ((obj->m_AngularVelocity * s_UpdateTimestep * 0.5f) * obj->m_Orientation);
-                obj->m_Orientation.Normalise();
-
-                // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+                // Update position
+                newPX = _mm_add_ps(px, _mm_mul_ps(newVX, timeStep));
+                newPY = _mm_add_ps(py, _mm_mul_ps(newVY, timeStep));
+                newPZ = _mm_add_ps(pz, _mm_mul_ps(newVZ, timeStep));
+            }
+            else
+            {
+                // Integration::RK2 and RK4 evaluate every derivative of a constant acceleration to the
+                // starting velocity and that acceleration, so both reduce to this
+                newPX = _mm_add_ps(px, _mm_mul_ps(newVX, timeStep));
+                newPY = _mm_add_ps(py, _mm_mul_ps(newVY, timeStep));
+                newPZ = _mm_add_ps(pz, _mm_mul_ps(newVZ, timeStep));
 
-                // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping * obj->m_AngularFactor;
+                // Linear velocity damping
+                newVX = _mm_mul_ps(_mm_add_ps(newVX, _mm_mul_ps(ax, timeStep)), dampingWide);
+                newVY = _mm_mul_ps(_mm_add_ps(newVY, _mm_mul_ps(ay, timeStep)), dampingWide);
+                newVZ = _mm_mul_ps(_mm_add_ps(newVZ, _mm_mul_ps(az, timeStep)), dampingWide);
+            }
 
-                break;
+            // Update angular velocity
+            __m128 newWX = _mm_add_ps(wx, _mm_mul_ps(alphaX, timeStep));
+            __m128 newWY = _mm_add_ps(wy, _mm_mul_ps(alphaY, timeStep));
+            __m128 newWZ = _mm_add_ps(wz, _mm_mul_ps(alphaZ, timeStep));
+
+            // Angular velocity damping
+            newWX = _mm_mul_ps(_mm_mul_ps(newWX, dampingWide), factor);
+            newWY = _mm_mul_ps(_mm_mul_ps(newWY, dampingWide), factor);
+            newWZ = _mm_mul_ps(_mm_mul_ps(newWZ, dampingWide), factor);
+
+            // Update orientation, q += QuatMulVec3(q, h)
+            __m128 hx = _mm_mul_ps(newWX, timeStep);
+            __m128 hy = _mm_mul_ps(newWY, timeStep);
+            __m128 hz = _mm_mul_ps(newWZ, timeStep);
+            if(!semiImplicit)
+            {
+                hx = _mm_mul_ps(hx, half);
+                hy = _mm_mul_ps(hy, half);
+                hz = _mm_mul_ps(hz, half);
             }
 
-            case IntegrationType::SEMI_IMPLICIT_EULER:
+            const __m128 dw = _mm_sub_ps(_mm_sub_ps(_mm_xor_ps(_mm_mul_ps(qx, hx), signBit), _mm_mul_ps(qy, hy)), _mm_mul_ps(qz, hz));
+            const __m128 dx = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(qw, hx), _mm_mul_ps(hy, qz)), _mm_mul_ps(hz, qy));
+            const __m128 dy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(qw, hy), _mm_mul_ps(hz, qx)), _mm_mul_ps(hx, qz));
+            const __m128 dz = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(qw, hz), _mm_mul_ps(hx, qy)), _mm_mul_ps(hy, qx));
+
+            __m128 newQX = _mm_add_ps(qx, dx);
+            __m128 newQY = _mm_add_ps(qy, dy);
+            __m128 newQZ = _mm_add_ps(qz, dz);
+            __m128 newQW = _mm_add_ps(qw, dw);
+
+            // Normalise, with the same reciprocal square root and Newton step as Quat::Normalise
+            const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(newQX, newQX), _mm_mul_ps(newQY, newQY)),
+                                               _mm_add_ps(_mm_mul_ps(newQZ, newQZ), _mm_mul_ps(newQW, newQW)));
+            const __m128 e        = _mm_rsqrt_ps(lengthSq);
+            const __m128 e3       = _mm_mul_ps(_mm_mul_ps(e, e), e);
+            const __m128 scale    = _mm_add_ps(e, _mm_mul_ps(half, _mm_sub_ps(e, _mm_mul_ps(lengthSq, e3))));
+            const __m128 nonZero  = _mm_cmpneq_ps(lengthSq, zero);
+            newQX                 = _mm_blendv_ps(newQX, _mm_mul_ps(newQX, scale), nonZero);
+            newQY                 = _mm_blendv_ps(newQY, _mm_mul_ps(newQY, scale), nonZero);
+            newQZ                 = _mm_blendv_ps(newQZ, _mm_mul_ps(newQZ, scale), nonZero);
+            newQW                 = _mm_blendv_ps(newQW, _mm_mul_ps(newQW, scale), nonZero);
+
+            StoreTransposed(&store.Positions[i].x, _mm_blendv_ps(px, newPX, mask), _mm_blendv_ps(py, newPY, mask), _mm_blendv_ps(pz, newPZ, mask), pPad);
+            StoreTransposed(&store.LinearVelocities[i].x, _mm_blendv_ps(vx, newVX, mask), _mm_blendv_ps(vy, newVY, mask), _mm_blendv_ps(vz, newVZ, mask), vPad);
+            StoreTransposed(&store.AngularVelocities[i].x, _mm_blendv_ps(wx, newWX, mask), _mm_blendv_ps(wy, newWY, mask), _mm_blendv_ps(wz, newWZ, mask), wPad);
+            StoreTransposed(&store.Orientations[i].x, _mm_blendv_ps(qx, newQX, mask), _mm_blendv_ps(qy, newQY, mask), _mm_blendv_ps(qz, newQZ, mask), _mm_blendv_ps(qw, newQW, mask));
+        }
+    }
+#endif
+
+    void LumosPhysicsEngine::IntegrateBodies(float dt)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        RigidBodyStore& store     = m_BodyStore;
+        const float damping       = m_DampingFactor;
+        const Vec3 gravityImpulse = m_Gravity * dt;
+
+#ifdef LUMOS_SSE
+        // Explicit Euler turns the angular velocity into a rotation through Euler angles, which has no four wide form
+        if(m_IntegrationType != IntegrationType::EXPLICIT_EULER)
+        {
+            IntegrateBodiesWide(store, m_IntegrationType, gravityImpulse, damping, dt);
+            return;
+        }
+#endif
+
+        const uint32_t bodyCount         = store.Size();
+        const uint32_t* masks            = store.IntegrateMasks.Data();
+        Vec3* positions                  = store.Positions.Data();
+        Quat* orientations               = store.Orientations.Data();
+        Vec3* linearVelocities           = store.LinearVelocities.Data();
+        Vec3* angularVelocities          = store.AngularVelocities.Data();
+        const Vec3* linearAccelerations  = store.LinearAccelerations.Data();
+        const Vec3* angularAccelerations = store.AngularAccelerations.Data();
+        const float* invMasses           = store.InvMasses.Data();
+        const float* factors             = store.AngularFactors.Data();
+
+        // Apply gravity
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            if(masks[i] && invMasses[i] > 0.0f)
+                linearVelocities[i] += gravityImpulse;
+        }
+
+        // The integration type is the same for every body, so branch once outside the loops
+        switch(m_IntegrationType)
+        {
+        case IntegrationType::EXPLICIT_EULER:
+        {
+            for(uint32_t i = 0; i < bodyCount; i++)
             {
+                if(!masks[i])
+                    continue;
+
+                // Update position
+                positions[i] += linearVelocities[i] * dt;
+
                 // Update linear velocity (v = u + at)
-                obj->m_LinearVelocity += obj->m_LinearVelocity * obj->m_InvMass * s_UpdateTimestep;
+                linearVelocities[i] += linearAccelerations[i] * dt;
 
                 // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+                linearVelocities[i] = linearVelocities[i] * damping;
 
-                // Update position
-                obj->m_Position += obj->m_LinearVelocity * s_UpdateTimestep;
+                // Update orientation
+                orientations[i] += orientations[i] * Quat(angularVelocities[i] * dt);
+                orientations[i].Normalise();
 
                 // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+                angularVelocities[i] += angularAccelerations[i] * dt;
 
                 // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping * obj->m_AngularFactor;
-
-                auto angularVelocity = obj->m_AngularVelocity * s_UpdateTimestep;
-
-                // Update orientation
-                obj->m_Orientation += QuatMulVec3(obj->m_Orientation, angularVelocity);
-                obj->m_Orientation.Normalise();
-
-                break;
+                angularVelocities[i] = angularVelocities[i] * damping * factors[i];
             }
+            break;
+        }
 
-            case IntegrationType::RUNGE_KUTTA_2:
+        case IntegrationType::SEMI_IMPLICIT_EULER:
+        {
+            for(uint32_t i = 0; i < bodyCount; i++)
             {
-                // RK2 integration for linear motion
-                Integration::State state = { obj->m_Position, obj->m_LinearVelocity, obj->m_Force * obj->m_InvMass };
-                Integration::RK2(state, 0.0f, s_UpdateTimestep);
+                if(!masks[i])
+                    continue;
 
-                obj->m_Position       = state.position;
-                obj->m_LinearVelocity = state.velocity;
+                // Update linear velocity (v = u + at)
+                linearVelocities[i] += linearVelocities[i] * invMasses[i] * dt;
 
                 // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+                linearVelocities[i] = linearVelocities[i] * damping;
+
+                // Update position
+                positions[i] += linearVelocities[i] * dt;
 
                 // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+                angularVelocities[i] += angularAccelerations[i] * dt;
 
                 // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping * obj->m_AngularFactor;
-
-                auto angularVelocity = obj->m_AngularVelocity * s_UpdateTimestep * 0.5f;
+                angularVelocities[i] = angularVelocities[i] * damping * factors[i];
 
                 // Update orientation
-                obj->m_Orientation += QuatMulVec3(obj->m_Orientation, angularVelocity);
-                obj->m_Orientation.Normalise();
-
-                break;
+                orientations[i] += QuatMulVec3(orientations[i], angularVelocities[i] * dt);
+                orientations[i].Normalise();
             }
+            break;
+        }
 
-            case IntegrationType::RUNGE_KUTTA_4:
+        case IntegrationType::RUNGE_KUTTA_2:
+        case IntegrationType::RUNGE_KUTTA_4:
+        {
+            const bool rk4 = m_IntegrationType == IntegrationType::RUNGE_KUTTA_4;
+            for(uint32_t i = 0; i < bodyCount; i++)
             {
-                // RK4 integration for linear motion
-                Integration::State state = { obj->m_Position, obj->m_LinearVelocity, obj->m_Force * obj->m_InvMass };
-                Integration::RK4(state, 0.0f, s_UpdateTimestep);
-                obj->m_Position       = state.position;
-                obj->m_LinearVelocity = state.velocity;
+                if(!masks[i])
+                    continue;
+
+                // RK integration for linear motion
+                Integration::State state = { positions[i], linearVelocities[i], linearAccelerations[i] };
+                if(rk4)
+                    Integration::RK4(state, 0.0f, dt);
+                else
+                    Integration::RK2(state, 0.0f, dt);
+
+                positions[i] = state.position;
 
                 // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+                linearVelocities[i] = state.velocity * damping;
 
                 // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+                angularVelocities[i] += angularAccelerations[i] * dt;
 
                 // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping * obj->m_AngularFactor;
+                angularVelocities[i] = angularVelocities[i] * damping * factors[i];
 
                 // Update orientation
-                // Check order of quat multiplication
-                auto angularVelocity = obj->m_AngularVelocity * s_UpdateTimestep * 0.5f;
-
-                obj->m_Orientation += QuatMulVec3(obj->m_Orientation, angularVelocity);
-                obj->m_Orientation.Normalise();
-
-                break;
-            }
+                orientations[i] += QuatMulVec3(orientations[i], angularVelocities[i] * dt * 0.5f);
+                orientations[i].Normalise();
             }
-
-            // Mark cached world transform and AABB as invalid
-            obj->m_WSTransformInvalidated = true;
-            obj->m_WSAabbInvalidated      = true;
+            break;
+        }
         }
-
-        ASSERT(obj->m_Orientation.IsValid());
-        ASSERT(obj->m_Position.IsValid());
-
-        s_UpdateTimestep *= m_PositionIterations;
     }
 
     Quat AngularVelcityToQuaternion(const Vec3& angularVelocity)
@@ -411,7 +652,7 @@ namespace Lumos
         LUMOS_PROFILE_FUNCTION();
         m_BroadphaseCollisionPairs.Clear();
         if(m_BroadphaseDetection)
-            m_BroadphaseDetection->FindPotentialCollisionPairs(m_RootBody, m_BroadphaseCollisionPairs, m_RigidBodyCount);
+            m_BroadphaseDetection->FindPotentialCollisionPairs(m_BodyStore.Bodies.Data(), m_BroadphaseCollisionPairs, (uint32_t)m_BodyStore.Bodies.Size());
 
 #ifdef CHECK_COLLISION_PAIR_DUPLICATES
 
@@ -437,100 +678,430 @@ namespace Lumos
 #endif
     }
 
+    const Manifold* LumosPhysicsEngine::FindPreviousManifold(RigidBody3D* bodyA, RigidBody3D* bodyB)
+    {
+        ManifoldKey key       = ManifoldKey::Make(bodyA, bodyB);
+        const uint32_t* index = (const uint32_t*)HashMapFindPtr(&m_ManifoldCache, key);
+        return index ? &m_PreviousManifolds[*index] : nullptr;
+    }
+
     void LumosPhysicsEngine::NarrowPhaseCollisions()
     {
         LUMOS_PROFILE_FUNCTION();
+
+        // Keep last step's manifolds, keyed by body pair, to warm start the pairs that are still touching.
+        // Pairs that stopped touching have no manifold this step so drop out on the next swap
+        Swap(m_Manifolds, m_PreviousManifolds);
+        m_Manifolds.Clear();
+        HashMapClear(&m_ManifoldCache);
+        if(m_WarmStarting)
+        {
+            LUMOS_PROFILE_SCOPE("Build Manifold Cache");
+            for(uint32_t index = 0; index < (uint32_t)m_PreviousManifolds.Size(); index++)
+            {
+                ManifoldKey key = ManifoldKey::Make(m_PreviousManifolds[index].NodeA(), m_PreviousManifolds[index].NodeB());
+                HashMapInsert(&m_ManifoldCache, key, index);
+            }
+        }
+
+        m_Stats.CollisionCount = 0;
+
         if(m_BroadphaseCollisionPairs.Empty())
+        {
+            HashMapClear(&m_SearchAxisCache);
             return;
+        }
+
+        const uint32_t pairCount = (uint32_t)m_BroadphaseCollisionPairs.Size();
+        m_Stats.NarrowPhaseCount = pairCount;
+        m_PairSearchAxes.Resize(pairCount);
 
-        m_Stats.NarrowPhaseCount = (uint32_t)m_BroadphaseCollisionPairs.Size();
-        m_Stats.CollisionCount   = 0;
-        CollisionData colData;
+        // World space transforms are cached lazily, update them here so the jobs below only read them
+        for(RigidBody3D* body : m_BodyStore.Bodies)
+            body->GetWorldSpaceTransform();
+
+        const uint32_t groupCount = System::JobSystem::DispatchGroupCount(pairCount, NARROWPHASE_GROUP_SIZE);
+        if(m_NarrowphaseBuffers.Size() < groupCount)
+            m_NarrowphaseBuffers.Resize(groupCount);
 
-        for(auto& cp : m_BroadphaseCollisionPairs)
         {
-            auto shapeA = cp.pObjectA->GetCollisionShape();
-            auto shapeB = cp.pObjectB->GetCollisionShape();
+            LUMOS_PROFILE_SCOPE("Narrowphase Jobs");
+            System::JobSystem::Context ctx;
+            System::JobSystem::Dispatch(ctx, pairCount, NARROWPHASE_GROUP_SIZE, [&](JobDispatchArgs args)
+                                        {
+                TDArray<NarrowphaseResult>& results = m_NarrowphaseBuffers[args.groupID].Results;
+                if(args.isFirstJobInGroup)
+                    results.Clear();
+
+                const CollisionPair& cp = m_BroadphaseCollisionPairs[args.jobIndex];
+                auto shapeA             = cp.pObjectA->GetCollisionShape();
+                auto shapeB             = cp.pObjectB->GetCollisionShape();
+
+                // Seed GJK with the pair's axis from the last step. The cache is only read here, it is rebuilt after the jobs
+                ManifoldKey key        = ManifoldKey::Make(cp.pObjectA, cp.pObjectB);
+                const Vec3* cachedAxis = (const Vec3*)HashMapFindPtr(&m_SearchAxisCache, key);
+                Vec3& searchAxis       = m_PairSearchAxes[args.jobIndex];
+                searchAxis             = cachedAxis ? (cp.pObjectA < cp.pObjectB ? *cachedAxis : -*cachedAxis) : Vec3(0.0f);
+
+                if(!shapeA || !shapeB)
+                    return;
+
+                // Detects if the objects are colliding
+                CollisionData colData;
+                if(!CollisionDetection::Get().CheckCollision(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), &colData, &searchAxis))
+                    return;
+
+                // Build full collision manifold that will also handle the collision
+                // response between the two objects in the solver stage.
+                // Collision callbacks are fired when the results are merged, so it is built even if a callback later rejects it
+                NarrowphaseResult& result = results.EmplaceBack();
+                result.PairIndex          = args.jobIndex;
+                result.ColData            = colData;
+                result.ContactManifold.Initiate(cp.pObjectA, cp.pObjectB, m_BaumgarteScalar, m_BaumgarteSlop);
+
+                // Construct contact points that form the perimeter of the collision manifold
+                result.HasManifold = CollisionDetection::Get().BuildCollisionManifold(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), colData, &result.ContactManifold);
+
+                // As above, the manifold cache was filled before the jobs started
+                if(result.HasManifold && m_WarmStarting)
+                {
+                    if(const Manifold* previous = FindPreviousManifold(cp.pObjectA, cp.pObjectB))
+                        result.ContactManifold.WarmStart(*previous);
+                } });
+            System::JobSystem::Wait(ctx);
+        }
 
-            if(shapeA && shapeB)
+        // Pairs that leave the broadphase drop out of the cache here
+        {
+            LUMOS_PROFILE_SCOPE("Store Search Axes");
+            HashMapClear(&m_SearchAxisCache);
+            for(uint32_t pairIndex = 0; pairIndex < pairCount; pairIndex++)
             {
+                const CollisionPair& cp = m_BroadphaseCollisionPairs[pairIndex];
+                if(Maths::Length2(m_PairSearchAxes[pairIndex]) < Maths::M_EPSILON)
+                    continue;
 
-                // Broadphase debug draw
-                if(m_DebugDrawFlags & PhysicsDebugFlags::BROADPHASE_PAIRS)
-                {
-                    Vec4 colour = Colour::RandomColour();
-                    DebugRenderer::DrawThickLine(cp.pObjectA->GetPosition(), cp.pObjectB->GetPosition(), 0.02f, false, colour);
-                    DebugRenderer::DrawPoint(cp.pObjectA->GetPosition(), 0.05f, false, colour);
-                    DebugRenderer::DrawPoint(cp.pObjectB->GetPosition(), 0.05f, false, colour);
-                }
+                ManifoldKey key = ManifoldKey::Make(cp.pObjectA, cp.pObjectB);
+                Vec3 axis       = cp.pObjectA < cp.pObjectB ? m_PairSearchAxes[pairIndex] : -m_PairSearchAxes[pairIndex];
+                HashMapInsert(&m_SearchAxisCache, key, axis);
+            }
+        }
+
+        // Broadphase debug draw
+        if(m_DebugDrawFlags & PhysicsDebugFlags::BROADPHASE_PAIRS)
+        {
+            for(auto& cp : m_BroadphaseCollisionPairs)
+            {
+                Vec4 colour = Colour::RandomColour();
+                DebugRenderer::DrawThickLine(cp.pObjectA->GetPosition(), cp.pObjectB->GetPosition(), 0.02f, false, colour);
+                DebugRenderer::DrawPoint(cp.pObjectA->GetPosition(), 0.05f, false, colour);
+                DebugRenderer::DrawPoint(cp.pObjectB->GetPosition(), 0.05f, false, colour);
+            }
+        }
+
+        // Merge the group buffers in pair order, so callbacks and the solver see the same order as a serial narrowphase
+        {
+            LUMOS_PROFILE_SCOPE("Merge Manifolds");
+            size_t resultCount = 0;
+            for(uint32_t groupIndex = 0; groupIndex < groupCount; groupIndex++)
+                resultCount += m_NarrowphaseBuffers[groupIndex].Results.Size();
+
+            // Reserve up front so manifold pointers passed to callbacks stay valid for the rest of the step
+            m_Manifolds.Reserve(resultCount);
 
-                // Detects if the objects are colliding - Seperating Axis Theorem
-                if(CollisionDetection::Get().CheckCollision(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), &colData))
+            for(uint32_t groupIndex = 0; groupIndex < groupCount; groupIndex++)
+            {
+                for(NarrowphaseResult& result : m_NarrowphaseBuffers[groupIndex].Results)
                 {
+                    const CollisionPair& cp = m_BroadphaseCollisionPairs[result.PairIndex];
+
                     // Check to see if any of the objects have collision callbacks that dont
                     // want the objects to physically collide
                     const bool okA = cp.pObjectA->FireOnCollisionEvent(cp.pObjectA, cp.pObjectB);
                     const bool okB = cp.pObjectB->FireOnCollisionEvent(cp.pObjectB, cp.pObjectA);
 
-                    if(okA && okB)
+                    if(!okA || !okB || !result.HasManifold)
+                        continue;
+
+                    if(m_DebugDrawFlags & PhysicsDebugFlags::COLLISIONNORMALS)
                     {
-                        // Build full collision manifold that will also handle the collision
-                        // response between the two objects in the solver stage
-                        m_ManifoldLock.lock();
-                        Manifold& manifold = m_Manifolds[m_ManifoldCount++];
-                        manifold.Initiate(cp.pObjectA, cp.pObjectB, m_BaumgarteScalar, m_BaumgarteSlop);
-
-                        ASSERT(m_ManifoldCount < 1000);
-                        // Construct contact points that form the perimeter of the collision manifold
-                        if(CollisionDetection::Get().BuildCollisionManifold(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), colData, &manifold))
-                        {
-                            if(m_DebugDrawFlags & PhysicsDebugFlags::COLLISIONNORMALS)
-                            {
-                                DebugRenderer::DrawPoint(colData.pointOnPlane, 0.1f, false, Vec4(0.5f, 0.5f, 1.0f, 1.0f), 3.0f);
-                                DebugRenderer::DrawThickLine(colData.pointOnPlane, colData.pointOnPlane - colData.normal * colData.penetration, 0.05f, false, Vec4(0.0f, 0.0f, 1.0f, 1.0f), 3.0f);
-                            }
-
-                            // Fire callback
-                            cp.pObjectA->FireOnCollisionManifoldCallback(cp.pObjectA, cp.pObjectB, &manifold);
-                            cp.pObjectB->FireOnCollisionManifoldCallback(cp.pObjectB, cp.pObjectA, &manifold);
-                            m_Stats.CollisionCount++;
-                        }
-                        else
-                        {
-                            m_ManifoldCount--;
-                        }
-
-                        m_ManifoldLock.unlock();
+                        const CollisionData& colData = result.ColData;
+                        DebugRenderer::DrawPoint(colData.pointOnPlane, 0.1f, false, Vec4(0.5f, 0.5f, 1.0f, 1.0f), 3.0f);
+                        DebugRenderer::DrawThickLine(colData.pointOnPlane, colData.pointOnPlane - colData.normal * colData.penetration, 0.05f, false, Vec4(0.0f, 0.0f, 1.0f, 1.0f), 3.0f);
                     }
+
+                    m_Manifolds.PushBack(result.ContactManifold);
+                    Manifold& manifold = m_Manifolds.Back();
+
+                    // Fire callback
+                    cp.pObjectA->FireOnCollisionManifoldCallback(cp.pObjectA, cp.pObjectB, &manifold);
+                    cp.pObjectB->FireOnCollisionManifoldCallback(cp.pObjectB, cp.pObjectA, &manifold);
+                    m_Stats.CollisionCount++;
                 }
             }
         }
     }
 
+    void LumosPhysicsEngine::BuildIslands()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        const uint32_t bodyCount = (uint32_t)m_BodyStore.Bodies.Size();
+
+        // Static bodies do not join islands, otherwise the ground would connect everything
+        m_IslandParents.Resize(bodyCount);
+        for(uint32_t i = 0; i < bodyCount; i++)
+            m_IslandParents[i] = m_BodyStore.Bodies[i]->m_Static ? ISLAND_NONE : i;
+
+        auto GetBodyIndex        = [&](RigidBody3D* body) -> uint32_t
+        {
+            // Constraints can outlive their bodies, only trust indices that map back to the body
+            if(!body || body->m_BodyIndex >= bodyCount || m_BodyStore.Bodies[body->m_BodyIndex] != body)
+                return ISLAND_NONE;
+            return body->m_BodyIndex;
+        };
+
+        // Constraints can move static bodies (welds set positions directly), so their bodies always join
+        for(uint32_t index = 0; index < m_ConstraintCount; index++)
+        {
+            const uint32_t bodyA = GetBodyIndex(m_Constraints[index]->GetBodyA());
+            const uint32_t bodyB = GetBodyIndex(m_Constraints[index]->GetBodyB());
+
+            if(bodyA != ISLAND_NONE && m_IslandParents[bodyA] == ISLAND_NONE)
+                m_IslandParents[bodyA] = bodyA;
+            if(bodyB != ISLAND_NONE && m_IslandParents[bodyB] == ISLAND_NONE)
+                m_IslandParents[bodyB] = bodyB;
+            if(bodyA != ISLAND_NONE && bodyB != ISLAND_NONE)
+                UnionIslands(m_IslandParents, bodyA, bodyB);
+        }
+
+        for(Manifold& manifold : m_Manifolds)
+        {
+            const uint32_t bodyA = manifold.NodeA()->m_BodyIndex;
+            const uint32_t bodyB = manifold.NodeB()->m_BodyIndex;
+            if(m_IslandParents[bodyA] != ISLAND_NONE && m_IslandParents[bodyB] != ISLAND_NONE)
+                UnionIslands(m_IslandParents, bodyA, bodyB);
+        }
+
+        // Number the islands in order of their root body and count their contents
+        m_Islands.Clear();
+        m_BodyIslands.Resize(bodyCount);
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            if(m_IslandParents[i] == ISLAND_NONE)
+            {
+                m_BodyIslands[i] = ISLAND_NONE;
+                continue;
+            }
+
+            const uint32_t root = FindIslandRoot(m_IslandParents, i);
+            if(root == i)
+            {
+                m_BodyIslands[i]         = (uint32_t)m_Islands.Size();
+                SimulationIsland& island = m_Islands.EmplaceBack();
+                island                   = {};
+            }
+            else
+            {
+                // Roots have the lowest index in their island so are always numbered first
+                m_BodyIslands[i] = m_BodyIslands[root];
+            }
+
+            SimulationIsland& island = m_Islands[m_BodyIslands[i]];
+            island.BodyCount++;
+            if(!m_BodyStore.Bodies[i]->m_Static)
+            {
+                island.HasDynamicBodies = true;
+                if(m_BodyStore.Bodies[i]->IsAwake())
+                    island.Awake = true;
+            }
+        }
+
+        // Constraints between static bodies can never fall asleep
+        for(SimulationIsland& island : m_Islands)
+        {
+            if(!island.HasDynamicBodies)
+                island.Awake = true;
+        }
+
+        auto GetManifoldIsland = [&](const Manifold& manifold) -> uint32_t
+        {
+            const uint32_t islandA = m_BodyIslands[manifold.NodeA()->m_BodyIndex];
+            return islandA != ISLAND_NONE ? islandA : m_BodyIslands[manifold.NodeB()->m_BodyIndex];
+        };
+
+        auto GetConstraintIsland = [&](const Constraint* constraint) -> uint32_t
+        {
+            const uint32_t bodyA = GetBodyIndex(constraint->GetBodyA());
+            if(bodyA != ISLAND_NONE)
+                return m_BodyIslands[bodyA];
+            const uint32_t bodyB = GetBodyIndex(constraint->GetBodyB());
+            return bodyB != ISLAND_NONE ? m_BodyIslands[bodyB] : ISLAND_NONE;
+        };
+
+        for(const Manifold& manifold : m_Manifolds)
+        {
+            // Manifolds between two static bodies have nothing to solve
+            const uint32_t island = GetManifoldIsland(manifold);
+            if(island != ISLAND_NONE)
+                m_Islands[island].ManifoldCount++;
+        }
+
+        m_UnassignedConstraints.Clear();
+        for(uint32_t index = 0; index < m_ConstraintCount; index++)
+        {
+            const uint32_t island = GetConstraintIsland(m_Constraints[index].get());
+            if(island != ISLAND_NONE)
+                m_Islands[island].ConstraintCount++;
+            else
+                m_UnassignedConstraints.PushBack(index);
+        }
+
+        // Prefix sums, then scatter everything into island order. Counts are rebuilt while scattering
+        uint32_t bodyOffset = 0, manifoldOffset = 0, constraintOffset = 0;
+        for(SimulationIsland& island : m_Islands)
+        {
+            island.BodyOffset       = bodyOffset;
+            island.ManifoldOffset   = manifoldOffset;
+            island.ConstraintOffset = constraintOffset;
+            bodyOffset += island.BodyCount;
+            manifoldOffset += island.ManifoldCount;
+            constraintOffset += island.ConstraintCount;
+            island.BodyCount       = 0;
+            island.ManifoldCount   = 0;
+            island.ConstraintCount = 0;
+        }
+
+        m_IslandBodies.Resize(bodyOffset);
+        m_IslandManifolds.Resize(manifoldOffset);
+        m_IslandConstraints.Resize(constraintOffset);
+
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            if(m_BodyIslands[i] == ISLAND_NONE)
+                continue;
+
+            SimulationIsland& island = m_Islands[m_BodyIslands[i]];
+            m_IslandBodies[island.BodyOffset + island.BodyCount++] = m_BodyStore.Bodies[i];
+        }
+
+        for(uint32_t index = 0; index < (uint32_t)m_Manifolds.Size(); index++)
+        {
+            const uint32_t islandIndex = GetManifoldIsland(m_Manifolds[index]);
+            if(islandIndex == ISLAND_NONE)
+                continue;
+
+            SimulationIsland& island = m_Islands[islandIndex];
+            m_IslandManifolds[island.ManifoldOffset + island.ManifoldCount++] = index;
+        }
+
+        for(uint32_t index = 0; index < m_ConstraintCount; index++)
+        {
+            const uint32_t islandIndex = GetConstraintIsland(m_Constraints[index].get());
+            if(islandIndex == ISLAND_NONE)
+                continue;
+
+            SimulationIsland& island = m_Islands[islandIndex];
+            m_IslandConstraints[island.ConstraintOffset + island.ConstraintCount++] = index;
+        }
+
+        m_Stats.IslandCount = (uint32_t)m_Islands.Size();
+    }
+
     void LumosPhysicsEngine::SolveConstraints()
     {
         LUMOS_PROFILE_FUNCTION();
 
+        // Sleeping islands and islands without contacts or constraints are skipped
+        m_ActiveIslands.Clear();
+        for(uint32_t index = 0; index < (uint32_t)m_Islands.Size(); index++)
         {
-            LUMOS_PROFILE_SCOPE("Solve Manifolds");
-            for(uint32_t index = 0; index < m_ManifoldCount; index++)
-                m_Manifolds[index].PreSolverStep(s_UpdateTimestep);
+            const SimulationIsland& island = m_Islands[index];
+            if(island.Awake && island.ManifoldCount + island.ConstraintCount > 0)
+                m_ActiveIslands.PushBack(index);
         }
+
+        auto SolveIsland = [&](const SimulationIsland& island)
         {
-            LUMOS_PROFILE_SCOPE("Solve Constraints");
-            for(uint32_t index = 0; index < m_ConstraintCount; index++)
+            const uint32_t* manifolds   = m_IslandManifolds.Data() + island.ManifoldOffset;
+            const uint32_t* constraints = m_IslandConstraints.Data() + island.ConstraintOffset;
+
+            for(uint32_t i = 0; i < island.ManifoldCount; i++)
+                m_Manifolds[manifolds[i]].PreSolverStep();
+
+            for(uint32_t i = 0; i < island.ConstraintCount; i++)
+                m_Constraints[constraints[i]]->PreSolverStep(s_UpdateTimestep);
+
+            // Only once every contact has taken its bounce from the unsolved velocities
+            for(uint32_t i = 0; i < island.ManifoldCount; i++)
+                m_Manifolds[manifolds[i]].ApplyWarmStart();
+
+            for(uint32_t iteration = 0; iteration < m_VelocityIterations; iteration++)
+            {
+                for(uint32_t i = 0; i < island.ManifoldCount; i++)
+                    m_Manifolds[manifolds[i]].ApplyImpulse();
+
+                for(uint32_t i = 0; i < island.ConstraintCount; i++)
+                    m_Constraints[constraints[i]]->ApplyImpulse();
+            }
+        };
+
+        {
+            LUMOS_PROFILE_SCOPE("Solve Islands");
+            if(m_ActiveIslands.Size() == 1)
+            {
+                SolveIsland(m_Islands[m_ActiveIslands[0]]);
+            }
+            else if(m_ActiveIslands.Size() > 1)
+            {
+                System::JobSystem::Context ctx;
+                System::JobSystem::Dispatch(ctx, (uint32_t)m_ActiveIslands.Size(), 1, [&](JobDispatchArgs args)
+                                            { SolveIsland(m_Islands[m_ActiveIslands[args.jobIndex]]); });
+                System::JobSystem::Wait(ctx);
+            }
+        }
+
+        if(!m_UnassignedConstraints.Empty())
+        {
+            LUMOS_PROFILE_SCOPE("Solve Unassigned Constraints");
+            for(uint32_t index : m_UnassignedConstraints)
                 m_Constraints[index]->PreSolverStep(s_UpdateTimestep);
+
+            for(uint32_t iteration = 0; iteration < m_VelocityIterations; iteration++)
+            {
+                for(uint32_t index : m_UnassignedConstraints)
+                    m_Constraints[index]->ApplyImpulse();
+            }
         }
+    }
+
+    void LumosPhysicsEngine::UpdateIslandSleep()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        m_Stats.SleepingIslandCount = 0;
+        for(const SimulationIsland& island : m_Islands)
         {
-            LUMOS_PROFILE_SCOPE("Apply Impulses");
+            if(!island.HasDynamicBodies)
+                continue;
+
+            RigidBody3D** bodies = m_IslandBodies.Data() + island.BodyOffset;
 
-            for(uint32_t i = 0; i < m_VelocityIterations; i++)
+            bool awake = false;
+            for(uint32_t i = 0; i < island.BodyCount && !awake; i++)
+                awake = !bodies[i]->m_Static && bodies[i]->IsAwake();
+
+            if(!awake)
             {
-                for(uint32_t index = 0; index < m_ManifoldCount; index++)
-                    m_Manifolds[index].ApplyImpulse();
+                m_Stats.SleepingIslandCount++;
+                continue;
+            }
 
-                for(uint32_t index = 0; index < m_ConstraintCount; index++)
-                    m_Constraints[index]->ApplyImpulse();
+            // Bodies that passed their own rest test stay awake until the whole island can sleep
+            for(uint32_t i = 0; i < island.BodyCount; i++)
+            {
+                if(!bodies[i]->m_Static)
+                    bodies[i]->WakeUp();
             }
         }
     }
@@ -567,6 +1138,8 @@ namespace Lumos
             return "Sort and Sweap";
         case BroadphaseType::OCTREE:
             return "Octree";
+        case BroadphaseType::DYNAMIC_TREE:
+            return "Dynamic Tree";
         default:
             return "";
         }
@@ -580,12 +1153,17 @@ namespace Lumos
         switch(type)
         {
         case BroadphaseType::SORT_AND_SWEAP:
+            m_BroadphaseDetection = Lumos::CreateSharedPtr<SortAndSweepBroadphase>();
+            break;
         case BroadphaseType::BRUTE_FORCE:
             m_BroadphaseDetection = Lumos::CreateSharedPtr<BruteForceBroadphase>();
             break;
         case BroadphaseType::OCTREE:
             m_BroadphaseDetection = Lumos::CreateSharedPtr<OctreeBroadphase>(5, 8);
             break;
+        case BroadphaseType::DYNAMIC_TREE:
+            m_BroadphaseDetection = Lumos::CreateSharedPtr<DynamicTreeBroadphase>();
+            break;
         default:
             m_BroadphaseDetection = Lumos::CreateSharedPtr<BruteForceBroadphase>();
             break;
@@ -619,6 +1197,8 @@ namespace Lumos
         ImGuiUtilities::Property("Collision Count", m_Stats.CollisionCount, ImGuiUtilities::PropertyFlag::ReadOnly);
         ImGuiUtilities::Property("NarrowPhase Count", m_Stats.NarrowPhaseCount, ImGuiUtilities::PropertyFlag::ReadOnly);
         ImGuiUtilities::Property("Constraint Count", m_Stats.ConstraintCount, ImGuiUtilities::PropertyFlag::ReadOnly);
+        ImGuiUtilities::Property("Island Count", m_Stats.IslandCount, ImGuiUtilities::PropertyFlag::ReadOnly);
+        ImGuiUtilities::Property("Sleeping Island Count", m_Stats.SleepingIslandCount, ImGuiUtilities::PropertyFlag::ReadOnly);
 
         ImGui::AlignTextToFramePadding();
         ImGui::TextUnformatted("Paused");
@@ -644,6 +1224,12 @@ namespace Lumos
         ImGui::PopItemWidth();
         ImGui::NextColumn();
 
+        ImGuiUtilities::Property("Warm Starting", m_WarmStarting);
+
+        bool gjkNarrowphase = CollisionDetection::Get().GetGJKEnabled();
+        if(ImGuiUtilities::Property("GJK Narrowphase", gjkNarrowphase))
+            CollisionDetection::Get().SetGJKEnabled(gjkNarrowphase);
+
         ImGui::AlignTextToFramePadding();
         ImGui::TextUnformatted("Integration Type");
         ImGui::NextColumn();
@@ -682,12 +1268,12 @@ namespace Lumos
         LUMOS_PROFILE_FUNCTION_LOW();
         if(m_DebugDrawFlags & PhysicsDebugFlags::MANIFOLD)
         {
-            for(uint32_t index = 0; index < m_ManifoldCount; index++)
-                m_Manifolds[index].DebugDraw();
+            for(const Manifold& manifold : m_Manifolds)
+                manifold.DebugDraw();
         }
 
         if(m_IsPaused)
-            m_ManifoldCount = 0;
+            m_Manifolds.Clear();
 
         // Draw all constraints
         if(m_DebugDrawFlags & PhysicsDebugFlags::CONSTRAINT)
@@ -699,13 +1285,11 @@ namespace Lumos
         if(!m_IsPaused && m_BroadphaseDetection && (m_DebugDrawFlags & PhysicsDebugFlags::BROADPHASE))
             m_BroadphaseDetection->DebugDraw();
 
-        RigidBody3D* current = m_RootBody;
-        while(current)
+        for(RigidBody3D* body : m_BodyStore.Bodies)
         {
-            current->DebugDraw(m_DebugDrawFlags);
-            if(current->GetCollisionShape() && (m_DebugDrawFlags & PhysicsDebugFlags::COLLISIONVOLUMES))
-                current->GetCollisionShape()->DebugDraw(current);
-            current = current->m_Next;
+            body->DebugDraw(m_DebugDrawFlags);
+            if(body->GetCollisionShape() && (m_DebugDrawFlags & PhysicsDebugFlags::COLLISIONVOLUMES))
+                body->GetCollisionShape()->DebugDraw(body);
         }
     }
 }
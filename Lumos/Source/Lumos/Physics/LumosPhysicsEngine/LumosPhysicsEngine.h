@@ -3,8 +3,10 @@
 #include "Utilities/TSingleton.h"
 #include "Narrowphase/Manifold.h"
 #include "Broadphase/Broadphase.h"
+#include "RigidBodyStore.h"
 #include "Scene/ISystem.h"
 #include "Core/OS/Allocators/PoolAllocator.h"
+#include "Core/DataStructures/Map.h"
 
 namespace Lumos
 {
@@ -23,6 +25,7 @@ namespace Lumos
         BRUTE_FORCE    = 0,
         SORT_AND_SWEAP = 1,
         OCTREE         = 2,
+        DYNAMIC_TREE   = 3,
     };
 
     enum PhysicsDebugFlags : uint32_t
@@ -42,6 +45,8 @@ namespace Lumos
     class Constraint;
     class TimeStep;
     class Scene;
+    struct NarrowphaseBuffer;
+    struct SimulationIsland;
 
     struct PhysicsStats3D
     {
@@ -51,6 +56,8 @@ namespace Lumos
         uint32_t StaticCount;
         uint32_t ConstraintCount;
         uint32_t NarrowPhaseCount;
+        uint32_t IslandCount;
+        uint32_t SleepingIslandCount;
     };
 
     struct LumosPhysicsEngineConfig
@@ -63,6 +70,8 @@ namespace Lumos
         float BaumgarteScalar      = 0.3f;   // Amount of force to add to the System to solve error
         float BaumgarteSlop        = 0.001f; // Amount of allowed penetration, ensures a complete manifold each frame
         float PenetrationSlop      = 0.02f;  // How much bodies are allowed to sink into each other in meters
+        bool WarmStarting          = true;   // Start each contact from the impulses it needed last step
+        bool GJKNarrowphase        = false;  // Test polyhedron pairs with GJK/EPA instead of the separating axis test
     };
 
     class LUMOS_EXPORT LumosPhysicsEngine : public ISystem
@@ -119,11 +128,19 @@ namespace Lumos
         uint32_t GetPositionIterations() const { return m_PositionIterations; }
         void SetPositionIterations(uint32_t iterations) { m_PositionIterations = iterations; }
 
+        bool GetWarmStarting() const { return m_WarmStarting; }
+        void SetWarmStarting(bool enabled) { m_WarmStarting = enabled; }
+
         RigidBody3D* CreateBody(const RigidBody3DProperties& properties = {});
         void DestroyBody(RigidBody3D* body);
 
         const PhysicsStats3D& GetStats() const { return m_Stats; }
 
+        // Scene queries against body AABBs as of the last physics step. Uses the broadphase when it
+        // supports them, otherwise tests every body
+        void QueryAABB(const Maths::BoundingBox& box, TDArray<RigidBody3D*>& bodies);
+        bool Raycast(const Maths::Ray& ray, float maxDistance, RaycastHit& hit);
+
     protected:
         // The actual time-independant update function
         void UpdatePhysics();
@@ -134,13 +151,24 @@ namespace Lumos
         // Handles narrowphase collision detection
         void NarrowPhaseCollisions();
 
+        // Last step's manifold for the same pair of bodies, or nullptr
+        const Manifold* FindPreviousManifold(RigidBody3D* bodyA, RigidBody3D* bodyB);
+
         // Updates all Rigid Body position, orientation, velocity etc (default method uses symplectic euler integration)
         void UpdateRigidBodys();
-        void UpdateRigidBody(RigidBody3D* obj) const;
 
-        // Solves all engine constraints (constraints and manifolds)
+        // One position iteration over the bodies UpdateRigidBodys marked in m_BodyStore.IntegrateMasks
+        void IntegrateBodies(float dt);
+
+        // Groups bodies connected by contacts or constraints into islands using union-find
+        void BuildIslands();
+
+        // Solves all engine constraints (constraints and manifolds). Awake islands are solved in parallel
         void SolveConstraints();
 
+        // An island only sleeps once all of its bodies are at rest, otherwise the whole island is woken
+        void UpdateIslandSleep();
+
     protected:
         bool m_IsPaused;
         float m_UpdateAccum;
@@ -149,18 +177,41 @@ namespace Lumos
         uint32_t m_MaxUpdatesPerFrame = 5;
         uint32_t m_PositionIterations = 2;
         uint32_t m_VelocityIterations = 10;
-
-        uint32_t m_RigidBodyCount = 0;
+        bool m_WarmStarting           = true;
 
         float m_BaumgarteScalar = 0.2f;   // Amount of force to add to the System to solve error
         float m_BaumgarteSlop   = 0.001f; // Amount of allowed penetration, ensures a complete manifold each frame
 
         TDArray<CollisionPair> m_BroadphaseCollisionPairs;
-        SharedPtr<Constraint>* m_Constraints; // Misc constraints between pairs of objects
-        Manifold* m_Manifolds;                // Contact constraints between pairs of objects
-        std::mutex m_ManifoldsMutex;
+        SharedPtr<Constraint>* m_Constraints;            // Misc constraints between pairs of objects
+        TDArray<Manifold> m_Manifolds;                   // Contact constraints between pairs of objects
+        TDArray<Manifold> m_PreviousManifolds;           // Last step's manifolds, warm start the pairs still touching
+
+        // Body pair, lowest address first
+        struct ManifoldKey
+        {
+            RigidBody3D* BodyA;
+            RigidBody3D* BodyB;
+
+            static ManifoldKey Make(RigidBody3D* bodyA, RigidBody3D* bodyB)
+            {
+                return bodyA < bodyB ? ManifoldKey { bodyA, bodyB } : ManifoldKey { bodyB, bodyA };
+            }
+        };
+        HashMap(ManifoldKey, uint32_t) m_ManifoldCache = {}; // Index of each pair's manifold in m_PreviousManifolds
+        HashMap(ManifoldKey, Vec3) m_SearchAxisCache   = {}; // Last step's GJK axis for each broadphase pair, from BodyA towards BodyB
+        TDArray<Vec3> m_PairSearchAxes;                      // This step's axis for each broadphase pair, written by the narrowphase jobs
+        TDArray<NarrowphaseBuffer> m_NarrowphaseBuffers; // Per job group narrowphase output, merged into m_Manifolds
+
+        TDArray<SimulationIsland> m_Islands;
+        TDArray<uint32_t> m_IslandParents;         // Union-find forest over m_BodyStore.Bodies
+        TDArray<uint32_t> m_BodyIslands;           // Island of each indexed body, or ISLAND_NONE
+        TDArray<RigidBody3D*> m_IslandBodies;      // Bodies grouped by island
+        TDArray<uint32_t> m_IslandManifolds;       // Manifold indices grouped by island
+        TDArray<uint32_t> m_IslandConstraints;     // Constraint indices grouped by island
+        TDArray<uint32_t> m_UnassignedConstraints; // Constraints that do not report their bodies
+        TDArray<uint32_t> m_ActiveIslands;
 
-        uint32_t m_ManifoldCount   = 0;
         uint32_t m_ConstraintCount = 0;
 
         SharedPtr<Broadphase> m_BroadphaseDetection;
@@ -168,9 +219,8 @@ namespace Lumos
         IntegrationType m_IntegrationType;
 
         uint32_t m_DebugDrawFlags = 0;
-        std::mutex m_ManifoldLock;
 
-        RigidBody3D* m_RootBody;
+        RigidBodyStore m_BodyStore; // Packed, indexed by RigidBody3D::m_BodyIndex
         PoolAllocator<RigidBody3D>* m_Allocator;
         Arena* m_Arena;
 
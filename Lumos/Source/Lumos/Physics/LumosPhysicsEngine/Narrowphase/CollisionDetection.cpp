@@ -5,10 +5,15 @@
 #include "Physics/LumosPhysicsEngine/CollisionShapes/PyramidCollisionShape.h"
 #include "Physics/LumosPhysicsEngine/CollisionShapes/HullCollisionShape.h"
 #include "Physics/LumosPhysicsEngine/CollisionShapes/CapsuleCollisionShape.h"
+#include "GJK.h"
 #include "Maths/MathsUtilities.h"
 
 namespace Lumos
 {
+    // How far a face normal may be from the EPA normal, and how much deeper it may be, for it to be used instead
+    static const float FACE_AXIS_MIN_COS   = 0.99f;
+    static const float FACE_AXIS_TOLERANCE = 0.005f;
+
     CollisionDetection::CollisionDetection()
     {
         m_MaxSize                 = CollisionShapeTypeMax | (CollisionShapeTypeMax >> 1);
@@ -32,20 +37,38 @@ namespace Lumos
         m_CollisionCheckFunctions[CollisionCapsule | CollisionHull]    = &CollisionDetection::CheckPolyhedronCapsuleCheckCollision;
     }
 
-    bool CollisionDetection::CheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    void CollisionDetection::SetGJKEnabled(bool enabled)
+    {
+        m_GJKEnabled = enabled;
+
+        const CollisionCheckFunc polyhedron = enabled ? &CollisionDetection::CheckPolyhedronGJKCollision : &CollisionDetection::CheckPolyhedronCollision;
+        const CollisionCheckFunc capsule    = enabled ? &CollisionDetection::CheckPolyhedronGJKCollision : &CollisionDetection::CheckPolyhedronCapsuleCheckCollision;
+
+        m_CollisionCheckFunctions[CollisionCuboid]                     = polyhedron;
+        m_CollisionCheckFunctions[CollisionPyramid]                    = polyhedron;
+        m_CollisionCheckFunctions[CollisionHull]                       = polyhedron;
+        m_CollisionCheckFunctions[CollisionCuboid | CollisionPyramid]  = polyhedron;
+        m_CollisionCheckFunctions[CollisionCuboid | CollisionHull]     = polyhedron;
+        m_CollisionCheckFunctions[CollisionPyramid | CollisionHull]    = polyhedron;
+        m_CollisionCheckFunctions[CollisionCapsule | CollisionCuboid]  = capsule;
+        m_CollisionCheckFunctions[CollisionCapsule | CollisionPyramid] = capsule;
+        m_CollisionCheckFunctions[CollisionCapsule | CollisionHull]    = capsule;
+    }
+
+    bool CollisionDetection::CheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         ASSERT(((shape1->GetType() | shape2->GetType()) < m_MaxSize), "Invalid collision func %i, %i, %i, %i", (int)shape1->GetType(), (int)shape2->GetType(), (int)shape2->GetType() | (int)shape2->GetType(), m_MaxSize);
-        return CALL_MEMBER_FN(*this, m_CollisionCheckFunctions[shape1->GetType() | shape2->GetType()])(obj1, obj2, shape1, shape2, out_coldata);
+        return CALL_MEMBER_FN(*this, m_CollisionCheckFunctions[shape1->GetType() | shape2->GetType()])(obj1, obj2, shape1, shape2, out_coldata, searchAxis);
     }
 
-    bool CollisionDetection::InvalidCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    bool CollisionDetection::InvalidCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LFATAL("Invalid Collision type specified");
         return false;
     }
 
-    bool CollisionDetection::CheckSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    bool CollisionDetection::CheckSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         ASSERT(shape1->GetType() == CollisionShapeType::CollisionSphere && shape2->GetType() == CollisionShapeType::CollisionSphere, "Both shapes are not spheres");
@@ -89,7 +112,7 @@ namespace Lumos
         possibleCollisionAxes[possibleCollisionAxesCount++] = axis;
     }
 
-    bool CollisionDetection::CheckPolyhedronSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    bool CollisionDetection::CheckPolyhedronSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         ASSERT(shape1->GetType() == CollisionShapeType::CollisionSphere || shape2->GetType() == CollisionShapeType::CollisionSphere, "No sphere collision shape");
@@ -115,21 +138,25 @@ namespace Lumos
         CollisionData best_colData;
         best_colData.penetration = -FLT_MAX;
 
-        TDArray<Vec3>& shapeCollisionAxes           = complexShape->GetCollisionAxes(complexObj);
-        TDArray<CollisionEdge>& complex_shape_edges = complexShape->GetEdges(complexObj);
+        ArenaTemp scratch = ScratchBegin(nullptr, 0);
+        TDArray<Vec3> shapeCollisionAxes(scratch.arena);
+        TDArray<CollisionEdge> complex_shape_edges(scratch.arena);
+        complexShape->GetCollisionAxes(complexObj, shapeCollisionAxes);
+        complexShape->GetEdges(complexObj, complex_shape_edges);
 
         Vec3 p   = GetClosestPointOnEdges(sphereObj->GetPosition(), complex_shape_edges);
         Vec3 p_t = sphereObj->GetPosition() - p;
         p_t.Normalise();
 
         static const int MAX_COLLISION_AXES = 100;
-        static Vec3 possibleCollisionAxes[MAX_COLLISION_AXES];
+        Vec3 possibleCollisionAxes[MAX_COLLISION_AXES];
 
         uint32_t possibleCollisionAxesCount = 0;
         for(const Vec3& axis : shapeCollisionAxes)
         {
             possibleCollisionAxes[possibleCollisionAxesCount++] = axis;
         }
+        ScratchEnd(scratch);
 
         AddPossibleCollisionAxis(p_t, possibleCollisionAxes, possibleCollisionAxesCount);
 
@@ -149,18 +176,21 @@ namespace Lumos
         return true;
     }
 
-    bool CollisionDetection::CheckPolyhedronCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    bool CollisionDetection::CheckPolyhedronCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         CollisionData cur_colData;
         CollisionData best_colData;
         best_colData.penetration = -FLT_MAX;
 
-        TDArray<Vec3>& shape1CollisionAxes         = shape1->GetCollisionAxes(obj1);
-        TDArray<Vec3>& shape2PossibleCollisionAxes = shape2->GetCollisionAxes(obj2);
+        ArenaTemp scratch = ScratchBegin(nullptr, 0);
+        TDArray<Vec3> shape1CollisionAxes(scratch.arena);
+        TDArray<Vec3> shape2PossibleCollisionAxes(scratch.arena);
+        shape1->GetCollisionAxes(obj1, shape1CollisionAxes);
+        shape2->GetCollisionAxes(obj2, shape2PossibleCollisionAxes);
 
         static const int MAX_COLLISION_AXES = 100;
-        static Vec3 possibleCollisionAxes[MAX_COLLISION_AXES];
+        Vec3 possibleCollisionAxes[MAX_COLLISION_AXES];
 
         uint32_t possibleCollisionAxesCount = 0;
         for(const Vec3& axis : shape1CollisionAxes)
@@ -172,9 +202,7 @@ namespace Lumos
         {
             possibleCollisionAxes[possibleCollisionAxesCount++] = axis;
         }
-
-        TDArray<CollisionEdge>& shape1_edges = shape1->GetEdges(obj1);
-        TDArray<CollisionEdge>& shape2_edges = shape2->GetEdges(obj2);
+        ScratchEnd(scratch);
 
         for(uint32_t i = 0; i < possibleCollisionAxesCount; i++)
         {
@@ -192,6 +220,68 @@ namespace Lumos
         return true;
     }
 
+    bool CollisionDetection::CheckPolyhedronGJKCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+        const ConvexSupport support1(obj1, shape1);
+        const ConvexSupport support2(obj2, shape2);
+
+        // Start from the pair's axis from the last step if there is one, otherwise from the line between the bodies
+        Vec3 axis = searchAxis && Maths::Length2(*searchAxis) > Maths::M_EPSILON ? *searchAxis : obj2->GetPosition() - obj1->GetPosition();
+
+        GJKSimplex simplex;
+        const bool overlap = GJK::Intersect(support1, support2, axis, simplex);
+
+        CollisionData colData;
+        float depth;
+        Vec3 pointOnA;
+        if(!overlap || !GJK::Penetration(support1, support2, simplex, colData.normal, depth, pointOnA))
+        {
+            if(searchAxis)
+                *searchAxis = axis;
+            return false;
+        }
+
+        // Same convention as the separating axis tests, penetration is negative and the point lies on obj2's surface
+        colData.penetration  = -depth;
+        colData.pointOnPlane = pointOnA - colData.normal * depth;
+
+        // For two nearly parallel faces EPA's exact answer can be a slightly tilted edge/edge direction. Clipping
+        // and resting stacks do much better with a face normal, so take a face axis of either shape close to it
+        // if it separates them almost as cheaply
+        ArenaTemp scratch = ScratchBegin(nullptr, 0);
+        TDArray<Vec3> faceAxes(scratch.arena);
+        shape1->GetCollisionAxes(obj1, faceAxes);
+
+        TDArray<Vec3> shape2Axes(scratch.arena);
+        shape2->GetCollisionAxes(obj2, shape2Axes);
+        for(const Vec3& shape2Axis : shape2Axes)
+            faceAxes.PushBack(shape2Axis);
+
+        float bestDepth = depth + FACE_AXIS_TOLERANCE;
+        for(const Vec3& faceAxis : faceAxes)
+        {
+            CollisionData faceData;
+            if(Maths::Abs(Maths::Dot(faceAxis, colData.normal)) < FACE_AXIS_MIN_COS || !CheckCollisionAxis(faceAxis, obj1, obj2, shape1, shape2, &faceData))
+                continue;
+
+            if(Maths::Dot(faceData.normal, colData.normal) > 0.0f && -faceData.penetration <= bestDepth)
+            {
+                bestDepth = -faceData.penetration;
+                colData   = faceData;
+            }
+        }
+        ScratchEnd(scratch);
+
+        if(searchAxis)
+            *searchAxis = colData.normal;
+
+        if(out_coldata)
+            *out_coldata = colData;
+
+        return true;
+    }
+
     float PlaneSegmentIntersection(const Vec3& segA, const Vec3& segB, const float planeD, const Vec3& planeNormal)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
@@ -221,7 +311,7 @@ namespace Lumos
         return (Maths::Length(Maths::Cross((point - linePointA), (point - linePointB)))) / distAB;
     }
 
-    bool CollisionDetection::CheckCapsuleCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    bool CollisionDetection::CheckCapsuleCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         CapsuleCollisionShape* capsuleShape1 = static_cast<CapsuleCollisionShape*>(shape1);
@@ -326,7 +416,7 @@ namespace Lumos
                 float correlation1 = Maths::Dot(normalWorld, Vec3(contactPointACapsule1Local));
                 float correlation2 = Maths::Dot(normalWorld, Vec3(contactPointBCapsule1Local));
 
-                static bool flipNormal = false;
+                // bool flipNormal = false;
                 // flipNormal = !flipNormal;
                 // if(correlation1 <= correlation2)
                 //  if(Maths::Length(normalWorld, p2 - p1) < 0.0f)
@@ -464,7 +554,7 @@ namespace Lumos
         return false;
     }
 
-    bool CollisionDetection::CheckCapsuleSphereCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    bool CollisionDetection::CheckCapsuleSphereCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         ASSERT(shape1->GetType() == CollisionShapeType::CollisionSphere || shape2->GetType() == CollisionShapeType::CollisionSphere, "Both shapes are not spheres");
@@ -586,7 +676,7 @@ namespace Lumos
         return false;
     }
 
-    bool CollisionDetection::CheckPolyhedronCapsuleCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
+    bool CollisionDetection::CheckPolyhedronCapsuleCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
         CollisionShape* complexShape;
@@ -613,21 +703,25 @@ namespace Lumos
         CollisionData best_colData;
         best_colData.penetration = -FLT_MAX;
 
-        TDArray<Vec3>& shapeCollisionAxes           = complexShape->GetCollisionAxes(complexObj);
-        TDArray<CollisionEdge>& complex_shape_edges = complexShape->GetEdges(complexObj);
+        ArenaTemp scratch = ScratchBegin(nullptr, 0);
+        TDArray<Vec3> shapeCollisionAxes(scratch.arena);
+        TDArray<CollisionEdge> complex_shape_edges(scratch.arena);
+        complexShape->GetCollisionAxes(complexObj, shapeCollisionAxes);
+        complexShape->GetEdges(complexObj, complex_shape_edges);
 
         Vec3 p   = GetClosestPointOnEdges(capsuleObj->GetPosition(), complex_shape_edges);
         Vec3 p_t = capsuleObj->GetPosition() - p;
         p_t.Normalise();
 
         static const int MAX_COLLISION_AXES = 100;
-        static Vec3 possibleCollisionAxes[MAX_COLLISION_AXES];
+        Vec3 possibleCollisionAxes[MAX_COLLISION_AXES];
 
         uint32_t possibleCollisionAxesCount = 0;
         for(const Vec3& axis : shapeCollisionAxes)
         {
             possibleCollisionAxes[possibleCollisionAxesCount++] = axis;
         }
+        ScratchEnd(scratch);
 
         AddPossibleCollisionAxis(p_t, possibleCollisionAxes, possibleCollisionAxesCount);
 
@@ -20,7 +20,7 @@ namespace Lumos
     class LUMOS_EXPORT CollisionDetection : public ThreadSafeSingleton<CollisionDetection>
     {
         friend class TSingleton<CollisionDetection>;
-        typedef bool (CollisionDetection::*CollisionCheckFunc)(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata);
+        typedef bool (CollisionDetection::*CollisionCheckFunc)(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata, Vec3* searchAxis);
 
         CollisionCheckFunc* m_CollisionCheckFunctions;
 
@@ -32,7 +32,14 @@ namespace Lumos
                 delete[] m_CollisionCheckFunctions;
         }
 
-        bool CheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
+        // searchAxis is optional per pair storage for the convex pairs tested with GJK, the other tests ignore it. It
+        // is read as the first search direction and updated with the separating axis or contact normal, so keeping
+        // it between steps makes pairs that are still apart exit after one support query.
+        bool CheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+
+        // Polyhedron and capsule/polyhedron pairs use the separating axis test unless GJK/EPA is enabled
+        void SetGJKEnabled(bool enabled);
+        bool GetGJKEnabled() const { return m_GJKEnabled; }
 
         bool BuildCollisionManifold(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData& coldata, Manifold* out_manifold);
 
@@ -43,13 +50,14 @@ namespace Lumos
         static bool CheckAABBInsideAABB(const Vec3& AABBInsideCenter, const Vec3& AABBInsideHalfVol, const Vec3& AABBCenter, const Vec3& AABBHalfVol);
 
     protected:
-        bool CheckPolyhedronCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-        bool CheckPolyhedronSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-        bool CheckSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-        bool CheckCapsuleCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-        bool CheckCapsuleSphereCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-        bool CheckPolyhedronCapsuleCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
-        bool InvalidCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr);
+        bool CheckPolyhedronCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+        bool CheckPolyhedronGJKCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+        bool CheckPolyhedronSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+        bool CheckSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+        bool CheckCapsuleCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+        bool CheckCapsuleSphereCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+        bool CheckPolyhedronCapsuleCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
+        bool InvalidCheckCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata = nullptr, Vec3* searchAxis = nullptr);
 
         static bool CheckCollisionAxis(const Vec3& axis, RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata);
 
@@ -57,5 +65,6 @@ namespace Lumos
         Vec3 PlaneEdgeIntersection(const Plane& plane, const Vec3& start, const Vec3& end) const;
         void SutherlandHodgesonClipping(Arena* arena, const TDArray<Vec3>& input_polygon, int num_clip_planes, const Plane* clip_planes, TDArray<Vec3>* out_polygon, bool removePoints) const;
         uint32_t m_MaxSize = 0;
+        bool m_GJKEnabled  = false;
     };
 }
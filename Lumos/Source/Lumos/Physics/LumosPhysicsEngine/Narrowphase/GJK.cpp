@@ -0,0 +1,359 @@
+#include "Precompiled.h"
+#include "GJK.h"
+#include "Physics/LumosPhysicsEngine/RigidBody3D.h"
+#include "Physics/LumosPhysicsEngine/CollisionShapes/CollisionShape.h"
+#include "Maths/MathsUtilities.h"
+
+namespace Lumos
+{
+    static const uint32_t GJK_MAX_ITERATIONS  = 32;
+    static const uint32_t EPA_MAX_ITERATIONS  = 32;
+    static const uint32_t EPA_MAX_VERTICES    = 4 + EPA_MAX_ITERATIONS;
+    static const uint32_t EPA_MAX_FACES       = 2 * EPA_MAX_VERTICES;
+    static const float EPA_TOLERANCE          = 0.0001f; // Smallest gain in depth worth another iteration
+    static const float EPA_RELATIVE_TOLERANCE = 0.001f;  // Deep contacts stop once the gain is this fraction of the depth
+
+    ConvexSupport::ConvexSupport(const RigidBody3D* body, const CollisionShape* shape)
+        : Shape(shape)
+        , Transform(body->GetWorldSpaceTransform())
+    {
+        // Body transforms are rotation and translation only, so the transpose takes directions into body space
+        InvRotation = Maths::Transpose(Mat3(Transform));
+    }
+
+    Vec3 ConvexSupport::Support(const Vec3& direction) const
+    {
+        return Transform * Vec4(Shape->GetSupport(InvRotation * direction), 1.0f);
+    }
+
+    static GJKSupportPoint MinkowskiSupport(const ConvexSupport& a, const ConvexSupport& b, const Vec3& direction)
+    {
+        GJKSupportPoint point;
+        point.OnA   = a.Support(direction);
+        point.Point = point.OnA - b.Support(-direction);
+        return point;
+    }
+
+    static Vec3 AnyPerpendicular(const Vec3& v)
+    {
+        return Maths::Abs(v.x) >= 0.57735f ? Vec3(v.y, -v.x, 0.0f) : Vec3(0.0f, v.z, -v.y);
+    }
+
+    // Each case keeps the feature of the simplex closest to the origin and points direction at the origin from it.
+    // Points[0] is always the point just added, so the origin can't lie beyond it
+    static bool SimplexLine(GJKSimplex& simplex, Vec3& direction)
+    {
+        const Vec3 ab = simplex.Points[1].Point - simplex.Points[0].Point;
+        const Vec3 ao = -simplex.Points[0].Point;
+
+        if(Maths::Dot(ab, ao) > 0.0f)
+        {
+            direction = Maths::Cross(Maths::Cross(ab, ao), ab);
+
+            // Origin on the segment
+            if(Maths::Length2(direction) < Maths::M_EPSILON)
+                direction = AnyPerpendicular(ab);
+        }
+        else
+        {
+            simplex.Count = 1;
+            direction     = ao;
+        }
+
+        return false;
+    }
+
+    static bool SimplexTriangle(GJKSimplex& simplex, Vec3& direction)
+    {
+        const GJKSupportPoint a = simplex.Points[0];
+        const GJKSupportPoint b = simplex.Points[1];
+        const GJKSupportPoint c = simplex.Points[2];
+
+        const Vec3 ab  = b.Point - a.Point;
+        const Vec3 ac  = c.Point - a.Point;
+        const Vec3 ao  = -a.Point;
+        const Vec3 abc = Maths::Cross(ab, ac);
+
+        if(Maths::Dot(Maths::Cross(abc, ac), ao) > 0.0f)
+        {
+            if(Maths::Dot(ac, ao) > 0.0f)
+            {
+                simplex.Points[1] = c;
+                simplex.Count     = 2;
+                direction         = Maths::Cross(Maths::Cross(ac, ao), ac);
+                return false;
+            }
+
+            simplex.Count = 2;
+            return SimplexLine(simplex, direction);
+        }
+
+        if(Maths::Dot(Maths::Cross(ab, abc), ao) > 0.0f)
+        {
+            simplex.Count = 2;
+            return SimplexLine(simplex, direction);
+        }
+
+        // Inside the triangle, above or below it. Wind it so the next point ends up behind abc
+        if(Maths::Dot(abc, ao) > 0.0f)
+            direction = abc;
+        else
+        {
+            simplex.Points[1] = c;
+            simplex.Points[2] = b;
+            direction         = -abc;
+        }
+
+        return false;
+    }
+
+    static bool SimplexTetrahedron(GJKSimplex& simplex, Vec3& direction)
+    {
+        const GJKSupportPoint a = simplex.Points[0];
+        const GJKSupportPoint b = simplex.Points[1];
+        const GJKSupportPoint c = simplex.Points[2];
+        const GJKSupportPoint d = simplex.Points[3];
+
+        const Vec3 ab = b.Point - a.Point;
+        const Vec3 ac = c.Point - a.Point;
+        const Vec3 ad = d.Point - a.Point;
+        const Vec3 ao = -a.Point;
+
+        simplex.Count = 3;
+        if(Maths::Dot(Maths::Cross(ab, ac), ao) > 0.0f)
+            return SimplexTriangle(simplex, direction);
+
+        if(Maths::Dot(Maths::Cross(ac, ad), ao) > 0.0f)
+        {
+            simplex.Points[1] = c;
+            simplex.Points[2] = d;
+            return SimplexTriangle(simplex, direction);
+        }
+
+        if(Maths::Dot(Maths::Cross(ad, ab), ao) > 0.0f)
+        {
+            simplex.Points[1] = d;
+            simplex.Points[2] = b;
+            return SimplexTriangle(simplex, direction);
+        }
+
+        simplex.Count = 4;
+        return true;
+    }
+
+    bool GJK::Intersect(const ConvexSupport& a, const ConvexSupport& b, Vec3& direction, GJKSimplex& simplex)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        Vec3 searchDirection = Maths::Length2(direction) > Maths::M_EPSILON ? direction : Vec3(1.0f, 0.0f, 0.0f);
+
+        simplex.Points[0] = MinkowskiSupport(a, b, searchDirection);
+        simplex.Count     = 1;
+
+        // With a good first guess, separated pairs stop here
+        if(Maths::Dot(simplex.Points[0].Point, searchDirection) < 0.0f)
+        {
+            direction = searchDirection;
+            return false;
+        }
+
+        searchDirection = -simplex.Points[0].Point;
+
+        for(uint32_t iteration = 0; iteration < GJK_MAX_ITERATIONS; iteration++)
+        {
+            // The origin is on the simplex, any direction will do to grow it
+            if(Maths::Length2(searchDirection) < Maths::M_EPSILON)
+                searchDirection = AnyPerpendicular(simplex.Count > 1 ? simplex.Points[1].Point - simplex.Points[0].Point : Vec3(1.0f, 0.0f, 0.0f));
+
+            const GJKSupportPoint point = MinkowskiSupport(a, b, searchDirection);
+            if(Maths::Dot(point.Point, searchDirection) < 0.0f)
+            {
+                direction = searchDirection;
+                return false;
+            }
+
+            for(uint32_t i = simplex.Count; i > 0; i--)
+                simplex.Points[i] = simplex.Points[i - 1];
+            simplex.Points[0] = point;
+            simplex.Count++;
+
+            bool containsOrigin = false;
+            switch(simplex.Count)
+            {
+            case 2:
+                containsOrigin = SimplexLine(simplex, searchDirection);
+                break;
+            case 3:
+                containsOrigin = SimplexTriangle(simplex, searchDirection);
+                break;
+            case 4:
+                containsOrigin = SimplexTetrahedron(simplex, searchDirection);
+                break;
+            }
+
+            if(containsOrigin)
+                return true;
+        }
+
+        // Not converged, only happens for shapes that are just touching
+        direction = searchDirection;
+        return false;
+    }
+
+    struct EPAFace
+    {
+        uint32_t Indices[3];
+        Vec3 Normal;
+        float Distance;
+    };
+
+    struct EPAEdge
+    {
+        uint32_t A;
+        uint32_t B;
+    };
+
+    // Faces are wound counter clockwise seen from outside the polytope
+    static bool MakeFace(const GJKSupportPoint* vertices, uint32_t a, uint32_t b, uint32_t c, EPAFace& face)
+    {
+        const Vec3 normal  = Maths::Cross(vertices[b].Point - vertices[a].Point, vertices[c].Point - vertices[a].Point);
+        const float length = Maths::Length(normal);
+        if(length < Maths::M_EPSILON)
+            return false;
+
+        face.Indices[0] = a;
+        face.Indices[1] = b;
+        face.Indices[2] = c;
+        face.Normal     = normal / length;
+        face.Distance   = Maths::Dot(face.Normal, vertices[a].Point);
+        return true;
+    }
+
+    static void AddHorizonEdge(EPAEdge* edges, uint32_t& edgeCount, uint32_t a, uint32_t b)
+    {
+        // An edge shared by two removed faces is inside the hole, both copies go
+        for(uint32_t i = 0; i < edgeCount; i++)
+        {
+            if(edges[i].A == b && edges[i].B == a)
+            {
+                edges[i] = edges[--edgeCount];
+                return;
+            }
+        }
+
+        edges[edgeCount++] = { a, b };
+    }
+
+    bool GJK::Penetration(const ConvexSupport& a, const ConvexSupport& b, const GJKSimplex& simplex, Vec3& out_normal, float& out_depth, Vec3& out_pointOnA)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        if(simplex.Count != 4)
+            return false;
+
+        GJKSupportPoint vertices[EPA_MAX_VERTICES];
+        EPAFace faces[EPA_MAX_FACES];
+        EPAEdge edges[EPA_MAX_FACES * 3];
+        uint32_t vertexCount = 4;
+        uint32_t faceCount   = 0;
+
+        for(uint32_t i = 0; i < 4; i++)
+            vertices[i] = simplex.Points[i];
+
+        // A flat tetrahedron has no inside to expand from, the shapes are only touching
+        const Vec3& origin = vertices[0].Point;
+        if(Maths::Abs(Maths::Dot(Maths::Cross(vertices[1].Point - origin, vertices[2].Point - origin), vertices[3].Point - origin)) < Maths::M_EPSILON)
+            return false;
+
+        // Wind each face of the tetrahedron away from the vertex opposite it
+        static const uint32_t tetrahedron[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+        for(const auto& indices : tetrahedron)
+        {
+            EPAFace& face = faces[faceCount++];
+            if(!MakeFace(vertices, indices[0], indices[1], indices[2], face))
+                return false;
+
+            if(Maths::Dot(face.Normal, vertices[indices[3]].Point - vertices[indices[0]].Point) > 0.0f)
+            {
+                Swap(face.Indices[1], face.Indices[2]);
+                face.Normal   = -face.Normal;
+                face.Distance = -face.Distance;
+            }
+        }
+
+        uint32_t closest = 0;
+        for(uint32_t iteration = 0;; iteration++)
+        {
+            closest = 0;
+            for(uint32_t i = 1; i < faceCount; i++)
+            {
+                if(faces[i].Distance < faces[closest].Distance)
+                    closest = i;
+            }
+
+            if(iteration == EPA_MAX_ITERATIONS || vertexCount == EPA_MAX_VERTICES)
+                break;
+
+            // Stop once the shapes can't be pushed out much further along the closest face
+            const GJKSupportPoint point = MinkowskiSupport(a, b, faces[closest].Normal);
+            const float tolerance       = Maths::Max(EPA_TOLERANCE, EPA_RELATIVE_TOLERANCE * faces[closest].Distance);
+            if(Maths::Dot(point.Point, faces[closest].Normal) - faces[closest].Distance < tolerance)
+                break;
+
+            // Remove every face the new point can see and patch the hole with faces to the point
+            uint32_t edgeCount = 0;
+            for(uint32_t i = 0; i < faceCount;)
+            {
+                const EPAFace& face = faces[i];
+                if(Maths::Dot(face.Normal, point.Point - vertices[face.Indices[0]].Point) > 0.0f)
+                {
+                    AddHorizonEdge(edges, edgeCount, face.Indices[0], face.Indices[1]);
+                    AddHorizonEdge(edges, edgeCount, face.Indices[1], face.Indices[2]);
+                    AddHorizonEdge(edges, edgeCount, face.Indices[2], face.Indices[0]);
+                    faces[i] = faces[--faceCount];
+                }
+                else
+                    i++;
+            }
+
+            const uint32_t pointIndex = vertexCount++;
+            vertices[pointIndex]      = point;
+
+            for(uint32_t i = 0; i < edgeCount && faceCount < EPA_MAX_FACES; i++)
+            {
+                if(MakeFace(vertices, edges[i].A, edges[i].B, pointIndex, faces[faceCount]))
+                    faceCount++;
+            }
+
+            if(faceCount == 0)
+                return false;
+        }
+
+        const EPAFace& face = faces[closest];
+        out_normal          = face.Normal;
+        out_depth           = face.Distance;
+
+        // The origin projected onto the face, as barycentric coordinates of the face's support points on A
+        const Vec3& p0 = vertices[face.Indices[0]].Point;
+        const Vec3 v0  = vertices[face.Indices[1]].Point - p0;
+        const Vec3 v1  = vertices[face.Indices[2]].Point - p0;
+        const Vec3 v2  = face.Normal * face.Distance - p0;
+
+        const float d00   = Maths::Dot(v0, v0);
+        const float d01   = Maths::Dot(v0, v1);
+        const float d11   = Maths::Dot(v1, v1);
+        const float d20   = Maths::Dot(v2, v0);
+        const float d21   = Maths::Dot(v2, v1);
+        const float denom = d00 * d11 - d01 * d01;
+
+        float v = 0.0f, w = 0.0f;
+        if(Maths::Abs(denom) > Maths::M_EPSILON)
+        {
+            v = (d11 * d20 - d01 * d21) / denom;
+            w = (d00 * d21 - d01 * d20) / denom;
+        }
+
+        out_pointOnA = vertices[face.Indices[0]].OnA * (1.0f - v - w) + vertices[face.Indices[1]].OnA * v + vertices[face.Indices[2]].OnA * w;
+        return true;
+    }
+}
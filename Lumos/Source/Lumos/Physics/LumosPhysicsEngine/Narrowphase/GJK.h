@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Maths/Vector3.h"
+#include "Maths/Matrix3.h"
+#include "Maths/Matrix4.h"
+
+namespace Lumos
+{
+    class RigidBody3D;
+    class CollisionShape;
+
+    // A collision shape placed in the world, seen only through its support function.
+    // Directions are taken into body space once per pair rather than on every support query
+    struct LUMOS_EXPORT ConvexSupport
+    {
+        ConvexSupport(const RigidBody3D* body, const CollisionShape* shape);
+
+        // World space point of the shape furthest along a world space direction
+        Vec3 Support(const Vec3& direction) const;
+
+        const CollisionShape* Shape;
+        Mat4 Transform;
+        Mat3 InvRotation;
+    };
+
+    struct LUMOS_EXPORT GJKSupportPoint
+    {
+        Vec3 Point; // On the Minkowski difference A - B
+        Vec3 OnA;   // Support point on A that produced it, used to find the contact point
+    };
+
+    struct LUMOS_EXPORT GJKSimplex
+    {
+        GJKSupportPoint Points[4]; // Newest first
+        uint32_t Count = 0;
+    };
+
+    namespace GJK
+    {
+        // Tests two convex shapes for overlap.
+        //  - direction is the first search direction, ideally the pair's axis from the last step. If the shapes
+        //    are apart it is left holding a separating axis pointing from A towards B.
+        //  - On overlap simplex is a tetrahedron around the origin, ready for Penetration
+        LUMOS_EXPORT bool Intersect(const ConvexSupport& a, const ConvexSupport& b, Vec3& direction, GJKSimplex& simplex);
+
+        // Expanding polytope algorithm. Finds the smallest translation that separates two overlapping shapes,
+        // as a normal pointing from A towards B, a depth and the deepest point of A inside B
+        LUMOS_EXPORT bool Penetration(const ConvexSupport& a, const ConvexSupport& b, const GJKSimplex& simplex, Vec3& out_normal, float& out_depth, Vec3& out_pointOnA);
+    }
+}
@@ -12,6 +12,18 @@ namespace Lumos
 
 #define persistentThresholdSq 0.025f
 
+    // Any two axes perpendicular to the normal will do for a new contact. A contact matched by WarmStart keeps the
+    // previous step's axes instead
+    static void ComputeTangents(const Vec3& normal, Vec3& tangent1, Vec3& tangent2)
+    {
+        if(Maths::Abs(normal.x) >= 0.57735f)
+            tangent1 = Vec3(normal.y, -normal.x, 0.0f).Normalised();
+        else
+            tangent1 = Vec3(0.0f, normal.z, -normal.y).Normalised();
+
+        tangent2 = Maths::Cross(normal, tangent1);
+    }
+
     Manifold::Manifold()
         : m_pNodeA(nullptr)
         , m_pNodeB(nullptr)
@@ -42,6 +54,15 @@ namespace Lumos
         }
     }
 
+    void Manifold::ApplyContactImpulse(const ContactPoint& c, const Vec3& impulse) const
+    {
+        m_pNodeA->SetLinearVelocity(m_pNodeA->GetLinearVelocity() + impulse * m_pNodeA->GetInverseMass());
+        m_pNodeB->SetLinearVelocity(m_pNodeB->GetLinearVelocity() - impulse * m_pNodeB->GetInverseMass());
+
+        m_pNodeA->SetAngularVelocity(m_pNodeA->GetAngularVelocity() + m_pNodeA->GetInverseInertia() * Maths::Cross(c.relPosA, impulse));
+        m_pNodeB->SetAngularVelocity(m_pNodeB->GetAngularVelocity() - m_pNodeB->GetInverseInertia() * Maths::Cross(c.relPosB, impulse));
+    }
+
     void Manifold::SolveContactPoint(ContactPoint& c) const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
@@ -49,106 +70,109 @@ namespace Lumos
         if(m_pNodeA->GetInverseMass() + m_pNodeB->GetInverseMass() < Maths::M_EPSILON)
             return;
 
-        Vec3& r1 = c.relPosA;
-        Vec3& r2 = c.relPosB;
-
-        Vec3 v0 = m_pNodeA->GetLinearVelocity() + Maths::Cross(m_pNodeA->GetAngularVelocity(), r1);
-        Vec3 v1 = m_pNodeB->GetLinearVelocity() + Maths::Cross(m_pNodeB->GetAngularVelocity(), r2);
-
-        Vec3& normal = c.collisionNormal;
-        Vec3 dv      = v0 - v1;
+        auto RelativeVelocity = [&]()
+        {
+            return m_pNodeA->GetLinearVelocity() + Maths::Cross(m_pNodeA->GetAngularVelocity(), c.relPosA)
+                - m_pNodeB->GetLinearVelocity() - Maths::Cross(m_pNodeB->GetAngularVelocity(), c.relPosB);
+        };
 
-        // Collision Resoluton
+        // Collision Resoluton. The impulse that stops the bodies approaching is accumulated on its own, as it's
+        // the part carried over to warm start the next step
         {
-            const float constraintMass = (m_pNodeA->GetInverseMass()
-                                          + m_pNodeB->GetInverseMass())
-                + Maths::Dot(normal,
-                             Maths::Cross(m_pNodeA->GetInverseInertia()
-                                              * Maths::Cross(r1, normal),
-                                          r1)
-                                 + Maths::Cross(m_pNodeB->GetInverseInertia()
-                                                    * Maths::Cross(r2, normal),
-                                                r2));
-            // Baumgarte Offset ( Adds energy to the System to counter
-            // slight solving errors that accumulate over time
-            // called as �constraint drift �)
-
-            float penetrationSlop      = Maths::Min(c.collisionPenetration + m_BaumgarteSlop, 0.0f);
-            float b                    = -(m_BaumgarteScalar / LumosPhysicsEngine::GetDeltaTime()) * penetrationSlop;
-            float b_real               = Maths::Max(b, c.elatisity_term + b * 0.2f);
-            float jn                   = -(Maths::Dot(dv, normal) + b_real) / constraintMass;
+            float jn                   = -(Maths::Dot(RelativeVelocity(), c.collisionNormal) + c.elatisity_term) * c.normalMass;
             float oldSumImpulseContact = c.sumImpulseContact;
 
-            jn                  = Maths::Min(jn, 0.0f);
+            // Clamp the total rather than this iteration's impulse, so a warm started contact can give back
+            // impulse it no longer needs
             c.sumImpulseContact = Maths::Min(c.sumImpulseContact + jn, 0.0f);
             jn                  = c.sumImpulseContact - oldSumImpulseContact;
 
-            m_pNodeA->SetLinearVelocity(m_pNodeA->GetLinearVelocity()
-                                        + normal * (jn * m_pNodeA->GetInverseMass()));
-            m_pNodeB->SetLinearVelocity(m_pNodeB->GetLinearVelocity()
-                                        - normal * (jn * m_pNodeB->GetInverseMass()));
-
-            m_pNodeA->SetAngularVelocity(m_pNodeA->GetAngularVelocity()
-                                         + m_pNodeA->GetInverseInertia()
-                                             * Maths::Cross(r1, normal * jn));
-            m_pNodeB->SetAngularVelocity(m_pNodeB->GetAngularVelocity()
-                                         - m_pNodeB->GetInverseInertia()
-                                             * Maths::Cross(r2, normal * jn));
+            ApplyContactImpulse(c, c.collisionNormal * jn);
         }
-        // Friction
+        // Baumgarte Offset ( Adds energy to the System to counter
+        // slight solving errors that accumulate over time
+        // called as "constraint drift" ). Accumulated separately and started from zero every step, so the
+        // correction for last step's penetration isn't applied again by the warm start
         {
-            Vec3 tangent      = dv - normal * Maths::Dot(dv, normal);
-            float tangent_len = Maths::Length(tangent);
+            float penetrationSlop   = Maths::Min(c.collisionPenetration + m_BaumgarteSlop, 0.0f);
+            float b                 = -(m_BaumgarteScalar / LumosPhysicsEngine::GetDeltaTime()) * penetrationSlop;
+            float b_real            = Maths::Max(b, c.elatisity_term + b * 0.2f);
+            float jb                = -(Maths::Dot(RelativeVelocity(), c.collisionNormal) + b_real) * c.normalMass;
+            float oldSumImpulseBias = c.sumImpulseBias;
+
+            c.sumImpulseBias = Maths::Min(c.sumImpulseBias + jb, 0.0f);
+            jb               = c.sumImpulseBias - oldSumImpulseBias;
 
-            if(tangent_len > 0.001f)
+            ApplyContactImpulse(c, c.collisionNormal * jb);
+        }
+        // Friction
+        {
+            // Clamp the combined tangent impulse to the friction cone, so it never applies more force than the
+            // main collision resolution force in any direction. Clamping each axis on its own would allow up to
+            // sqrt(2) times that along the diagonal. sumImpulseContact is never positive
+            const float maxJt              = -m_Friction * c.sumImpulseContact;
+            const Vec3 relativeVelocity    = RelativeVelocity();
+            const float oldImpulseTangent0 = c.sumImpulseFriction[0];
+            const float oldImpulseTangent1 = c.sumImpulseFriction[1];
+
+            float sumJt0 = oldImpulseTangent0 - Maths::Dot(relativeVelocity, c.tangents[0]) * c.tangentMass[0];
+            float sumJt1 = oldImpulseTangent1 - Maths::Dot(relativeVelocity, c.tangents[1]) * c.tangentMass[1];
+
+            const float sumJtSq = sumJt0 * sumJt0 + sumJt1 * sumJt1;
+            if(sumJtSq > maxJt * maxJt)
             {
-                tangent = tangent * (1.0f / tangent_len);
-
-                float frictionalMass = (m_pNodeA->GetInverseMass() + m_pNodeB->GetInverseMass())
-                    + Maths::Dot(tangent, Maths::Cross(m_pNodeA->GetInverseInertia() * Maths::Cross(r1, tangent), r1) + Maths::Cross(m_pNodeB->GetInverseInertia() * Maths::Cross(r2, tangent), r2));
-                float frictionCoef = sqrtf(Maths::Max(m_pNodeA->GetFriction(), 0.1f) * Maths::Max(m_pNodeB->GetFriction(), 0.1f));
-                float jt           = -1.0f * frictionCoef * Maths::Dot(dv, tangent) / frictionalMass;
-
-                // Clamp friction to never apply more force than the main collision
-                // resolution force
-
-                float oldImpulseTangent = c.sumImpulseFriction;
-                float maxJt             = frictionCoef * c.sumImpulseContact;
-                c.sumImpulseFriction    = Maths::Min(Maths::Max(oldImpulseTangent + jt, maxJt), -maxJt);
-                jt                      = c.sumImpulseFriction - oldImpulseTangent;
-
-                m_pNodeA->SetLinearVelocity(m_pNodeA->GetLinearVelocity()
-                                            + tangent * (jt * m_pNodeA->GetInverseMass()));
-                m_pNodeB->SetLinearVelocity(m_pNodeB->GetLinearVelocity()
-                                            - tangent * (jt * m_pNodeB->GetInverseMass()));
-
-                m_pNodeA->SetAngularVelocity(m_pNodeA->GetAngularVelocity()
-                                             + m_pNodeA->GetInverseInertia()
-                                                 * Maths::Cross(r1, tangent * jt));
-                m_pNodeB->SetAngularVelocity(m_pNodeB->GetAngularVelocity()
-                                             - m_pNodeB->GetInverseInertia()
-                                                 * Maths::Cross(r2, tangent * jt));
+                const float scale = maxJt / sqrtf(sumJtSq);
+                sumJt0 *= scale;
+                sumJt1 *= scale;
             }
+
+            c.sumImpulseFriction[0] = sumJt0;
+            c.sumImpulseFriction[1] = sumJt1;
+
+            ApplyContactImpulse(c, c.tangents[0] * (sumJt0 - oldImpulseTangent0) + c.tangents[1] * (sumJt1 - oldImpulseTangent1));
         }
     }
 
-    void Manifold::PreSolverStep(float dt)
+    void Manifold::PreSolverStep()
     {
         LUMOS_PROFILE_FUNCTION_LOW();
 
+        m_Friction = sqrtf(Maths::Max(m_pNodeA->GetFriction(), 0.1f) * Maths::Max(m_pNodeB->GetFriction(), 0.1f));
+
         for(uint32_t i = 0; i < m_ContactCount; i++)
         {
             UpdateConstraint(m_vContacts[i]);
         }
     }
 
+    void Manifold::ApplyWarmStart()
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        // Applying last step's impulses up front leaves the iterations to correct the difference, rather than
+        // building the whole impulse up again from zero
+        for(uint32_t i = 0; i < m_ContactCount; i++)
+        {
+            const ContactPoint& contact = m_vContacts[i];
+            ApplyContactImpulse(contact, contact.collisionNormal * contact.sumImpulseContact + contact.tangents[0] * contact.sumImpulseFriction[0] + contact.tangents[1] * contact.sumImpulseFriction[1]);
+        }
+    }
+
     void Manifold::UpdateConstraint(ContactPoint& contact)
     {
         LUMOS_PROFILE_FUNCTION_LOW();
 
-        // Reset total impulse forces computed this physics timestep
-        contact.sumImpulseContact  = 0.0f;
-        contact.sumImpulseFriction = 0.0f;
+        auto EffectiveMass = [&](const Vec3& axis)
+        {
+            const float mass = m_pNodeA->GetInverseMass() + m_pNodeB->GetInverseMass()
+                + Maths::Dot(axis, Maths::Cross(m_pNodeA->GetInverseInertia() * Maths::Cross(contact.relPosA, axis), contact.relPosA) + Maths::Cross(m_pNodeB->GetInverseInertia() * Maths::Cross(contact.relPosB, axis), contact.relPosB));
+            return mass > Maths::M_EPSILON ? 1.0f / mass : 0.0f;
+        };
+
+        contact.sumImpulseBias = 0.0f;
+        contact.normalMass     = EffectiveMass(contact.collisionNormal);
+        contact.tangentMass[0] = EffectiveMass(contact.tangents[0]);
+        contact.tangentMass[1] = EffectiveMass(contact.tangents[1]);
 
         // Compute Elasticity Term - must be computed prior to solving
         // ANY constraints otherwise the objects velocities may have
@@ -195,11 +219,12 @@ namespace Lumos
         ContactPoint contact;
         contact.relPosA              = r1;
         contact.relPosB              = r2;
+        contact.localPosA            = m_pNodeA->GetOrientation().Conjugate() * r1;
+        contact.localPosB            = m_pNodeB->GetOrientation().Conjugate() * r2;
         contact.collisionNormal      = _normal;
         contact.collisionPenetration = _penetration;
         contact.elatisity_term       = 1.0f;
-        contact.sumImpulseContact    = 0.0f;
-        contact.sumImpulseFriction   = 0.0f;
+        ComputeTangents(_normal, contact.tangents[0], contact.tangents[1]);
 
         // Check to see if we already contain a contact point almost in that location
         const float min_allowed_dist_sq = 0.2f * 0.2f;
@@ -226,13 +251,66 @@ namespace Lumos
             }
         }
 
-        if(should_add)
+        // Clipping a small face against a large one can produce more points than fit, keep the first ones
+        if(should_add && m_ContactCount < MAX_CONTACT_POINTS)
         {
             m_vContacts[m_ContactCount] = contact;
             m_ContactCount++;
         }
     }
 
+    void Manifold::WarmStart(const Manifold& previous)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+
+        // The broadphase can report a pair in either order. With the bodies swapped the normal flips, so the
+        // normal impulse is unchanged and the friction impulse and tangents change sign
+        const bool swapped = previous.m_pNodeA != m_pNodeA;
+        const float sign   = swapped ? -1.0f : 1.0f;
+
+        for(uint32_t i = 0; i < m_ContactCount; i++)
+        {
+            ContactPoint& contact = m_vContacts[i];
+
+            // No feature ids come out of clipping, so contacts are matched by how close they are on both bodies
+            const ContactPoint* match = nullptr;
+            float closestDistSq       = persistentThresholdSq;
+            for(uint32_t j = 0; j < previous.m_ContactCount; j++)
+            {
+                const ContactPoint& old = previous.m_vContacts[j];
+                const Vec3 onA          = swapped ? old.localPosB : old.localPosA;
+                const Vec3 onB          = swapped ? old.localPosA : old.localPosB;
+                const float distSq      = Maths::Max(Maths::Length2(onA - contact.localPosA), Maths::Length2(onB - contact.localPosB));
+
+                if(distSq < closestDistSq)
+                {
+                    closestDistSq = distSq;
+                    match         = &old;
+                }
+            }
+
+            if(!match)
+                continue;
+
+            contact.sumImpulseContact = match->sumImpulseContact;
+
+            // Keep the matched contact's tangents rather than the ones AddContact rebuilt from the new normal, so
+            // the friction impulse stays along the axes it was accumulated on. They only need re-orthogonalising
+            // against the new normal, which is close to the old one for a persistent contact
+            const Vec3 oldTangent = match->tangents[0] * sign;
+            const Vec3 tangent    = oldTangent - contact.collisionNormal * Maths::Dot(oldTangent, contact.collisionNormal);
+            if(Maths::Length2(tangent) < Maths::M_EPSILON)
+                continue;
+
+            contact.tangents[0] = tangent.Normalised();
+            contact.tangents[1] = Maths::Cross(contact.collisionNormal, contact.tangents[0]);
+
+            const Vec3 friction           = (match->tangents[0] * match->sumImpulseFriction[0] + match->tangents[1] * match->sumImpulseFriction[1]) * sign;
+            contact.sumImpulseFriction[0] = Maths::Dot(friction, contact.tangents[0]);
+            contact.sumImpulseFriction[1] = Maths::Dot(friction, contact.tangents[1]);
+        }
+    }
+
     void Manifold::DebugDraw() const
     {
         LUMOS_PROFILE_FUNCTION_LOW();
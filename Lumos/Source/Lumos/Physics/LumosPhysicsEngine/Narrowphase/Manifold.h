@@ -11,14 +11,23 @@ namespace Lumos
         */
     struct LUMOS_EXPORT ContactPoint
     {
-        float sumImpulseContact    = 0.0f;
-        float sumImpulseFriction   = 0.0f;
-        float elatisity_term       = 0.0f;
-        float collisionPenetration = 0.0f;
+        // Accumulated impulses. Carried over from the matching contact of the previous step to warm start the solver
+        float sumImpulseContact     = 0.0f;
+        float sumImpulseFriction[2] = { 0.0f, 0.0f };
+        float sumImpulseBias        = 0.0f; // Baumgarte correction, not carried over
+        float elatisity_term        = 0.0f;
+        float collisionPenetration  = 0.0f;
+
+        // Inverse effective masses along the normal and tangents, computed once per step
+        float normalMass     = 0.0f;
+        float tangentMass[2] = { 0.0f, 0.0f };
 
         Vec3 collisionNormal;
-        Vec3 relPosA; // Position relative to objectA
-        Vec3 relPosB; // Position relative to objectB
+        Vec3 tangents[2];
+        Vec3 relPosA;   // Position relative to objectA
+        Vec3 relPosB;   // Position relative to objectB
+        Vec3 localPosA; // relPosA in objectA's local space, used to match contacts between steps
+        Vec3 localPosB;
     };
 #define MAX_CONTACT_POINTS 8
 
@@ -34,9 +43,19 @@ namespace Lumos
         // Called whenever a new collision contact between A & B are found
         void AddContact(const Vec3& globalOnA, const Vec3& globalOnB, const Vec3& _normal, const float& _penetration);
 
+        // Takes the accumulated impulses of contacts that are still close to one of previous' contacts.
+        // previous must be the same body pair's manifold from the last step, in either order
+        void WarmStart(const Manifold& previous);
+
         // Sequentially solves each contact constraint
         void ApplyImpulse();
-        void PreSolverStep(float dt);
+
+        // Computes the per step contact terms
+        void PreSolverStep();
+
+        // Applies the impulses carried over by WarmStart. Called once every manifold in the island has run
+        // PreSolverStep, so no contact's bounce term sees another's warm start
+        void ApplyWarmStart();
 
         // Debug draws the manifold surface area
         void DebugDraw() const;
@@ -51,15 +70,20 @@ namespace Lumos
             return m_pNodeB;
         }
 
+        uint32_t GetContactCount() const { return m_ContactCount; }
+        const ContactPoint& GetContact(uint32_t index) const { return m_vContacts[index]; }
+
     protected:
         void SolveContactPoint(ContactPoint& c) const;
         void UpdateConstraint(ContactPoint& c);
+        void ApplyContactImpulse(const ContactPoint& c, const Vec3& impulse) const;
 
     protected:
         RigidBody3D* m_pNodeA;
         RigidBody3D* m_pNodeB;
         ContactPoint m_vContacts[MAX_CONTACT_POINTS];
         uint32_t m_ContactCount = 0;
+        float m_Friction        = 0.0f;
         float m_BaumgarteScalar = 0.2f;   // Amount of force to add to the System to solve error
         float m_BaumgarteSlop   = 0.001f; // Amount of allowed penetration, ensures a complete manifold each frame
     };
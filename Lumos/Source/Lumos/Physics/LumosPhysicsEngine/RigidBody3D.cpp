@@ -13,23 +13,25 @@
 namespace Lumos
 {
 
-    RigidBody3D::RigidBody3D(const RigidBody3DProperties& properties)
+    RigidBody3D::RigidBody3D(const RigidBody3DProperties& properties, RigidBodyStore* store)
         : m_WSTransformInvalidated(true)
         , m_RestVelocityThresholdSquared(0.004f)
         , m_AverageSummedVelocity(0.0f)
         , m_WSAabbInvalidated(true)
-        , m_Position(properties.Position)
-        , m_LinearVelocity(properties.LinearVelocity)
-        , m_Force(properties.Force)
-        , m_Orientation(properties.Orientation)
-        , m_AngularVelocity(properties.AngularVelocity)
-        , m_Torque(properties.Torque)
-        , m_InvInertia(Mat3(1.0f))
-        , m_AngularFactor(1.0f)
         , m_WSTransform(Mat4(1.0f))
     {
+        m_Store     = store ? store : &RigidBodyStore::Detached();
+        m_BodyIndex = m_Store->Add(this);
+
+        m_Store->Positions[m_BodyIndex]         = properties.Position;
+        m_Store->LinearVelocities[m_BodyIndex]  = properties.LinearVelocity;
+        m_Store->Forces[m_BodyIndex]            = properties.Force;
+        m_Store->Orientations[m_BodyIndex]      = properties.Orientation;
+        m_Store->AngularVelocities[m_BodyIndex] = properties.AngularVelocity;
+        m_Store->Torques[m_BodyIndex]           = properties.Torque;
+
         ASSERT(properties.Mass > 0.0f, "Mass <= 0");
-        m_InvMass = 1.0f / properties.Mass;
+        m_Store->InvMasses[m_BodyIndex] = 1.0f / properties.Mass;
 
         m_LocalBoundingBox.Set(Vec3(-0.5f), Vec3(0.5f));
 
@@ -48,6 +50,7 @@ namespace Lumos
 
     RigidBody3D::~RigidBody3D()
     {
+        m_Store->Remove(m_BodyIndex);
         m_UUID = 0;
     }
 
@@ -82,7 +85,7 @@ namespace Lumos
         LUMOS_PROFILE_FUNCTION_LOW();
         if(m_WSTransformInvalidated)
         {
-            m_WSTransform = Mat4::Translation(m_Position) * Maths::ToMat4(m_Orientation);
+            m_WSTransform = Mat4::Translation(GetPosition()) * Maths::ToMat4(GetOrientation());
 
             m_WSTransformInvalidated = false;
         }
@@ -130,7 +133,7 @@ namespace Lumos
         static const float ALPHA = 0.15f;
 
         // Calculate exponential moving average
-        const float v = Maths::Length2(m_LinearVelocity) + Maths::Length2(m_AngularVelocity);
+        const float v = Maths::Length2(GetLinearVelocity()) + Maths::Length2(GetAngularVelocity());
         m_AverageSummedVelocity += ALPHA * (v - m_AverageSummedVelocity);
 
         // Do test
@@ -153,10 +156,10 @@ namespace Lumos
         }
 
         if(flags & PhysicsDebugFlags::LINEARVELOCITY)
-            DebugRenderer::DrawThickLine(Vec3(m_WSTransform.Translation()), m_WSTransform * Vec4(m_LinearVelocity, 1.0f), 0.02f, false, Vec4(0.0f, 1.0f, 0.0f, 1.0f));
+            DebugRenderer::DrawThickLine(Vec3(m_WSTransform.Translation()), m_WSTransform * Vec4(GetLinearVelocity(), 1.0f), 0.02f, false, Vec4(0.0f, 1.0f, 0.0f, 1.0f));
 
         if(flags & PhysicsDebugFlags::LINEARFORCE)
-            DebugRenderer::DrawThickLine(Vec3(m_WSTransform.Translation()), m_WSTransform * Vec4(m_Force, 1.0f), 0.02f, false, Vec4(0.0f, 0.0f, 1.0f, 1.0f));
+            DebugRenderer::DrawThickLine(Vec3(m_WSTransform.Translation()), m_WSTransform * Vec4(GetForce(), 1.0f), 0.02f, false, Vec4(0.0f, 0.0f, 1.0f, 1.0f));
     }
 
     void RigidBody3D::SetCollisionShape(CollisionShapeType type)
@@ -188,7 +191,7 @@ namespace Lumos
     void RigidBody3D::SetCollisionShape(const SharedPtr<CollisionShape>& shape)
     {
         m_CollisionShape = shape;
-        m_InvInertia     = m_CollisionShape->BuildInverseInertia(m_InvMass);
+        SetInverseInertia(m_CollisionShape->BuildInverseInertia(GetInverseMass()));
         AutoResizeBoundingBox();
     }
 
@@ -196,7 +199,7 @@ namespace Lumos
     {
         if(m_Static)
             return;
-        m_AngularVelocity = v;
+        m_Store->AngularVelocities[m_BodyIndex] = v;
 
         if(Maths::Length2(v) > Maths::M_EPSILON)
             m_AtRest = false;
@@ -205,24 +208,24 @@ namespace Lumos
     void RigidBody3D::CollisionShapeUpdated()
     {
         if(m_CollisionShape)
-            m_InvInertia = m_CollisionShape->BuildInverseInertia(m_InvMass);
+            SetInverseInertia(m_CollisionShape->BuildInverseInertia(GetInverseMass()));
         AutoResizeBoundingBox();
     }
 
     void RigidBody3D::SetInverseMass(const float& v)
     {
-        m_InvMass = v;
+        m_Store->InvMasses[m_BodyIndex] = v;
         if(m_CollisionShape)
-            m_InvInertia = m_CollisionShape->BuildInverseInertia(m_InvMass);
+            SetInverseInertia(m_CollisionShape->BuildInverseInertia(v));
     }
 
     void RigidBody3D::SetMass(const float& v)
     {
         ASSERT(v > 0, "Physics object mass <= 0");
-        m_InvMass = 1.0f / v;
+        m_Store->InvMasses[m_BodyIndex] = 1.0f / v;
 
         if(m_CollisionShape)
-            m_InvInertia = m_CollisionShape->BuildInverseInertia(m_InvMass);
+            SetInverseInertia(m_CollisionShape->BuildInverseInertia(GetInverseMass()));
     }
 
     const SharedPtr<CollisionShape>& RigidBody3D::GetCollisionShape() const
@@ -233,13 +236,13 @@ namespace Lumos
     RigidBody3DProperties RigidBody3D::GetProperties()
     {
         RigidBody3DProperties properties;
-        properties.Position = m_Position;
-        properties.LinearVelocity = m_LinearVelocity;
-        properties.Force = m_Force;
+        properties.Position = GetPosition();
+        properties.LinearVelocity = GetLinearVelocity();
+        properties.Force = GetForce();
         properties.Elasticity = m_Elasticity;
 
-        if(m_InvMass != 0.0f)
-        properties.Mass = 1.0f / m_InvMass;
+        if(GetInverseMass() != 0.0f)
+        properties.Mass = 1.0f / GetInverseMass();
             else
         properties.Mass = 1.0f;
         //TODO: Finish rest;
@@ -9,6 +9,7 @@
 #include "Maths/Matrix4.h"
 #include "Maths/Quaternion.h"
 #include "Core/Function.h"
+#include "RigidBodyStore.h"
 
 namespace Lumos
 {
@@ -51,6 +52,7 @@ namespace Lumos
     class alignas(16) RigidBody3D
     {
         friend class LumosPhysicsEngine;
+        friend class RigidBodyStore;
         template <typename Archive>
         friend void save(Archive& archive, const RigidBody3D& rigidBody3D);
 
@@ -59,16 +61,18 @@ namespace Lumos
 
     public:
         ~RigidBody3D();
+        NONCOPYABLE(RigidBody3D)
 
         //<--------- GETTERS ------------->
-        const Vec3& GetPosition() const { return m_Position; }
-        const Vec3& GetLinearVelocity() const { return m_LinearVelocity; }
-        const Vec3& GetForce() const { return m_Force; }
-        float GetInverseMass() const { return m_InvMass; }
-        const Quat& GetOrientation() const { return m_Orientation; }
-        const Vec3& GetAngularVelocity() const { return m_AngularVelocity; }
-        const Vec3& GetTorque() const { return m_Torque; }
-        const Mat3& GetInverseInertia() const { return m_InvInertia; }
+        // References into the body store, only valid until the next body is created
+        const Vec3& GetPosition() const { return m_Store->Positions[m_BodyIndex]; }
+        const Vec3& GetLinearVelocity() const { return m_Store->LinearVelocities[m_BodyIndex]; }
+        const Vec3& GetForce() const { return m_Store->Forces[m_BodyIndex]; }
+        float GetInverseMass() const { return m_Store->InvMasses[m_BodyIndex]; }
+        const Quat& GetOrientation() const { return m_Store->Orientations[m_BodyIndex]; }
+        const Vec3& GetAngularVelocity() const { return m_Store->AngularVelocities[m_BodyIndex]; }
+        const Vec3& GetTorque() const { return m_Store->Torques[m_BodyIndex]; }
+        const Mat3& GetInverseInertia() const { return m_Store->InvInertias[m_BodyIndex]; }
         const Mat4& GetWorldSpaceTransform() const; // Built from scratch or returned from cached value
 
         const Maths::BoundingBox& GetWorldSpaceAABB();
@@ -99,9 +103,9 @@ namespace Lumos
 
         void SetPosition(const Vec3& v)
         {
-            m_Position               = v;
-            m_WSTransformInvalidated = true;
-            m_WSAabbInvalidated      = true;
+            m_Store->Positions[m_BodyIndex] = v;
+            m_WSTransformInvalidated        = true;
+            m_WSAabbInvalidated             = true;
             // m_AtRest = false;
         }
 
@@ -109,22 +113,22 @@ namespace Lumos
         {
             if(m_Static)
                 return;
-            m_LinearVelocity = v;
-            m_AtRest         = false;
+            m_Store->LinearVelocities[m_BodyIndex] = v;
+            m_AtRest                               = false;
         }
         void SetForce(const Vec3& v)
         {
             if(m_Static)
                 return;
-            m_Force  = v;
-            m_AtRest = false;
+            m_Store->Forces[m_BodyIndex] = v;
+            m_AtRest                     = false;
         }
 
         void SetOrientation(const Quat& v)
         {
-            m_Orientation            = v;
-            m_WSTransformInvalidated = true;
-            m_AtRest                 = false;
+            m_Store->Orientations[m_BodyIndex] = v;
+            m_WSTransformInvalidated           = true;
+            m_AtRest                           = false;
         }
 
         void SetAngularVelocity(const Vec3& v);
@@ -132,10 +136,10 @@ namespace Lumos
         {
             if(m_Static)
                 return;
-            m_Torque = v;
-            m_AtRest = false;
+            m_Store->Torques[m_BodyIndex] = v;
+            m_AtRest                      = false;
         }
-        void SetInverseInertia(const Mat3& v) { m_InvInertia = v; }
+        void SetInverseInertia(const Mat3& v) { m_Store->InvInertias[m_BodyIndex] = v; }
 
         //<---------- CALLBACKS ------------>
         void SetOnCollisionCallback(PhysicsCollisionCallback& callback) { m_OnCollisionCallback = callback; }
@@ -175,8 +179,8 @@ namespace Lumos
         bool GetIsTrigger() const { return m_Trigger; }
         void SetIsTrigger(bool trigger) { m_Trigger = trigger; }
 
-        float GetAngularFactor() const { return m_AngularFactor; }
-        void SetAngularFactor(float factor) { m_AngularFactor = factor; }
+        float GetAngularFactor() const { return m_Store->AngularFactors[m_BodyIndex]; }
+        void SetAngularFactor(float factor) { m_Store->AngularFactors[m_BodyIndex] = factor; }
 
         bool GetIsStatic() const { return m_Static; }
         bool GetIsAtRest() const { return m_AtRest; }
@@ -194,10 +198,6 @@ namespace Lumos
         // void SetIsColliding(const bool colliding) { m_IsColliding = colliding; }
         UUID GetUUID() const { return m_UUID; }
 
-        // For iteration
-        RigidBody3D* m_Prev = nullptr;
-        RigidBody3D* m_Next = nullptr;
-
         bool Valid() const { return m_UUID != 0; }
 
         uint16_t GetCollisionLayer() const { return m_CollisionLayer; }
@@ -206,7 +206,8 @@ namespace Lumos
         RigidBody3DProperties GetProperties();
 
     protected:
-        RigidBody3D(const RigidBody3DProperties& properties = RigidBody3DProperties());
+        // Bodies created without a store, like PathNode, go in RigidBodyStore::Detached
+        RigidBody3D(const RigidBody3DProperties& properties = RigidBody3DProperties(), RigidBodyStore* store = nullptr);
 
         float m_RestVelocityThresholdSquared;
         float m_AverageSummedVelocity;
@@ -222,22 +223,13 @@ namespace Lumos
         mutable bool m_WSAabbInvalidated; //!< Flag indicating if the cached world space transoformed AABB is invalid
         bool m_Static;
         bool m_AtRest;
-        float m_AngularFactor;
+        bool m_Trigger = false;
 
         UUID m_UUID;
 
-        u16 m_CollisionLayer = 0;
-
-        Vec3 m_Position;
-        float m_InvMass;
-        Vec3 m_LinearVelocity;
-        bool m_Trigger = false;
-        Vec3 m_Force;
-
-        Quat m_Orientation;
-        Vec3 m_AngularVelocity;
-        Vec3 m_Torque;
-        Mat3 m_InvInertia;
+        u16 m_CollisionLayer    = 0;
+        RigidBodyStore* m_Store = nullptr; // Holds the position, orientation, velocities, forces, mass and inertia
+        uint32_t m_BodyIndex    = 0;       // Slot in m_Store, changes when another body is removed
 
         SharedPtr<CollisionShape> m_CollisionShape;
         PhysicsCollisionCallback m_OnCollisionCallback;
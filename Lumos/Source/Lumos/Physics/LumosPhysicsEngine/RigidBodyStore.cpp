@@ -0,0 +1,94 @@
+#include "Precompiled.h"
+#include "RigidBodyStore.h"
+#include "RigidBody3D.h"
+#include "Maths/MathsUtilities.h"
+
+namespace Lumos
+{
+    uint32_t RigidBodyStore::Add(RigidBody3D* body)
+    {
+        const uint32_t index = Size();
+        if(index == PaddedSize())
+            Grow(index + 4);
+
+        Bodies.PushBack(body);
+        Positions[index]            = Vec3(0.0f);
+        Orientations[index]         = Quat();
+        LinearVelocities[index]     = Vec3(0.0f);
+        AngularVelocities[index]    = Vec3(0.0f);
+        Forces[index]               = Vec3(0.0f);
+        Torques[index]              = Vec3(0.0f);
+        InvInertias[index]          = Mat3(1.0f);
+        InvMasses[index]            = 0.0f;
+        AngularFactors[index]       = 1.0f;
+        IntegrateMasks[index]       = 0;
+        LinearAccelerations[index]  = Vec3(0.0f);
+        AngularAccelerations[index] = Vec3(0.0f);
+
+        return index;
+    }
+
+    void RigidBodyStore::Remove(uint32_t index)
+    {
+        ASSERT(index < Size());
+
+        // Move the last body into the slot to keep the arrays packed
+        const uint32_t last = Size() - 1;
+        if(index != last)
+        {
+            Bodies[index]               = Bodies[last];
+            Positions[index]            = Positions[last];
+            Orientations[index]         = Orientations[last];
+            LinearVelocities[index]     = LinearVelocities[last];
+            AngularVelocities[index]    = AngularVelocities[last];
+            Forces[index]               = Forces[last];
+            Torques[index]              = Torques[last];
+            InvInertias[index]          = InvInertias[last];
+            InvMasses[index]            = InvMasses[last];
+            AngularFactors[index]       = AngularFactors[last];
+            IntegrateMasks[index]       = IntegrateMasks[last];
+            LinearAccelerations[index]  = LinearAccelerations[last];
+            AngularAccelerations[index] = AngularAccelerations[last];
+
+            Bodies[index]->m_BodyIndex = index;
+        }
+
+        // The freed slot becomes padding until the next Add
+        Bodies.PopBack();
+        IntegrateMasks[last] = 0;
+    }
+
+    RigidBodyStore& RigidBodyStore::Detached()
+    {
+        static RigidBodyStore store;
+        return store;
+    }
+
+    void RigidBodyStore::Grow(uint32_t size)
+    {
+        // Resize only reserves what it is asked for, so double the capacity here to keep Add amortised
+        size_t capacity = Positions.Capacity();
+        if(size > capacity)
+            capacity = Maths::Max((size_t)size, capacity * 2);
+
+        auto grow = [size, capacity](auto& array)
+        {
+            array.Reserve(capacity);
+            array.Resize(size);
+        };
+
+        Bodies.Reserve(capacity);
+        grow(Positions);
+        grow(Orientations);
+        grow(LinearVelocities);
+        grow(AngularVelocities);
+        grow(Forces);
+        grow(Torques);
+        grow(InvInertias);
+        grow(InvMasses);
+        grow(AngularFactors);
+        grow(IntegrateMasks);
+        grow(LinearAccelerations);
+        grow(AngularAccelerations);
+    }
+}
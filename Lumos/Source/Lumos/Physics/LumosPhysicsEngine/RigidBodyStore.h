@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core/DataStructures/TDArray.h"
+#include "Maths/Vector3.h"
+#include "Maths/Matrix3.h"
+#include "Maths/Quaternion.h"
+
+namespace Lumos
+{
+    class RigidBody3D;
+
+    // Structure of arrays holding the motion state of every body. RigidBody3D keeps its slot index and reads
+    // and writes its state here. Slots stay packed: removing a body moves the last one into its slot and
+    // updates that body's index, so code outside the physics engine holds RigidBody3D pointers, which are
+    // pooled and stable, rather than indices.
+    // Every array but Bodies is padded to a multiple of four with slots that are never integrated, so
+    // IntegrateBodies can always load four bodies at a time
+    class RigidBodyStore
+    {
+    public:
+        RigidBodyStore() = default;
+        NONCOPYABLE(RigidBodyStore)
+
+        // Returns the new body's slot. Its state is zeroed, with an identity orientation and inertia
+        uint32_t Add(RigidBody3D* body);
+        void Remove(uint32_t index);
+
+        uint32_t Size() const { return (uint32_t)Bodies.Size(); }
+        uint32_t PaddedSize() const { return (uint32_t)Positions.Size(); }
+
+        // Holds the bodies created outside a physics engine, like PathNode
+        static RigidBodyStore& Detached();
+
+        TDArray<RigidBody3D*> Bodies;
+        TDArray<Vec3> Positions;
+        TDArray<Quat> Orientations;
+        TDArray<Vec3> LinearVelocities;
+        TDArray<Vec3> AngularVelocities;
+        TDArray<Vec3> Forces;
+        TDArray<Vec3> Torques;
+        TDArray<Mat3> InvInertias;
+        TDArray<float> InvMasses;
+        TDArray<float> AngularFactors;
+
+        // Filled by LumosPhysicsEngine::UpdateRigidBodys, forces and sleep state don't change during a step
+        TDArray<uint32_t> IntegrateMasks;   // ~0u for the awake dynamic bodies, 0 for everything else
+        TDArray<Vec3> LinearAccelerations;  // Force * InvMass
+        TDArray<Vec3> AngularAccelerations; // InvInertia * Torque
+
+    private:
+        void Grow(uint32_t size);
+    };
+}
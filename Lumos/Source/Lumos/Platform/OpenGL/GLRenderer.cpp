@@ -254,7 +254,7 @@ namespace Lumos
             }
 
             Engine::Get().Statistics().NumDrawCalls++;
-            GLCall(glDrawElements(GLUtilities::DrawTypeToGL(type), count, GLUtilities::DataTypeToGL(DataType::UNSIGNED_INT), nullptr));
+            GLCall(glDrawElements(GLUtilities::DrawTypeToGL(type), count, GLUtilities::DataTypeToGL(DataType::UNSIGNED_INT), (const void*)(uintptr_t(start) * sizeof(uint32_t))));
             // GLCall(glDrawArrays(GLTools::DrawTypeToGL(type), start, count));
         }
 
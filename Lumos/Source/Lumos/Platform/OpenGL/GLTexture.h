@@ -43,6 +43,10 @@ namespace Lumos
             {
                 return m_FileName;
             }
+            void SetFilepath(const std::string& filePath) override
+            {
+                m_FileName = filePath;
+            }
 
             uint32_t GetMipMapLevels() const override
             {
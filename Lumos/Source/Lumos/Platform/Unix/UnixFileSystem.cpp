@@ -6,6 +6,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <iostream>
 
 namespace Lumos
@@ -50,6 +51,48 @@ namespace Lumos
         return buffer.st_size;
     }
 
+    uint64_t FileSystem::GetFileModifiedTime(const std::string& path)
+    {
+        struct stat buffer;
+        if(stat(path.c_str(), &buffer) != 0)
+            return 0;
+#ifdef LUMOS_PLATFORM_MACOS
+        return (uint64_t)buffer.st_mtimespec.tv_sec * 1000000000ull + (uint64_t)buffer.st_mtimespec.tv_nsec;
+#else
+        return (uint64_t)buffer.st_mtim.tv_sec * 1000000000ull + (uint64_t)buffer.st_mtim.tv_nsec;
+#endif
+    }
+
+    uint8_t* FileSystem::MapFile(const std::string& path, int64_t& outSize)
+    {
+        outSize = 0;
+        int file = open(path.c_str(), O_RDONLY);
+        if(file < 0)
+            return nullptr;
+
+        struct stat buffer;
+        if(fstat(file, &buffer) != 0 || buffer.st_size == 0)
+        {
+            close(file);
+            return nullptr;
+        }
+
+        // The mapping keeps its own reference to the file
+        void* data = mmap(nullptr, buffer.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if(data == MAP_FAILED)
+            return nullptr;
+
+        outSize = buffer.st_size;
+        return (uint8_t*)data;
+    }
+
+    void FileSystem::UnmapFile(uint8_t* data, int64_t size)
+    {
+        if(data)
+            munmap(data, size);
+    }
+
     bool FileSystem::ReadFile(const std::string& path, void* buffer, int64_t size)
     {
         if(!FileExists(path))
@@ -432,7 +432,7 @@ file.close();
             Engine::Get().Statistics().NumDrawCalls++;
             Engine::Get().Statistics().TriangleCount += count / 3;
 
-            vkCmdDrawIndexed(static_cast<VKCommandBuffer*>(commandBuffer)->GetHandle(), count, 1, 0, 0, 0);
+            vkCmdDrawIndexed(static_cast<VKCommandBuffer*>(commandBuffer)->GetHandle(), count, 1, start, 0, 0);
         }
 
         void VKRenderer::DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType, void* indices) const
@@ -75,6 +75,11 @@ namespace Lumos
                 m_Name = name;
             }
 
+            void SetFilepath(const std::string& filePath) override
+            {
+                m_FileName = filePath;
+            }
+
             void BuildTexture();
             void Resize(uint32_t width, uint32_t height) override;
 
@@ -55,6 +55,49 @@ namespace Lumos
         return result;
     }
 
+    uint64_t FileSystem::GetFileModifiedTime(const std::string& path)
+    {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if(!GetFileAttributesEx(WindowsUtilities::StringToWString(path).c_str(), GetFileExInfoStandard, &data))
+            return 0;
+        return ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+    }
+
+    uint8_t* FileSystem::MapFile(const std::string& path, int64_t& outSize)
+    {
+        outSize     = 0;
+        HANDLE file = CreateFile(WindowsUtilities::StringToWString(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(file == INVALID_HANDLE_VALUE)
+            return nullptr;
+
+        const int64_t size = GetFileSizeInternal(file);
+        if(size == 0)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if(!mapping)
+            return nullptr;
+
+        // The view keeps the mapping alive
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if(!data)
+            return nullptr;
+
+        outSize = size;
+        return (uint8_t*)data;
+    }
+
+    void FileSystem::UnmapFile(uint8_t* data, int64_t size)
+    {
+        if(data)
+            UnmapViewOfFile(data);
+    }
+
     bool FileSystem::ReadFile(const std::string& path, void* buffer, int64_t size)
     {
         std::ifstream stream(path, std::ios::binary | std::ios::ate);
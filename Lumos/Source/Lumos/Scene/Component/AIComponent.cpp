@@ -19,4 +19,30 @@ namespace Lumos
     {
     }
 
+    void AIComponent::RequestPath(PathQueryService& service, PathNode* start, PathNode* end, PathQueryPriority priority)
+    {
+        if(m_PathQuery != 0)
+            service.Cancel(m_PathQuery);
+
+        m_PathQuery = service.Submit(start, end, priority);
+    }
+
+    bool AIComponent::OnPathQueryCompleted(const PathQueryService& service, const PathQueryResult& result)
+    {
+        if(result.ID != m_PathQuery)
+            return false;
+
+        m_PathQuery = 0;
+        m_Path.Clear();
+
+        if(result.Success)
+        {
+            PathNode* const* path = service.GetPath(result);
+            for(uint32_t i = 0; i < result.PathLength; i++)
+                m_Path.PushBack(path[i]);
+        }
+
+        return true;
+    }
+
 }
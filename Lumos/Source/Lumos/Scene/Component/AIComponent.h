@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AI/AINode.h"
+#include "AI/PathQueryService.h"
 
 namespace Lumos
 {
@@ -12,7 +13,20 @@ namespace Lumos
 
         void OnImGui();
 
+        // Queues a search on the service, replacing any request that is still pending
+        void RequestPath(PathQueryService& service, PathNode* start, PathNode* end, PathQueryPriority priority = PathQueryPriority::Normal);
+
+        // Call with results polled from the service. Returns false if the result belongs to another request
+        bool OnPathQueryCompleted(const PathQueryService& service, const PathQueryResult& result);
+
+        bool IsPathPending() const { return m_PathQuery != 0; }
+        bool HasPath() const { return !m_Path.Empty(); }
+        const TDArray<PathNode*>& GetPath() const { return m_Path; }
+
     private:
         SharedPtr<AINode> m_AINode;
+
+        PathQueryID m_PathQuery = 0;
+        TDArray<PathNode*> m_Path;
     };
 }
@@ -6,6 +6,27 @@
 
 namespace Lumos
 {
+    EntityManager::EntityManager(Scene* scene)
+        : m_Scene(scene)
+    {
+        m_Registry = {};
+
+        m_Registry.on_construct<IDComponent>().connect<&EntityManager::OnIDConstruct>(*this);
+        m_Registry.on_update<IDComponent>().connect<&EntityManager::OnIDUpdate>(*this);
+        m_Registry.on_destroy<IDComponent>().connect<&EntityManager::OnIDDestroy>(*this);
+    }
+
+    EntityManager::~EntityManager()
+    {
+        m_Registry.on_construct<IDComponent>().disconnect<&EntityManager::OnIDConstruct>(*this);
+        m_Registry.on_update<IDComponent>().disconnect<&EntityManager::OnIDUpdate>(*this);
+        m_Registry.on_destroy<IDComponent>().disconnect<&EntityManager::OnIDDestroy>(*this);
+
+        HashMapDeinit(&m_UUIDIndex);
+        HashMapDeinit(&m_IndexedUUID);
+        HashMapDeinit(&m_SharedUUIDCount);
+    }
+
     Entity EntityManager::Create()
     {
         LUMOS_PROFILE_FUNCTION();
@@ -32,19 +53,19 @@ namespace Lumos
         }
 
         m_Registry.clear();
+
+        HashMapClear(&m_UUIDIndex);
+        HashMapClear(&m_IndexedUUID);
+        HashMapClear(&m_SharedUUIDCount);
     }
 
     Entity EntityManager::GetEntityByUUID(uint64_t id)
     {
         LUMOS_PROFILE_FUNCTION();
 
-        auto view = m_Registry.view<IDComponent>();
-        for(auto entity : view)
-        {
-            auto& idComponent = m_Registry.get<IDComponent>(entity);
-            if(idComponent.ID == id)
-                return Entity(entity, m_Scene);
-        }
+        entt::entity entity = FindEntity(id);
+        if(entity != entt::null)
+            return Entity(entity, m_Scene);
 
         LWARN("Entity not found by ID");
         return Entity {};
@@ -53,15 +74,111 @@ namespace Lumos
     bool EntityManager::EntityExists(u64 id)
     {
         LUMOS_PROFILE_FUNCTION();
+        return FindEntity(id) != entt::null;
+    }
+
+    void EntityManager::GetEntitiesByUUID(const u64* ids, u32 count, Entity* outEntities)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        for(u32 i = 0; i < count; i++)
+        {
+            entt::entity entity = FindEntity(ids[i]);
+            outEntities[i]      = entity != entt::null ? Entity(entity, m_Scene) : Entity {};
+        }
+    }
+
+    void EntityManager::RebuildUUIDIndex()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        HashMapClear(&m_UUIDIndex);
+        HashMapClear(&m_IndexedUUID);
+        HashMapClear(&m_SharedUUIDCount);
 
         auto view = m_Registry.view<IDComponent>();
         for(auto entity : view)
+            IndexEntity(entity, (u64)view.get<IDComponent>(entity).ID);
+    }
+
+    void EntityManager::OnIDConstruct(entt::registry& registry, entt::entity entity)
+    {
+        IndexEntity(entity, (u64)registry.get<IDComponent>(entity).ID);
+    }
+
+    void EntityManager::OnIDUpdate(entt::registry& registry, entt::entity entity)
+    {
+        UnindexEntity(entity);
+        IndexEntity(entity, (u64)registry.get<IDComponent>(entity).ID);
+    }
+
+    void EntityManager::OnIDDestroy(entt::registry& registry, entt::entity entity)
+    {
+        UnindexEntity(entity);
+    }
+
+    void EntityManager::IndexEntity(entt::entity entity, u64 id)
+    {
+        HashMapInsert(&m_IndexedUUID, entity, id);
+
+        entt::entity* indexed = (entt::entity*)HashMapFindPtr(&m_UUIDIndex, id);
+        if(indexed && *indexed != entity && m_Registry.valid(*indexed))
+        {
+            const IDComponent* indexedID = m_Registry.try_get<IDComponent>(*indexed);
+            if(indexedID && (u64)indexedID->ID == id)
+            {
+                u32* sharedCount;
+                if(HashMapGetOrAddPtr(&m_SharedUUIDCount, id, &sharedCount))
+                    *sharedCount = 0;
+                (*sharedCount)++;
+                return;
+            }
+        }
+
+        HashMapInsert(&m_UUIDIndex, id, entity);
+    }
+
+    void EntityManager::UnindexEntity(entt::entity entity)
+    {
+        u64 id;
+        if(!HashMapFind(&m_IndexedUUID, entity, &id))
+            return;
+
+        HashMapRemove(&m_IndexedUUID, entity);
+
+        u32 sharedCount = 0;
+        HashMapFind(&m_SharedUUIDCount, id, &sharedCount);
+        if(sharedCount > 1)
         {
-            auto& idComponent = m_Registry.get<IDComponent>(entity);
-            if(idComponent.ID == id)
-                return true;
+            sharedCount--;
+            HashMapInsert(&m_SharedUUIDCount, id, sharedCount);
         }
+        else if(sharedCount == 1)
+            HashMapRemove(&m_SharedUUIDCount, id);
+
+        // Only remove the id if it still points here, another entity may have been indexed under it since
+        entt::entity* indexed = (entt::entity*)HashMapFindPtr(&m_UUIDIndex, id);
+        if(!indexed || *indexed != entity)
+            return;
+
+        HashMapRemove(&m_UUIDIndex, id);
+        if(sharedCount == 0)
+            return;
 
-        return false;
+        // Another entity holds the same id, so it becomes the one the id resolves to
+        auto view = m_Registry.view<IDComponent>();
+        for(auto other : view)
+        {
+            if(other != entity && (u64)view.get<IDComponent>(other).ID == id)
+            {
+                HashMapInsert(&m_UUIDIndex, id, other);
+                break;
+            }
+        }
+    }
+
+    entt::entity EntityManager::FindEntity(u64 id)
+    {
+        entt::entity* entity = (entt::entity*)HashMapFindPtr(&m_UUIDIndex, id);
+        return entity ? *entity : entt::null;
     }
 }
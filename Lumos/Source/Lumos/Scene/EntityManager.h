@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.h"
+#include "Core/DataStructures/Map.h"
 
 DISABLE_WARNING_PUSH
 DISABLE_WARNING_CONVERSION_TO_SMALLER_TYPE
@@ -143,11 +144,8 @@ namespace Lumos
     class EntityManager
     {
     public:
-        EntityManager(Scene* scene)
-            : m_Scene(scene)
-        {
-            m_Registry = {};
-        }
+        EntityManager(Scene* scene);
+        ~EntityManager();
 
         Entity Create();
         Entity Create(const std::string& name);
@@ -180,8 +178,27 @@ namespace Lumos
         Entity GetEntityByUUID(uint64_t id);
         bool EntityExists(u64 id);
 
+        // Looks up count ids at once. Ids with no entity give a null Entity
+        void GetEntitiesByUUID(const u64* ids, u32 count, Entity* outEntities);
+
+        // Re-indexes every IDComponent. Needed after IDs are written without a registry signal, like a snapshot load
+        void RebuildUUIDIndex();
+
     private:
+        void OnIDConstruct(entt::registry& registry, entt::entity entity);
+        void OnIDUpdate(entt::registry& registry, entt::entity entity);
+        void OnIDDestroy(entt::registry& registry, entt::entity entity);
+
+        void IndexEntity(entt::entity entity, u64 id);
+        void UnindexEntity(entt::entity entity);
+        entt::entity FindEntity(u64 id);
+
         Scene* m_Scene = nullptr;
         entt::registry m_Registry;
+
+        // Kept in sync through the IDComponent signals. If two entities share an id, the first one indexed is kept
+        HashMap(u64, entt::entity) m_UUIDIndex   = {};
+        HashMap(entt::entity, u64) m_IndexedUUID = {}; // The id each entity was indexed under, to unindex it once it changes
+        HashMap(u64, u32) m_SharedUUIDCount      = {}; // Entities holding an id beyond the indexed one, one takes its place when it goes
     };
 }
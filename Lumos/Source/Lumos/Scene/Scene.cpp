@@ -28,6 +28,7 @@
 #include "Graphics/MeshFactory.h"
 #include "Graphics/Light.h"
 #include "Graphics/Model.h"
+#include "Graphics/Animation/AnimationController.h"
 #include "Graphics/ParticleManager.h"
 #include "Graphics/Environment.h"
 #include "Scene/EntityManager.h"
@@ -35,12 +36,14 @@
 #include "Scene/Component/ModelComponent.h"
 #include "SceneGraph.h"
 #include "Serialisation/SerialisationImplementation.h"
+#include "Serialisation/SceneBinary.h"
 
 #include "Scene/Component/SoundComponent.h"
 #include "Scene/Component/TextureMatrixComponent.h"
 #include "Scene/Component/RigidBody2DComponent.h"
 #include "Scene/Component/RigidBody3DComponent.h"
 #include "Scene/Component/AIComponent.h"
+#include "Core/JobSystem.h"
 
 #include <cereal/types/polymorphic.hpp>
 #include <cereal/archives/binary.hpp>
@@ -219,6 +222,14 @@ namespace entt
 
 namespace Lumos
 {
+    // Animating a model costs tens of microseconds, so a few share a job
+    static const uint32_t PARALLEL_ANIMATION_THRESHOLD = 8;
+    static const uint32_t MODELS_PER_ANIMATION_JOB     = 4;
+
+    // Each step past this distance from the camera halves the animation update rate
+    static const float ANIMATION_LOD_DISTANCE = 25.0f;
+    static const uint32_t MAX_ANIMATION_LOD   = 3;
+
     Scene::Scene(const std::string& name)
         : m_SceneName(name)
         , m_ScreenWidth(0)
@@ -320,6 +331,11 @@ namespace Lumos
             animSprite.OnUpdate((float)timeStep.GetSeconds());
         }
 
+        Maths::Transform* cameraTransform = camera ? cameraView.Front().TryGetComponent<Maths::Transform>() : nullptr;
+        const Vec3 cameraPosition         = cameraTransform ? cameraTransform->GetWorldPosition() : Vec3(0.0f);
+
+        // Gather the animated models on this thread, where their animation state is created on first use
+        m_AnimatedModels.Clear();
         auto group = m_EntityManager->GetRegistry().group<Graphics::ModelComponent>(entt::get<Maths::Transform>);
         for(auto entity : group)
         {
@@ -328,14 +344,53 @@ namespace Lumos
 
             const auto& [model, trans] = group.get<Graphics::ModelComponent, Maths::Transform>(entity);
 
-            if(!model.ModelRef)
-                continue;
+            if(model.ModelRef && model.ModelRef->PrepareAnimation())
+            {
+                m_AnimatedModels.PushBack(model.ModelRef.get());
+                model.ModelRef->GetAnimationController()->SetLOD(MAX_ANIMATION_LOD);
+            }
+        }
 
-            const auto& meshes = model.ModelRef->GetMeshes();
-            model.ModelRef->UpdateAnimation(Engine::GetTimeStep());
+        // Entities can share a model, and each one must only be updated once
+        Graphics::Model** models = m_AnimatedModels.Data();
+        std::sort(models, models + m_AnimatedModels.Size());
+        const uint32_t modelCount = (uint32_t)(std::unique(models, models + m_AnimatedModels.Size()) - models);
+        m_AnimatedModels.Resize(modelCount);
+
+        // A shared model is animated at the detail of its closest instance
+        if(cameraTransform)
+        {
+            for(auto entity : group)
+            {
+                const auto& [model, trans] = group.get<Graphics::ModelComponent, Maths::Transform>(entity);
+                if(!model.ModelRef || !model.ModelRef->GetAnimationController() || !Entity(entity, this).Active())
+                    continue;
+
+                Graphics::AnimationController* controller = model.ModelRef->GetAnimationController().get();
+                const float distance                      = Maths::Distance(trans.GetWorldPosition(), cameraPosition);
+                const uint32_t lod                        = (uint32_t)Maths::Min(distance / ANIMATION_LOD_DISTANCE, (float)MAX_ANIMATION_LOD);
+                controller->SetLOD(Maths::Min(controller->GetLOD(), lod));
+            }
+        }
+        else
+        {
+            for(Graphics::Model* model : m_AnimatedModels)
+                model->GetAnimationController()->SetLOD(0);
         }
     }
 
+    uint32_t Scene::AddAnimationTasks(System::JobSystem::TaskGraph& graph)
+    {
+        const uint32_t modelCount = (uint32_t)m_AnimatedModels.Size();
+        if(modelCount == 0)
+            return UINT32_MAX;
+
+        // A few models are animated as one job
+        const uint32_t groupSize = modelCount >= PARALLEL_ANIMATION_THRESHOLD ? MODELS_PER_ANIMATION_JOB : modelCount;
+        return graph.AddDispatch(modelCount, groupSize, [this](JobDispatchArgs args)
+                                 { m_AnimatedModels[args.jobIndex]->UpdateAnimation(Engine::GetTimeStep()); });
+    }
+
     void Scene::OnEvent(Event& e)
     {
         LUMOS_PROFILE_FUNCTION();
@@ -386,6 +441,10 @@ namespace Lumos
 #define ALL_COMPONENTSENTTV9(input) get<Maths::Transform>(input).get<NameComponent>(input).get<ActiveComponent>(input).get<Hierarchy>(input).get<Camera>(input).get<LuaScriptComponent>(input).get<Graphics::Model>(input).get<Graphics::Light>(input).get<RigidBody3DComponent>(input).get<Graphics::Environment>(input).get<Graphics::Sprite>(input).get<RigidBody2DComponent>(input).get<DefaultCameraController>(input).get<Graphics::AnimatedSprite>(input).get<SoundComponent>(input).get<Listener>(input).get<IDComponent>(input).get<Graphics::ModelComponent>(input).get<AxisConstraintComponent>(input).get<TextComponent>(input).get<ParticleEmitter>(input)
 #define ALL_COMPONENTSENTTV10(input) get<Maths::Transform>(input).get<NameComponent>(input).get<ActiveComponent>(input).get<Hierarchy>(input).get<Camera>(input).get<LuaScriptComponent>(input).get<Graphics::Model>(input).get<Graphics::Light>(input).get<RigidBody3DComponent>(input).get<Graphics::Environment>(input).get<Graphics::Sprite>(input).get<RigidBody2DComponent>(input).get<DefaultCameraController>(input).get<Graphics::AnimatedSprite>(input).get<SoundComponent>(input).get<Listener>(input).get<IDComponent>(input).get<Graphics::ModelComponent>(input).get<AxisConstraintComponent>(input).get<TextComponent>(input).get<ParticleEmitter>(input).get<SpringConstraintComponent>(input)
 
+// Components written to binary scenes as cereal archives, one chunk per type. Transform, name, active, hierarchy and ID
+// are packed by SceneBinaryWriter itself
+#define BINARY_ARCHIVED_COMPONENTS(X) X(Camera) X(LuaScriptComponent) X(Graphics::Model) X(Graphics::Light) X(RigidBody3DComponent) X(Graphics::Environment) X(Graphics::Sprite) X(RigidBody2DComponent) X(DefaultCameraController) X(Graphics::AnimatedSprite) X(SoundComponent) X(Listener) X(Graphics::ModelComponent) X(AxisConstraintComponent) X(TextComponent) X(ParticleEmitter) X(SpringConstraintComponent)
+
     void Scene::Serialise(const std::string& filePath, bool binary)
     {
         LUMOS_PROFILE_FUNCTION();
@@ -398,16 +457,7 @@ namespace Lumos
         if(binary)
         {
             path += std::string(".bin");
-
-            std::ofstream file(path, std::ios::binary);
-
-            {
-                // output finishes flushing its contents when it goes out of scope
-                cereal::BinaryOutputArchive output { file };
-                output(*this);
-                entt::snapshot { m_EntityManager->GetRegistry() }.get<entt::entity>(output).ALL_COMPONENTSENTTV10(output);
-            }
-            file.close();
+            SerialiseBinary(path);
         }
         else
         {
@@ -432,7 +482,24 @@ namespace Lumos
         std::string path = filePath;
         path += m_SceneName; // StringUtilities::RemoveSpaces(m_SceneName);
 
-        if(binary)
+        SceneBinaryReader reader;
+        bool chunkedBinary = false;
+        bool text          = !binary;
+        if(binary && reader.Open(path + ".bin"))
+        {
+            // Scenes saved before the chunked format are a single cereal archive and go through the loader below
+            chunkedBinary = DeserialiseBinary(reader);
+            reader.Close();
+
+            // A chunk can fail after earlier ones have filled the registry, so start again from the text scene
+            if(!chunkedBinary)
+            {
+                LERROR("Failed to load scene - %s.bin, loading %s.lsn instead", path.c_str(), path.c_str());
+                m_EntityManager->Clear();
+                text = true;
+            }
+        }
+        else if(binary)
         {
             path += std::string(".bin");
 
@@ -527,7 +594,8 @@ namespace Lumos
                 LERROR("Failed to load scene - %s", path.c_str());
             }
         }
-        else
+
+        if(text)
         {
             path += std::string(".lsn");
 
@@ -623,10 +691,60 @@ namespace Lumos
             }
         }
 
+        // The snapshot loader fills in IDs after the components are constructed. Chunked binary scenes insert them
+        // with their values, so the index is already up to date
+        if(!chunkedBinary)
+            m_EntityManager->RebuildUUIDIndex();
+
         m_SceneGraph->DisableOnConstruct(false, m_EntityManager->GetRegistry());
         Application::Get().OnNewScene(this);
     }
 
+    void Scene::SerialiseBinary(const std::string& path)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const entt::registry& registry = m_EntityManager->GetRegistry();
+
+        SceneBinaryWriter writer;
+        writer.WriteMetadata(*this);
+        writer.WriteEntities(registry);
+        writer.WritePackedComponents(registry);
+#define WRITE_ARCHIVED_COMPONENT(Type) writer.WriteArchived<Type>(#Type, registry);
+        BINARY_ARCHIVED_COMPONENTS(WRITE_ARCHIVED_COMPONENT)
+#undef WRITE_ARCHIVED_COMPONENT
+
+        if(!writer.Save(path, SceneSerialisationVersion))
+            LERROR("Failed to save scene - %s", path.c_str());
+    }
+
+    bool Scene::DeserialiseBinary(const SceneBinaryReader& reader)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        entt::registry& registry = m_EntityManager->GetRegistry();
+
+        try
+        {
+            if(!reader.ReadMetadata(*this))
+                return false;
+
+            if(m_SceneSerialisationVersion < MIN_SCENE_VERSION)
+            {
+                LERROR("Invalid Scene Version - Version too low %d. Minimum version supported %d", m_SceneSerialisationVersion, MIN_SCENE_VERSION);
+                return false;
+            }
+
+            bool loaded = reader.ReadEntities(registry) && reader.ReadPackedComponents(registry);
+#define READ_ARCHIVED_COMPONENT(Type) loaded = loaded && reader.ReadArchived<Type>(#Type, registry);
+            BINARY_ARCHIVED_COMPONENTS(READ_ARCHIVED_COMPONENT)
+#undef READ_ARCHIVED_COMPONENT
+            return loaded;
+        }
+        catch(...)
+        {
+            return false;
+        }
+    }
+
     void Scene::UpdateSceneGraph()
     {
         LUMOS_PROFILE_FUNCTION();
@@ -712,7 +830,8 @@ namespace Lumos
         Entity newEntity = m_EntityManager->Create();
 
         CopyEntity<ALL_COMPONENTSLISTV8>(newEntity.GetHandle(), entity.GetHandle(), m_EntityManager->GetRegistry());
-        newEntity.GetComponent<IDComponent>().ID = UUID();
+        m_EntityManager->GetRegistry().patch<IDComponent>(newEntity.GetHandle(), [](IDComponent& id)
+                                                          { id.ID = UUID(); });
 
         auto hierarchyComponent = newEntity.TryGetComponent<Hierarchy>();
         if(hierarchyComponent)
@@ -762,6 +881,9 @@ namespace Lumos
             DeserialiseEntity<ALL_COMPONENTSLISTV8>(entity, archive);
         entity.ClearChildren();
 
+        // The ID is loaded in place, so tell the UUID index about it
+        entity.GetScene()->GetRegistry().patch<IDComponent>(entity.GetHandle());
+
         // Serialize the children recursively
         int children; // = entity.GetChildren();
         archive(children);
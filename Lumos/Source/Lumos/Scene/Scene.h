@@ -15,12 +15,22 @@ namespace Lumos
     class SceneGraph;
     class Event;
     class WindowResizeEvent;
+    class SceneBinaryReader;
 
     namespace Graphics
     {
         struct Light;
         class GBuffer;
         class Material;
+        class Model;
+    }
+
+    namespace System
+    {
+        namespace JobSystem
+        {
+            class TaskGraph;
+        }
     }
 
     class LUMOS_EXPORT Scene
@@ -55,6 +65,10 @@ namespace Lumos
         //   - Called once per frame and should contain all time-sensitive update logic
         //	   Note: This is time relative to seconds not milliseconds! (e.g. msec / 1000)
         virtual void OnUpdate(const TimeStep& timeStep);
+
+        // Adds a node animating the models gathered by the last OnUpdate. Returns UINT32_MAX if there are none
+        uint32_t AddAnimationTasks(System::JobSystem::TaskGraph& graph);
+
         virtual void OnImGui() {};
         virtual void OnEvent(Event& e);
         // Delete all contained Objects
@@ -225,11 +239,18 @@ namespace Lumos
         // Load these assets ready to be used during a scene
         TDArray<UUID> m_PreLoadAssetsList;
 
+        // Animated models gathered each update, kept to avoid reallocating
+        TDArray<Graphics::Model*> m_AnimatedModels;
+
     private:
         NONCOPYABLE(Scene)
 
         bool OnWindowResize(WindowResizeEvent& e);
 
+        // Chunked binary format from SceneBinary.h, used for .bin scenes
+        void SerialiseBinary(const std::string& path);
+        bool DeserialiseBinary(const SceneBinaryReader& reader);
+
         friend class Entity;
     };
 }
@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "SceneGraph.h"
 #include "Maths/Transform.h"
+#include "Core/JobSystem.h"
 
 DISABLE_WARNING_PUSH
 DISABLE_WARNING_CONVERSION_TO_SMALLER_TYPE
@@ -9,6 +10,10 @@ DISABLE_WARNING_POP
 
 namespace Lumos
 {
+    // Below this many hierarchy nodes the propagation runs on the calling thread
+    static const uint32_t PARALLEL_NODE_THRESHOLD = 4096;
+    static const uint32_t ROOTS_PER_JOB           = 64;
+
     Hierarchy::Hierarchy(entt::entity p)
         : m_Parent(p)
     {
@@ -34,27 +39,150 @@ namespace Lumos
         registry.on_construct<Hierarchy>().connect<&Hierarchy::OnConstruct>();
         registry.on_update<Hierarchy>().connect<&Hierarchy::OnUpdate>();
         registry.on_destroy<Hierarchy>().connect<&Hierarchy::OnDestroy>();
+
+        // The flattened hierarchy caches transform pointers, so any structural change invalidates it
+        registry.on_construct<Hierarchy>().connect<&SceneGraph::OnStructureChanged>(*this);
+        registry.on_update<Hierarchy>().connect<&SceneGraph::OnStructureChanged>(*this);
+        registry.on_destroy<Hierarchy>().connect<&SceneGraph::OnStructureChanged>(*this);
+        registry.on_construct<Maths::Transform>().connect<&SceneGraph::OnStructureChanged>(*this);
+        registry.on_destroy<Maths::Transform>().connect<&SceneGraph::OnStructureChanged>(*this);
+
+        // Replacing or patching a transform through the registry bypasses its setters, so the new value is marked
+        // dirty here. The component stays in place, so the flattened hierarchy is still valid
+        registry.on_update<Maths::Transform>().connect<&SceneGraph::OnTransformUpdated>();
+
+        registry.ctx().insert_or_assign<SceneGraph*>(this);
+    }
+
+    void SceneGraph::MarkHierarchyDirty(entt::registry& registry)
+    {
+        SceneGraph** sceneGraph = registry.ctx().find<SceneGraph*>();
+        if(sceneGraph)
+            (*sceneGraph)->m_HierarchyDirty = true;
+    }
+
+    void SceneGraph::OnStructureChanged(entt::registry& /*registry*/, entt::entity /*entity*/)
+    {
+        m_HierarchyDirty = true;
+    }
+
+    void SceneGraph::OnTransformUpdated(entt::registry& registry, entt::entity entity)
+    {
+        registry.get<Maths::Transform>(entity).SetDirty(true);
     }
 
     void SceneGraph::Update(entt::registry& registry)
     {
         LUMOS_PROFILE_FUNCTION();
-        auto nonHierarchyView = registry.view<Maths::Transform>(entt::exclude<Hierarchy>);
 
-        for(auto entity : nonHierarchyView)
+        if(m_HierarchyDirty)
         {
-            registry.get<Maths::Transform>(entity).SetWorldMatrix(Mat4(1.0f));
+            RebuildHierarchy(registry);
+
+            // Parents may have changed without the transforms being touched
+            m_HierarchyDirty = false;
+            m_ForceUpdate    = true;
         }
 
+        {
+            LUMOS_PROFILE_SCOPE("Non Hierarchy Transforms");
+            auto nonHierarchyView = registry.view<Maths::Transform>(entt::exclude<Hierarchy>);
+
+            for(auto entity : nonHierarchyView)
+            {
+                Maths::Transform& transform = nonHierarchyView.get<Maths::Transform>(entity);
+                if(m_ForceUpdate || transform.IsDirty())
+                {
+                    transform.SetWorldMatrix(Mat4(1.0f));
+                    transform.SetDirty(false);
+                }
+            }
+        }
+
+        const uint32_t rootCount = (uint32_t)m_Roots.Size();
+        if(rootCount > 1 && m_Nodes.Size() >= PARALLEL_NODE_THRESHOLD)
+        {
+            System::JobSystem::Context ctx;
+            System::JobSystem::Dispatch(ctx, rootCount, ROOTS_PER_JOB, [&](JobDispatchArgs args)
+                                        {
+                                            const RootRange& range = m_Roots[args.jobIndex];
+                                            PropagateRange(range.Offset, range.Offset + range.Count); });
+            System::JobSystem::Wait(ctx);
+        }
+        else
+            PropagateRange(0, (uint32_t)m_Nodes.Size());
+
+        m_ForceUpdate = false;
+    }
+
+    void SceneGraph::RebuildHierarchy(entt::registry& registry)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Nodes.Clear();
+        m_Roots.Clear();
+
         auto view = registry.view<Hierarchy>();
         for(auto entity : view)
         {
-            const auto hierarchy = registry.try_get<Hierarchy>(entity);
-            if(hierarchy && hierarchy->Parent() == entt::null)
+            const Hierarchy& hierarchy = view.get<Hierarchy>(entity);
+            if(hierarchy.Parent() != entt::null)
+                continue;
+
+            RootRange range;
+            range.Offset = (uint32_t)m_Nodes.Size();
+
+            HierarchyNode& root = m_Nodes.EmplaceBack();
+            root.Entity         = entity;
+            root.Transform      = registry.try_get<Maths::Transform>(entity);
+            root.Parent         = -1;
+
+            // Breadth first walk using the node array as the queue, which leaves the subtree in depth order
+            for(uint32_t i = range.Offset; i < (uint32_t)m_Nodes.Size(); i++)
             {
-                // Recursively update children
-                UpdateTransform(entity, registry);
+                const Hierarchy* nodeHierarchy = registry.try_get<Hierarchy>(m_Nodes[i].Entity);
+                entt::entity child             = nodeHierarchy ? nodeHierarchy->First() : entt::null;
+                while(child != entt::null)
+                {
+                    const Hierarchy* childHierarchy = registry.try_get<Hierarchy>(child);
+                    if(!childHierarchy)
+                        break;
+
+                    HierarchyNode& node = m_Nodes.EmplaceBack();
+                    node.Entity         = child;
+                    node.Transform      = registry.try_get<Maths::Transform>(child);
+                    node.Parent         = (int32_t)i;
+
+                    child = childHierarchy->Next();
+                }
             }
+
+            range.Count = (uint32_t)m_Nodes.Size() - range.Offset;
+            m_Roots.PushBack(range);
+        }
+
+        m_Changed.Resize(m_Nodes.Size());
+    }
+
+    void SceneGraph::PropagateRange(uint32_t begin, uint32_t end)
+    {
+        LUMOS_PROFILE_FUNCTION_LOW();
+        for(uint32_t i = begin; i < end; i++)
+        {
+            const HierarchyNode& node = m_Nodes[i];
+            bool changed              = m_ForceUpdate || (node.Parent >= 0 && m_Changed[node.Parent]);
+
+            if(node.Transform)
+            {
+                changed = changed || node.Transform->IsDirty();
+                if(changed)
+                {
+                    Maths::Transform* parentTransform = node.Parent >= 0 ? m_Nodes[node.Parent].Transform : nullptr;
+                    node.Transform->SetWorldMatrix(parentTransform ? parentTransform->GetWorldMatrix() : Mat4(1.0f));
+                    node.Transform->SetDirty(false);
+                }
+            }
+
+            m_Changed[i] = changed ? 1 : 0;
         }
     }
 
@@ -99,6 +227,7 @@ namespace Lumos
     void Hierarchy::Reparent(entt::entity entity, entt::entity parent, entt::registry& registry, Hierarchy& hierarchy)
     {
         LUMOS_PROFILE_FUNCTION();
+        SceneGraph::MarkHierarchyDirty(registry);
         Hierarchy::OnDestroy(registry, entity);
 
         hierarchy.m_Parent = entt::null;
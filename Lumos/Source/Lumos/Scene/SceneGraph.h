@@ -6,11 +6,18 @@
 #include "Graphics/Camera/FPSCamera.h"
 #include "Graphics/Camera/EditorCamera.h"
 
+#include "Core/DataStructures/TDArray.h"
+
 #include <entt/entity/fwd.hpp>
 #include <cereal/cereal.hpp>
 
 namespace Lumos
 {
+    namespace Maths
+    {
+        class Transform;
+    }
+
 
     class DefaultCameraController
     {
@@ -221,7 +228,40 @@ namespace Lumos
 
         void DisableOnConstruct(bool disable, entt::registry& registry);
 
+        // Rebuilds world matrices of dirty transforms and their descendants
         void Update(entt::registry& registry);
         void UpdateTransform(entt::entity entity, entt::registry& registry);
+
+        // Forces the flattened hierarchy to be rebuilt on the next Update. Needed when parents are
+        // changed without going through the registry, as Hierarchy::Reparent does
+        static void MarkHierarchyDirty(entt::registry& registry);
+
+    private:
+        void OnStructureChanged(entt::registry& registry, entt::entity entity);
+        static void OnTransformUpdated(entt::registry& registry, entt::entity entity);
+        void RebuildHierarchy(entt::registry& registry);
+        void PropagateRange(uint32_t begin, uint32_t end);
+
+        struct HierarchyNode
+        {
+            entt::entity Entity;
+            Maths::Transform* Transform; // nullptr if the entity has no transform
+            int32_t Parent;              // Index into m_Nodes, -1 for roots
+        };
+
+        struct RootRange
+        {
+            uint32_t Offset;
+            uint32_t Count;
+        };
+
+        // Every root's subtree is stored contiguously in depth order, so parents always come before
+        // their children and independent roots can be propagated in parallel
+        TDArray<HierarchyNode> m_Nodes;
+        TDArray<RootRange> m_Roots;
+        TDArray<uint8_t> m_Changed; // World matrix was rebuilt during the current Update
+
+        bool m_HierarchyDirty = true;
+        bool m_ForceUpdate    = true;
     };
 }
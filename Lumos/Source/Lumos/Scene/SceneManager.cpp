@@ -9,6 +9,8 @@
 #include "Core/OS/FileSystem.h"
 #include "Core/OS/FileSystem.h"
 #include "Utilities/StringUtilities.h"
+#include "Utilities/Timer.h"
+#include "Core/Asset/AssetCache.h"
 
 namespace Lumos
 {
@@ -114,7 +116,11 @@ namespace Lumos
         if(Lumos::FileSystem::Get().ResolvePhysicalPath("//Assets/Scenes/" + m_CurrentScene->GetSceneName() + ".lsn", physicalPath))
         {
             auto newPath = StringUtilities::RemoveName(physicalPath);
+
+            AssetCache::Get().ResetStats();
+            const TimeStamp start = Timer::Now();
             m_CurrentScene->Deserialise(newPath, false);
+            LINFO("[SceneManager] - Loaded %s in %.2fms (cooked assets : %u, imported : %u)", m_CurrentScene->GetSceneName().c_str(), Timer::Duration(start, Timer::Now(), 1000.0f), AssetCache::Get().GetHitCount(), AssetCache::Get().GetMissCount());
         }
 
         auto screenSize = app.GetWindowSize();
@@ -0,0 +1,412 @@
+#include "Precompiled.h"
+#include "SceneBinary.h"
+#include "Core/OS/FileSystem.h"
+#include "Core/JobSystem.h"
+#include "Maths/MathsUtilities.h"
+#include "Maths/Transform.h"
+#include "Scene/SceneGraph.h"
+#include "Scene/Entity.h"
+
+namespace Lumos
+{
+    static const uint32_t SceneBinaryMagic   = 0x42534D4C; // "LMSB"
+    static const uint32_t SceneBinaryVersion = 1;
+    static const uint64_t SceneBinaryAlign   = 16;
+
+    // Below this many records the packed chunks are decoded on the calling thread
+    static const uint32_t PARALLEL_DECODE_THRESHOLD = 4096;
+    static const uint32_t RECORDS_PER_JOB           = 4096;
+
+    // File layout: SceneBinaryHeader, ChunkCount SceneChunkInfo entries, then the chunk payloads from PayloadOffset.
+    // A packed chunk holds Count entity identifiers, then Count records of ElementSize, then any variable length data,
+    // each part starting on a 16 byte boundary
+    struct SceneBinaryHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t SceneVersion;
+        uint32_t ChunkCount;
+        uint64_t PayloadOffset;
+        uint64_t PayloadSize;
+    };
+
+    struct PackedTransform
+    {
+        Vec3 Position;
+        float Rotation[4]; // x, y, z, w. Quat has its own copy constructor
+        Vec3 Scale;
+    };
+
+    // Offset and length of the name within the chunk's character data
+    struct PackedName
+    {
+        uint32_t Offset;
+        uint32_t Length;
+    };
+
+    static_assert(std::is_trivially_copyable<PackedTransform>::value, "Packed records must be trivially copyable");
+    static_assert(std::is_trivially_copyable<ActiveComponent>::value, "ActiveComponent is copied straight from the file");
+    static_assert(std::is_trivially_copyable<Hierarchy>::value, "Hierarchy is copied straight from the file");
+
+    static uint64_t AlignSceneOffset(uint64_t offset)
+    {
+        return (offset + SceneBinaryAlign - 1) & ~(SceneBinaryAlign - 1);
+    }
+
+    SceneChunkInfo& SceneBinaryWriter::BeginChunk(SceneChunkType type, uint64_t key, uint32_t elementSize, uint32_t count)
+    {
+        m_Payload.Align();
+
+        SceneChunkInfo chunk;
+        chunk.Key         = key;
+        chunk.Type        = (uint32_t)type;
+        chunk.ElementSize = elementSize;
+        chunk.Count       = count;
+        chunk.Reserved    = 0;
+        chunk.Offset      = m_Payload.Size();
+        chunk.Size        = 0;
+        m_Chunks.PushBack(chunk);
+        return m_Chunks.Back();
+    }
+
+    void SceneBinaryWriter::EndChunk(SceneChunkInfo& chunk)
+    {
+        chunk.Size = m_Payload.Size() - chunk.Offset;
+    }
+
+    void SceneBinaryWriter::WriteEntities(const entt::registry& registry)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const auto* storage  = registry.storage<entt::entity>();
+        const uint32_t count = storage ? (uint32_t)storage->size() : 0;
+        const uint32_t inUse = storage ? (uint32_t)storage->in_use() : 0;
+
+        SceneChunkInfo& chunk = BeginChunk(SceneChunkType::Entities, 0, sizeof(entt::entity), count);
+        m_Payload.Write(inUse);
+        if(count > 0)
+            m_Payload.Write(storage->data(), count * sizeof(entt::entity));
+        EndChunk(chunk);
+    }
+
+    void SceneBinaryWriter::WritePackedComponents(const entt::registry& registry)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        // Records are written in packed order, the same order the entity identifiers come in
+        if(const auto* storage = registry.storage<Maths::Transform>(); storage && !storage->empty())
+        {
+            SceneChunkInfo& chunk = BeginChunk(SceneChunkType::Packed, AssetCache::Hash("Transform"), sizeof(PackedTransform), (uint32_t)storage->size());
+            m_Payload.Write(storage->data(), storage->size() * sizeof(entt::entity));
+            m_Payload.Align();
+            for(auto [entity, transform] : storage->reach())
+            {
+                const Quat& rotation = transform.GetLocalOrientation();
+                m_Payload.Write(PackedTransform { transform.GetLocalPosition(), { rotation.x, rotation.y, rotation.z, rotation.w }, transform.GetLocalScale() });
+            }
+            EndChunk(chunk);
+        }
+
+        if(const auto* storage = registry.storage<NameComponent>(); storage && !storage->empty())
+        {
+            SceneChunkInfo& chunk = BeginChunk(SceneChunkType::Packed, AssetCache::Hash("NameComponent"), sizeof(PackedName), (uint32_t)storage->size());
+            m_Payload.Write(storage->data(), storage->size() * sizeof(entt::entity));
+            m_Payload.Align();
+
+            uint32_t offset = 0;
+            for(auto [entity, name] : storage->reach())
+            {
+                m_Payload.Write(PackedName { offset, (uint32_t)name.name.size() });
+                offset += (uint32_t)name.name.size();
+            }
+
+            m_Payload.Align();
+            for(auto [entity, name] : storage->reach())
+                m_Payload.Write(name.name.data(), name.name.size());
+            EndChunk(chunk);
+        }
+
+        if(const auto* storage = registry.storage<IDComponent>(); storage && !storage->empty())
+        {
+            SceneChunkInfo& chunk = BeginChunk(SceneChunkType::Packed, AssetCache::Hash("IDComponent"), sizeof(uint64_t), (uint32_t)storage->size());
+            m_Payload.Write(storage->data(), storage->size() * sizeof(entt::entity));
+            m_Payload.Align();
+            for(auto [entity, id] : storage->reach())
+                m_Payload.Write((uint64_t)id.ID);
+            EndChunk(chunk);
+        }
+
+        if(const auto* storage = registry.storage<ActiveComponent>(); storage && !storage->empty())
+        {
+            SceneChunkInfo& chunk = BeginChunk(SceneChunkType::Packed, AssetCache::Hash("ActiveComponent"), sizeof(ActiveComponent), (uint32_t)storage->size());
+            m_Payload.Write(storage->data(), storage->size() * sizeof(entt::entity));
+            m_Payload.Align();
+            for(auto [entity, active] : storage->reach())
+                m_Payload.Write(active);
+            EndChunk(chunk);
+        }
+
+        if(const auto* storage = registry.storage<Hierarchy>(); storage && !storage->empty())
+        {
+            SceneChunkInfo& chunk = BeginChunk(SceneChunkType::Packed, AssetCache::Hash("Hierarchy"), sizeof(Hierarchy), (uint32_t)storage->size());
+            m_Payload.Write(storage->data(), storage->size() * sizeof(entt::entity));
+            m_Payload.Align();
+            for(auto [entity, hierarchy] : storage->reach())
+                m_Payload.Write(hierarchy);
+            EndChunk(chunk);
+        }
+    }
+
+    bool SceneBinaryWriter::Save(const std::string& path, uint32_t sceneVersion) const
+    {
+        LUMOS_PROFILE_FUNCTION();
+        SceneBinaryHeader header;
+        header.Magic         = SceneBinaryMagic;
+        header.Version       = SceneBinaryVersion;
+        header.SceneVersion  = sceneVersion;
+        header.ChunkCount    = (uint32_t)m_Chunks.Size();
+        header.PayloadOffset = AlignSceneOffset(sizeof(SceneBinaryHeader) + m_Chunks.Size() * sizeof(SceneChunkInfo));
+        header.PayloadSize   = m_Payload.Size();
+
+        CookedAssetWriter file;
+        file.Write(header);
+        for(SceneChunkInfo chunk : m_Chunks)
+        {
+            chunk.Offset += header.PayloadOffset;
+            file.Write(chunk);
+        }
+        file.Align();
+        file.Write(m_Payload.Data(), m_Payload.Size());
+
+        return FileSystem::WriteFile(path, (uint8_t*)file.Data(), (uint32_t)file.Size());
+    }
+
+    SceneBinaryReader::~SceneBinaryReader()
+    {
+        Close();
+    }
+
+    bool SceneBinaryReader::Open(const std::string& path)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        Close();
+
+        m_Mapping = FileSystem::MapFile(path, m_MappingSize);
+        if(!m_Mapping)
+            return false;
+
+        SceneBinaryHeader header;
+        CookedAssetReader reader(m_Mapping, (uint64_t)m_MappingSize);
+        if(!reader.Read(header) || header.Magic != SceneBinaryMagic)
+        {
+            Close();
+            return false;
+        }
+
+        if(header.Version != SceneBinaryVersion)
+        {
+            LWARN("Binary scene format %u not supported, expected %u - %s", header.Version, SceneBinaryVersion, path.c_str());
+            Close();
+            return false;
+        }
+
+        m_Chunks     = reader.ReadArray<SceneChunkInfo>(header.ChunkCount);
+        m_ChunkCount = header.ChunkCount;
+        bool valid   = reader.IsValid();
+        for(uint32_t i = 0; valid && i < m_ChunkCount; i++)
+        {
+            const SceneChunkInfo& chunk = m_Chunks[i];
+            valid                       = chunk.Offset % SceneBinaryAlign == 0 && chunk.Size <= (uint64_t)m_MappingSize && chunk.Offset <= (uint64_t)m_MappingSize - chunk.Size;
+        }
+
+        if(!valid)
+        {
+            LERROR("Binary scene is truncated or corrupt - %s", path.c_str());
+            Close();
+            return false;
+        }
+
+        m_SceneVersion = header.SceneVersion;
+        return true;
+    }
+
+    void SceneBinaryReader::Close()
+    {
+        if(m_Mapping)
+            FileSystem::UnmapFile(m_Mapping, m_MappingSize);
+
+        m_Mapping      = nullptr;
+        m_MappingSize  = 0;
+        m_Chunks       = nullptr;
+        m_ChunkCount   = 0;
+        m_SceneVersion = 0;
+    }
+
+    const SceneChunkInfo* SceneBinaryReader::FindChunk(SceneChunkType type, uint64_t key) const
+    {
+        for(uint32_t i = 0; i < m_ChunkCount; i++)
+        {
+            if(m_Chunks[i].Type == (uint32_t)type && m_Chunks[i].Key == key)
+                return &m_Chunks[i];
+        }
+        return nullptr;
+    }
+
+    bool SceneBinaryReader::ReadEntities(entt::registry& registry) const
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const SceneChunkInfo* chunk = FindChunk(SceneChunkType::Entities, 0);
+        if(!chunk || chunk->ElementSize != sizeof(entt::entity) || chunk->Size < sizeof(uint32_t) + (uint64_t)chunk->Count * sizeof(entt::entity))
+            return false;
+
+        const uint32_t inUse         = *(const uint32_t*)(m_Mapping + chunk->Offset);
+        const entt::entity* entities = (const entt::entity*)(m_Mapping + chunk->Offset + sizeof(uint32_t));
+
+        // Emplacing with a hint keeps each identifier and its version
+        auto& storage = registry.storage<entt::entity>();
+        storage.reserve(chunk->Count);
+        for(uint32_t i = 0; i < chunk->Count; i++)
+            storage.emplace(entities[i]);
+        storage.in_use(inUse);
+
+        return true;
+    }
+
+    struct PackedChunk
+    {
+        const entt::entity* Entities = nullptr;
+        const uint8_t* Records       = nullptr;
+        const uint8_t* Data          = nullptr; // Variable length data after the records
+        uint64_t DataSize            = 0;
+        uint32_t Count               = 0;
+    };
+
+    // A missing chunk is left empty. Fails if the chunk's records aren't the size this build expects
+    static bool GetPackedChunk(const uint8_t* mapping, const SceneChunkInfo* chunk, uint32_t elementSize, PackedChunk& outChunk)
+    {
+        if(!chunk)
+            return true;
+
+        const uint64_t recordsOffset = AlignSceneOffset((uint64_t)chunk->Count * sizeof(entt::entity));
+        const uint64_t dataOffset    = AlignSceneOffset(recordsOffset + (uint64_t)chunk->Count * elementSize);
+        if(chunk->ElementSize != elementSize || recordsOffset + (uint64_t)chunk->Count * elementSize > chunk->Size)
+            return false;
+
+        const uint8_t* base = mapping + chunk->Offset;
+        outChunk.Entities   = (const entt::entity*)base;
+        outChunk.Records    = base + recordsOffset;
+        outChunk.Data       = base + Maths::Min(dataOffset, chunk->Size);
+        outChunk.DataSize   = chunk->Size - Maths::Min(dataOffset, chunk->Size);
+        outChunk.Count      = chunk->Count;
+        return true;
+    }
+
+    enum class PackedCodec : uint32_t
+    {
+        Transform,
+        Name,
+        ID
+    };
+
+    struct DecodeRange
+    {
+        PackedCodec Codec;
+        uint32_t Begin;
+        uint32_t End;
+    };
+
+    bool SceneBinaryReader::ReadPackedComponents(entt::registry& registry) const
+    {
+        LUMOS_PROFILE_FUNCTION();
+        PackedChunk transforms, names, ids, actives, hierarchies;
+        bool valid = GetPackedChunk(m_Mapping, FindChunk(SceneChunkType::Packed, AssetCache::Hash("Transform")), sizeof(PackedTransform), transforms);
+        valid      = valid && GetPackedChunk(m_Mapping, FindChunk(SceneChunkType::Packed, AssetCache::Hash("NameComponent")), sizeof(PackedName), names);
+        valid      = valid && GetPackedChunk(m_Mapping, FindChunk(SceneChunkType::Packed, AssetCache::Hash("IDComponent")), sizeof(uint64_t), ids);
+        valid      = valid && GetPackedChunk(m_Mapping, FindChunk(SceneChunkType::Packed, AssetCache::Hash("ActiveComponent")), sizeof(ActiveComponent), actives);
+        valid      = valid && GetPackedChunk(m_Mapping, FindChunk(SceneChunkType::Packed, AssetCache::Hash("Hierarchy")), sizeof(Hierarchy), hierarchies);
+        if(!valid)
+            return false;
+
+        // Transforms and names only need to exist for their construction signals, so they are bulk inserted as
+        // defaults and filled in place afterwards. Active and hierarchy records are already in their component layout
+        // and are inserted straight from the file. Inserting stays on this thread as the signals touch the scene graph
+        auto& transformStorage = registry.storage<Maths::Transform>();
+        auto& nameStorage      = registry.storage<NameComponent>();
+        if(transforms.Count > 0)
+            transformStorage.insert(transforms.Entities, transforms.Entities + transforms.Count);
+        if(names.Count > 0)
+            nameStorage.insert(names.Entities, names.Entities + names.Count);
+        if(actives.Count > 0)
+            registry.storage<ActiveComponent>().insert(actives.Entities, actives.Entities + actives.Count, (const ActiveComponent*)actives.Records);
+        if(hierarchies.Count > 0)
+            registry.storage<Hierarchy>().insert(hierarchies.Entities, hierarchies.Entities + hierarchies.Count, (const Hierarchy*)hierarchies.Records);
+
+        // IDs are indexed as they are constructed, so they are decoded first and inserted last
+        TDArray<IDComponent> stagedIDs;
+        stagedIDs.Resize(ids.Count);
+
+        TDArray<DecodeRange> ranges;
+        auto addRanges = [&ranges](PackedCodec codec, uint32_t count)
+        {
+            for(uint32_t begin = 0; begin < count; begin += RECORDS_PER_JOB)
+                ranges.PushBack({ codec, begin, Maths::Min(begin + RECORDS_PER_JOB, count) });
+        };
+        addRanges(PackedCodec::Transform, transforms.Count);
+        addRanges(PackedCodec::Name, names.Count);
+        addRanges(PackedCodec::ID, ids.Count);
+
+        auto decode = [&](const DecodeRange& range)
+        {
+            switch(range.Codec)
+            {
+            case PackedCodec::Transform:
+            {
+                const PackedTransform* records = (const PackedTransform*)transforms.Records;
+                for(uint32_t i = range.Begin; i < range.End; i++)
+                {
+                    Maths::Transform& transform = transformStorage.get(transforms.Entities[i]);
+                    transform.SetLocalPosition(records[i].Position);
+                    transform.SetLocalOrientation(Quat(records[i].Rotation[0], records[i].Rotation[1], records[i].Rotation[2], records[i].Rotation[3]));
+                    transform.SetLocalScale(records[i].Scale);
+                }
+                break;
+            }
+            case PackedCodec::Name:
+            {
+                const PackedName* records = (const PackedName*)names.Records;
+                for(uint32_t i = range.Begin; i < range.End; i++)
+                {
+                    if((uint64_t)records[i].Offset + records[i].Length <= names.DataSize)
+                        nameStorage.get(names.Entities[i]).name.assign((const char*)names.Data + records[i].Offset, records[i].Length);
+                }
+                break;
+            }
+            case PackedCodec::ID:
+            {
+                const uint64_t* records = (const uint64_t*)ids.Records;
+                for(uint32_t i = range.Begin; i < range.End; i++)
+                    stagedIDs[i].ID = UUID(records[i]);
+                break;
+            }
+            }
+        };
+
+        const uint32_t recordCount = transforms.Count + names.Count + ids.Count;
+        if(recordCount >= PARALLEL_DECODE_THRESHOLD)
+        {
+            System::JobSystem::Context ctx;
+            System::JobSystem::Dispatch(ctx, (uint32_t)ranges.Size(), 1, [&ranges, &decode](JobDispatchArgs args)
+                                        { decode(ranges[args.jobIndex]); });
+            System::JobSystem::Wait(ctx);
+        }
+        else
+        {
+            for(const DecodeRange& range : ranges)
+                decode(range);
+        }
+
+        if(ids.Count > 0)
+            registry.storage<IDComponent>().insert(ids.Entities, ids.Entities + ids.Count, stagedIDs.Data());
+
+        return true;
+    }
+}
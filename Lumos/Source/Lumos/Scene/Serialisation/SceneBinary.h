@@ -0,0 +1,182 @@
+#pragma once
+#include "Core/Asset/AssetCache.h"
+#include "Core/DataStructures/TDArray.h"
+#include <entt/entity/registry.hpp>
+#include <cereal/archives/binary.hpp>
+#include <streambuf>
+#include <istream>
+#include <sstream>
+
+namespace Lumos
+{
+    enum class SceneChunkType : uint32_t
+    {
+        Metadata, // cereal binary of the Scene itself
+        Entities, // Entity storage as raw identifiers, in_use first
+        Packed,   // One fixed size record per entity, laid out by the loader's own codec
+        Archived  // Entity identifiers followed by a cereal binary blob of the components
+    };
+
+    // Chunk table entry. Offset is from the start of the file and always 16 byte aligned
+    struct SceneChunkInfo
+    {
+        uint64_t Key; // Hash of the component name, 0 for the metadata and entity chunks
+        uint32_t Type;
+        uint32_t ElementSize; // Size of a packed record, checked against the loader's so a layout change fails to load
+        uint32_t Count;
+        uint32_t Reserved;
+        uint64_t Offset;
+        uint64_t Size;
+    };
+
+    // Reads a block of memory as a stream without copying it, so cereal can decode straight from a mapped file
+    class MemoryStreamBuffer : public std::streambuf
+    {
+    public:
+        MemoryStreamBuffer(const uint8_t* data, uint64_t size)
+        {
+            char* begin = (char*)data;
+            setg(begin, begin, begin + size);
+        }
+    };
+
+    // Builds a binary scene. Each component type is one contiguous chunk: Transform, name, ID, active and hierarchy
+    // are written as flat records, everything else is archived with cereal per type
+    class SceneBinaryWriter
+    {
+    public:
+        template <typename T>
+        void WriteMetadata(const T& value)
+        {
+            std::ostringstream stream;
+            {
+                cereal::BinaryOutputArchive output { stream };
+                output(value);
+            }
+
+            const std::string data = stream.str();
+            SceneChunkInfo& chunk  = BeginChunk(SceneChunkType::Metadata, 0, 0, 0);
+            m_Payload.Write(data.data(), data.size());
+            EndChunk(chunk);
+        }
+
+        void WriteEntities(const entt::registry& registry);
+        void WritePackedComponents(const entt::registry& registry);
+
+        template <typename T>
+        void WriteArchived(const char* name, const entt::registry& registry)
+        {
+            const auto* storage = registry.storage<T>();
+            if(!storage || storage->empty())
+                return;
+
+            std::ostringstream stream;
+            {
+                cereal::BinaryOutputArchive output { stream };
+                if constexpr(entt::registry::storage_for_type<T>::traits_type::page_size != 0u)
+                {
+                    for(auto [entity, component] : storage->reach())
+                        output(component);
+                }
+            }
+
+            const std::string data = stream.str();
+            SceneChunkInfo& chunk  = BeginChunk(SceneChunkType::Archived, AssetCache::Hash(name), 0, (uint32_t)storage->size());
+            m_Payload.Write(storage->data(), storage->size() * sizeof(entt::entity));
+            m_Payload.Align();
+            m_Payload.Write(data.data(), data.size());
+            EndChunk(chunk);
+        }
+
+        bool Save(const std::string& path, uint32_t sceneVersion) const;
+
+    private:
+        SceneChunkInfo& BeginChunk(SceneChunkType type, uint64_t key, uint32_t elementSize, uint32_t count);
+        void EndChunk(SceneChunkInfo& chunk);
+
+        CookedAssetWriter m_Payload;
+        TDArray<SceneChunkInfo> m_Chunks;
+    };
+
+    // Loads a binary scene from a mapped file. Entities keep their identifiers, so entity references stored in
+    // components stay valid. Packed chunks are decoded in parallel on the job system and bulk inserted, archived
+    // chunks are loaded on the calling thread as their loads can create assets and physics bodies.
+    // The registry's signals fire as usual
+    class SceneBinaryReader
+    {
+    public:
+        SceneBinaryReader() = default;
+        ~SceneBinaryReader();
+
+        SceneBinaryReader(const SceneBinaryReader&)            = delete;
+        SceneBinaryReader& operator=(const SceneBinaryReader&) = delete;
+
+        // Returns false if the file isn't a binary scene of the current format
+        bool Open(const std::string& path);
+        void Close();
+
+        uint32_t GetSceneVersion() const { return m_SceneVersion; }
+
+        template <typename T>
+        bool ReadMetadata(T& value) const
+        {
+            const SceneChunkInfo* chunk = FindChunk(SceneChunkType::Metadata, 0);
+            if(!chunk)
+                return false;
+
+            MemoryStreamBuffer buffer(m_Mapping + chunk->Offset, chunk->Size);
+            std::istream stream(&buffer);
+            cereal::BinaryInputArchive input(stream);
+            input(value);
+            return true;
+        }
+
+        // Must be called on an empty registry before reading any components
+        bool ReadEntities(entt::registry& registry) const;
+        bool ReadPackedComponents(entt::registry& registry) const;
+
+        template <typename T>
+        bool ReadArchived(const char* name, entt::registry& registry) const
+        {
+            const SceneChunkInfo* chunk = FindChunk(SceneChunkType::Archived, AssetCache::Hash(name));
+            if(!chunk)
+                return true;
+
+            // The blob starts on the first 16 byte boundary after the identifiers
+            const entt::entity* entities = (const entt::entity*)(m_Mapping + chunk->Offset);
+            const uint64_t blobOffset    = ((uint64_t)chunk->Count * sizeof(entt::entity) + 15) & ~15ull;
+            if(blobOffset > chunk->Size)
+                return false;
+
+            auto& storage = registry.storage<T>();
+            storage.reserve(storage.size() + chunk->Count);
+
+            MemoryStreamBuffer buffer(m_Mapping + chunk->Offset + blobOffset, chunk->Size - blobOffset);
+            std::istream stream(&buffer);
+            cereal::BinaryInputArchive input(stream);
+            for(uint32_t i = 0; i < chunk->Count; i++)
+            {
+                if constexpr(entt::registry::storage_for_type<T>::traits_type::page_size == 0u)
+                    storage.emplace(entities[i]);
+                else
+                {
+                    // Decoded before it's added, so on_construct sees the loaded component rather than a default one
+                    T component;
+                    input(component);
+                    storage.emplace(entities[i], std::move(component));
+                }
+            }
+
+            return true;
+        }
+
+    private:
+        const SceneChunkInfo* FindChunk(SceneChunkType type, uint64_t key) const;
+
+        uint8_t* m_Mapping             = nullptr;
+        int64_t m_MappingSize          = 0;
+        const SceneChunkInfo* m_Chunks = nullptr;
+        uint32_t m_ChunkCount          = 0;
+        uint32_t m_SceneVersion        = 0;
+    };
+}
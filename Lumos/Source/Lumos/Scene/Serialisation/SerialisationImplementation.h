@@ -142,7 +142,7 @@ namespace Lumos
         const int Version = 2;
 
         archive(cereal::make_nvp("Version", Version));
-        archive(cereal::make_nvp("Position", rigidBody.m_Position), cereal::make_nvp("Orientation", rigidBody.m_Orientation), cereal::make_nvp("LinearVelocity", rigidBody.m_LinearVelocity), cereal::make_nvp("Force", rigidBody.m_Force), cereal::make_nvp("Mass", 1.0f / rigidBody.m_InvMass), cereal::make_nvp("AngularVelocity", rigidBody.m_AngularVelocity), cereal::make_nvp("Torque", rigidBody.m_Torque), cereal::make_nvp("Static", rigidBody.m_Static), cereal::make_nvp("Friction", rigidBody.m_Friction), cereal::make_nvp("Elasticity", rigidBody.m_Elasticity), cereal::make_nvp("CollisionShape", shape), cereal::make_nvp("Trigger", rigidBody.m_Trigger), cereal::make_nvp("AngularFactor", rigidBody.m_AngularFactor));
+        archive(cereal::make_nvp("Position", rigidBody.GetPosition()), cereal::make_nvp("Orientation", rigidBody.GetOrientation()), cereal::make_nvp("LinearVelocity", rigidBody.GetLinearVelocity()), cereal::make_nvp("Force", rigidBody.GetForce()), cereal::make_nvp("Mass", 1.0f / rigidBody.GetInverseMass()), cereal::make_nvp("AngularVelocity", rigidBody.GetAngularVelocity()), cereal::make_nvp("Torque", rigidBody.GetTorque()), cereal::make_nvp("Static", rigidBody.m_Static), cereal::make_nvp("Friction", rigidBody.m_Friction), cereal::make_nvp("Elasticity", rigidBody.m_Elasticity), cereal::make_nvp("CollisionShape", shape), cereal::make_nvp("Trigger", rigidBody.m_Trigger), cereal::make_nvp("AngularFactor", rigidBody.GetAngularFactor()));
         archive(cereal::make_nvp("UUID", (uint64_t)rigidBody.m_UUID));
         shape.release();
     }
@@ -154,7 +154,9 @@ namespace Lumos
 
         int Version;
         archive(cereal::make_nvp("Version", Version));
-        archive(cereal::make_nvp("Position", rigidBody.m_Position), cereal::make_nvp("Orientation", rigidBody.m_Orientation), cereal::make_nvp("LinearVelocity", rigidBody.m_LinearVelocity), cereal::make_nvp("Force", rigidBody.m_Force), cereal::make_nvp("Mass", 1.0f / rigidBody.m_InvMass), cereal::make_nvp("AngularVelocity", rigidBody.m_AngularVelocity), cereal::make_nvp("Torque", rigidBody.m_Torque), cereal::make_nvp("Static", rigidBody.m_Static), cereal::make_nvp("Friction", rigidBody.m_Friction), cereal::make_nvp("Elasticity", rigidBody.m_Elasticity), cereal::make_nvp("CollisionShape", shape), cereal::make_nvp("Trigger", rigidBody.m_Trigger), cereal::make_nvp("AngularFactor", rigidBody.m_AngularFactor));
+        RigidBodyStore& store = *rigidBody.m_Store;
+        const uint32_t index  = rigidBody.m_BodyIndex;
+        archive(cereal::make_nvp("Position", store.Positions[index]), cereal::make_nvp("Orientation", store.Orientations[index]), cereal::make_nvp("LinearVelocity", store.LinearVelocities[index]), cereal::make_nvp("Force", store.Forces[index]), cereal::make_nvp("Mass", 1.0f / store.InvMasses[index]), cereal::make_nvp("AngularVelocity", store.AngularVelocities[index]), cereal::make_nvp("Torque", store.Torques[index]), cereal::make_nvp("Static", rigidBody.m_Static), cereal::make_nvp("Friction", rigidBody.m_Friction), cereal::make_nvp("Elasticity", rigidBody.m_Elasticity), cereal::make_nvp("CollisionShape", shape), cereal::make_nvp("Trigger", rigidBody.m_Trigger), cereal::make_nvp("AngularFactor", store.AngularFactors[index]));
 
         rigidBody.m_CollisionShape = SharedPtr<CollisionShape>(shape.get());
         rigidBody.CollisionShapeUpdated();
@@ -561,6 +563,7 @@ namespace Lumos
         void load(Archive& archive, Maths::Transform& transform)
         {
             archive(cereal::make_nvp("Position", transform.m_LocalPosition), cereal::make_nvp("Rotation", transform.m_LocalOrientation), cereal::make_nvp("Scale", transform.m_LocalScale));
+            transform.m_Dirty = true;
         }
 
     }
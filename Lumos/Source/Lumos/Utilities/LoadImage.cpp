@@ -2,6 +2,7 @@
 #include "LoadImage.h"
 
 #include "Core/OS/FileSystem.h"
+#include "Core/Asset/AssetCache.h"
 
 #ifdef FREEIMAGE
 #include <FreeImage.h>
@@ -22,6 +23,55 @@ namespace Lumos
     static uint32_t s_MaxWidth  = 0;
     static uint32_t s_MaxHeight = 0;
 
+    // Cooked images hold the decoded and resized pixels, so a cache hit skips stb entirely
+    struct CookedImageInfo
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Bits;
+        uint32_t IsHDR;
+    };
+
+    static uint64_t GetImageSettingsHash(uint32_t maxWidth, uint32_t maxHeight)
+    {
+        const uint32_t settings[2] = { maxWidth, maxHeight };
+        return AssetCache::Hash(settings, sizeof(settings));
+    }
+
+    static uint8_t* LoadCookedImage(const std::string& physicalPath, uint64_t settingsHash, CookedImageInfo& outInfo)
+    {
+        CookedAsset cooked;
+        if(!AssetCache::Get().Load(physicalPath, AssetType::Texture, settingsHash, cooked))
+            return nullptr;
+
+        CookedAssetReader reader = cooked.GetReader();
+        if(!reader.Read(outInfo))
+            return nullptr;
+
+        reader.Align();
+        const uint64_t size   = uint64_t(outInfo.Width) * uint64_t(outInfo.Height) * uint64_t(outInfo.Bits / 8U);
+        const uint8_t* pixels = reader.ReadArray<uint8_t>(size);
+        if(!pixels)
+            return nullptr;
+
+        // Callers own the pixels, the mapping goes away with cooked
+        uint8_t* result = new uint8_t[size];
+        MemoryCopy(result, pixels, size);
+        return result;
+    }
+
+    static void StoreCookedImage(const std::string& physicalPath, uint64_t settingsHash, const CookedImageInfo& info, const uint8_t* pixels)
+    {
+        if(!AssetCache::Get().IsEnabled())
+            return;
+
+        CookedAssetWriter writer;
+        writer.Write(info);
+        writer.Align();
+        writer.Write(pixels, uint64_t(info.Width) * uint64_t(info.Height) * uint64_t(info.Bits / 8U));
+        AssetCache::Get().Store(physicalPath, AssetType::Texture, settingsHash, writer);
+    }
+
     uint8_t* LoadImageFromFile(const char* filename, uint32_t* width, uint32_t* height, uint32_t* bits, bool* isHDR, bool flipY, bool srgb)
     {
         LUMOS_PROFILE_FUNCTION();
@@ -32,6 +82,23 @@ namespace Lumos
 
         filename = physicalPath.c_str();
 
+        const bool resize           = !isHDR && s_MaxWidth > 0 && s_MaxHeight > 0;
+        const uint64_t settingsHash = resize ? GetImageSettingsHash(s_MaxWidth, s_MaxHeight) : GetImageSettingsHash(0, 0);
+
+        CookedImageInfo cookedInfo;
+        if(uint8_t* cookedPixels = LoadCookedImage(physicalPath, settingsHash, cookedInfo))
+        {
+            if(width)
+                *width = cookedInfo.Width;
+            if(height)
+                *height = cookedInfo.Height;
+            if(bits)
+                *bits = cookedInfo.Bits;
+            if(isHDR)
+                *isHDR = cookedInfo.IsHDR != 0;
+            return cookedPixels;
+        }
+
         int texWidth = 0, texHeight = 0, texChannels = 0;
         stbi_uc* pixels   = nullptr;
         int sizeOfChannel = 8;
@@ -52,7 +119,7 @@ namespace Lumos
         }
 
         // Resize the image if it exceeds the maximum width or height
-        if(!isHDR && s_MaxWidth > 0 && s_MaxHeight > 0 && ((uint32_t)texWidth > s_MaxWidth || (uint32_t)texHeight > s_MaxHeight))
+        if(resize && ((uint32_t)texWidth > s_MaxWidth || (uint32_t)texHeight > s_MaxHeight))
         {
             uint32_t texWidthOld = texWidth, texHeightOld = texHeight;
             float aspectRatio = static_cast<float>(texWidth) / static_cast<float>(texHeight);
@@ -129,6 +196,9 @@ namespace Lumos
         memcpy(result, pixels, size);
 
         stbi_image_free(pixels);
+
+        cookedInfo = { uint32_t(texWidth), uint32_t(texHeight), uint32_t(texChannels * sizeOfChannel), sizeOfChannel == 32 ? 1u : 0u };
+        StoreCookedImage(physicalPath, settingsHash, cookedInfo, result);
         return result;
     }
 
@@ -146,10 +216,25 @@ namespace Lumos
         int texWidth = 0, texHeight = 0, texChannels = 0;
 
         int sizeOfChannel = 8;
+
+        const bool resize           = desc.maxWidth > 0 && desc.maxHeight > 0;
+        const uint64_t settingsHash = resize ? GetImageSettingsHash(desc.maxWidth, desc.maxHeight) : GetImageSettingsHash(0, 0);
+
         if(FileSystem::Get().ResolvePhysicalPath(filePath, physicalPath))
         {
             desc.filePath = physicalPath.c_str();
 
+            CookedImageInfo cookedInfo;
+            if(uint8_t* cookedPixels = LoadCookedImage(physicalPath, settingsHash, cookedInfo))
+            {
+                desc.outWidth  = cookedInfo.Width;
+                desc.outHeight = cookedInfo.Height;
+                desc.outBits   = cookedInfo.Bits;
+                desc.isHDR     = cookedInfo.IsHDR != 0;
+                desc.outPixels = cookedPixels;
+                return true;
+            }
+
             if(stbi_is_hdr(desc.filePath))
             {
                 sizeOfChannel = 32;
@@ -165,7 +250,7 @@ namespace Lumos
             }
 
             // Resize the image if it exceeds the maximum width or height
-            if(!desc.isHDR && desc.maxWidth > 0 && desc.maxHeight > 0 && ((uint32_t)texWidth > desc.maxWidth || (uint32_t)texHeight > desc.maxHeight))
+            if(!desc.isHDR && resize && ((uint32_t)texWidth > desc.maxWidth || (uint32_t)texHeight > desc.maxHeight))
             {
                 uint32_t texWidthOld = texWidth, texHeightOld = texHeight;
                 float aspectRatio = static_cast<float>(texWidth) / static_cast<float>(texHeight);
@@ -242,6 +327,9 @@ namespace Lumos
 
         stbi_image_free(pixels);
         desc.outPixels = result;
+
+        const CookedImageInfo cookedInfo = { desc.outWidth, desc.outHeight, desc.outBits, desc.isHDR ? 1u : 0u };
+        StoreCookedImage(physicalPath, settingsHash, cookedInfo, result);
         return true;
     }
 
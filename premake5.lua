@@ -85,3 +85,5 @@ workspace( settings.workspace_name )
 		   SetRecommendedSettings()
 	include "Editor/premake5"
 		   SetRecommendedSettings()
+	include "Benchmarks/premake5"
+		SetRecommendedSettings()